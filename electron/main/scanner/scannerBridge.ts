@@ -5,12 +5,18 @@
  * Connects renderer process to native scanner drivers.
  */
 
-import { ipcMain, IpcMainInvokeEvent } from 'electron';
+import { ipcMain, IpcMainInvokeEvent, webContents } from 'electron';
 import type {
   ScannerDevice,
   ScanSettings,
   ScanResult,
   BatchScanResult,
+  ScanSessionInfo,
+  PreviewScanResult,
+  ScanMetrics,
+  ScanMetricStage,
+  ScanMetricsEvent,
+  PageScanMetrics,
 } from '../../../src/lib/scanner/types';
 
 /**
@@ -28,6 +34,17 @@ export const SCANNER_CHANNELS = {
   BATCH_SCAN: 'scanner-batch-scan',
   CANCEL_SCAN: 'scanner-cancel-scan',
   GET_SCAN_STATUS: 'scanner-get-scan-status',
+  GET_METRICS: 'scanner-get-metrics',
+
+  // Sessions (several devices open at once)
+  OPEN_SESSION: 'scanner-open-session',
+  CLOSE_SESSION: 'scanner-close-session',
+  GET_SESSIONS: 'scanner-get-sessions',
+  SESSION_SCAN: 'scanner-session-scan',
+  SESSION_BATCH_SCAN: 'scanner-session-batch-scan',
+  SESSION_CANCEL_SCAN: 'scanner-session-cancel-scan',
+  SESSION_GET_SCAN_STATUS: 'scanner-session-get-scan-status',
+  SESSION_GET_METRICS: 'scanner-session-get-metrics',
 
   // Preview
   PREVIEW_SCAN: 'scanner-preview-scan',
@@ -38,8 +55,56 @@ export const SCANNER_CHANNELS = {
   SCAN_ERROR: 'scanner-scan-error',
   DEVICE_CONNECTED: 'scanner-device-connected',
   DEVICE_DISCONNECTED: 'scanner-device-disconnected',
+  SCAN_METRICS: 'scanner-scan-metrics',
 } as const;
 
+const METRIC_STAGES: ScanMetricStage[] = [
+  'deviceSetup',
+  'transfer',
+  'assemble',
+  'binarize',
+  'encode',
+  'pdfWrite',
+  'spool',
+  'queueWait',
+  'ipcHandoff',
+];
+
+/**
+ * Page records kept per session, as in the native metrics
+ */
+const RECENT_PAGE_METRICS = 32;
+
+/**
+ * Zeroed counters in the shape of the native getMetrics() result
+ */
+function createEmptyMetrics(): ScanMetrics {
+  const stages = {} as ScanMetrics['stages'];
+  for (const stage of METRIC_STAGES) {
+    stages[stage] = { count: 0, totalMs: 0, maxMs: 0, meanMs: 0 };
+  }
+  return {
+    scans: 0,
+    pages: 0,
+    stages,
+    bytes: { transferred: 0, encoded: 0, delivered: 0 },
+    queue: { depth: 0, maxDepth: 0, bytes: 0, maxBytes: 0 },
+    bufferPool: { hits: 0, misses: 0, pooledBytes: 0, pooledBuffers: 0 },
+    threadPool: { threads: 0, queuedTasks: 0 },
+    recentPages: [],
+  };
+}
+
+/**
+ * Open device in the mock scanner, mirroring a native scan session
+ */
+interface MockSession {
+  id: number;
+  device: ScannerDevice;
+  isScanning: boolean;
+  metrics: ScanMetrics;
+}
+
 /**
  * Mock scanner for development and testing
  */
@@ -83,44 +148,148 @@ class MockScanner {
     },
   ];
 
-  private selectedDevice: ScannerDevice | null = null;
-  private isScanning = false;
+  private sessions = new Map<number, MockSession>();
+  private nextSessionId = 1;
+  private selectedSession: MockSession | null = null;
+
+  /** Receives every finished page's metrics, like native onMetrics() */
+  onMetrics: ((event: ScanMetricsEvent) => void) | null = null;
 
   async enumerateDevices(): Promise<ScannerDevice[]> {
     return this.devices;
   }
 
-  async selectDevice(deviceId: string): Promise<boolean> {
+  /**
+   * Open a device, or return the session that already has it open
+   */
+  openSession(deviceId: string): number | null {
+    for (const session of this.sessions.values()) {
+      if (session.device.id === deviceId) {
+        return session.id;
+      }
+    }
+
     const device = this.devices.find((d) => d.id === deviceId);
-    if (device) {
-      this.selectedDevice = device;
-      return true;
+    if (!device) {
+      return null;
+    }
+
+    const session: MockSession = {
+      id: this.nextSessionId++,
+      device,
+      isScanning: false,
+      metrics: createEmptyMetrics(),
+    };
+    this.sessions.set(session.id, session);
+    return session.id;
+  }
+
+  closeSession(sessionId: number): boolean {
+    const session = this.sessions.get(sessionId);
+    if (!session || session.isScanning) {
+      return false;
     }
-    return false;
+
+    this.sessions.delete(sessionId);
+    if (this.selectedSession === session) {
+      this.selectedSession = null;
+    }
+    return true;
+  }
+
+  getSession(sessionId: number): MockSession | null {
+    return this.sessions.get(sessionId) ?? null;
+  }
+
+  getSessions(): ScanSessionInfo[] {
+    return Array.from(this.sessions.values(), (session) => ({
+      sessionId: session.id,
+      deviceId: session.device.id,
+      isScanning: session.isScanning,
+    }));
+  }
+
+  async selectDevice(deviceId: string): Promise<boolean> {
+    const sessionId = this.openSession(deviceId);
+    if (sessionId === null) {
+      return false;
+    }
+    this.selectedSession = this.sessions.get(sessionId) ?? null;
+    return true;
   }
 
   getSelectedDevice(): ScannerDevice | null {
-    return this.selectedDevice;
+    return this.selectedSession?.device ?? null;
+  }
+
+  getMetrics(session: MockSession | null = this.selectedSession): ScanMetrics {
+    return session?.metrics ?? createEmptyMetrics();
+  }
+
+  /**
+   * Book a simulated page: the feed delay counts as transfer time
+   */
+  private recordPage(session: MockSession, pageIndex: number, transferMs: number, bytes: number): void {
+    const metrics = session.metrics;
+    const page: PageScanMetrics = {
+      pageIndex,
+      bytesTransferred: bytes,
+      stages: {} as PageScanMetrics['stages'],
+    };
+    for (const stage of METRIC_STAGES) {
+      page.stages[stage] = stage === 'transfer' ? transferMs : 0;
+    }
+
+    const transfer = metrics.stages.transfer;
+    transfer.count++;
+    transfer.totalMs += transferMs;
+    transfer.maxMs = Math.max(transfer.maxMs, transferMs);
+    transfer.meanMs = transfer.totalMs / transfer.count;
+    metrics.pages++;
+    metrics.bytes.transferred += bytes;
+    metrics.bytes.delivered += bytes;
+    metrics.recentPages.push(page);
+    if (metrics.recentPages.length > RECENT_PAGE_METRICS) {
+      metrics.recentPages.shift();
+    }
+
+    this.onMetrics?.({ sessionId: session.id, deviceId: session.device.id, page });
   }
 
-  async scan(settings: ScanSettings): Promise<ScanResult> {
-    if (!this.selectedDevice) {
+  async scan(
+    settings: ScanSettings,
+    onProgress?: (progress: number) => void,
+    session: MockSession | null = this.selectedSession
+  ): Promise<ScanResult> {
+    if (!session) {
       return { success: false, error: 'No scanner selected' };
     }
+    if (session.isScanning) {
+      return { success: false, error: 'Scan already in progress' };
+    }
 
-    this.isScanning = true;
+    session.isScanning = true;
+    session.metrics.scans++;
+    const started = Date.now();
 
-    // Simulate scan delay
-    await new Promise((resolve) => setTimeout(resolve, 1500));
+    // Simulate scan delay, reporting progress per band like the native
+    // scanStream() API does
+    const bands = 4;
+    for (let band = 1; band <= bands; band++) {
+      await new Promise((resolve) => setTimeout(resolve, 1500 / bands));
+      onProgress?.(band / bands);
+    }
 
-    this.isScanning = false;
+    session.isScanning = false;
 
-    // Generate mock scan result
-    const width = Math.round(settings.resolution * 8.5);
-    const height = Math.round(settings.resolution * 11);
+    // Generate mock scan result, honouring a hardware scan area
+    const area = settings.scanArea;
+    const width = Math.round(settings.resolution * (area ? area.width : 8.5));
+    const height = Math.round(settings.resolution * (area ? area.height : 11));
 
     // Create a simple gradient image as mock data
     const canvas = createMockCanvas(width, height, settings.colorMode);
+    this.recordPage(session, 0, Date.now() - started, width * height * 3);
 
     return {
       success: true,
@@ -129,15 +298,90 @@ class MockScanner {
       height,
       resolution: settings.resolution,
       colorMode: settings.colorMode,
+      scanArea: area,
+    };
+  }
+
+  /**
+   * Feed up to maxPages sheets in one session, mirroring the native
+   * scanBatch() API: the feeder keeps running and each page is handed to
+   * onPage as soon as it is done.
+   */
+  async scanBatch(
+    settings: ScanSettings,
+    maxPages: number,
+    onPage: (page: ScanResult, index: number) => void,
+    session: MockSession | null = this.selectedSession
+  ): Promise<BatchScanResult> {
+    if (!session) {
+      return { success: false, pageCount: 0, pages: [], error: 'No scanner selected' };
+    }
+    if (session.isScanning) {
+      return { success: false, pageCount: 0, pages: [], error: 'Scan already in progress' };
+    }
+
+    session.isScanning = true;
+    session.metrics.scans++;
+    const pages: ScanResult[] = [];
+
+    for (let i = 0; i < maxPages && session.isScanning; i++) {
+      // Simulated per-sheet feed time of a continuously running ADF
+      const started = Date.now();
+      await new Promise((resolve) => setTimeout(resolve, 500));
+
+      const width = Math.round(settings.resolution * 8.5);
+      const height = Math.round(settings.resolution * 11);
+      const page: ScanResult = {
+        success: true,
+        dataUrl: createMockCanvas(width, height, settings.colorMode),
+        width,
+        height,
+        resolution: settings.resolution,
+        colorMode: settings.colorMode,
+      };
+
+      pages.push(page);
+      this.recordPage(session, i, Date.now() - started, width * height * 3);
+      onPage(page, i);
+    }
+
+    session.isScanning = false;
+
+    return {
+      success: pages.length > 0,
+      pageCount: pages.length,
+      pages,
     };
   }
 
-  async cancelScan(): Promise<void> {
-    this.isScanning = false;
+  /**
+   * Quick low-resolution frame of the flatbed, mirroring the native
+   * preview() API
+   */
+  async preview(
+    settings: Partial<ScanSettings> = {},
+    session: MockSession | null = this.selectedSession
+  ): Promise<PreviewScanResult> {
+    const result = await this.scan(
+      {
+        resolution: 75,
+        colorMode: settings.colorMode === 'blackwhite' ? 'grayscale' : settings.colorMode ?? 'color',
+        paperSize: settings.paperSize ?? 'auto',
+      },
+      undefined,
+      session
+    );
+    return { ...result, document: { detected: false } };
+  }
+
+  async cancelScan(session: MockSession | null = this.selectedSession): Promise<void> {
+    if (session) {
+      session.isScanning = false;
+    }
   }
 
-  isScanInProgress(): boolean {
-    return this.isScanning;
+  isScanInProgress(session: MockSession | null = this.selectedSession): boolean {
+    return session?.isScanning ?? false;
   }
 }
 
@@ -198,31 +442,24 @@ export class ScannerBridge {
     // Scan
     ipcMain.handle(
       SCANNER_CHANNELS.SCAN,
-      async (_event: IpcMainInvokeEvent, settings: ScanSettings) => {
-        return this.mockScanner.scan(settings);
+      async (event: IpcMainInvokeEvent, settings: ScanSettings) => {
+        return this.mockScanner.scan(settings, (progress) => {
+          event.sender.send(SCANNER_CHANNELS.SCAN_PROGRESS, { progress });
+        });
       }
     );
 
     // Batch scan
     ipcMain.handle(
       SCANNER_CHANNELS.BATCH_SCAN,
-      async (_event: IpcMainInvokeEvent, settings: ScanSettings, pageCount: number) => {
-        const pages: ScanResult[] = [];
-
-        for (let i = 0; i < pageCount; i++) {
-          const result = await this.mockScanner.scan(settings);
-          if (result.success) {
-            pages.push(result);
-          } else {
-            break;
-          }
-        }
-
-        return {
-          success: pages.length > 0,
-          pageCount: pages.length,
-          pages,
-        } as BatchScanResult;
+      async (event: IpcMainInvokeEvent, settings: ScanSettings, pageCount: number) => {
+        // One feeder session for the whole stack instead of a scan per page
+        return this.mockScanner.scanBatch(settings, pageCount, (_page, index) => {
+          event.sender.send(SCANNER_CHANNELS.SCAN_PROGRESS, {
+            current: index + 1,
+            total: pageCount,
+          });
+        });
       }
     );
 
@@ -238,15 +475,102 @@ export class ScannerBridge {
       };
     });
 
+    // Pipeline timings and counters of the selected device
+    ipcMain.handle(SCANNER_CHANNELS.GET_METRICS, async () => {
+      return this.mockScanner.getMetrics();
+    });
+
+    // Per-page metrics go to every window, like the native onMetrics()
+    this.mockScanner.onMetrics = (metricsEvent) => {
+      for (const contents of webContents.getAllWebContents()) {
+        contents.send(SCANNER_CHANNELS.SCAN_METRICS, metricsEvent);
+      }
+    };
+
+    // Open a device alongside the others; returns its session ID
+    ipcMain.handle(
+      SCANNER_CHANNELS.OPEN_SESSION,
+      async (_event: IpcMainInvokeEvent, deviceId: string) => {
+        return this.mockScanner.openSession(deviceId);
+      }
+    );
+
+    ipcMain.handle(
+      SCANNER_CHANNELS.CLOSE_SESSION,
+      async (_event: IpcMainInvokeEvent, sessionId: number) => {
+        return this.mockScanner.closeSession(sessionId);
+      }
+    );
+
+    ipcMain.handle(SCANNER_CHANNELS.GET_SESSIONS, async () => {
+      return this.mockScanner.getSessions();
+    });
+
+    // Per-session scanning: every open device feeds independently
+    ipcMain.handle(
+      SCANNER_CHANNELS.SESSION_SCAN,
+      async (event: IpcMainInvokeEvent, sessionId: number, settings: ScanSettings) => {
+        const session = this.mockScanner.getSession(sessionId);
+        if (!session) {
+          return { success: false, error: 'Unknown scan session' };
+        }
+        return this.mockScanner.scan(settings, (progress) => {
+          event.sender.send(SCANNER_CHANNELS.SCAN_PROGRESS, { sessionId, progress });
+        }, session);
+      }
+    );
+
+    ipcMain.handle(
+      SCANNER_CHANNELS.SESSION_BATCH_SCAN,
+      async (
+        event: IpcMainInvokeEvent,
+        sessionId: number,
+        settings: ScanSettings,
+        pageCount: number
+      ) => {
+        const session = this.mockScanner.getSession(sessionId);
+        if (!session) {
+          return { success: false, pageCount: 0, pages: [], error: 'Unknown scan session' };
+        }
+        return this.mockScanner.scanBatch(settings, pageCount, (_page, index) => {
+          event.sender.send(SCANNER_CHANNELS.SCAN_PROGRESS, {
+            sessionId,
+            current: index + 1,
+            total: pageCount,
+          });
+        }, session);
+      }
+    );
+
+    ipcMain.handle(
+      SCANNER_CHANNELS.SESSION_CANCEL_SCAN,
+      async (_event: IpcMainInvokeEvent, sessionId: number) => {
+        await this.mockScanner.cancelScan(this.mockScanner.getSession(sessionId));
+      }
+    );
+
+    ipcMain.handle(
+      SCANNER_CHANNELS.SESSION_GET_SCAN_STATUS,
+      async (_event: IpcMainInvokeEvent, sessionId: number) => {
+        return {
+          isScanning: this.mockScanner.isScanInProgress(this.mockScanner.getSession(sessionId)),
+        };
+      }
+    );
+
+    ipcMain.handle(
+      SCANNER_CHANNELS.SESSION_GET_METRICS,
+      async (_event: IpcMainInvokeEvent, sessionId: number) => {
+        const session = this.mockScanner.getSession(sessionId);
+        return session ? this.mockScanner.getMetrics(session) : null;
+      }
+    );
+
     // Preview scan (low-res quick scan)
     ipcMain.handle(
       SCANNER_CHANNELS.PREVIEW_SCAN,
-      async () => {
-        return this.mockScanner.scan({
-          resolution: 75,
-          colorMode: 'color',
-          paperSize: 'auto',
-        });
+      async (_event: IpcMainInvokeEvent, settings?: Partial<ScanSettings>) => {
+        return this.mockScanner.preview(settings);
       }
     );
 
@@ -262,6 +586,7 @@ export class ScannerBridge {
     Object.values(SCANNER_CHANNELS).forEach((channel) => {
       ipcMain.removeHandler(channel);
     });
+    this.mockScanner.onMetrics = null;
 
     this.initialized = false;
   }
@@ -0,0 +1,449 @@
+/**
+ * Scanner Core Band Stream Implementation
+ */
+
+#include "bandStream.h"
+#include "bitonalSink.h"
+#include "imageEncoder.h"
+#include "jpegEncoder.h"
+#include "thumbnailPyramid.h"
+#include <algorithm>
+#include <cstring>
+
+namespace ScannerCore {
+
+namespace {
+
+std::shared_ptr<PixelBuffer> AllocateBuffer(const std::shared_ptr<BufferPool>& pool, size_t size) {
+    return pool ? pool->Acquire(size) : std::make_shared<PixelBuffer>(size);
+}
+
+} // namespace
+
+BandWriter::BandWriter(BandSink& sink, int bandRows, std::shared_ptr<BufferPool> pool, ScanMetrics* metrics)
+    : sink_(sink),
+      bandRows_(std::max(1, bandRows)),
+      pool_(std::move(pool)),
+      pageIndex_(-1),
+      bandCount_(0),
+      geometry_{},
+      bandFill_(0),
+      nextRow_(0),
+      pageOpen_(false),
+      metrics_(metrics),
+      cancel_(nullptr),
+      markNs_(metrics ? ScanMetrics::Now() : 0),
+      pageStartNs_(0),
+      sinkNs_(0) {}
+
+template <typename Call>
+bool BandWriter::TimedSinkCall(Call&& call) {
+    if (!metrics_) {
+        return call();
+    }
+    const uint64_t start = ScanMetrics::Now();
+    bool result = call();
+    sinkNs_ += ScanMetrics::Now() - start;
+    return result;
+}
+
+bool BandWriter::BeginPage(const PageGeometry& geometry) {
+    nextRow_ = 0;
+    bandFill_ = 0;
+    band_.reset();
+    held_.reset();
+    pageOpen_ = false;
+    if (geometry.encoding == ImageEncoding::Raw &&
+        (geometry.width <= 0 || geometry.height < 0 || geometry.stride < MinStride(geometry.pixelFormat, geometry.width))) {
+        return false;
+    }
+
+    geometry_ = geometry;
+    pageIndex_++;
+    pageOpen_ = true;
+
+    if (metrics_) {
+        pageStartNs_ = ScanMetrics::Now();
+        sinkNs_ = 0;
+        metrics_->Record(MetricStage::DeviceSetup, pageStartNs_ - markNs_, pageIndex_);
+    }
+    TimedSinkCall([this]() {
+        sink_.BeginPage(pageIndex_, geometry_);
+        return true;
+    });
+    return true;
+}
+
+bool BandWriter::Write(const uint8_t* data, size_t size) {
+    if (!pageOpen_ || Cancelled()) {
+        return false;
+    }
+    const size_t bandBytes = static_cast<size_t>(bandRows_) * geometry_.stride;
+    if (metrics_) {
+        metrics_->AddTransferred(size, pageIndex_);
+    }
+    if (geometry_.encoding != ImageEncoding::Raw) {
+        AppendEncoded(data, size);
+        return true;
+    }
+
+    while (size > 0) {
+        if (!band_) {
+            band_ = AllocateBuffer(pool_, bandBytes);
+            bandFill_ = 0;
+        }
+
+        size_t chunk = std::min(size, bandBytes - bandFill_);
+        std::memcpy(band_->Data() + bandFill_, data, chunk);
+        bandFill_ += chunk;
+        data += chunk;
+        size -= chunk;
+
+        if (bandFill_ == bandBytes) {
+            if (Cancelled() || !FlushHeld(false)) {
+                return false;
+            }
+            if (geometry_.height > 0 && nextRow_ + bandRows_ >= geometry_.height) {
+                if (!FlushBand(true)) {
+                    return false;
+                }
+            } else {
+                // The page length may be unknown, or the device may end the
+                // page early, so only EndPage() can tell that a band short
+                // of the page height is the last; each waits for the next
+                held_ = std::move(band_);
+                bandFill_ = 0;
+            }
+        }
+    }
+
+    return true;
+}
+
+bool BandWriter::EndPage() {
+    if (!pageOpen_) {
+        return true;
+    }
+    if (Cancelled()) {
+        // The partial page never reaches the sink; its bands go back to the pool
+        pageOpen_ = false;
+        band_.reset();
+        held_.reset();
+        return false;
+    }
+
+    bool keepGoing = true;
+    if (geometry_.encoding != ImageEncoding::Raw) {
+        if (band_ && bandFill_ > 0) {
+            keepGoing = FlushEncoded();
+        }
+    } else {
+        const bool partial = band_ && bandFill_ >= static_cast<size_t>(geometry_.stride);
+        keepGoing = FlushHeld(!partial);
+        if (keepGoing && partial) {
+            keepGoing = FlushBand(true);
+        }
+    }
+
+    pageOpen_ = false;
+    band_.reset();
+    held_.reset();
+
+    // Transfer time is taken before EndPage() so that waiting for memory
+    // to free up counts as queue wait, not as USB time
+    if (metrics_) {
+        metrics_->Record(MetricStage::Transfer, ScanMetrics::Now() - pageStartNs_ - sinkNs_, pageIndex_);
+    }
+    bool more = sink_.EndPage(pageIndex_);
+    if (metrics_) {
+        markNs_ = ScanMetrics::Now();
+    }
+    return more && keepGoing;
+}
+
+bool BandWriter::FlushBand(bool lastBand) {
+    const size_t bytes = bandFill_;
+    bandFill_ = 0;
+    return EmitBand(std::move(band_), bytes, lastBand);
+}
+
+bool BandWriter::FlushHeld(bool lastBand) {
+    if (!held_) {
+        return true;
+    }
+    return EmitBand(std::move(held_), static_cast<size_t>(bandRows_) * geometry_.stride, lastBand);
+}
+
+bool BandWriter::EmitBand(std::shared_ptr<PixelBuffer> pixels, size_t bytes, bool lastBand) {
+    // Only whole scanlines are emitted; a trailing partial row is dropped
+    ScanBand band;
+    band.pixels = std::move(pixels);
+    band.pageIndex = pageIndex_;
+    band.firstRow = nextRow_;
+    band.rows = static_cast<int>(bytes / geometry_.stride);
+    band.lastBand = lastBand;
+    band.geometry = geometry_;
+
+    nextRow_ += band.rows;
+    bandCount_++;
+
+    return TimedSinkCall([this, &band]() { return sink_.OnBand(band); });
+}
+
+void BandWriter::AppendEncoded(const uint8_t* data, size_t size) {
+    // A compressed stream has no scanlines to cut at, so it is collected
+    // whole; the first guess is one raw band
+    if (!band_ || bandFill_ + size > band_->Size()) {
+        const size_t guess = static_cast<size_t>(bandRows_) * geometry_.stride;
+        const size_t grownSize = std::max({guess, bandFill_ + size, band_ ? band_->Size() * 2 : 0});
+        auto grown = AllocateBuffer(pool_, grownSize);
+        if (band_) {
+            std::memcpy(grown->Data(), band_->Data(), bandFill_);
+        }
+        band_ = std::move(grown);
+    }
+    std::memcpy(band_->Data() + bandFill_, data, size);
+    bandFill_ += size;
+}
+
+bool BandWriter::FlushEncoded() {
+    band_->Truncate(bandFill_);
+
+    ScanBand band;
+    band.pixels = std::move(band_);
+    band.pageIndex = pageIndex_;
+    band.firstRow = 0;
+    band.rows = geometry_.height;
+    band.lastBand = true;
+    band.geometry = geometry_;
+
+    nextRow_ = geometry_.height;
+    bandFill_ = 0;
+    bandCount_++;
+
+    return TimedSinkCall([this, &band]() { return sink_.OnBand(band); });
+}
+
+PageAssembler::PageAssembler() : encoding_(ImageEncoding::Raw), jpegQuality_(0) {}
+
+PageAssembler::PageAssembler(const ScanSettings& settings, std::shared_ptr<BufferPool> pool)
+    : encoding_(EncodingForSettings(settings)),
+      jpegQuality_(settings.jpegQuality),
+      pool_(std::move(pool)) {
+    if (settings.thumbnailLevels > 0) {
+        thumbnails_ = std::make_unique<ThumbnailPyramid>(settings.thumbnailLevels);
+    }
+}
+
+PageAssembler::~PageAssembler() = default;
+
+void PageAssembler::BeginPage(int pageIndex, const PageGeometry& geometry) {
+    geometry_ = geometry;
+    pageIndex_ = pageIndex;
+    rows_ = 0;
+    fill_ = 0;
+    error_.clear();
+    if (thumbnails_) {
+        thumbnails_->BeginPage(geometry);
+    }
+
+    // Compressed by the device; the stream is kept as delivered
+    if (geometry.encoding != ImageEncoding::Raw) {
+        page_.reset();
+        return;
+    }
+
+    if (!encoder_) {
+        encoder_ = CreatePageEncoder(encoding_, jpegQuality_);
+    }
+    if (encoder_) {
+        page_.reset();
+        if (!encoder_->Begin(geometry, error_)) {
+            encoder_.reset();
+        }
+        return;
+    }
+
+    // Height may be unknown up front; grow on demand in that case
+    size_t expected = static_cast<size_t>(std::max(geometry.height, 1)) * geometry.stride;
+    page_ = AllocateBuffer(pool_, expected);
+}
+
+bool PageAssembler::OnBand(const ScanBand& band) {
+    if (!error_.empty()) {
+        return false;
+    }
+
+    if (geometry_.encoding != ImageEncoding::Raw) {
+        StageTimer timer(metrics_, MetricStage::Assemble, pageIndex_);
+        page_ = band.pixels;
+        fill_ = page_->Size();
+        rows_ = band.rows;
+        return true;
+    }
+
+    if (thumbnails_) {
+        StageTimer timer(metrics_, MetricStage::Assemble, pageIndex_);
+        thumbnails_->OnBand(band);
+    }
+
+    if (encoder_) {
+        StageTimer timer(metrics_, MetricStage::Encode, pageIndex_);
+        rows_ += band.rows;
+        return encoder_->WriteRows(band.pixels->Data(), band.rows, error_);
+    }
+
+    StageTimer timer(metrics_, MetricStage::Assemble, pageIndex_);
+    size_t bytes = static_cast<size_t>(band.rows) * geometry_.stride;
+
+    if (fill_ + bytes > page_->Size()) {
+        auto grown = AllocateBuffer(pool_, std::max(page_->Size() * 2, fill_ + bytes));
+        std::memcpy(grown->Data(), page_->Data(), fill_);
+        page_ = std::move(grown);
+    }
+
+    std::memcpy(page_->Data() + fill_, band.pixels->Data(), bytes);
+    fill_ += bytes;
+    rows_ += band.rows;
+
+    return true;
+}
+
+ScanResult PageAssembler::TakeResult(const ScanSettings& settings) {
+    ScanResult result{};
+
+    if (!error_.empty()) {
+        result.success = false;
+        result.errorMessage = error_;
+        return result;
+    }
+
+    if (geometry_.encoding != ImageEncoding::Raw) {
+        return TakeDeviceEncoded(settings);
+    }
+
+    if (encoder_) {
+        StageTimer timer(metrics_, MetricStage::Encode, pageIndex_);
+        if (!encoder_->Finish(rows_, error_)) {
+            result.success = false;
+            result.errorMessage = error_;
+            encoder_.reset();
+            return result;
+        }
+
+        result.success = true;
+        result.encoding = encoding_;
+        result.encoded = encoder_->TakeOutput();
+        if (metrics_ && result.encoded) {
+            metrics_->AddEncoded(result.encoded->Size());
+        }
+        result.width = geometry_.width;
+        result.height = encoder_->EncodedHeight();
+        result.stride = geometry_.stride;
+        result.pixelFormat = geometry_.pixelFormat;
+        result.resolution = geometry_.resolution > 0 ? geometry_.resolution : settings.resolution;
+        result.colorMode = settings.colorMode;
+        result.scanArea = settings.scanArea;
+        if (thumbnails_) {
+            result.thumbnails = thumbnails_->Take();
+        }
+        return result;
+    }
+
+    if (!page_ || rows_ == 0) {
+        result.success = false;
+        result.errorMessage = "Driver returned no image data";
+        return result;
+    }
+
+    // Short pages (ADF length detection) keep their allocation, just trimmed
+    page_->Truncate(fill_);
+
+    result.success = true;
+    result.pixels = std::move(page_);
+    result.width = geometry_.width;
+    result.height = rows_;
+    result.stride = geometry_.stride;
+    result.pixelFormat = geometry_.pixelFormat;
+    result.resolution = geometry_.resolution > 0 ? geometry_.resolution : settings.resolution;
+    result.colorMode = settings.colorMode;
+    result.scanArea = settings.scanArea;
+    if (thumbnails_) {
+        result.thumbnails = thumbnails_->Take();
+    }
+
+    return result;
+}
+
+ScanResult PageAssembler::TakeDeviceEncoded(const ScanSettings& settings) {
+    ScanResult result{};
+    result.success = false;
+    if (!page_ || fill_ == 0) {
+        result.errorMessage = "Driver returned no image data";
+        return result;
+    }
+
+    int width = geometry_.width;
+    int height = geometry_.height;
+    PixelFormat format = geometry_.pixelFormat;
+    if (geometry_.encoding == ImageEncoding::Jpeg) {
+        // The frame header is authoritative: ADF length detection leaves
+        // the height open and some devices send gray JPEG for color scans
+        int components = 0;
+        if (!ReadJpegFrame(page_->Data(), page_->Size(), width, height, components) ||
+            (components != 1 && components != 3)) {
+            result.errorMessage = "Device returned an unsupported JPEG stream";
+            return result;
+        }
+        format = components == 1 ? PixelFormat::Gray8 : PixelFormat::Rgb24;
+    } else if (height <= 0) {
+        // G4 has no header; the PDF needs /Rows up front
+        result.errorMessage = "Device did not report the page height";
+        return result;
+    }
+
+    if (metrics_) {
+        metrics_->AddEncoded(page_->Size());
+    }
+    result.success = true;
+    result.encoding = geometry_.encoding;
+    result.encoded = std::move(page_);
+    result.width = width;
+    result.height = height;
+    result.stride = MinStride(format, width);
+    result.pixelFormat = format;
+    result.resolution = geometry_.resolution > 0 ? geometry_.resolution : settings.resolution;
+    result.colorMode = settings.colorMode;
+    result.scanArea = settings.scanArea;
+    return result;
+}
+
+ScanResult AcquireFullPage(const BandAcquireFn& acquire,
+                           const ScanSettings& settings,
+                           const std::shared_ptr<BufferPool>& pool,
+                           ScanMetrics* metrics,
+                           CancelToken* cancel) {
+    PageAssembler page(settings, pool);
+    page.SetMetrics(metrics);
+    BitonalSink bitonal(page, settings, pool);
+    bitonal.SetMetrics(metrics);
+    BandWriter writer(bitonal, kDefaultBandRows, pool, metrics);
+    writer.SetCancelToken(cancel);
+    std::string error;
+
+    const bool acquired = acquire(AcquisitionSettings(settings), 1, writer, error);
+    if (!acquired || writer.Cancelled()) {
+        ScanResult result{};
+        result.success = false;
+        // An encoder failure is the real cause when it stopped the driver
+        result.errorMessage = writer.Cancelled()        ? kScanCancelledMessage
+                              : !page.Error().empty() ? page.Error()
+                              : error.empty()         ? "Scan failed"
+                                                      : error;
+        return result;
+    }
+
+    return page.TakeResult(settings);
+}
+
+} // namespace ScannerCore
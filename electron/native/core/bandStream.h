@@ -0,0 +1,214 @@
+/**
+ * Scanner Core Band Stream
+ *
+ * Drivers deliver pixels in whatever chunk size the transport uses
+ * (sane_read blocks, TWAIN memory strips). BandWriter re-chunks that
+ * data into fixed-height scanline bands and hands them to a BandSink,
+ * so downstream stages can start before the page has finished.
+ */
+
+#ifndef SCANNER_CORE_BAND_STREAM_H
+#define SCANNER_CORE_BAND_STREAM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include "bufferPool.h"
+#include "cancelToken.h"
+#include "scanMetrics.h"
+#include "scanTypes.h"
+
+namespace ScannerCore {
+
+class PageEncoder;
+class ThumbnailPyramid;
+
+/**
+ * Default band height in scanlines
+ */
+constexpr int kDefaultBandRows = 256;
+
+/**
+ * Error reported by an acquisition stopped through its CancelToken
+ */
+constexpr const char* kScanCancelledMessage = "Scan cancelled";
+
+/**
+ * Geometry of the page a driver is about to transfer
+ */
+struct PageGeometry {
+    int width;
+    int height;      // 0 if the driver cannot tell in advance (ADF length detection)
+    int stride;      // bytes per scanline as delivered by the driver
+    PixelFormat pixelFormat;
+    int resolution;
+    // Set when the device compressed the page itself: Write() then takes
+    // the encoded stream, which reaches the sink as one band
+    ImageEncoding encoding = ImageEncoding::Raw;
+};
+
+/**
+ * A run of consecutive scanlines from one page
+ */
+struct ScanBand {
+    std::shared_ptr<PixelBuffer> pixels;
+    int pageIndex;
+    int firstRow;
+    int rows;
+    bool lastBand;
+    PageGeometry geometry;
+};
+
+/**
+ * Consumer of bands. Called on the acquisition thread.
+ */
+class BandSink {
+public:
+    virtual ~BandSink() = default;
+
+    virtual void BeginPage(int /*pageIndex*/, const PageGeometry& /*geometry*/) {}
+
+    // Return false to ask the driver to stop the transfer
+    virtual bool OnBand(const ScanBand& band) = 0;
+
+    // Return false to stop the feeder after this page
+    virtual bool EndPage(int /*pageIndex*/) { return true; }
+};
+
+/**
+ * Re-chunks arbitrarily sized driver reads into fixed-height bands
+ */
+class BandWriter {
+public:
+    // With metrics, records device setup and transfer time per page;
+    // time spent in the sink is left to the stages behind it
+    explicit BandWriter(BandSink& sink,
+                        int bandRows = kDefaultBandRows,
+                        std::shared_ptr<BufferPool> pool = nullptr,
+                        ScanMetrics* metrics = nullptr);
+
+    // Open the next page; false (and nothing reaches the sink) when a
+    // raw page has no width or a stride shorter than its rows
+    bool BeginPage(const PageGeometry& geometry);
+
+    // Append raw scanline bytes, or the next part of the stream for a page
+    // the device encodes; returns false if the sink stopped the transfer
+    bool Write(const uint8_t* data, size_t size);
+
+    // Flush the partial last band; returns false if the sink stopped the
+    // transfer or wants no further pages
+    bool EndPage();
+
+    int PageCount() const { return pageIndex_ + 1; }
+    int BandCount() const { return bandCount_; }
+
+    // Once the token is set, Write() and EndPage() return false at the
+    // next strip or band and the open page is discarded. Drivers register
+    // their abort call on Token() so a blocking read returns as well.
+    void SetCancelToken(CancelToken* token) { cancel_ = token; }
+    CancelToken* Token() const { return cancel_; }
+    bool Cancelled() const { return cancel_ && cancel_->IsCancelled(); }
+
+private:
+    bool FlushBand(bool lastBand);
+    bool FlushHeld(bool lastBand);
+    bool EmitBand(std::shared_ptr<PixelBuffer> pixels, size_t bytes, bool lastBand);
+    void AppendEncoded(const uint8_t* data, size_t size);
+    bool FlushEncoded();
+
+    // Sink call, timed into sinkNs_ when metrics are on
+    template <typename Call>
+    bool TimedSinkCall(Call&& call);
+
+    BandSink& sink_;
+    int bandRows_;
+    std::shared_ptr<BufferPool> pool_;
+    int pageIndex_;
+    int bandCount_;
+    PageGeometry geometry_;
+    std::shared_ptr<PixelBuffer> band_;
+    // Latest full band short of the page height, kept until it is known
+    // whether more rows follow
+    std::shared_ptr<PixelBuffer> held_;
+    size_t bandFill_;
+    int nextRow_;
+    bool pageOpen_;
+    ScanMetrics* metrics_;
+    CancelToken* cancel_;
+    uint64_t markNs_;       // acquisition start or last EndPage()
+    uint64_t pageStartNs_;
+    uint64_t sinkNs_;       // this page's time inside the sink
+};
+
+/**
+ * Driver acquisition entry point. Runs on the acquisition thread, must
+ * not touch any N-API value, and reports failures through error.
+ *
+ * Drivers keep the data source enabled for up to maxPages sheets
+ * (0 = until the feeder is empty) and stop early when
+ * BandWriter::Write() or EndPage() returns false. A driver whose reads
+ * can block registers its abort call with CancelHook on writer.Token().
+ */
+using BandAcquireFn = std::function<bool(const ScanSettings& settings,
+                                         int maxPages,
+                                         BandWriter& writer,
+                                         std::string& error)>;
+
+/**
+ * Sink that stitches bands back into a single full-page ScanResult.
+ * When the settings ask for compression, bands are encoded as they
+ * arrive and only the encoded page is kept. Pages the device encoded
+ * itself are kept as delivered. With settings.thumbnailLevels, the
+ * result also carries a thumbnail pyramid built from the same bands.
+ */
+class PageAssembler : public BandSink {
+public:
+    PageAssembler();
+    explicit PageAssembler(const ScanSettings& settings, std::shared_ptr<BufferPool> pool = nullptr);
+    ~PageAssembler() override;
+
+    void BeginPage(int pageIndex, const PageGeometry& geometry) override;
+    bool OnBand(const ScanBand& band) override;
+
+    ScanResult TakeResult(const ScanSettings& settings);
+
+    // Record assemble and encode time under the current page index
+    void SetMetrics(ScanMetrics* metrics) { metrics_ = metrics; }
+
+    // Encoder failure that stopped the transfer, if any
+    const std::string& Error() const { return error_; }
+
+private:
+    ScanResult TakeDeviceEncoded(const ScanSettings& settings);
+
+    ImageEncoding encoding_;
+    int jpegQuality_;
+    std::shared_ptr<BufferPool> pool_;
+    // Kept across pages of a batch so its scratch memory is reused
+    std::unique_ptr<PageEncoder> encoder_;
+    std::unique_ptr<ThumbnailPyramid> thumbnails_;
+    std::string error_;
+    PageGeometry geometry_{};
+    std::shared_ptr<PixelBuffer> page_;
+    size_t fill_ = 0;
+    int rows_ = 0;
+    int pageIndex_ = 0;
+    ScanMetrics* metrics_ = nullptr;
+};
+
+/**
+ * Run a band acquisition to completion and return the assembled page.
+ * Band and page buffers come from pool when one is given; a set cancel
+ * token fails the scan with kScanCancelledMessage.
+ */
+ScanResult AcquireFullPage(const BandAcquireFn& acquire,
+                           const ScanSettings& settings,
+                           const std::shared_ptr<BufferPool>& pool = nullptr,
+                           ScanMetrics* metrics = nullptr,
+                           CancelToken* cancel = nullptr);
+
+} // namespace ScannerCore
+
+#endif // SCANNER_CORE_BAND_STREAM_H
@@ -0,0 +1,682 @@
+/**
+ * Scanner Core Batch Worker Implementation
+ */
+
+#include "batchWorker.h"
+#include "bitonalSink.h"
+#include "blankPage.h"
+#include "imageEncoder.h"
+#include "napiConvert.h"
+#include "pageQueue.h"
+#include "separatorSheet.h"
+#include "spoolFile.h"
+#include "threadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace ScannerCore {
+
+namespace {
+
+/**
+ * Thumbnail levels of one acquired page, awaiting delivery
+ */
+struct PendingThumbnails {
+    int pageIndex;
+    std::vector<PageThumbnail> levels;
+};
+
+/**
+ * One document of a batch split by separator sheets
+ */
+struct BatchDocument {
+    int firstPage = -1;       // acquisition index of its first page
+    int pageCount = 0;
+    std::string pdfPath;
+    uint64_t pdfBytes = 0;
+    SeparatorMark separator;  // sheet that opened it, if any
+};
+
+/**
+ * State owned by one batch acquisition. Deleted by the TSFN finalizer
+ * once every queued page has been delivered.
+ */
+struct BatchContext {
+    BatchContext(Napi::Env env, size_t highWaterMark)
+        : deferred(Napi::Promise::Deferred::New(env)), queue(highWaterMark) {}
+
+    Napi::Promise::Deferred deferred;
+    Napi::ThreadSafeFunction tsfn;
+    Napi::FunctionReference onPage;
+    Napi::FunctionReference onThumbnails;
+    bool deliverThumbnails = false;  // onThumbnails given and thumbnails requested
+    std::thread thread;
+    ScanSettings settings;
+    ScanSettings finishSettings;  // settings without thumbnails, for FinishPage()
+    int maxPages = 0;
+    BandAcquireFn acquire;
+    std::shared_ptr<ScanState> state;
+    PageQueue queue;  // also accounts the pages still being processed
+    PdfOutputOptions pdf;
+    PdfWriter pdfWriter;
+    SpoolOptions spool;
+    SpoolWriter spoolWriter;
+    int resumedPages = 0;  // pages already in a resumed spool
+
+    bool success = false;
+    bool cancelled = false;
+    std::string errorMessage;  // written by the ordered output stage
+    int pageCount = 0;         // pages delivered, output stage only
+    int failedPages = 0;       // pages whose processing failed, output stage only
+    int acquiredCount = 0;     // sheets acquired, acquisition thread only
+    int blankPages = 0;        // blank pages dropped, acquisition thread only
+    int blankBacks = 0;        // of which duplex back sides
+    int separatorPages = 0;    // separator sheet sides dropped, acquisition thread only
+
+    // settings.separation is on: each document goes to its own PDF
+    bool separating = false;
+    std::vector<BatchDocument> documents;  // output stage only
+
+    // Sent ahead of their pages; small, so not booked in the queue budget
+    std::mutex thumbnailMutex;
+    std::vector<PendingThumbnails> thumbnails;
+
+    // Post-processing: one finish task per page (parallel) feeding an
+    // output task per page chained in page order
+    Imaging::ThreadPool::TaskHandle lastOutput;
+    std::atomic<bool> failed{false};
+};
+
+/**
+ * Deliver every queued page to the JavaScript callback
+ */
+void DrainPages(Napi::Env env, Napi::Function onPage, BatchContext* context) {
+    if (env == nullptr) {
+        // Environment teardown: unblock the producer so the thread can exit
+        context->queue.Close();
+        return;
+    }
+
+    if (context->deliverThumbnails) {
+        std::vector<PendingThumbnails> ready;
+        {
+            std::lock_guard<std::mutex> lock(context->thumbnailMutex);
+            ready.swap(context->thumbnails);
+        }
+        Napi::Function onThumbnails = context->onThumbnails.Value();
+        for (const PendingThumbnails& page : ready) {
+            onThumbnails.Call({Napi::Number::New(env, page.pageIndex), ThumbnailsToArray(env, page.levels)});
+        }
+    }
+
+    ScanMetrics& metrics = context->state->metrics;
+    for (ScanResult& page : context->queue.PopAll()) {
+        const uint64_t bytes = PageBytes(page);
+        onPage.Call({ScanResultToObject(env, page)});
+        metrics.AddDelivered(bytes);
+        metrics.FinishPage(page.pageIndex);
+    }
+    metrics.SetQueue(context->queue.Size(), context->queue.BufferedBytes());
+}
+
+/**
+ * Settings the acquisition thread assembles pages with: raw pixels,
+ * leaving binarization and encoding to FinishPage() on the pool
+ */
+ScanSettings RawPageSettings(const ScanSettings& settings) {
+    ScanSettings raw = settings;
+    raw.compression = "none";
+    raw.binarize = "none";
+    return raw;
+}
+
+/**
+ * Binarize and encode an assembled raw page as the settings ask. Pages
+ * the device already compressed go on unchanged. `settings` must not
+ * ask for thumbnails; the raw page already carries them.
+ */
+ScanResult FinishPage(ScanResult raw, int pageIndex, const ScanSettings& settings,
+                      const std::shared_ptr<BufferPool>& pool, ScanMetrics* metrics) {
+    if (!raw.success || raw.encoding != ImageEncoding::Raw ||
+        (!BinarizeEnabled(settings) && EncodingForSettings(settings) == ImageEncoding::Raw)) {
+        return raw;
+    }
+
+    // Replay the page as one band through the same stages a streamed
+    // acquisition would use
+    std::vector<PageThumbnail> thumbnails = std::move(raw.thumbnails);
+    PageGeometry geometry{raw.width, raw.height, raw.stride, raw.pixelFormat, raw.resolution};
+    PageAssembler page(settings, pool);
+    BitonalSink bitonal(page, settings, pool);
+    page.SetMetrics(metrics);
+    bitonal.SetMetrics(metrics);
+    bitonal.BeginPage(pageIndex, geometry);
+    if (bitonal.OnBand(ScanBand{std::move(raw.pixels), pageIndex, 0, raw.height, true, geometry})) {
+        bitonal.EndPage(pageIndex);
+    }
+    ScanResult result = page.TakeResult(settings);
+    result.thumbnails = std::move(thumbnails);
+    return result;
+}
+
+/**
+ * PDF file of one document of a separated batch: the requested path
+ * with the 1-based document number before the extension
+ */
+std::string DocumentPdfPath(const std::string& path, int documentIndex) {
+    char suffix[16];
+    std::snprintf(suffix, sizeof(suffix), "-%03d", documentIndex + 1);
+    const size_t slash = path.find_last_of("/\\");
+    const size_t dot = path.rfind('.');
+    const size_t at = dot != std::string::npos && (slash == std::string::npos || dot > slash) ? dot : path.size();
+    return path.substr(0, at) + suffix + path.substr(at);
+}
+
+/**
+ * Make documentIndex the current document of a separated batch. A new
+ * document finishes the previous one's PDF first, so every document is
+ * complete on disk as soon as the next one starts.
+ */
+bool EnterDocument(BatchContext* context, int documentIndex, const SeparatorMark& separator) {
+    if (documentIndex < static_cast<int>(context->documents.size())) {
+        // The first document is opened before its first page arrives
+        if (separator.Found()) {
+            context->documents[documentIndex].separator = separator;
+        }
+        return true;
+    }
+
+    if (context->pdfWriter.IsOpen()) {
+        if (!context->pdfWriter.Close(context->errorMessage)) {
+            return false;
+        }
+        context->documents.back().pdfBytes = context->pdfWriter.BytesWritten();
+    }
+
+    BatchDocument document;
+    document.separator = separator;
+    if (!context->pdf.path.empty()) {
+        document.pdfPath = DocumentPdfPath(context->pdf.path, documentIndex);
+        if (!context->pdfWriter.Open(document.pdfPath, context->pdf.info, context->errorMessage)) {
+            return false;
+        }
+    }
+    context->documents.push_back(std::move(document));
+    return true;
+}
+
+/**
+ * Ordered output stage: PDF and spool append and page queue, one page
+ * at a time. `charged` is the page's reservation in the queue's byte
+ * budget; `separator` is set on the first page after a separator sheet.
+ */
+void DeliverPage(BatchContext* context, ScanResult page, size_t charged, const SeparatorMark& separator) {
+    if (context->failed || context->state->cancel.IsCancelled()) {
+        context->queue.Release(charged);
+        return;
+    }
+    if (context->separating && !EnterDocument(context, page.documentIndex, separator)) {
+        context->failed = true;
+        context->queue.Release(charged);
+        return;
+    }
+
+    ScanMetrics* metrics = &context->state->metrics;
+    const int index = page.pageIndex;
+    const int documentIndex = page.documentIndex;
+    const bool captured = page.success;
+    if (context->pdfWriter.IsOpen() && page.success) {
+        StageTimer timer(metrics, MetricStage::PdfWrite, index);
+        if (!context->pdfWriter.AddPage(page, context->errorMessage)) {
+            context->failed = true;
+            context->queue.Release(charged);
+            return;
+        }
+    }
+    if (context->spoolWriter.IsOpen() && page.success) {
+        StageTimer timer(metrics, MetricStage::Spool, index);
+        if (!context->spoolWriter.Append(page, context->errorMessage)) {
+            context->failed = true;
+            context->queue.Release(charged);
+            return;
+        }
+        page.spoolIndex = context->spoolWriter.PageCount() - 1;
+    }
+    if ((context->pdfWriter.IsOpen() || context->spoolWriter.IsOpen()) && page.success) {
+        // The page lives in the file now; JavaScript only gets its metadata
+        page.pixels.reset();
+        page.encoded.reset();
+    }
+
+    // Keep only what the page still holds (encoded, or metadata only)
+    // booked until JavaScript takes it, so the driver resumes sooner
+    const size_t keep = std::min(charged, context->queue.Charge(PageBytes(page)));
+    context->queue.Release(charged - keep);
+
+    metrics->MarkHandoff(index);
+    if (!context->queue.Push(std::move(page), keep)) {
+        context->failed = true;
+        return;
+    }
+    metrics->SetQueue(context->queue.Size(), context->queue.BufferedBytes());
+
+    // A page that failed to process still reaches onPage with its error,
+    // but it was not captured, so it is not counted as delivered
+    if (!captured) {
+        context->failedPages++;
+        context->tsfn.NonBlockingCall(context, DrainPages);
+        return;
+    }
+
+    if (context->separating) {
+        BatchDocument& document = context->documents[documentIndex];
+        if (document.firstPage < 0) {
+            document.firstPage = index;
+        }
+        document.pageCount++;
+    }
+
+    context->pageCount++;
+    context->tsfn.NonBlockingCall(context, DrainPages);
+}
+
+/**
+ * Assembles each sheet on the acquisition thread and hands it to the
+ * shared pool, so the driver moves on to the next sheet right away.
+ * Every page is booked against the queue's high-water mark first; while
+ * the mark is reached EndPage() blocks, which holds the driver before
+ * it starts the next sheet. Pages the settings allow to skip are
+ * measured as they arrive and dropped here when blank, before any
+ * further work is spent on them. Separator sheets are recognised the
+ * same way: the pages after one go to the next document, and the sheet
+ * itself is dropped unless settings.keepSeparators. Thumbnails are
+ * built from the same bands and, with an onThumbnails callback, sent to
+ * JavaScript as soon as the sheet is in, ahead of the processed page.
+ */
+class BatchPageSink : public BandSink {
+public:
+    explicit BatchPageSink(BatchContext* context)
+        : context_(context),
+          raw_(RawPageSettings(context->settings)),
+          page_(raw_, context->state->buffers),
+          separator_(context->settings) {
+        page_.SetMetrics(&context->state->metrics);
+    }
+
+    void BeginPage(int pageIndex, const PageGeometry& geometry) override {
+        page_.BeginPage(pageIndex, geometry);
+        detectSeparator_ = !separatorBack_ && SeparatorEligible(context_->settings, context_->acquiredCount);
+        if (detectSeparator_) {
+            separator_.BeginPage(geometry);
+        }
+        detectBlank_ = !separatorBack_ && BlankPageEligible(context_->settings, context_->acquiredCount);
+        if (detectBlank_) {
+            blank_.BeginPage(geometry);
+        }
+    }
+
+    bool OnBand(const ScanBand& band) override {
+        if (detectSeparator_) {
+            separator_.OnBand(band);
+        }
+        if (detectBlank_) {
+            blank_.OnBand(band);
+        }
+        return page_.OnBand(band);
+    }
+
+    bool EndPage(int /*pageIndex*/) override {
+        if (context_->failed) {
+            return false;
+        }
+
+        auto page = std::make_shared<ScanResult>(page_.TakeResult(raw_));
+        const int index = context_->acquiredCount;
+        page->pageIndex = index;
+
+        if (separatorBack_) {
+            // Back side of a dropped separator sheet
+            separatorBack_ = false;
+            context_->separatorPages++;
+            return DropPage(index);
+        }
+
+        if (detectSeparator_ && page->success) {
+            SeparatorMark mark = separator_.Finish();
+            if (mark.Found()) {
+                // Separators in a row, or before the first page, open one document
+                if (documentPages_ > 0) {
+                    document_++;
+                    documentPages_ = 0;
+                }
+                pendingSeparator_ = std::move(mark);
+                if (!context_->settings.keepSeparators) {
+                    separatorBack_ = context_->settings.duplex;
+                    context_->separatorPages++;
+                    return DropPage(index);
+                }
+            }
+        }
+
+        if (detectBlank_ && page->success) {
+            const double coverage = blank_.InkCoverage();
+            if (coverage >= 0.0 && coverage <= context_->settings.blankThreshold) {
+                context_->blankPages++;
+                context_->blankBacks += context_->settings.duplex && index % 2 == 1;
+                return DropPage(index);
+            }
+        }
+
+        if (context_->deliverThumbnails && !page->thumbnails.empty()) {
+            {
+                std::lock_guard<std::mutex> lock(context_->thumbnailMutex);
+                context_->thumbnails.push_back(PendingThumbnails{index, std::move(page->thumbnails)});
+            }
+            page->thumbnails.clear();
+            context_->tsfn.NonBlockingCall(context_, DrainPages);
+        }
+
+        size_t charged = 0;
+        {
+            StageTimer timer(&context_->state->metrics, MetricStage::QueueWait, index);
+            charged = context_->queue.Reserve(PageBytes(*page));
+        }
+        if (charged == 0) {
+            // Queue closed by environment teardown
+            return false;
+        }
+
+        const int document = context_->separating ? document_ : -1;
+        page->documentIndex = document;
+        SeparatorMark separator = std::move(pendingSeparator_);
+        pendingSeparator_ = SeparatorMark{};
+        documentPages_++;
+
+        Imaging::ThreadPool& pool = Imaging::ThreadPool::Shared();
+        BatchContext* context = context_;
+
+        auto finish = pool.Submit([context, page, index, document]() {
+            if (context->state->cancel.IsCancelled()) {
+                // Not worth finishing; the buffers go back to the pool
+                *page = ScanResult{};
+                return;
+            }
+            try {
+                *page = FinishPage(std::move(*page), index, context->finishSettings, context->state->buffers,
+                                   &context->state->metrics);
+            } catch (const std::exception& e) {
+                *page = ScanResult{};
+                page->success = false;
+                page->errorMessage = e.what();
+            }
+            page->pageIndex = index;
+            page->documentIndex = document;
+        });
+        context->lastOutput = pool.Submit([context, page, charged, separator]() {
+            DeliverPage(context, std::move(*page), charged, separator);
+        }, {finish, context->lastOutput});
+
+        context_->acquiredCount++;
+
+        // Stop the feeder once the requested page count is reached
+        return context_->maxPages <= 0 || context_->acquiredCount < context_->maxPages;
+    }
+
+private:
+    // Release a page before any further work is spent on it; its
+    // buffers go straight back to the pool
+    bool DropPage(int index) {
+        context_->state->metrics.DiscardPage(index);
+        context_->acquiredCount++;
+        return context_->maxPages <= 0 || context_->acquiredCount < context_->maxPages;
+    }
+
+    BatchContext* context_;
+    ScanSettings raw_;
+    PageAssembler page_;
+    BlankPageDetector blank_;
+    bool detectBlank_ = false;
+    SeparatorDetector separator_;
+    bool detectSeparator_ = false;
+    bool separatorBack_ = false;      // the next page is the back of a dropped separator
+    int document_ = 0;                // document the next kept page belongs to
+    int documentPages_ = 0;           // pages kept in it so far
+    SeparatorMark pendingSeparator_;  // separator that opened document_, for its first page
+};
+
+/**
+ * Open the requested outputs. A resumed spool's committed pages go into
+ * the PDF first, straight from the mapped file, so the document covers
+ * the whole job.
+ */
+bool OpenOutputs(BatchContext* context) {
+    if (!context->spool.path.empty()) {
+        if (!context->spoolWriter.Open(context->spool.path, context->spool.resume, context->errorMessage)) {
+            return false;
+        }
+        context->resumedPages = context->spoolWriter.PageCount();
+    }
+
+    if (context->pdf.path.empty()) {
+        return true;
+    }
+    if (context->separating) {
+        // The first document also takes the resumed pages
+        if (!EnterDocument(context, 0, SeparatorMark{})) {
+            return false;
+        }
+    } else if (!context->pdfWriter.Open(context->pdf.path, context->pdf.info, context->errorMessage)) {
+        return false;
+    }
+    if (context->resumedPages > 0) {
+        SpoolReader reader;
+        if (!reader.Open(context->spool.path, context->errorMessage)) {
+            return false;
+        }
+        // The writer kept only intact pages, but the data is read again here
+        if (!reader.VerifyAll(context->errorMessage)) {
+            return false;
+        }
+        for (int i = 0; i < reader.PageCount(); i++) {
+            if (!context->pdfWriter.AddImage(reader.Page(i).Image(), context->errorMessage)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void RunBatch(BatchContext* context) {
+    if (!OpenOutputs(context)) {
+        std::string ignored;
+        context->pdfWriter.Close(ignored);
+        context->success = false;
+        context->tsfn.Release();
+        return;
+    }
+
+    context->state->metrics.BeginScan();
+    context->state->buffers->ConfigureForScan(RawPageSettings(context->settings), kDefaultBandRows);
+    BatchPageSink sink(context);
+    BandWriter writer(sink, kDefaultBandRows, context->state->buffers, &context->state->metrics);
+    writer.SetCancelToken(&context->state->cancel);
+
+    // Wake the acquisition thread if it is waiting on the high-water mark
+    CancelHook wake(&context->state->cancel, [context]() { context->queue.Close(); });
+
+    std::string error;
+    try {
+        context->success = context->acquire(AcquisitionSettings(context->settings), context->maxPages, writer, error);
+    } catch (const std::exception& e) {
+        context->success = false;
+        error = e.what();
+    }
+
+    // Let the pages still being processed reach the PDF and the queue;
+    // after a cancel they are dropped instead
+    Imaging::ThreadPool::Shared().Wait(context->lastOutput);
+    if (writer.Cancelled()) {
+        context->cancelled = true;
+        error = kScanCancelledMessage;
+    }
+
+    // A PDF write failure is reported in preference to the driver's stop
+    if (context->errorMessage.empty()) {
+        context->errorMessage = error;
+    }
+
+    // Pages already delivered still count as a (partial) success, and
+    // the pages written so far still make a valid document
+    context->success = context->success || context->pageCount > 0;
+
+    std::string closeError;
+    const bool lastDocument = context->separating && context->pdfWriter.IsOpen();
+    if (!context->pdfWriter.Close(closeError) || !context->spoolWriter.Close(closeError)) {
+        context->success = false;
+        context->errorMessage = closeError;
+    }
+    if (lastDocument) {
+        context->documents.back().pdfBytes = context->pdfWriter.BytesWritten();
+    }
+
+    context->tsfn.Release();
+}
+
+void FinishBatch(Napi::Env env, void* /*data*/, BatchContext* context) {
+    context->thread.join();
+    context->state->scanning = false;
+
+    // Pick up anything queued after the last drain call
+    DrainPages(env, context->onPage.Value(), context);
+
+    Napi::Object summary = Napi::Object::New(env);
+    summary.Set("success", context->success);
+    summary.Set("pageCount", context->pageCount);
+    if (context->failedPages > 0) {
+        summary.Set("failedPages", context->failedPages);
+    }
+    if (context->cancelled) {
+        summary.Set("cancelled", true);
+    }
+    summary.Set("blankPages", context->blankPages);
+    summary.Set("blankBacks", context->blankBacks);
+    if (!context->errorMessage.empty()) {
+        summary.Set("errorMessage", context->errorMessage);
+    }
+    if (!context->pdf.path.empty() && !context->separating) {
+        summary.Set("pdfPath", context->pdf.path);
+        summary.Set("pdfBytes", static_cast<double>(context->pdfWriter.BytesWritten()));
+    }
+    if (context->separating) {
+        summary.Set("separatorPages", context->separatorPages);
+
+        // One PDF per document; pdfBytes totals them
+        uint64_t pdfBytes = 0;
+        Napi::Array documents = Napi::Array::New(env, context->documents.size());
+        for (size_t i = 0; i < context->documents.size(); i++) {
+            const BatchDocument& document = context->documents[i];
+            Napi::Object entry = Napi::Object::New(env);
+            if (document.firstPage >= 0) {
+                entry.Set("firstPage", document.firstPage);
+            }
+            entry.Set("pageCount", document.pageCount);
+            if (!document.pdfPath.empty()) {
+                entry.Set("pdfPath", document.pdfPath);
+                entry.Set("pdfBytes", static_cast<double>(document.pdfBytes));
+                pdfBytes += document.pdfBytes;
+            }
+            if (document.separator.Found()) {
+                Napi::Object separator = Napi::Object::New(env);
+                separator.Set("type", document.separator.type);
+                if (!document.separator.value.empty()) {
+                    separator.Set("value", document.separator.value);
+                }
+                entry.Set("separator", separator);
+            }
+            documents.Set(static_cast<uint32_t>(i), entry);
+        }
+        summary.Set("documents", documents);
+        if (!context->pdf.path.empty()) {
+            summary.Set("pdfBytes", static_cast<double>(pdfBytes));
+        }
+    }
+    if (!context->spool.path.empty()) {
+        summary.Set("spoolPath", context->spool.path);
+        summary.Set("resumedPages", context->resumedPages);
+        if (context->spoolWriter.CorruptPages() > 0) {
+            summary.Set("corruptPages", context->spoolWriter.CorruptPages());
+        }
+
+        // Every committed page, including those of a resumed run
+        Napi::Array handles = Napi::Array::New(env, context->spoolWriter.PageCount());
+        for (int i = 0; i < context->spoolWriter.PageCount(); i++) {
+            Napi::Object handle = Napi::Object::New(env);
+            handle.Set("spoolPath", context->spool.path);
+            handle.Set("index", i);
+            handle.Set("offset", static_cast<double>(context->spoolWriter.PageOffset(i)));
+            handles.Set(static_cast<uint32_t>(i), handle);
+        }
+        summary.Set("pageHandles", handles);
+    }
+    context->deferred.Resolve(summary);
+
+    delete context;
+}
+
+} // namespace
+
+Napi::Value QueueScanBatch(Napi::Env env,
+                           const ScanSettings& settings,
+                           int maxPages,
+                           BandAcquireFn acquire,
+                           Napi::Function onPage,
+                           const std::shared_ptr<ScanState>& state,
+                           const PdfOutputOptions& pdf,
+                           const SpoolOptions& spool,
+                           Napi::Function onThumbnails) {
+    if (state->scanning.exchange(true)) {
+        Napi::Promise::Deferred deferred = Napi::Promise::Deferred::New(env);
+        deferred.Reject(Napi::Error::New(env, "Scan already in progress").Value());
+        return deferred.Promise();
+    }
+    state->cancel.Reset();
+
+    BatchContext* context = new BatchContext(env, settings.highWaterMark);
+    context->settings = settings;
+    context->maxPages = maxPages;
+    context->acquire = std::move(acquire);
+    context->state = state;
+    context->onPage = Napi::Persistent(onPage);
+    context->pdf = pdf;
+    context->spool = spool;
+    SeparationMode separation = SeparationMode::Off;
+    context->separating = ParseSeparationMode(settings.separation, separation) && separation != SeparationMode::Off;
+
+    // Raw pages would make an uncompressed PDF or spool
+    if ((!pdf.path.empty() || !spool.path.empty()) && context->settings.compression == "none") {
+        context->settings.compression = "auto";
+    }
+    context->finishSettings = context->settings;
+    context->finishSettings.thumbnailLevels = 0;
+    if (!onThumbnails.IsEmpty() && settings.thumbnailLevels > 0) {
+        context->onThumbnails = Napi::Persistent(onThumbnails);
+        context->deliverThumbnails = true;
+    }
+
+    // The page queue's byte budget bounds memory, so the drain
+    // notifications need no limit
+    context->tsfn = Napi::ThreadSafeFunction::New(
+        env, onPage, "ScannerScanBatch", 0, 1, context, FinishBatch, (void*)nullptr);
+
+    Napi::Promise promise = context->deferred.Promise();
+    context->thread = std::thread(RunBatch, context);
+
+    return promise;
+}
+
+} // namespace ScannerCore
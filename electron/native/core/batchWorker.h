@@ -0,0 +1,67 @@
+/**
+ * Scanner Core Batch Worker
+ *
+ * Runs a whole ADF stack in one driver session: the data source stays
+ * enabled across sheets and finished pages go into a PageQueue, bounded
+ * by a byte high-water mark, that the JavaScript thread drains. The
+ * feeder keeps running at its rated speed instead of waiting on an IPC
+ * round trip per page.
+ */
+
+#ifndef SCANNER_CORE_BATCH_WORKER_H
+#define SCANNER_CORE_BATCH_WORKER_H
+
+#include <napi.h>
+#include <memory>
+#include "bandStream.h"
+#include "pdfWriter.h"
+#include "scanWorker.h"
+#include "spoolFile.h"
+
+namespace ScannerCore {
+
+/**
+ * Start a batch acquisition of up to maxPages pages (0 = until the
+ * feeder is empty). onPage is called on the JavaScript thread with each
+ * page; the returned Promise resolves with a
+ * { success, pageCount, errorMessage? } summary after the last page.
+ * cancelScan() stops the feeder at the next strip: pages still being
+ * processed are dropped, pages already queued are delivered, and the
+ * summary adds `cancelled: true`.
+ *
+ * Pages are binarized and encoded on the shared imaging pool while the
+ * driver feeds the next sheet, and delivered in order. With a PDF output
+ * path, every page is appended to that file as soon as it is complete;
+ * onPage then receives page metadata only and the summary adds
+ * { pdfPath, pdfBytes }.
+ *
+ * With a spool path, every page is also committed to a page spool
+ * (spoolFile.h); onPage gets metadata with a spoolIndex and the summary
+ * adds { spoolPath, resumedPages, pageHandles }. With `resume`, the
+ * committed pages of an interrupted run are kept (and written to the
+ * PDF first) and new pages are appended after them.
+ *
+ * With settings.thumbnailLevels, each page carries a thumbnail pyramid.
+ * Given onThumbnails, the levels are instead passed to
+ * onThumbnails(pageIndex, thumbnails) as soon as the sheet has been
+ * acquired, before its page reaches onPage.
+ *
+ * With settings.separation, separator sheets (separatorSheet.h) split
+ * the stack into documents: each page carries its documentIndex, each
+ * document gets its own PDF next to the requested path ("scan-001.pdf",
+ * "scan-002.pdf", ...) and the summary adds { separatorPages,
+ * documents } in place of pdfPath.
+ */
+Napi::Value QueueScanBatch(Napi::Env env,
+                           const ScanSettings& settings,
+                           int maxPages,
+                           BandAcquireFn acquire,
+                           Napi::Function onPage,
+                           const std::shared_ptr<ScanState>& state,
+                           const PdfOutputOptions& pdf = {},
+                           const SpoolOptions& spool = {},
+                           Napi::Function onThumbnails = Napi::Function());
+
+} // namespace ScannerCore
+
+#endif // SCANNER_CORE_BATCH_WORKER_H
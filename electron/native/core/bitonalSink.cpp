@@ -0,0 +1,107 @@
+/**
+ * Scanner Core Bitonal Sink Implementation
+ */
+
+#include "bitonalSink.h"
+#include <algorithm>
+#include <cstring>
+
+namespace ScannerCore {
+
+bool BinarizeEnabled(const ScanSettings& settings) {
+    Imaging::ThresholdMethod method;
+    return Imaging::ParseThresholdMethod(settings.binarize, method);
+}
+
+ScanSettings AcquisitionSettings(const ScanSettings& settings) {
+    ScanSettings driver = settings;
+    if (BinarizeEnabled(settings) && driver.colorMode == "blackwhite") {
+        driver.colorMode = "grayscale";
+    }
+    return driver;
+}
+
+BitonalSink::BitonalSink(BandSink& next,
+                         const ScanSettings& settings,
+                         std::shared_ptr<BufferPool> pool,
+                         int bandRows)
+    : next_(next),
+      enabled_(Imaging::ParseThresholdMethod(settings.binarize, options_.method)),
+      pool_(std::move(pool)),
+      bandRows_(std::max(1, bandRows)) {
+    options_.threshold = settings.binarizeThreshold;
+    options_.resolution = settings.resolution;
+}
+
+void BitonalSink::BeginPage(int pageIndex, const PageGeometry& geometry) {
+    in_ = geometry;
+    passthrough_ = !enabled_ || geometry.pixelFormat == PixelFormat::BlackWhite1 ||
+                   geometry.encoding != ImageEncoding::Raw;
+    if (passthrough_) {
+        next_.BeginPage(pageIndex, geometry);
+        return;
+    }
+
+    gray_.width = geometry.width;
+    gray_.height = 0;
+    gray_.data.clear();
+    gray_.data.reserve(static_cast<size_t>(std::max(geometry.height, 1)) * geometry.width);
+    rows_.BeginPage(geometry.pixelFormat, geometry.width);
+}
+
+bool BitonalSink::OnBand(const ScanBand& band) {
+    if (passthrough_) {
+        return next_.OnBand(band);
+    }
+
+    StageTimer timer(metrics_, MetricStage::Binarize, band.pageIndex);
+    const int channels = Channels(in_.pixelFormat);
+    gray_.data.resize(static_cast<size_t>(gray_.height + band.rows) * gray_.width);
+
+    for (int r = 0; r < band.rows; r++) {
+        const uint8_t* src = rows_.Convert(band.pixels->Data() + static_cast<size_t>(r) * in_.stride);
+        Imaging::ToGrayRow(src, gray_.width, channels, gray_.Row(gray_.height));
+        gray_.height++;
+    }
+    return true;
+}
+
+bool BitonalSink::EndPage(int pageIndex) {
+    if (passthrough_) {
+        return next_.EndPage(pageIndex);
+    }
+
+    PageGeometry out{in_.width, gray_.height, (in_.width + 7) / 8, PixelFormat::BlackWhite1, in_.resolution};
+    if (out.resolution > 0) {
+        options_.resolution = out.resolution;
+    }
+    next_.BeginPage(pageIndex, out);
+
+    if (gray_.height > 0) {
+        Imaging::BitonalImage bitonal;
+        {
+            StageTimer timer(metrics_, MetricStage::Binarize, pageIndex);
+            bitonal = Imaging::Binarize(gray_, options_);
+        }
+
+        for (int row = 0; row < bitonal.height; row += bandRows_) {
+            ScanBand band;
+            band.rows = std::min(bandRows_, bitonal.height - row);
+            const size_t bytes = static_cast<size_t>(band.rows) * bitonal.stride;
+            band.pixels = pool_ ? pool_->Acquire(bytes) : std::make_shared<PixelBuffer>(bytes);
+            std::memcpy(band.pixels->Data(), bitonal.data.data() + static_cast<size_t>(row) * bitonal.stride, bytes);
+            band.pageIndex = pageIndex;
+            band.firstRow = row;
+            band.lastBand = row + band.rows >= bitonal.height;
+            band.geometry = out;
+
+            if (!next_.OnBand(band)) {
+                return false;
+            }
+        }
+    }
+
+    return next_.EndPage(pageIndex);
+}
+
+} // namespace ScannerCore
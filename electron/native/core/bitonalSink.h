@@ -0,0 +1,72 @@
+/**
+ * Scanner Core Bitonal Sink
+ *
+ * Post-acquisition binarization stage. When a scan asks for native
+ * thresholding the driver is asked for gray instead of its own 1-bit
+ * mode, each band is converted to gray as it arrives, and at the end of
+ * the page the imaging kernels threshold it and the packed BlackWhite1
+ * page is forwarded to the next sink (typically a PageAssembler that
+ * encodes it as CCITT G4). Bitonal pages never reach a canvas.
+ */
+
+#ifndef SCANNER_CORE_BITONAL_SINK_H
+#define SCANNER_CORE_BITONAL_SINK_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "bandStream.h"
+#include "binarize.h"
+#include "pixelKernels.h"
+
+namespace ScannerCore {
+
+/**
+ * True when settings ask for native thresholding
+ */
+bool BinarizeEnabled(const ScanSettings& settings);
+
+/**
+ * Settings handed to the driver: "blackwhite" scans that binarize
+ * natively are acquired as "grayscale"
+ */
+ScanSettings AcquisitionSettings(const ScanSettings& settings);
+
+/**
+ * Sink that thresholds each page to 1 bpp before forwarding it. Adaptive
+ * methods need rows below the current one, so the page is held as 8-bit
+ * gray (a third of the RGB size) and forwarded in bandRows bands once
+ * the driver ends it. Pages already in BlackWhite1 or compressed by the
+ * device, and every page when binarization is off, pass straight
+ * through.
+ */
+class BitonalSink : public BandSink {
+public:
+    BitonalSink(BandSink& next,
+                const ScanSettings& settings,
+                std::shared_ptr<BufferPool> pool = nullptr,
+                int bandRows = kDefaultBandRows);
+
+    void BeginPage(int pageIndex, const PageGeometry& geometry) override;
+    bool OnBand(const ScanBand& band) override;
+    bool EndPage(int pageIndex) override;
+
+    // Record gray conversion and thresholding time per page
+    void SetMetrics(ScanMetrics* metrics) { metrics_ = metrics; }
+
+private:
+    BandSink& next_;
+    bool enabled_;
+    bool passthrough_ = true;
+    Imaging::BinarizeOptions options_;
+    std::shared_ptr<BufferPool> pool_;
+    int bandRows_;
+    PageGeometry in_{};
+    Imaging::GrayImage gray_;
+    RowConverter rows_;  // 16-bit rows reduced to 8 bits
+    ScanMetrics* metrics_ = nullptr;
+};
+
+} // namespace ScannerCore
+
+#endif // SCANNER_CORE_BITONAL_SINK_H
@@ -0,0 +1,184 @@
+/**
+ * Scanner Core Blank Page Detection Implementation
+ */
+
+#include "blankPage.h"
+#include "binarize.h"
+#include <algorithm>
+
+namespace ScannerCore {
+
+namespace {
+
+// Cells per inch of the measuring grid
+constexpr int kCellsPerInch = 32;
+
+// Cells this much darker than the paper hold ink
+constexpr int kMinInkContrast = 40;
+
+// Edge-connected dark regions inside this fraction of each side are noise
+constexpr double kBorderFrame = 0.12;
+
+// Paper level: the brightness this fraction of the cells reach
+constexpr double kPaperQuantile = 0.25;
+
+} // namespace
+
+bool ParseBlankPageMode(const std::string& name, BlankPageMode& mode) {
+    if (name == "none") {
+        mode = BlankPageMode::Keep;
+    } else if (name == "backs") {
+        mode = BlankPageMode::Backs;
+    } else if (name == "all") {
+        mode = BlankPageMode::All;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool BlankPageEligible(const ScanSettings& settings, int pageIndex) {
+    BlankPageMode mode = BlankPageMode::Keep;
+    ParseBlankPageMode(settings.skipBlankPages, mode);
+    switch (mode) {
+        case BlankPageMode::All: return true;
+        case BlankPageMode::Backs: return settings.duplex && pageIndex % 2 == 1;
+        case BlankPageMode::Keep: break;
+    }
+    return false;
+}
+
+void BlankPageDetector::BeginPage(const PageGeometry& geometry) {
+    geometry_ = geometry;
+    measuring_ = geometry.encoding == ImageEncoding::Raw && geometry.width > 0;
+    cell_ = std::max(1, geometry.resolution / kCellsPerInch);
+    columns_ = (geometry.width + cell_ - 1) / cell_;
+    pendingRows_ = 0;
+    sums_.assign(columns_, 0);
+    rows_.BeginPage(geometry.pixelFormat, geometry.width);
+    gray_.resize(geometry.width);
+    cells_.clear();
+    if (geometry.height > 0) {
+        cells_.reserve(static_cast<size_t>((geometry.height + cell_ - 1) / cell_) * columns_);
+    }
+}
+
+void BlankPageDetector::OnBand(const ScanBand& band) {
+    if (!measuring_ || !band.pixels) {
+        return;
+    }
+    for (int r = 0; r < band.rows; r++) {
+        AddRow(band.pixels->Data() + static_cast<size_t>(r) * geometry_.stride);
+    }
+}
+
+void BlankPageDetector::AddRow(const uint8_t* row) {
+    const int width = geometry_.width;
+    const uint8_t* gray = rows_.Convert(row);
+    if (Channels(geometry_.pixelFormat) == 3) {
+        Imaging::ToGrayRow(gray, width, 3, gray_.data());
+        gray = gray_.data();
+    }
+
+    for (int x = 0, column = 0; x < width; x += cell_, column++) {
+        const int end = std::min(width, x + cell_);
+        uint32_t sum = 0;
+        for (int i = x; i < end; i++) {
+            sum += gray[i];
+        }
+        sums_[column] += sum;
+    }
+
+    if (++pendingRows_ == cell_) {
+        FinishCellRow();
+    }
+}
+
+void BlankPageDetector::FinishCellRow() {
+    for (int column = 0; column < columns_; column++) {
+        const int cellWidth = std::min(cell_, geometry_.width - column * cell_);
+        cells_.push_back(static_cast<uint8_t>(sums_[column] / (static_cast<uint32_t>(cellWidth) * pendingRows_)));
+    }
+    std::fill(sums_.begin(), sums_.end(), 0);
+    pendingRows_ = 0;
+}
+
+double BlankPageDetector::InkCoverage() {
+    if (!measuring_) {
+        return -1.0;
+    }
+    if (pendingRows_ > 0) {
+        FinishCellRow();
+    }
+    const int rows = columns_ > 0 ? static_cast<int>(cells_.size()) / columns_ : 0;
+    if (rows == 0) {
+        return 0.0;
+    }
+
+    // Paper is the bright majority of the sheet; beds and shadows sit
+    // below it, so a high quantile finds it even on a small sheet
+    uint32_t histogram[256] = {};
+    for (uint8_t v : cells_) {
+        histogram[v]++;
+    }
+    const size_t target = static_cast<size_t>(cells_.size() * kPaperQuantile);
+    size_t seen = 0;
+    int paper = 255;
+    while (paper > 0 && (seen += histogram[paper]) <= target) {
+        paper--;
+    }
+    const int inkLimit = paper - kMinInkContrast;
+    if (inkLimit <= 0) {
+        return 100.0;
+    }
+
+    // Flood the dark cells connected to the edge, staying in the frame
+    const int frameX = std::max(1, static_cast<int>(columns_ * kBorderFrame));
+    const int frameY = std::max(1, static_cast<int>(rows * kBorderFrame));
+    auto inFrame = [&](int x, int y) {
+        return x < frameX || y < frameY || x >= columns_ - frameX || y >= rows - frameY;
+    };
+    std::vector<uint8_t> border(cells_.size(), 0);
+    std::vector<int> stack;
+    auto visit = [&](int x, int y) {
+        const size_t i = static_cast<size_t>(y) * columns_ + x;
+        if (!border[i] && cells_[i] < inkLimit && inFrame(x, y)) {
+            border[i] = 1;
+            stack.push_back(static_cast<int>(i));
+        }
+    };
+    for (int x = 0; x < columns_; x++) {
+        visit(x, 0);
+        visit(x, rows - 1);
+    }
+    for (int y = 0; y < rows; y++) {
+        visit(0, y);
+        visit(columns_ - 1, y);
+    }
+    while (!stack.empty()) {
+        const int i = stack.back();
+        stack.pop_back();
+        const int x = i % columns_;
+        const int y = i / columns_;
+        if (x > 0) visit(x - 1, y);
+        if (x + 1 < columns_) visit(x + 1, y);
+        if (y > 0) visit(x, y - 1);
+        if (y + 1 < rows) visit(x, y + 1);
+    }
+
+    // A cell's share of ink follows how far it is below the paper
+    double ink = 0.0;
+    size_t sheet = 0;
+    for (size_t i = 0; i < cells_.size(); i++) {
+        if (border[i]) {
+            continue;
+        }
+        sheet++;
+        if (cells_[i] < inkLimit) {
+            ink += static_cast<double>(paper - cells_[i]) / paper;
+        }
+    }
+    return sheet > 0 ? ink * 100.0 / sheet : 0.0;
+}
+
+} // namespace ScannerCore
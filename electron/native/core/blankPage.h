@@ -0,0 +1,69 @@
+/**
+ * Scanner Core Blank Page Detection
+ *
+ * Measures the ink coverage of a page while its bands arrive, so a
+ * batch can drop blank sheets (typically the empty backs of a duplex
+ * stack) before they are encoded, written to the PDF or handed to
+ * JavaScript. Each band is reduced to a grid of cell means about 1/32
+ * inch across, which averages away dust and sensor noise; at the end of
+ * the page the cells clearly darker than the paper count as ink, except
+ * dark regions that touch the edge of the scan within its outer frame
+ * (bed, shadows, punch holes), which are border noise.
+ */
+
+#ifndef SCANNER_CORE_BLANK_PAGE_H
+#define SCANNER_CORE_BLANK_PAGE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "bandStream.h"
+#include "pixelKernels.h"
+
+namespace ScannerCore {
+
+/**
+ * Which batch pages may be dropped as blank ("none", "backs", "all")
+ */
+enum class BlankPageMode {
+    Keep,
+    Backs,  // duplex back sides only
+    All
+};
+
+bool ParseBlankPageMode(const std::string& name, BlankPageMode& mode);
+
+/**
+ * True when settings.skipBlankPages allows dropping batch page
+ * `pageIndex`. Duplex drivers deliver front and back alternately, so
+ * odd pages are backs.
+ */
+bool BlankPageEligible(const ScanSettings& settings, int pageIndex);
+
+class BlankPageDetector {
+public:
+    void BeginPage(const PageGeometry& geometry);
+    void OnBand(const ScanBand& band);
+
+    // Percent of the sheet covered by ink, or -1 if the page could not be
+    // measured (compressed by the device)
+    double InkCoverage();
+
+private:
+    void AddRow(const uint8_t* row);
+    void FinishCellRow();
+
+    PageGeometry geometry_{};
+    bool measuring_ = false;
+    int cell_ = 1;          // cell size in pixels
+    int columns_ = 0;       // cells per row
+    int pendingRows_ = 0;   // rows accumulated into sums_
+    std::vector<uint32_t> sums_;
+    RowConverter rows_;            // driver rows as 8-bit samples
+    std::vector<uint8_t> gray_;    // RGB rows reduced to gray
+    std::vector<uint8_t> cells_;  // row-major cell means
+};
+
+} // namespace ScannerCore
+
+#endif // SCANNER_CORE_BLANK_PAGE_H
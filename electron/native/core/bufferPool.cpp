@@ -0,0 +1,173 @@
+/**
+ * Scanner Core Buffer Pool Implementation
+ */
+
+#include "bufferPool.h"
+#include <algorithm>
+#include <cmath>
+
+namespace ScannerCore {
+
+namespace {
+
+// Idle page buffers kept for raw scans: one in JavaScript, one filling
+constexpr size_t kRetainedPages = 2;
+
+// Band buffers kept in flight (BandWriter plus queued stream bands)
+constexpr size_t kRetainedBands = 6;
+
+// A recycled buffer may be at most this many times larger than requested
+constexpr size_t kMaxOversize = 2;
+
+struct PaperInches {
+    const char* name;
+    double width;
+    double height;
+};
+
+const PaperInches kPaperSizes[] = {
+    {"letter", 8.5, 11.0},
+    {"legal", 8.5, 14.0},
+    {"a4", 8.27, 11.69},
+    {"a5", 5.83, 8.27},
+    {"b5", 6.93, 9.84},
+};
+
+} // namespace
+
+BufferPool::BufferPool() : idleBytes_(0), retainBytes_(0), hits_(0), misses_(0) {}
+
+std::shared_ptr<BufferPool> BufferPool::Create() {
+    return std::shared_ptr<BufferPool>(new BufferPool());
+}
+
+std::shared_ptr<PixelBuffer> BufferPool::Wrap(PixelBuffer* buffer, const std::weak_ptr<BufferPool>& pool) {
+    // The deleter runs wherever the last reference drops: an acquisition
+    // thread, or the JavaScript thread in an ArrayBuffer finalizer
+    return std::shared_ptr<PixelBuffer>(buffer, [pool](PixelBuffer* released) {
+        if (std::shared_ptr<BufferPool> owner = pool.lock()) {
+            owner->Recycle(released);
+        } else {
+            delete released;
+        }
+    });
+}
+
+std::shared_ptr<PixelBuffer> BufferPool::Acquire(size_t size) {
+    std::unique_ptr<PixelBuffer> buffer;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        // Best fit among idle buffers that are not wastefully large
+        size_t best = idle_.size();
+        for (size_t i = 0; i < idle_.size(); i++) {
+            size_t capacity = idle_[i]->Capacity();
+            if (capacity >= size && capacity <= size * kMaxOversize &&
+                (best == idle_.size() || capacity < idle_[best]->Capacity())) {
+                best = i;
+            }
+        }
+
+        if (best < idle_.size()) {
+            buffer = std::move(idle_[best]);
+            idle_.erase(idle_.begin() + static_cast<std::ptrdiff_t>(best));
+            idleBytes_ -= buffer->Capacity();
+            hits_++;
+        } else {
+            misses_++;
+        }
+    }
+
+    if (buffer) {
+        buffer->Reset(size);
+    } else {
+        buffer = std::make_unique<PixelBuffer>(size);
+    }
+
+    return Wrap(buffer.release(), weak_from_this());
+}
+
+void BufferPool::Recycle(PixelBuffer* buffer) {
+    std::unique_ptr<PixelBuffer> owned(buffer);
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (idleBytes_ + owned->Capacity() <= retainBytes_) {
+        idleBytes_ += owned->Capacity();
+        idle_.push_back(std::move(owned));
+    }
+}
+
+void BufferPool::ConfigureForScan(const ScanSettings& settings, int bandRows) {
+    size_t stride = 0;
+    const size_t pageBytes = EstimatePageBytes(settings, &stride);
+    const size_t bandBytes = stride * static_cast<size_t>(std::max(1, bandRows));
+
+    // Compressed scans never hold a raw page, only bands
+    const bool rawPages = settings.compression.empty() || settings.compression == "none";
+    const size_t retain = (rawPages ? kRetainedPages * pageBytes : 0) + kRetainedBands * bandBytes;
+
+    size_t idleBands = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        retainBytes_ = std::max(retainBytes_, retain);
+        for (const auto& buffer : idle_) {
+            if (buffer->Capacity() >= bandBytes && buffer->Capacity() <= bandBytes * kMaxOversize) {
+                idleBands++;
+            }
+        }
+    }
+
+    // Pre-allocate the band buffers the first strips will need
+    for (size_t i = idleBands; i < kRetainedBands; i++) {
+        auto buffer = std::make_unique<PixelBuffer>(bandBytes);
+        std::lock_guard<std::mutex> lock(mutex_);
+        idleBytes_ += buffer->Capacity();
+        idle_.push_back(std::move(buffer));
+    }
+}
+
+void BufferPool::Trim() {
+    std::vector<std::unique_ptr<PixelBuffer>> released;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        released.swap(idle_);
+        idleBytes_ = 0;
+        retainBytes_ = 0;
+    }
+}
+
+BufferPoolStats BufferPool::Stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return BufferPoolStats{hits_, misses_, idleBytes_, idle_.size()};
+}
+
+void PagePixelSize(const ScanSettings& settings, int& width, int& height) {
+    const PaperInches* paper = &kPaperSizes[0];
+    for (const PaperInches& size : kPaperSizes) {
+        if (settings.paperSize == size.name) {
+            paper = &size;
+        }
+    }
+
+    // A hardware scan area shrinks the page to just that region
+    const double inchesWide = settings.scanArea.IsSet() ? settings.scanArea.width : paper->width;
+    const double inchesHigh = settings.scanArea.IsSet() ? settings.scanArea.height : paper->height;
+
+    const int dpi = std::max(1, settings.resolution);
+    width = static_cast<int>(std::lround(inchesWide * dpi));
+    height = static_cast<int>(std::lround(inchesHigh * dpi));
+}
+
+size_t EstimatePageBytes(const ScanSettings& settings, size_t* stride) {
+    int width = 0;
+    int height = 0;
+    PagePixelSize(settings, width, height);
+    const size_t rowBytes = static_cast<size_t>(MinStride(PixelFormatForColorMode(settings.colorMode), width));
+
+    if (stride) {
+        *stride = rowBytes;
+    }
+    return rowBytes * height;
+}
+
+} // namespace ScannerCore
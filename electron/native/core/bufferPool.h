@@ -0,0 +1,87 @@
+/**
+ * Scanner Core Buffer Pool
+ *
+ * Per-scanner recycler for page, band and scratch PixelBuffers. Buffers
+ * handed out by Acquire() return to the pool when their last reference
+ * drops, including the reference held by a JavaScript ArrayBuffer
+ * finalizer, so an ADF batch keeps reusing the same few allocations
+ * instead of churning the allocator for every sheet.
+ */
+
+#ifndef SCANNER_CORE_BUFFER_POOL_H
+#define SCANNER_CORE_BUFFER_POOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "pixelBuffer.h"
+#include "scanTypes.h"
+
+namespace ScannerCore {
+
+/**
+ * Pool counters (hits are requests served from a recycled buffer)
+ */
+struct BufferPoolStats {
+    uint64_t hits;
+    uint64_t misses;
+    size_t pooledBytes;
+    size_t pooledBuffers;
+};
+
+class BufferPool : public std::enable_shared_from_this<BufferPool> {
+public:
+    static std::shared_ptr<BufferPool> Create();
+
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    /**
+     * Buffer with at least `size` bytes. Recycled buffers keep stale
+     * contents; callers overwrite what they use.
+     */
+    std::shared_ptr<PixelBuffer> Acquire(size_t size);
+
+    /**
+     * Size the pool for a scan: how much idle memory to retain and
+     * which band buffers to pre-allocate, derived from the resolution,
+     * paper size and color mode.
+     */
+    void ConfigureForScan(const ScanSettings& settings, int bandRows);
+
+    // Drop all idle buffers
+    void Trim();
+
+    BufferPoolStats Stats() const;
+
+private:
+    BufferPool();
+
+    void Recycle(PixelBuffer* buffer);
+    static std::shared_ptr<PixelBuffer> Wrap(PixelBuffer* buffer, const std::weak_ptr<BufferPool>& pool);
+
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<PixelBuffer>> idle_;
+    size_t idleBytes_;
+    size_t retainBytes_;
+    uint64_t hits_;
+    uint64_t misses_;
+};
+
+/**
+ * Page size in pixels for the given settings. Unknown or "auto" paper
+ * sizes assume US Letter; a scan area replaces the paper size.
+ */
+void PagePixelSize(const ScanSettings& settings, int& width, int& height);
+
+/**
+ * Expected raw bytes of one page for the given settings (same page
+ * size rules as PagePixelSize)
+ */
+size_t EstimatePageBytes(const ScanSettings& settings, size_t* stride = nullptr);
+
+} // namespace ScannerCore
+
+#endif // SCANNER_CORE_BUFFER_POOL_H
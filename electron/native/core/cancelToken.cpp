@@ -0,0 +1,47 @@
+/**
+ * Scanner Core Cancel Token Implementation
+ */
+
+#include "cancelToken.h"
+
+namespace ScannerCore {
+
+bool CancelToken::Cancel() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (cancelled_.exchange(true, std::memory_order_acq_rel)) {
+        return false;
+    }
+    for (auto& entry : hooks_) {
+        entry.second();
+    }
+    return true;
+}
+
+int CancelToken::AddHook(std::function<void()> hook) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (IsCancelled()) {
+        hook();
+    }
+    const int id = nextId_++;
+    hooks_.emplace(id, std::move(hook));
+    return id;
+}
+
+void CancelToken::RemoveHook(int id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    hooks_.erase(id);
+}
+
+CancelHook::CancelHook(CancelToken* token, std::function<void()> hook) : token_(token) {
+    if (token_) {
+        id_ = token_->AddHook(std::move(hook));
+    }
+}
+
+CancelHook::~CancelHook() {
+    if (token_) {
+        token_->RemoveHook(id_);
+    }
+}
+
+} // namespace ScannerCore
@@ -0,0 +1,70 @@
+/**
+ * Scanner Core Cancel Token
+ *
+ * Cooperative cancellation of an in-flight acquisition. cancelScan()
+ * sets the token on the JavaScript thread; BandWriter checks it at
+ * every driver read and page boundary, so the driver loop stops at the
+ * next strip. Stages that can block (driver reads, the page queue's
+ * high-water mark) register a hook that wakes them: the driver's abort
+ * call (sane_cancel, TWAIN MSG_RESET, a WIA callback returning S_FALSE)
+ * or closing the queue.
+ */
+
+#ifndef SCANNER_CORE_CANCEL_TOKEN_H
+#define SCANNER_CORE_CANCEL_TOKEN_H
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <mutex>
+
+namespace ScannerCore {
+
+class CancelToken {
+public:
+    CancelToken() = default;
+    CancelToken(const CancelToken&) = delete;
+    CancelToken& operator=(const CancelToken&) = delete;
+
+    // Clear a previous cancellation when a new acquisition starts
+    void Reset() { cancelled_.store(false, std::memory_order_release); }
+
+    // Set the token and run every registered hook once. Returns false if
+    // it was already set.
+    bool Cancel();
+
+    bool IsCancelled() const { return cancelled_.load(std::memory_order_acquire); }
+
+    // Hooks run on the cancelling thread, under the token's lock, and
+    // must not register or remove hooks themselves. A hook added after
+    // Cancel() runs at once.
+    int AddHook(std::function<void()> hook);
+    void RemoveHook(int id);
+
+private:
+    std::atomic<bool> cancelled_{false};
+    std::mutex mutex_;
+    std::map<int, std::function<void()>> hooks_;
+    int nextId_ = 0;
+};
+
+/**
+ * Registers a hook for the lifetime of the scope; once it is gone the
+ * hook can no longer be running. A null token is ignored.
+ */
+class CancelHook {
+public:
+    CancelHook(CancelToken* token, std::function<void()> hook);
+    ~CancelHook();
+
+    CancelHook(const CancelHook&) = delete;
+    CancelHook& operator=(const CancelHook&) = delete;
+
+private:
+    CancelToken* token_;
+    int id_ = -1;
+};
+
+} // namespace ScannerCore
+
+#endif // SCANNER_CORE_CANCEL_TOKEN_H
@@ -0,0 +1,265 @@
+/**
+ * Scanner Core CCITT Group 4 Encoder Implementation
+ */
+
+#include "ccittG4Encoder.h"
+#include <algorithm>
+
+namespace ScannerCore {
+
+namespace {
+
+struct RunCode {
+    uint16_t code;
+    uint8_t length;
+};
+
+// Terminating codes, run lengths 0-63
+const RunCode kWhiteTerminating[] = {
+    {0x035,  8}, {0x007,  6}, {0x007,  4}, {0x008,  4},
+    {0x00B,  4}, {0x00C,  4}, {0x00E,  4}, {0x00F,  4},
+    {0x013,  5}, {0x014,  5}, {0x007,  5}, {0x008,  5},
+    {0x008,  6}, {0x003,  6}, {0x034,  6}, {0x035,  6},
+    {0x02A,  6}, {0x02B,  6}, {0x027,  7}, {0x00C,  7},
+    {0x008,  7}, {0x017,  7}, {0x003,  7}, {0x004,  7},
+    {0x028,  7}, {0x02B,  7}, {0x013,  7}, {0x024,  7},
+    {0x018,  7}, {0x002,  8}, {0x003,  8}, {0x01A,  8},
+    {0x01B,  8}, {0x012,  8}, {0x013,  8}, {0x014,  8},
+    {0x015,  8}, {0x016,  8}, {0x017,  8}, {0x028,  8},
+    {0x029,  8}, {0x02A,  8}, {0x02B,  8}, {0x02C,  8},
+    {0x02D,  8}, {0x004,  8}, {0x005,  8}, {0x00A,  8},
+    {0x00B,  8}, {0x052,  8}, {0x053,  8}, {0x054,  8},
+    {0x055,  8}, {0x024,  8}, {0x025,  8}, {0x058,  8},
+    {0x059,  8}, {0x05A,  8}, {0x05B,  8}, {0x04A,  8},
+    {0x04B,  8}, {0x032,  8}, {0x033,  8}, {0x034,  8}
+};
+
+const RunCode kBlackTerminating[] = {
+    {0x037, 10}, {0x002,  3}, {0x003,  2}, {0x002,  2},
+    {0x003,  3}, {0x003,  4}, {0x002,  4}, {0x003,  5},
+    {0x005,  6}, {0x004,  6}, {0x004,  7}, {0x005,  7},
+    {0x007,  7}, {0x004,  8}, {0x007,  8}, {0x018,  9},
+    {0x017, 10}, {0x018, 10}, {0x008, 10}, {0x067, 11},
+    {0x068, 11}, {0x06C, 11}, {0x037, 11}, {0x028, 11},
+    {0x017, 11}, {0x018, 11}, {0x0CA, 12}, {0x0CB, 12},
+    {0x0CC, 12}, {0x0CD, 12}, {0x068, 12}, {0x069, 12},
+    {0x06A, 12}, {0x06B, 12}, {0x0D2, 12}, {0x0D3, 12},
+    {0x0D4, 12}, {0x0D5, 12}, {0x0D6, 12}, {0x0D7, 12},
+    {0x06C, 12}, {0x06D, 12}, {0x0DA, 12}, {0x0DB, 12},
+    {0x054, 12}, {0x055, 12}, {0x056, 12}, {0x057, 12},
+    {0x064, 12}, {0x065, 12}, {0x052, 12}, {0x053, 12},
+    {0x024, 12}, {0x037, 12}, {0x038, 12}, {0x027, 12},
+    {0x028, 12}, {0x058, 12}, {0x059, 12}, {0x02B, 12},
+    {0x02C, 12}, {0x05A, 12}, {0x066, 12}, {0x067, 12}
+};
+
+// Make-up codes, run lengths 64-2560 in steps of 64 (1792+ shared)
+const RunCode kWhiteMakeup[] = {
+    {0x01B,  5}, {0x012,  5}, {0x017,  6}, {0x037,  7},
+    {0x036,  8}, {0x037,  8}, {0x064,  8}, {0x065,  8},
+    {0x068,  8}, {0x067,  8}, {0x0CC,  9}, {0x0CD,  9},
+    {0x0D2,  9}, {0x0D3,  9}, {0x0D4,  9}, {0x0D5,  9},
+    {0x0D6,  9}, {0x0D7,  9}, {0x0D8,  9}, {0x0D9,  9},
+    {0x0DA,  9}, {0x0DB,  9}, {0x098,  9}, {0x099,  9},
+    {0x09A,  9}, {0x018,  6}, {0x09B,  9}, {0x008, 11},
+    {0x00C, 11}, {0x00D, 11}, {0x012, 12}, {0x013, 12},
+    {0x014, 12}, {0x015, 12}, {0x016, 12}, {0x017, 12},
+    {0x01C, 12}, {0x01D, 12}, {0x01E, 12}, {0x01F, 12}
+};
+
+const RunCode kBlackMakeup[] = {
+    {0x00F, 10}, {0x0C8, 12}, {0x0C9, 12}, {0x05B, 12},
+    {0x033, 12}, {0x034, 12}, {0x035, 12}, {0x06C, 13},
+    {0x06D, 13}, {0x04A, 13}, {0x04B, 13}, {0x04C, 13},
+    {0x04D, 13}, {0x072, 13}, {0x073, 13}, {0x074, 13},
+    {0x075, 13}, {0x076, 13}, {0x077, 13}, {0x052, 13},
+    {0x053, 13}, {0x054, 13}, {0x055, 13}, {0x05A, 13},
+    {0x05B, 13}, {0x064, 13}, {0x065, 13}, {0x008, 11},
+    {0x00C, 11}, {0x00D, 11}, {0x012, 12}, {0x013, 12},
+    {0x014, 12}, {0x015, 12}, {0x016, 12}, {0x017, 12},
+    {0x01C, 12}, {0x01D, 12}, {0x01E, 12}, {0x01F, 12}
+};
+
+// Mode codes (T.4 table 4)
+const RunCode kPassCode = {0x1, 4};
+const RunCode kHorizontalCode = {0x1, 3};
+
+// Vertical codes indexed by b1 - a1 + 3: VR3, VR2, VR1, V0, VL1, VL2, VL3
+const RunCode kVerticalCodes[] = {
+    {0x03, 7}, {0x03, 6}, {0x3, 3}, {0x1, 1}, {0x2, 3}, {0x02, 6}, {0x02, 7}
+};
+
+constexpr int kMaxMakeup = 2560;
+
+inline int Pixel(const uint8_t* line, int x) {
+    return (line[x >> 3] >> (7 - (x & 7))) & 1;
+}
+
+/**
+ * First position >= start (and <= end) whose colour differs from `color`
+ */
+int FindChange(const uint8_t* line, int start, int end, int color) {
+    int x = start;
+
+    // Partial leading byte
+    while (x < end && (x & 7) != 0) {
+        if (Pixel(line, x) != color) return x;
+        x++;
+    }
+
+    // Whole bytes of the same colour
+    const uint8_t same = color ? 0xFF : 0x00;
+    while (x + 8 <= end && line[x >> 3] == same) {
+        x += 8;
+    }
+
+    while (x < end && Pixel(line, x) == color) {
+        x++;
+    }
+    return std::min(x, end);
+}
+
+} // namespace
+
+CcittG4Encoder::CcittG4Encoder()
+    : width_(0),
+      stride_(0),
+      rows_(0),
+      bitBuffer_(0),
+      bitCount_(0) {}
+
+bool CcittG4Encoder::Begin(const PageGeometry& geometry, std::string& error) {
+    if (geometry.pixelFormat != PixelFormat::BlackWhite1) {
+        error = "CCITT G4 requires black & white pixels";
+        return false;
+    }
+
+    width_ = geometry.width;
+    stride_ = geometry.stride;
+    rows_ = 0;
+    bitBuffer_ = 0;
+    bitCount_ = 0;
+    output_.clear();
+
+    // Imaginary all-white line above the page
+    const size_t lineBytes = static_cast<size_t>(width_ + 7) / 8;
+    reference_.assign(lineBytes, 0);
+    coding_.assign(lineBytes, 0);
+    return true;
+}
+
+bool CcittG4Encoder::WriteRows(const uint8_t* data, int rows, std::string& /*error*/) {
+    for (int y = 0; y < rows; y++) {
+        EncodeRow(data + static_cast<size_t>(y) * stride_);
+    }
+    return true;
+}
+
+void CcittG4Encoder::EncodeRow(const uint8_t* row) {
+    // Internally 1 = black; clear the padding bits of the last byte
+    const size_t lineBytes = coding_.size();
+    for (size_t i = 0; i < lineBytes; i++) {
+        coding_[i] = static_cast<uint8_t>(~row[i]);
+    }
+    if (width_ & 7) {
+        coding_[lineBytes - 1] &= static_cast<uint8_t>(0xFF << (8 - (width_ & 7)));
+    }
+
+    const uint8_t* cur = coding_.data();
+    const uint8_t* ref = reference_.data();
+    const int bits = width_;
+
+    // a0 starts on an imaginary white pixel before the line
+    int a0 = 0;
+    int a1 = Pixel(cur, 0) ? 0 : FindChange(cur, 0, bits, 0);
+    int b1 = Pixel(ref, 0) ? 0 : FindChange(ref, 0, bits, 0);
+
+    for (;;) {
+        int b2 = b1 < bits ? FindChange(ref, b1, bits, Pixel(ref, b1)) : bits;
+
+        if (b2 >= a1) {
+            int d = b1 - a1;
+            if (d >= -3 && d <= 3) {
+                // Vertical mode
+                PutBits(kVerticalCodes[d + 3].code, kVerticalCodes[d + 3].length);
+                a0 = a1;
+            } else {
+                // Horizontal mode: two runs starting at a0
+                int a2 = a1 < bits ? FindChange(cur, a1, bits, Pixel(cur, a1)) : bits;
+                PutBits(kHorizontalCode.code, kHorizontalCode.length);
+                if (a0 + a1 == 0 || Pixel(cur, a0) == 0) {
+                    PutRun(a1 - a0, false);
+                    PutRun(a2 - a1, true);
+                } else {
+                    PutRun(a1 - a0, true);
+                    PutRun(a2 - a1, false);
+                }
+                a0 = a2;
+            }
+        } else {
+            // Pass mode
+            PutBits(kPassCode.code, kPassCode.length);
+            a0 = b2;
+        }
+
+        if (a0 >= bits) {
+            break;
+        }
+
+        const int color = Pixel(cur, a0);
+        a1 = FindChange(cur, a0, bits, color);
+        b1 = FindChange(ref, a0, bits, !color);
+        b1 = FindChange(ref, b1, bits, color);
+    }
+
+    reference_.swap(coding_);
+    rows_++;
+}
+
+void CcittG4Encoder::PutBits(uint32_t code, int length) {
+    bitBuffer_ = (bitBuffer_ << length) | code;
+    bitCount_ += length;
+    while (bitCount_ >= 8) {
+        bitCount_ -= 8;
+        output_.push_back(static_cast<uint8_t>(bitBuffer_ >> bitCount_));
+    }
+    bitBuffer_ &= (1u << bitCount_) - 1;
+}
+
+void CcittG4Encoder::PutRun(int run, bool black) {
+    const RunCode* makeup = black ? kBlackMakeup : kWhiteMakeup;
+    const RunCode* terminating = black ? kBlackTerminating : kWhiteTerminating;
+
+    while (run >= kMaxMakeup + 64) {
+        const RunCode& code = makeup[kMaxMakeup / 64 - 1];
+        PutBits(code.code, code.length);
+        run -= kMaxMakeup;
+    }
+    if (run >= 64) {
+        const RunCode& code = makeup[run / 64 - 1];
+        PutBits(code.code, code.length);
+        run %= 64;
+    }
+    PutBits(terminating[run].code, terminating[run].length);
+}
+
+bool CcittG4Encoder::Finish(int /*rows*/, std::string& error) {
+    if (rows_ == 0) {
+        error = "Driver returned no image data";
+        return false;
+    }
+
+    // EOFB, then pad to a byte boundary
+    PutBits(0x001, 12);
+    PutBits(0x001, 12);
+    if (bitCount_ > 0) {
+        PutBits(0, 8 - bitCount_);
+    }
+    return true;
+}
+
+std::shared_ptr<PixelBuffer> CcittG4Encoder::TakeOutput() {
+    return std::make_shared<PixelBuffer>(std::move(output_));
+}
+
+} // namespace ScannerCore
@@ -0,0 +1,55 @@
+/**
+ * Scanner Core CCITT Group 4 Encoder
+ *
+ * ITU-T T.6 (MMR) encoder for black & white pages. Each scanline is
+ * coded against the previous one, so rows are compressed as soon as
+ * they arrive and the page height does not need to be known up front.
+ * Output is the raw T.6 bit stream terminated by EOFB, as embedded by
+ * PDF /CCITTFaxDecode (/K -1) and TIFF compression 4.
+ */
+
+#ifndef SCANNER_CORE_CCITT_G4_ENCODER_H
+#define SCANNER_CORE_CCITT_G4_ENCODER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "bandStream.h"
+#include "imageEncoder.h"
+
+namespace ScannerCore {
+
+class CcittG4Encoder : public PageEncoder {
+public:
+    CcittG4Encoder();
+
+    bool Begin(const PageGeometry& geometry, std::string& error) override;
+    bool WriteRows(const uint8_t* data, int rows, std::string& error) override;
+    bool Finish(int rows, std::string& error) override;
+
+    int EncodedHeight() const override { return rows_; }
+    size_t EncodedSize() const override { return output_.size(); }
+    std::shared_ptr<PixelBuffer> TakeOutput() override;
+
+    // Encode one packed 1-bpp scanline (MSB first, 0 = black)
+    void EncodeRow(const uint8_t* row);
+
+private:
+    void PutBits(uint32_t code, int length);
+    void PutRun(int run, bool black);
+
+    int width_;
+    int stride_;
+    int rows_;
+    std::vector<uint8_t> reference_; // previous line, 1 = black
+    std::vector<uint8_t> coding_;    // current line, 1 = black
+    std::vector<uint8_t> output_;
+    uint32_t bitBuffer_;
+    int bitCount_;
+};
+
+} // namespace ScannerCore
+
+#endif // SCANNER_CORE_CCITT_G4_ENCODER_H
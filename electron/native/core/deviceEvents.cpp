@@ -0,0 +1,46 @@
+/**
+ * Scanner Core Device Events Implementation
+ */
+
+#include "deviceEvents.h"
+#include "napiConvert.h"
+
+namespace ScannerCore {
+
+namespace {
+
+struct DeviceEvent {
+    ScannerDevice device;
+    bool connected;
+};
+
+} // namespace
+
+DeviceEventEmitter::DeviceEventEmitter(Napi::Env env, Napi::Function callback) {
+    tsfn_ = Napi::ThreadSafeFunction::New(env, callback, "ScannerDeviceEvents", 0, 1);
+    // Watching for devices must not keep the process alive
+    tsfn_.Unref(env);
+}
+
+DeviceEventEmitter::~DeviceEventEmitter() {
+    tsfn_.Release();
+}
+
+void DeviceEventEmitter::Emit(const ScannerDevice& device, bool connected) {
+    DeviceEvent* event = new DeviceEvent{device, connected};
+    napi_status status = tsfn_.NonBlockingCall(event, [](Napi::Env env, Napi::Function callback, DeviceEvent* data) {
+        if (env != nullptr) {
+            Napi::Object obj = Napi::Object::New(env);
+            obj.Set("type", data->connected ? "connected" : "disconnected");
+            obj.Set("device", DeviceToObject(env, data->device));
+            callback.Call({obj});
+        }
+        delete data;
+    });
+
+    if (status != napi_ok) {
+        delete event;
+    }
+}
+
+} // namespace ScannerCore
@@ -0,0 +1,33 @@
+/**
+ * Scanner Core Device Events
+ *
+ * Forwards registry hot-plug changes to a JavaScript callback as
+ * { type: 'connected' | 'disconnected', device } objects.
+ */
+
+#ifndef SCANNER_CORE_DEVICE_EVENTS_H
+#define SCANNER_CORE_DEVICE_EVENTS_H
+
+#include <napi.h>
+#include "scanTypes.h"
+
+namespace ScannerCore {
+
+class DeviceEventEmitter {
+public:
+    DeviceEventEmitter(Napi::Env env, Napi::Function callback);
+    ~DeviceEventEmitter();
+
+    DeviceEventEmitter(const DeviceEventEmitter&) = delete;
+    DeviceEventEmitter& operator=(const DeviceEventEmitter&) = delete;
+
+    // Safe to call from any thread
+    void Emit(const ScannerDevice& device, bool connected);
+
+private:
+    Napi::ThreadSafeFunction tsfn_;
+};
+
+} // namespace ScannerCore
+
+#endif // SCANNER_CORE_DEVICE_EVENTS_H
@@ -0,0 +1,178 @@
+/**
+ * Scanner Core Device Registry Implementation
+ */
+
+#include "deviceRegistry.h"
+#include <algorithm>
+#include <exception>
+#include "threadPool.h"
+
+namespace ScannerCore {
+
+namespace {
+
+bool ContainsDevice(const std::vector<ScannerDevice>& devices, const std::string& id) {
+    return std::any_of(devices.begin(), devices.end(),
+                       [&id](const ScannerDevice& d) { return d.id == id; });
+}
+
+} // namespace
+
+DeviceRegistry::DeviceRegistry(DeviceProbeFn probe, DriverInitFn init)
+    : probe_(std::move(probe)),
+      init_(std::move(init)),
+      driverLoaded_(!init_),
+      hasSnapshot_(false),
+      stale_(true),
+      stopping_(false) {}
+
+DeviceRegistry::~DeviceRegistry() {
+    Stop();
+}
+
+void DeviceRegistry::Start() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!thread_.joinable() && !stopping_) {
+        thread_ = std::thread(&DeviceRegistry::Run, this);
+    }
+}
+
+bool DeviceRegistry::WaitReady(std::string& error) {
+    Start();
+    std::unique_lock<std::mutex> lock(mutex_);
+    WaitForSnapshot(lock);
+    if (!driverLoaded_) {
+        error = stopping_ && driverError_.empty() ? "Scanner driver closed" : driverError_;
+        return false;
+    }
+    return true;
+}
+
+std::vector<ScannerDevice> DeviceRegistry::Devices() {
+    Start();
+    std::unique_lock<std::mutex> lock(mutex_);
+    WaitForSnapshot(lock);
+    return devices_;
+}
+
+bool DeviceRegistry::Find(const std::string& deviceId, ScannerDevice& device) {
+    Start();
+    std::unique_lock<std::mutex> lock(mutex_);
+    WaitForSnapshot(lock);
+
+    for (const ScannerDevice& d : devices_) {
+        if (d.id == deviceId) {
+            device = d;
+            return true;
+        }
+    }
+    return false;
+}
+
+void DeviceRegistry::Invalidate() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stale_ = true;
+    }
+    wake_.notify_one();
+    Start();
+}
+
+void DeviceRegistry::SetChangeListener(DeviceChangeFn listener) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    listener_ = std::move(listener);
+}
+
+void DeviceRegistry::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        listener_ = nullptr;
+    }
+    wake_.notify_one();
+    ready_.notify_all();
+
+    if (thread_.joinable() && thread_.get_id() != std::this_thread::get_id()) {
+        thread_.join();
+    }
+}
+
+void DeviceRegistry::WaitForSnapshot(std::unique_lock<std::mutex>& lock) {
+    ready_.wait(lock, [this] { return hasSnapshot_ || stopping_; });
+}
+
+void DeviceRegistry::Run() {
+    // Driver loads and probes are background work; a scan dialog that
+    // waits on them still gets them, just not ahead of the UI
+    Imaging::LowerThreadPriority();
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    while (!stopping_) {
+        wake_.wait(lock, [this] { return stale_ || stopping_; });
+        if (stopping_) {
+            break;
+        }
+        stale_ = false;
+
+        if (!driverLoaded_) {
+            lock.unlock();
+            std::string error;
+            bool loaded = false;
+            try {
+                loaded = init_(error);
+            } catch (const std::exception& e) {
+                error = e.what();
+            }
+            lock.lock();
+            driverLoaded_ = loaded;
+            driverError_ = loaded ? std::string() : error.empty() ? "Scanner driver failed to load" : error;
+            if (!loaded) {
+                // No driver, no devices; refreshDevices() tries again
+                hasSnapshot_ = true;
+                ready_.notify_all();
+                continue;
+            }
+        }
+
+        // Probe without holding the lock; readers keep the old snapshot
+        lock.unlock();
+        std::vector<ScannerDevice> fresh;
+        try {
+            fresh = probe_();
+        } catch (const std::exception&) {
+            // Keep serving the previous snapshot if the driver probe fails
+            lock.lock();
+            hasSnapshot_ = true;
+            ready_.notify_all();
+            continue;
+        }
+        lock.lock();
+
+        std::vector<ScannerDevice> previous = std::move(devices_);
+        bool firstSnapshot = !hasSnapshot_;
+        devices_ = std::move(fresh);
+        hasSnapshot_ = true;
+        DeviceChangeFn listener = listener_;
+        ready_.notify_all();
+
+        if (firstSnapshot || !listener) {
+            continue;
+        }
+
+        std::vector<ScannerDevice> current = devices_;
+        lock.unlock();
+        for (const ScannerDevice& d : current) {
+            if (!ContainsDevice(previous, d.id)) {
+                listener(d, true);
+            }
+        }
+        for (const ScannerDevice& d : previous) {
+            if (!ContainsDevice(current, d.id)) {
+                listener(d, false);
+            }
+        }
+        lock.lock();
+    }
+}
+
+} // namespace ScannerCore
@@ -0,0 +1,98 @@
+/**
+ * Scanner Core Device Registry
+ *
+ * Caches the result of a driver device probe (sane_get_devices, TWAIN
+ * DSM enumeration, ...) which can take seconds while network scanners
+ * are contacted. enumerateDevices/getCapabilities are answered from
+ * memory; OS hot-plug notifications invalidate the cache and trigger a
+ * background re-probe that reports connected/disconnected devices.
+ *
+ * Loading the driver itself (sane_init() and its backends, the TWAIN
+ * DSM) happens on the same thread, below normal priority, just before
+ * the first probe, so neither constructing the addon nor initialize()
+ * costs the JavaScript thread anything.
+ */
+
+#ifndef SCANNER_CORE_DEVICE_REGISTRY_H
+#define SCANNER_CORE_DEVICE_REGISTRY_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "scanTypes.h"
+
+namespace ScannerCore {
+
+/**
+ * Driver device probe. Runs on the registry thread.
+ */
+using DeviceProbeFn = std::function<std::vector<ScannerDevice>()>;
+
+/**
+ * One-time driver load. Runs on the registry thread before the first
+ * probe; on failure it is retried by the next Invalidate().
+ */
+using DriverInitFn = std::function<bool(std::string& error)>;
+
+/**
+ * Called on the registry thread for each device that appeared or
+ * disappeared between two probes
+ */
+using DeviceChangeFn = std::function<void(const ScannerDevice& device, bool connected)>;
+
+class DeviceRegistry {
+public:
+    explicit DeviceRegistry(DeviceProbeFn probe, DriverInitFn init = nullptr);
+    ~DeviceRegistry();
+
+    DeviceRegistry(const DeviceRegistry&) = delete;
+    DeviceRegistry& operator=(const DeviceRegistry&) = delete;
+
+    // Start the first probe in the background (idempotent)
+    void Start();
+
+    // Start if needed and wait for the driver load and first probe.
+    // Returns false with the driver's error if it could not be loaded.
+    bool WaitReady(std::string& error);
+
+    // Cached devices; waits for the first probe if it has not finished
+    std::vector<ScannerDevice> Devices();
+
+    // Cached device lookup; waits for the first probe if needed
+    bool Find(const std::string& deviceId, ScannerDevice& device);
+
+    // Mark the cache stale and re-probe in the background. Safe to call
+    // from any thread, including OS notification callbacks.
+    void Invalidate();
+
+    void SetChangeListener(DeviceChangeFn listener);
+
+    // Stop the registry thread; pending probes finish first
+    void Stop();
+
+private:
+    void Run();
+    void WaitForSnapshot(std::unique_lock<std::mutex>& lock);
+
+    DeviceProbeFn probe_;
+    DriverInitFn init_;
+    DeviceChangeFn listener_;
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable ready_;
+    std::thread thread_;
+    std::vector<ScannerDevice> devices_;
+    bool driverLoaded_;
+    std::string driverError_;
+    bool hasSnapshot_;
+    bool stale_;
+    bool stopping_;
+};
+
+} // namespace ScannerCore
+
+#endif // SCANNER_CORE_DEVICE_REGISTRY_H
@@ -0,0 +1,242 @@
+/**
+ * Scanner Core File I/O Implementation
+ */
+
+#include "fileIo.h"
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <io.h>
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace ScannerCore {
+
+namespace {
+
+#ifdef _WIN32
+std::wstring WidePath(const std::string& path) {
+    int length = MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, nullptr, 0);
+    if (length <= 0) {
+        return std::wstring();
+    }
+    std::wstring wide(static_cast<size_t>(length), L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, &wide[0], length);
+    return wide;
+}
+#endif
+
+bool Seek(int fd, uint64_t offset) {
+#ifdef _WIN32
+    return _lseeki64(fd, static_cast<__int64>(offset), SEEK_SET) >= 0;
+#else
+    return lseek(fd, static_cast<off_t>(offset), SEEK_SET) >= 0;
+#endif
+}
+
+} // namespace
+
+int OpenFile(const std::string& path, FileMode mode) {
+#ifdef _WIN32
+    std::wstring wide = WidePath(path);
+    if (wide.empty()) {
+        errno = EINVAL;
+        return -1;
+    }
+    int flags = _O_BINARY;
+    switch (mode) {
+        case FileMode::Read: flags |= _O_RDONLY; break;
+        case FileMode::WriteTruncate: flags |= _O_WRONLY | _O_CREAT | _O_TRUNC; break;
+        case FileMode::ReadWrite: flags |= _O_RDWR | _O_CREAT; break;
+    }
+    return _wopen(wide.c_str(), flags, _S_IREAD | _S_IWRITE);
+#else
+    int flags = O_CLOEXEC;
+    switch (mode) {
+        case FileMode::Read: flags |= O_RDONLY; break;
+        case FileMode::WriteTruncate: flags |= O_WRONLY | O_CREAT | O_TRUNC; break;
+        case FileMode::ReadWrite: flags |= O_RDWR | O_CREAT; break;
+    }
+    return open(path.c_str(), flags, 0644);
+#endif
+}
+
+bool WriteAll(int fd, const void* data, size_t size) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    while (size > 0) {
+#ifdef _WIN32
+        int chunk = static_cast<int>(size > 0x40000000 ? 0x40000000 : size);
+        int written = _write(fd, bytes, static_cast<unsigned>(chunk));
+#else
+        ssize_t written = write(fd, bytes, size);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+#endif
+        if (written <= 0) {
+            return false;
+        }
+        bytes += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+bool WriteAt(int fd, uint64_t offset, const void* data, size_t size) {
+    return Seek(fd, offset) && WriteAll(fd, data, size);
+}
+
+bool ReadAt(int fd, uint64_t offset, void* data, size_t size) {
+    if (!Seek(fd, offset)) {
+        return false;
+    }
+    uint8_t* bytes = static_cast<uint8_t*>(data);
+    while (size > 0) {
+#ifdef _WIN32
+        int chunk = static_cast<int>(size > 0x40000000 ? 0x40000000 : size);
+        int got = _read(fd, bytes, static_cast<unsigned>(chunk));
+#else
+        ssize_t got = read(fd, bytes, size);
+        if (got < 0 && errno == EINTR) {
+            continue;
+        }
+#endif
+        if (got <= 0) {
+            return false;
+        }
+        bytes += got;
+        size -= static_cast<size_t>(got);
+    }
+    return true;
+}
+
+bool RemoveFile(const std::string& path) {
+#ifdef _WIN32
+    std::wstring wide = WidePath(path);
+    if (wide.empty()) {
+        errno = EINVAL;
+        return false;
+    }
+    // A mapped file cannot be deleted outright, and a delete-pending name
+    // cannot be created again, so the old file moves out of the way first
+    static std::atomic<unsigned> counter{0};
+    std::wstring aside = wide + L".old-" + std::to_wstring(GetCurrentProcessId()) + L"-" +
+                         std::to_wstring(counter++);
+    if (!MoveFileExW(wide.c_str(), aside.c_str(), MOVEFILE_REPLACE_EXISTING)) {
+        const DWORD code = GetLastError();
+        if (code == ERROR_FILE_NOT_FOUND || code == ERROR_PATH_NOT_FOUND) {
+            return true;
+        }
+        errno = EACCES;
+        return false;
+    }
+    DeleteFileW(aside.c_str());
+    return true;
+#else
+    return unlink(path.c_str()) == 0 || errno == ENOENT;
+#endif
+}
+
+uint64_t FileSize(int fd) {
+#ifdef _WIN32
+    struct _stat64 info;
+    return _fstat64(fd, &info) == 0 ? static_cast<uint64_t>(info.st_size) : 0;
+#else
+    struct stat info;
+    return fstat(fd, &info) == 0 ? static_cast<uint64_t>(info.st_size) : 0;
+#endif
+}
+
+bool SyncFile(int fd) {
+#ifdef _WIN32
+    return _commit(fd) == 0;
+#else
+    return fsync(fd) == 0;
+#endif
+}
+
+bool CloseFile(int fd) {
+#ifdef _WIN32
+    return _close(fd) == 0;
+#else
+    return close(fd) == 0;
+#endif
+}
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+bool MappedFile::Open(const std::string& path, std::string& error) {
+    Close();
+
+#ifdef _WIN32
+    // FILE_SHARE_DELETE lets RemoveFile() move the file away while mapped
+    HANDLE file = CreateFileW(WidePath(path).c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                              nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        error = "Cannot open " + path;
+        return false;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        CloseHandle(file);
+        error = "Empty or unreadable file: " + path;
+        return false;
+    }
+    mapping_ = CreateFileMappingW(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (!mapping_) {
+        error = "Cannot map " + path;
+        return false;
+    }
+    data_ = static_cast<const uint8_t*>(MapViewOfFile(mapping_, FILE_MAP_COPY, 0, 0, 0));
+    if (!data_) {
+        CloseHandle(mapping_);
+        mapping_ = nullptr;
+        error = "Cannot map " + path;
+        return false;
+    }
+    size_ = static_cast<size_t>(size.QuadPart);
+#else
+    int fd = OpenFile(path, FileMode::Read);
+    if (fd < 0) {
+        error = "Cannot open " + path + ": " + std::strerror(errno);
+        return false;
+    }
+    const uint64_t size = FileSize(fd);
+    void* view = size > 0 ? mmap(nullptr, static_cast<size_t>(size), PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+    CloseFile(fd);
+    if (view == MAP_FAILED) {
+        error = "Cannot map " + path;
+        return false;
+    }
+    data_ = static_cast<const uint8_t*>(view);
+    size_ = static_cast<size_t>(size);
+#endif
+    return true;
+}
+
+void MappedFile::Close() {
+    if (!data_) {
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(data_);
+    CloseHandle(mapping_);
+    mapping_ = nullptr;
+#else
+    munmap(const_cast<uint8_t*>(data_), size_);
+#endif
+    data_ = nullptr;
+    size_ = 0;
+}
+
+} // namespace ScannerCore
@@ -0,0 +1,70 @@
+/**
+ * Scanner Core File I/O
+ *
+ * Thin portable layer over POSIX and CRT file descriptors for the
+ * native writers (PDF output, page spool), with UTF-8 paths on every
+ * platform, plus a whole-file memory mapping for zero-copy readers.
+ */
+
+#ifndef SCANNER_CORE_FILE_IO_H
+#define SCANNER_CORE_FILE_IO_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace ScannerCore {
+
+enum class FileMode {
+    Read,           // existing file, read only
+    WriteTruncate,  // create or empty, write only
+    ReadWrite       // create if missing, keep contents
+};
+
+// File descriptor, or -1 with errno set
+int OpenFile(const std::string& path, FileMode mode);
+
+bool WriteAll(int fd, const void* data, size_t size);
+bool WriteAt(int fd, uint64_t offset, const void* data, size_t size);
+bool ReadAt(int fd, uint64_t offset, void* data, size_t size);
+
+// Remove the file at `path` (true if there was none). Open descriptors
+// and MappedFile views of it stay valid; on Windows it is renamed aside
+// and deleted once the last view closes.
+bool RemoveFile(const std::string& path);
+uint64_t FileSize(int fd);
+
+// Flush file contents to the device
+bool SyncFile(int fd);
+bool CloseFile(int fd);
+
+/**
+ * Whole-file mapping of an existing file, valid until Close(). The view
+ * is copy-on-write: writes through it (e.g. by JavaScript code given a
+ * Buffer over it) stay private and never reach the file.
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool Open(const std::string& path, std::string& error);
+    void Close();
+
+    const uint8_t* Data() const { return data_; }
+    size_t Size() const { return size_; }
+
+private:
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+#ifdef _WIN32
+    void* mapping_ = nullptr;
+#endif
+};
+
+} // namespace ScannerCore
+
+#endif // SCANNER_CORE_FILE_IO_H
@@ -0,0 +1,70 @@
+/**
+ * Scanner Core Page Encoder Implementation
+ */
+
+#include "imageEncoder.h"
+#include "bitonalSink.h"
+#include "ccittG4Encoder.h"
+#include "jpegEncoder.h"
+#include <algorithm>
+
+namespace ScannerCore {
+
+const char* ImageEncodingName(ImageEncoding encoding) {
+    switch (encoding) {
+        case ImageEncoding::Raw: return "raw";
+        case ImageEncoding::Jpeg: return "jpeg";
+        case ImageEncoding::CcittG4: return "ccitt-g4";
+    }
+    return "raw";
+}
+
+ImageEncoding EncodingForSettings(const ScanSettings& settings) {
+    // Natively binarized pages are 1 bpp, which JPEG cannot carry
+    if (BinarizeEnabled(settings) && settings.compression != "none") {
+        return ImageEncoding::CcittG4;
+    }
+    if (settings.compression == "jpeg") {
+        return ImageEncoding::Jpeg;
+    }
+    if (settings.compression == "ccitt-g4") {
+        return ImageEncoding::CcittG4;
+    }
+    if (settings.compression == "auto") {
+        return settings.colorMode == "blackwhite" ? ImageEncoding::CcittG4 : ImageEncoding::Jpeg;
+    }
+    return ImageEncoding::Raw;
+}
+
+bool ParseImageEncoding(const std::string& name, ImageEncoding& encoding) {
+    for (ImageEncoding candidate : {ImageEncoding::Raw, ImageEncoding::Jpeg, ImageEncoding::CcittG4}) {
+        if (name == ImageEncodingName(candidate)) {
+            encoding = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+ImageEncoding TransferEncodingFor(const ScanSettings& settings, const std::vector<ImageEncoding>& supported) {
+    if (settings.preview || BinarizeEnabled(settings)) {
+        return ImageEncoding::Raw;
+    }
+    const ImageEncoding wanted = EncodingForSettings(settings);
+    if (wanted == ImageEncoding::Raw ||
+        std::find(supported.begin(), supported.end(), wanted) == supported.end()) {
+        return ImageEncoding::Raw;
+    }
+    return wanted;
+}
+
+std::unique_ptr<PageEncoder> CreatePageEncoder(ImageEncoding encoding, int jpegQuality) {
+    switch (encoding) {
+        case ImageEncoding::Jpeg: return std::make_unique<JpegEncoder>(jpegQuality);
+        case ImageEncoding::CcittG4: return std::make_unique<CcittG4Encoder>();
+        case ImageEncoding::Raw: break;
+    }
+    return nullptr;
+}
+
+} // namespace ScannerCore
@@ -0,0 +1,82 @@
+/**
+ * Scanner Core Page Encoder
+ *
+ * Compresses a page band by band as it is acquired, so only the encoded
+ * bytes have to be kept for the whole page. JPEG is used for gray and
+ * color pages, CCITT Group 4 for black & white.
+ */
+
+#ifndef SCANNER_CORE_IMAGE_ENCODER_H
+#define SCANNER_CORE_IMAGE_ENCODER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "scanTypes.h"
+
+namespace ScannerCore {
+
+struct PageGeometry;
+
+/**
+ * Encoding name exposed to JavaScript ("raw", "jpeg", "ccitt-g4")
+ */
+const char* ImageEncodingName(ImageEncoding encoding);
+
+/**
+ * Encoding to use for the requested compression and color mode.
+ * "auto" picks CCITT G4 for black & white and JPEG otherwise; pages
+ * binarized natively are always CCITT G4 when compressed.
+ */
+ImageEncoding EncodingForSettings(const ScanSettings& settings);
+
+/**
+ * Parse an encoding name; false for anything else
+ */
+bool ParseImageEncoding(const std::string& name, ImageEncoding& encoding);
+
+/**
+ * Compressed transfer to negotiate with a device that can encode pages
+ * in hardware (`supported`, from ScanSession::transferEncodings). This
+ * is the encoding EncodingForSettings() would pick, so the device's
+ * stream can go into the result and the PDF unchanged; Raw when the
+ * device cannot produce it or the scan needs pixels (native
+ * binarization, previews).
+ */
+ImageEncoding TransferEncodingFor(const ScanSettings& settings, const std::vector<ImageEncoding>& supported);
+
+/**
+ * Streaming page encoder. Rows are fed in order on the acquisition
+ * thread; Finish() produces the encoded bytes.
+ */
+class PageEncoder {
+public:
+    virtual ~PageEncoder() = default;
+
+    virtual bool Begin(const PageGeometry& geometry, std::string& error) = 0;
+
+    // Rows use the page geometry's pixel format and stride
+    virtual bool WriteRows(const uint8_t* data, int rows, std::string& error) = 0;
+
+    // `rows` is the number of scanlines actually delivered
+    virtual bool Finish(int rows, std::string& error) = 0;
+
+    // Height written to the encoded stream (may exceed the delivered rows)
+    virtual int EncodedHeight() const = 0;
+
+    // Bytes encoded so far
+    virtual size_t EncodedSize() const = 0;
+
+    virtual std::shared_ptr<PixelBuffer> TakeOutput() = 0;
+};
+
+/**
+ * Create the encoder for an encoding, or nullptr for ImageEncoding::Raw
+ */
+std::unique_ptr<PageEncoder> CreatePageEncoder(ImageEncoding encoding, int jpegQuality);
+
+} // namespace ScannerCore
+
+#endif // SCANNER_CORE_IMAGE_ENCODER_H
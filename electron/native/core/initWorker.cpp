@@ -0,0 +1,42 @@
+/**
+ * Scanner Core Driver Init Worker Implementation
+ */
+
+#include "initWorker.h"
+
+namespace ScannerCore {
+
+InitWorker::InitWorker(Napi::Env env, std::shared_ptr<DeviceRegistry> registry)
+    : Napi::AsyncWorker(env, "ScannerInitialize"),
+      deferred_(Napi::Promise::Deferred::New(env)),
+      registry_(std::move(registry)) {}
+
+Napi::Promise InitWorker::GetPromise() const {
+    return deferred_.Promise();
+}
+
+void InitWorker::Execute() {
+    // Worker thread: the driver loads on the registry thread, this one waits
+    std::string error;
+    if (!registry_->WaitReady(error)) {
+        SetError(error);
+    }
+}
+
+void InitWorker::OnOK() {
+    deferred_.Resolve(Napi::Boolean::New(Env(), true));
+}
+
+void InitWorker::OnError(const Napi::Error& error) {
+    deferred_.Reject(error.Value());
+}
+
+Napi::Value QueueInitialize(Napi::Env env, const std::shared_ptr<DeviceRegistry>& registry) {
+    registry->Start();
+    InitWorker* worker = new InitWorker(env, registry);
+    Napi::Promise promise = worker->GetPromise();
+    worker->Queue();
+    return promise;
+}
+
+} // namespace ScannerCore
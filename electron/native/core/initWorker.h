@@ -0,0 +1,46 @@
+/**
+ * Scanner Core Driver Init Worker
+ *
+ * Backs initialize(): waits on the libuv thread pool for the device
+ * registry to load the driver and finish its first probe, then settles
+ * a Promise. Nothing is loaded when the addon is required, so the app
+ * can require it at startup and initialize() it on first scanner use
+ * or from an idle warm-up after the first window has painted. Repeated
+ * calls resolve at once from the loaded driver.
+ */
+
+#ifndef SCANNER_CORE_INIT_WORKER_H
+#define SCANNER_CORE_INIT_WORKER_H
+
+#include <napi.h>
+#include <memory>
+#include <string>
+#include "deviceRegistry.h"
+
+namespace ScannerCore {
+
+class InitWorker : public Napi::AsyncWorker {
+public:
+    InitWorker(Napi::Env env, std::shared_ptr<DeviceRegistry> registry);
+
+    Napi::Promise GetPromise() const;
+
+protected:
+    void Execute() override;
+    void OnOK() override;
+    void OnError(const Napi::Error& error) override;
+
+private:
+    Napi::Promise::Deferred deferred_;
+    std::shared_ptr<DeviceRegistry> registry_;
+};
+
+/**
+ * Start the registry and return a Promise that resolves to true once
+ * the driver is loaded, or rejects with the driver's error
+ */
+Napi::Value QueueInitialize(Napi::Env env, const std::shared_ptr<DeviceRegistry>& registry);
+
+} // namespace ScannerCore
+
+#endif // SCANNER_CORE_INIT_WORKER_H
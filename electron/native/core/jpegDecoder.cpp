@@ -0,0 +1,177 @@
+/**
+ * Scanner Core JPEG Decoder Implementation
+ */
+
+#include "jpegDecoder.h"
+#include <algorithm>
+#include <csetjmp>
+#include <cstdio>
+#include <cstring>
+
+extern "C" {
+#include <jpeglib.h>
+#include <jerror.h>
+}
+
+namespace ScannerCore {
+
+namespace {
+
+// Compressed bytes requested from the source per fill
+constexpr size_t kInputChunk = 64 * 1024;
+
+// Scanlines handed to jpeg_read_scanlines per call
+constexpr int kReadBatchRows = 16;
+
+const JOCTET kFakeEoi[] = {0xFF, JPEG_EOI};
+
+} // namespace
+
+/**
+ * libjpeg state. Errors, including a failing source, longjmp back into
+ * the JpegDecoder call that triggered them instead of calling exit().
+ */
+struct JpegDecoder::Codec {
+    jpeg_decompress_struct cinfo;
+    jpeg_error_mgr jerr;
+    jpeg_source_mgr src;
+    std::jmp_buf jump;
+    char message[JMSG_LENGTH_MAX];
+    JpegDecoder* owner;
+    bool finished = false;
+
+    static void ErrorExit(j_common_ptr cinfo) {
+        Codec* codec = static_cast<Codec*>(cinfo->client_data);
+        (*cinfo->err->format_message)(cinfo, codec->message);
+        std::longjmp(codec->jump, 1);
+    }
+
+    static void InitSource(j_decompress_ptr) {}
+
+    static boolean FillInputBuffer(j_decompress_ptr cinfo) {
+        Codec* codec = static_cast<Codec*>(cinfo->client_data);
+        JpegDecoder* owner = codec->owner;
+        long read;
+        {
+            std::string error;
+            read = owner->source_(owner->input_.data(), owner->input_.size(), error);
+            if (read < 0) {
+                std::snprintf(codec->message, sizeof(codec->message), "%s", error.c_str());
+            }
+        }
+        if (read < 0) {
+            std::longjmp(codec->jump, 1);
+        }
+        if (read == 0) {
+            // Truncated stream: end the image so the rows decoded so far stay
+            WARNMS(cinfo, JWRN_JPEG_EOF);
+            cinfo->src->next_input_byte = kFakeEoi;
+            cinfo->src->bytes_in_buffer = sizeof(kFakeEoi);
+            return TRUE;
+        }
+        cinfo->src->next_input_byte = owner->input_.data();
+        cinfo->src->bytes_in_buffer = static_cast<size_t>(read);
+        return TRUE;
+    }
+
+    static void SkipInputData(j_decompress_ptr cinfo, long count) {
+        jpeg_source_mgr* src = cinfo->src;
+        while (count > static_cast<long>(src->bytes_in_buffer)) {
+            count -= static_cast<long>(src->bytes_in_buffer);
+            FillInputBuffer(cinfo);
+        }
+        if (count > 0) {
+            src->next_input_byte += count;
+            src->bytes_in_buffer -= static_cast<size_t>(count);
+        }
+    }
+
+    static void TermSource(j_decompress_ptr) {}
+};
+
+JpegDecoder::JpegDecoder(JpegSourceFn source) : source_(std::move(source)), input_(kInputChunk), stride_(0) {}
+
+JpegDecoder::~JpegDecoder() {
+    if (codec_) {
+        jpeg_destroy_decompress(&codec_->cinfo);
+    }
+}
+
+bool JpegDecoder::Begin(PageGeometry& geometry, std::string& error) {
+    if (codec_) {
+        jpeg_destroy_decompress(&codec_->cinfo);
+        codec_.reset();
+    }
+
+    codec_ = std::make_unique<Codec>();
+    Codec* codec = codec_.get();
+    codec->owner = this;
+
+    codec->cinfo.err = jpeg_std_error(&codec->jerr);
+    codec->jerr.error_exit = Codec::ErrorExit;
+
+    if (setjmp(codec->jump)) {
+        error = codec->message;
+        jpeg_destroy_decompress(&codec->cinfo);
+        codec_.reset();
+        return false;
+    }
+
+    jpeg_create_decompress(&codec->cinfo);
+    codec->cinfo.client_data = codec;
+
+    codec->src.init_source = Codec::InitSource;
+    codec->src.fill_input_buffer = Codec::FillInputBuffer;
+    codec->src.skip_input_data = Codec::SkipInputData;
+    codec->src.resync_to_restart = jpeg_resync_to_restart;
+    codec->src.term_source = Codec::TermSource;
+    codec->src.next_input_byte = nullptr;
+    codec->src.bytes_in_buffer = 0;
+    codec->cinfo.src = &codec->src;
+
+    jpeg_read_header(&codec->cinfo, TRUE);
+    if (codec->cinfo.num_components != 1 && codec->cinfo.num_components != 3) {
+        error = "Device returned an unsupported JPEG stream";
+        jpeg_destroy_decompress(&codec->cinfo);
+        codec_.reset();
+        return false;
+    }
+    codec->cinfo.out_color_space = codec->cinfo.num_components == 1 ? JCS_GRAYSCALE : JCS_RGB;
+    jpeg_start_decompress(&codec->cinfo);
+
+    geometry.width = static_cast<int>(codec->cinfo.output_width);
+    geometry.height = static_cast<int>(codec->cinfo.output_height);
+    geometry.pixelFormat = codec->cinfo.output_components == 1 ? PixelFormat::Gray8 : PixelFormat::Rgb24;
+    geometry.stride = MinStride(geometry.pixelFormat, geometry.width);
+    geometry.encoding = ImageEncoding::Raw;
+    stride_ = static_cast<size_t>(geometry.stride);
+    return true;
+}
+
+int JpegDecoder::ReadRows(uint8_t* out, int rows, std::string& error) {
+    Codec* codec = codec_.get();
+    if (!codec || codec->finished) {
+        return 0;
+    }
+
+    if (setjmp(codec->jump)) {
+        error = codec->message;
+        return -1;
+    }
+
+    jpeg_decompress_struct& cinfo = codec->cinfo;
+    if (cinfo.output_scanline >= cinfo.output_height) {
+        jpeg_finish_decompress(&cinfo);
+        codec->finished = true;
+        return 0;
+    }
+
+    JSAMPROW pointers[kReadBatchRows];
+    const int count = std::min(rows, kReadBatchRows);
+    for (int i = 0; i < count; i++) {
+        pointers[i] = out + stride_ * i;
+    }
+    return static_cast<int>(jpeg_read_scanlines(&cinfo, pointers, static_cast<JDIMENSION>(count)));
+}
+
+} // namespace ScannerCore
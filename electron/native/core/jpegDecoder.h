@@ -0,0 +1,58 @@
+/**
+ * Scanner Core JPEG Decoder
+ *
+ * Streaming libjpeg(-turbo) decoder for devices that only transfer
+ * JPEG (network scanners, SANE_FRAME_JPEG) when the scan needs pixels.
+ * Compressed bytes are pulled from the transport as libjpeg asks for
+ * them and scanlines come out as they are decoded, so neither the
+ * encoded nor the decoded page is ever held whole.
+ */
+
+#ifndef SCANNER_CORE_JPEG_DECODER_H
+#define SCANNER_CORE_JPEG_DECODER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "bandStream.h"
+
+namespace ScannerCore {
+
+/**
+ * Next part of the compressed stream: bytes read into `data`, 0 at the
+ * end of the stream, or -1 with `error` set
+ */
+using JpegSourceFn = std::function<long(uint8_t* data, size_t size, std::string& error)>;
+
+class JpegDecoder {
+public:
+    explicit JpegDecoder(JpegSourceFn source);
+    ~JpegDecoder();
+
+    JpegDecoder(const JpegDecoder&) = delete;
+    JpegDecoder& operator=(const JpegDecoder&) = delete;
+
+    // Read the stream up to the frame header. geometry receives the
+    // decoded page: Gray8 or Rgb24 at the image's own size; the
+    // resolution is left to the caller, JFIF densities are unreliable.
+    bool Begin(PageGeometry& geometry, std::string& error);
+
+    // Decode up to `rows` scanlines into `out` (geometry.stride apart);
+    // returns the rows decoded, 0 once the page is complete, or -1
+    int ReadRows(uint8_t* out, int rows, std::string& error);
+
+private:
+    struct Codec;
+
+    JpegSourceFn source_;
+    std::unique_ptr<Codec> codec_;
+    std::vector<uint8_t> input_;
+    size_t stride_;
+};
+
+} // namespace ScannerCore
+
+#endif // SCANNER_CORE_JPEG_DECODER_H
@@ -0,0 +1,380 @@
+/**
+ * Scanner Core JPEG Encoder Implementation
+ */
+
+#include "jpegEncoder.h"
+#include <algorithm>
+#include <csetjmp>
+#include <cstdio>
+#include <cstring>
+
+extern "C" {
+#include <jpeglib.h>
+}
+
+namespace ScannerCore {
+
+namespace {
+
+// Destination growth step
+constexpr size_t kOutputChunk = 64 * 1024;
+
+// Scanlines handed to jpeg_write_scanlines per call
+constexpr int kWriteBatchRows = 16;
+
+// Sampling strip height: two MCU rows at 4:2:0, so strips never share a block
+constexpr int kEstimateStripRows = 16;
+
+// Fraction of strips compressed by EstimateJpegSize
+constexpr int kEstimateSampleEvery = 8;
+
+constexpr int kMinSearchQuality = 10;
+
+} // namespace
+
+/**
+ * libjpeg state. Errors longjmp back into the JpegEncoder call that
+ * triggered them instead of calling exit().
+ */
+struct JpegEncoder::Codec {
+    jpeg_compress_struct cinfo;
+    jpeg_error_mgr jerr;
+    jpeg_destination_mgr dest;
+    std::jmp_buf jump;
+    char message[JMSG_LENGTH_MAX];
+    std::vector<uint8_t>* output;
+
+    static void ErrorExit(j_common_ptr cinfo) {
+        Codec* codec = static_cast<Codec*>(cinfo->client_data);
+        (*cinfo->err->format_message)(cinfo, codec->message);
+        std::longjmp(codec->jump, 1);
+    }
+
+    static void InitDestination(j_compress_ptr cinfo) {
+        Codec* codec = static_cast<Codec*>(cinfo->client_data);
+        codec->output->resize(kOutputChunk);
+        cinfo->dest->next_output_byte = codec->output->data();
+        cinfo->dest->free_in_buffer = codec->output->size();
+    }
+
+    static boolean EmptyOutputBuffer(j_compress_ptr cinfo) {
+        // Called with the buffer completely full
+        Codec* codec = static_cast<Codec*>(cinfo->client_data);
+        size_t used = codec->output->size();
+        codec->output->resize(used + kOutputChunk);
+        cinfo->dest->next_output_byte = codec->output->data() + used;
+        cinfo->dest->free_in_buffer = kOutputChunk;
+        return TRUE;
+    }
+
+    static void TermDestination(j_compress_ptr cinfo) {
+        Codec* codec = static_cast<Codec*>(cinfo->client_data);
+        codec->output->resize(codec->output->size() - cinfo->dest->free_in_buffer);
+    }
+};
+
+JpegEncoder::JpegEncoder(int quality)
+    : quality_(std::min(100, std::max(1, quality))),
+      geometry_{},
+      components_(0),
+      encodedHeight_(0),
+      started_(false),
+      pendingRows_(0) {}
+
+JpegEncoder::~JpegEncoder() {
+    if (codec_) {
+        jpeg_destroy_compress(&codec_->cinfo);
+    }
+}
+
+bool JpegEncoder::Begin(const PageGeometry& geometry, std::string& error) {
+    // Reusable across pages: drop a codec left behind by a failed page,
+    // but keep the row buffers' capacity
+    if (codec_) {
+        jpeg_destroy_compress(&codec_->cinfo);
+        codec_.reset();
+    }
+
+    geometry_ = geometry;
+    components_ = Channels(geometry.pixelFormat);
+    toEightBit_ = SelectRowTo8(geometry.pixelFormat);
+    encodedHeight_ = 0;
+    started_ = false;
+    pendingRows_ = 0;
+    pending_.clear();
+    output_.clear();
+
+    if (geometry.width <= 0 || geometry.width > JPEG_MAX_DIMENSION) {
+        error = "Page width not supported by JPEG";
+        return false;
+    }
+
+    // Unknown height (ADF length detection): compress at Finish()
+    return geometry.height <= 0 || Start(geometry.height, error);
+}
+
+bool JpegEncoder::Start(int height, std::string& error) {
+    if (height > JPEG_MAX_DIMENSION) {
+        error = "Page height not supported by JPEG";
+        return false;
+    }
+
+    codec_ = std::make_unique<Codec>();
+    Codec* codec = codec_.get();
+    codec->output = &output_;
+
+    codec->cinfo.err = jpeg_std_error(&codec->jerr);
+    codec->jerr.error_exit = Codec::ErrorExit;
+
+    if (setjmp(codec->jump)) {
+        error = codec->message;
+        jpeg_destroy_compress(&codec->cinfo);
+        codec_.reset();
+        return false;
+    }
+
+    jpeg_create_compress(&codec->cinfo);
+    codec->cinfo.client_data = codec;
+
+    codec->dest.init_destination = Codec::InitDestination;
+    codec->dest.empty_output_buffer = Codec::EmptyOutputBuffer;
+    codec->dest.term_destination = Codec::TermDestination;
+    codec->cinfo.dest = &codec->dest;
+
+    codec->cinfo.image_width = static_cast<JDIMENSION>(geometry_.width);
+    codec->cinfo.image_height = static_cast<JDIMENSION>(height);
+    codec->cinfo.input_components = components_;
+    codec->cinfo.in_color_space = components_ == 3 ? JCS_RGB : JCS_GRAYSCALE;
+
+    jpeg_set_defaults(&codec->cinfo);
+    jpeg_set_quality(&codec->cinfo, quality_, TRUE);
+    if (geometry_.resolution > 0) {
+        codec->cinfo.density_unit = 1; // dots per inch
+        codec->cinfo.X_density = static_cast<UINT16>(geometry_.resolution);
+        codec->cinfo.Y_density = static_cast<UINT16>(geometry_.resolution);
+    }
+
+    jpeg_start_compress(&codec->cinfo, TRUE);
+
+    started_ = true;
+    encodedHeight_ = height;
+    return true;
+}
+
+bool JpegEncoder::NeedsConversion() const {
+    return toEightBit_ != nullptr;
+}
+
+void JpegEncoder::ConvertRow(const uint8_t* src, uint8_t* dst) const {
+    if (toEightBit_) {
+        toEightBit_(src, geometry_.width, dst);
+    } else {
+        std::memcpy(dst, src, static_cast<size_t>(geometry_.width) * components_);
+    }
+}
+
+bool JpegEncoder::Compress(const uint8_t* rows8, int rows, std::string& error) {
+    Codec* codec = codec_.get();
+    const size_t rowBytes = static_cast<size_t>(geometry_.width) * components_;
+
+    if (setjmp(codec->jump)) {
+        error = codec->message;
+        return false;
+    }
+
+    JSAMPROW pointers[kWriteBatchRows];
+    int row = 0;
+    while (row < rows && codec->cinfo.next_scanline < codec->cinfo.image_height) {
+        int count = std::min(rows - row, kWriteBatchRows);
+        for (int i = 0; i < count; i++) {
+            pointers[i] = const_cast<JSAMPROW>(rows8 + (row + i) * rowBytes);
+        }
+        row += static_cast<int>(jpeg_write_scanlines(&codec->cinfo, pointers, static_cast<JDIMENSION>(count)));
+    }
+
+    return true;
+}
+
+bool JpegEncoder::WriteRows(const uint8_t* data, int rows, std::string& error) {
+    const size_t rowBytes = static_cast<size_t>(geometry_.width) * components_;
+
+    if (!started_) {
+        size_t offset = pending_.size();
+        pending_.resize(offset + rows * rowBytes);
+        for (int y = 0; y < rows; y++) {
+            ConvertRow(data + static_cast<size_t>(y) * geometry_.stride, pending_.data() + offset + y * rowBytes);
+        }
+        pendingRows_ += rows;
+        return true;
+    }
+
+    if (!NeedsConversion() && static_cast<size_t>(geometry_.stride) == rowBytes) {
+        return Compress(data, rows, error);
+    }
+
+    scratch_.resize(rows * rowBytes);
+    for (int y = 0; y < rows; y++) {
+        ConvertRow(data + static_cast<size_t>(y) * geometry_.stride, scratch_.data() + y * rowBytes);
+    }
+    return Compress(scratch_.data(), rows, error);
+}
+
+bool JpegEncoder::Finish(int /*rows*/, std::string& error) {
+    if (!started_) {
+        if (pendingRows_ == 0) {
+            error = "Driver returned no image data";
+            return false;
+        }
+        if (!Start(pendingRows_, error) || !Compress(pending_.data(), pendingRows_, error)) {
+            return false;
+        }
+        pending_.clear();
+    }
+
+    Codec* codec = codec_.get();
+
+    // Short page: pad with white so the declared height is complete
+    const size_t rowBytes = static_cast<size_t>(geometry_.width) * components_;
+    int missing = static_cast<int>(codec->cinfo.image_height - codec->cinfo.next_scanline);
+    if (missing > 0) {
+        scratch_.assign(std::min(missing, kWriteBatchRows) * rowBytes, 255);
+        while (missing > 0) {
+            int count = std::min(missing, kWriteBatchRows);
+            if (!Compress(scratch_.data(), count, error)) {
+                return false;
+            }
+            missing -= count;
+        }
+    }
+
+    if (setjmp(codec->jump)) {
+        error = codec->message;
+        return false;
+    }
+    jpeg_finish_compress(&codec->cinfo);
+    jpeg_destroy_compress(&codec->cinfo);
+    codec_.reset();
+
+    return true;
+}
+
+size_t JpegEncoder::EncodedSize() const {
+    // While compressing, the tail of the output is unused destination space
+    return codec_ ? output_.size() - codec_->dest.free_in_buffer : output_.size();
+}
+
+std::vector<uint8_t> JpegEncoder::TakeBytes() {
+    return std::move(output_);
+}
+
+std::shared_ptr<PixelBuffer> JpegEncoder::TakeOutput() {
+    return std::make_shared<PixelBuffer>(TakeBytes());
+}
+
+bool EncodeJpeg(const uint8_t* data,
+                const PageGeometry& geometry,
+                int quality,
+                std::vector<uint8_t>& output,
+                std::string& error) {
+    JpegEncoder encoder(quality);
+    if (!encoder.Begin(geometry, error) ||
+        !encoder.WriteRows(data, geometry.height, error) ||
+        !encoder.Finish(geometry.height, error)) {
+        return false;
+    }
+    output = encoder.TakeBytes();
+    return true;
+}
+
+size_t EstimateJpegSize(const uint8_t* data, const PageGeometry& geometry, int quality) {
+    const int strips = geometry.height / kEstimateStripRows;
+    if (strips < kEstimateSampleEvery * 2) {
+        std::vector<uint8_t> output;
+        std::string error;
+        return EncodeJpeg(data, geometry, quality, output, error) ? output.size() : 0;
+    }
+
+    // Every Nth strip, compressed back to back as one shorter image
+    const int sampled = strips / kEstimateSampleEvery;
+    PageGeometry sample = geometry;
+    sample.height = sampled * kEstimateStripRows;
+
+    JpegEncoder encoder(quality);
+    std::string error;
+    if (!encoder.Begin(sample, error)) {
+        return 0;
+    }
+    const size_t stripBytes = static_cast<size_t>(kEstimateStripRows) * geometry.stride;
+    for (int i = 0; i < sampled; i++) {
+        const uint8_t* strip = data + static_cast<size_t>(i * kEstimateSampleEvery + kEstimateSampleEvery / 2) * stripBytes;
+        if (!encoder.WriteRows(strip, kEstimateStripRows, error)) {
+            return 0;
+        }
+    }
+    if (!encoder.Finish(sample.height, error)) {
+        return 0;
+    }
+
+    return static_cast<size_t>(static_cast<double>(encoder.EncodedSize()) * geometry.height / sample.height);
+}
+
+bool EncodeJpegToSize(const uint8_t* data,
+                      const PageGeometry& geometry,
+                      size_t targetBytes,
+                      int maxQuality,
+                      std::vector<uint8_t>& output,
+                      int& quality,
+                      std::string& error) {
+    // Highest quality whose estimate fits; the estimate is monotonic in quality
+    int low = kMinSearchQuality;
+    int high = std::min(100, std::max(low, maxQuality));
+    quality = low;
+    while (low <= high) {
+        int mid = (low + high) / 2;
+        if (EstimateJpegSize(data, geometry, mid) <= targetBytes) {
+            quality = mid;
+            low = mid + 1;
+        } else {
+            high = mid - 1;
+        }
+    }
+
+    return EncodeJpeg(data, geometry, quality, output, error);
+}
+
+bool ReadJpegFrame(const uint8_t* data, size_t size, int& width, int& height, int& components) {
+    if (size < 4 || data[0] != 0xFF || data[1] != 0xD8) {
+        return false;
+    }
+
+    size_t pos = 2;
+    while (pos + 4 <= size) {
+        if (data[pos] != 0xFF) {
+            return false;
+        }
+        const uint8_t marker = data[pos + 1];
+        if (marker == 0xFF) {
+            pos++;  // fill byte
+            continue;
+        }
+        const size_t length = (static_cast<size_t>(data[pos + 2]) << 8) | data[pos + 3];
+        // SOF0..SOF15 except DHT (C4), JPG (C8) and DAC (CC)
+        if (marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC) {
+            if (length < 8 || pos + 2 + length > size) {
+                return false;
+            }
+            const uint8_t* frame = data + pos + 4;
+            height = (frame[1] << 8) | frame[2];
+            width = (frame[3] << 8) | frame[4];
+            components = frame[5];
+            return true;
+        }
+        if (marker == 0xDA || length < 2) {
+            return false;  // scan data before any frame header
+        }
+        pos += 2 + length;
+    }
+    return false;
+}
+
+} // namespace ScannerCore
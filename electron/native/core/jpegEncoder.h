@@ -0,0 +1,96 @@
+/**
+ * Scanner Core JPEG Encoder
+ *
+ * Baseline JFIF encoder on top of libjpeg(-turbo). Pages with a known
+ * height are compressed scanline by scanline while the driver is still
+ * transferring; pages of unknown length are converted to 8-bit rows and
+ * compressed once the final height is known.
+ */
+
+#ifndef SCANNER_CORE_JPEG_ENCODER_H
+#define SCANNER_CORE_JPEG_ENCODER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "bandStream.h"
+#include "imageEncoder.h"
+#include "pixelKernels.h"
+
+namespace ScannerCore {
+
+class JpegEncoder : public PageEncoder {
+public:
+    explicit JpegEncoder(int quality);
+    ~JpegEncoder() override;
+
+    bool Begin(const PageGeometry& geometry, std::string& error) override;
+    bool WriteRows(const uint8_t* data, int rows, std::string& error) override;
+    bool Finish(int rows, std::string& error) override;
+
+    int EncodedHeight() const override { return encodedHeight_; }
+    size_t EncodedSize() const override;
+    std::shared_ptr<PixelBuffer> TakeOutput() override;
+    std::vector<uint8_t> TakeBytes();
+
+private:
+    struct Codec;
+
+    bool Start(int height, std::string& error);
+    bool Compress(const uint8_t* rows8, int rows, std::string& error);
+    void ConvertRow(const uint8_t* src, uint8_t* dst) const;
+    bool NeedsConversion() const;
+
+    int quality_;
+    PageGeometry geometry_;
+    int components_;
+    RowTo8Fn toEightBit_ = nullptr;  // null when rows are already 8-bit
+    int encodedHeight_;
+    bool started_;
+    std::unique_ptr<Codec> codec_;
+    std::vector<uint8_t> output_;
+    std::vector<uint8_t> scratch_;  // converted rows of the current band
+    std::vector<uint8_t> pending_;  // converted rows while the height is unknown
+    int pendingRows_;
+};
+
+/**
+ * Estimate the JPEG size of a page at a quality by compressing evenly
+ * spaced 16-row strips and scaling up.
+ */
+size_t EstimateJpegSize(const uint8_t* data, const PageGeometry& geometry, int quality);
+
+/**
+ * Encode a whole page at the highest quality whose estimated size fits
+ * targetBytes. The quality search runs on the sampled estimate, so the
+ * full page is compressed only once.
+ */
+bool EncodeJpegToSize(const uint8_t* data,
+                      const PageGeometry& geometry,
+                      size_t targetBytes,
+                      int maxQuality,
+                      std::vector<uint8_t>& output,
+                      int& quality,
+                      std::string& error);
+
+/**
+ * Encode a whole page at a fixed quality
+ */
+bool EncodeJpeg(const uint8_t* data,
+                const PageGeometry& geometry,
+                int quality,
+                std::vector<uint8_t>& output,
+                std::string& error);
+
+/**
+ * Frame size and component count from the SOF marker of a JPEG stream,
+ * for pages the device compressed itself. False if no frame header is
+ * found.
+ */
+bool ReadJpegFrame(const uint8_t* data, size_t size, int& width, int& height, int& components);
+
+} // namespace ScannerCore
+
+#endif // SCANNER_CORE_JPEG_ENCODER_H
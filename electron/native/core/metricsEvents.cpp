@@ -0,0 +1,52 @@
+/**
+ * Scanner Core Metrics Events Implementation
+ */
+
+#include "metricsEvents.h"
+#include "napiConvert.h"
+
+namespace ScannerCore {
+
+namespace {
+
+struct MetricsEvent {
+    int sessionId;
+    std::string deviceId;
+    PageMetrics page;
+};
+
+// Events waiting for the JavaScript thread; telemetry is not worth
+// blocking the acquisition for
+constexpr size_t kMaxQueuedMetricsEvents = 64;
+
+} // namespace
+
+MetricsEventEmitter::MetricsEventEmitter(Napi::Env env, Napi::Function callback) {
+    tsfn_ = Napi::ThreadSafeFunction::New(env, callback, "ScannerMetricsEvents", kMaxQueuedMetricsEvents, 1);
+    // Telemetry must not keep the process alive
+    tsfn_.Unref(env);
+}
+
+MetricsEventEmitter::~MetricsEventEmitter() {
+    tsfn_.Release();
+}
+
+void MetricsEventEmitter::Emit(int sessionId, const std::string& deviceId, const PageMetrics& page) {
+    MetricsEvent* event = new MetricsEvent{sessionId, deviceId, page};
+    napi_status status = tsfn_.NonBlockingCall(event, [](Napi::Env env, Napi::Function callback, MetricsEvent* data) {
+        if (env != nullptr) {
+            Napi::Object obj = Napi::Object::New(env);
+            obj.Set("sessionId", data->sessionId);
+            obj.Set("deviceId", data->deviceId);
+            obj.Set("page", PageMetricsToObject(env, data->page));
+            callback.Call({obj});
+        }
+        delete data;
+    });
+
+    if (status != napi_ok) {
+        delete event;
+    }
+}
+
+} // namespace ScannerCore
@@ -0,0 +1,35 @@
+/**
+ * Scanner Core Metrics Events
+ *
+ * Forwards finished page metrics to a JavaScript callback as
+ * { sessionId, deviceId, page } objects, where page is a
+ * PageMetricsToObject() record.
+ */
+
+#ifndef SCANNER_CORE_METRICS_EVENTS_H
+#define SCANNER_CORE_METRICS_EVENTS_H
+
+#include <napi.h>
+#include <string>
+#include "scanMetrics.h"
+
+namespace ScannerCore {
+
+class MetricsEventEmitter {
+public:
+    MetricsEventEmitter(Napi::Env env, Napi::Function callback);
+    ~MetricsEventEmitter();
+
+    MetricsEventEmitter(const MetricsEventEmitter&) = delete;
+    MetricsEventEmitter& operator=(const MetricsEventEmitter&) = delete;
+
+    // Safe to call from any thread; drops the event if JavaScript is behind
+    void Emit(int sessionId, const std::string& deviceId, const PageMetrics& page);
+
+private:
+    Napi::ThreadSafeFunction tsfn_;
+};
+
+} // namespace ScannerCore
+
+#endif // SCANNER_CORE_METRICS_EVENTS_H
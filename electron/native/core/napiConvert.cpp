@@ -0,0 +1,395 @@
+/**
+ * Scanner Core N-API Conversions Implementation
+ */
+
+#include "napiConvert.h"
+#include "imageEncoder.h"
+#include "threadPool.h"
+#include "thumbnailPyramid.h"
+#include <algorithm>
+#include <cmath>
+
+namespace ScannerCore {
+
+namespace {
+
+int GetInt(const Napi::Object& obj, const char* key, int fallback) {
+    Napi::Value value = obj.Get(key);
+    return value.IsNumber() ? value.As<Napi::Number>().Int32Value() : fallback;
+}
+
+double GetDouble(const Napi::Object& obj, const char* key, double fallback) {
+    Napi::Value value = obj.Get(key);
+    return value.IsNumber() ? value.As<Napi::Number>().DoubleValue() : fallback;
+}
+
+bool GetBool(const Napi::Object& obj, const char* key, bool fallback) {
+    Napi::Value value = obj.Get(key);
+    return value.IsBoolean() ? value.As<Napi::Boolean>().Value() : fallback;
+}
+
+std::string GetString(const Napi::Object& obj, const char* key, const char* fallback) {
+    Napi::Value value = obj.Get(key);
+    return value.IsString() ? value.As<Napi::String>().Utf8Value() : std::string(fallback);
+}
+
+void ReleasePixels(Napi::Env /*env*/, uint8_t* /*data*/, std::shared_ptr<PixelBuffer>* hint) {
+    delete hint;
+}
+
+void ReleaseSpool(Napi::Env /*env*/, uint8_t* /*data*/, std::shared_ptr<SpoolReader>* hint) {
+    delete hint;
+}
+
+ScanArea ParseScanArea(const Napi::Value& value) {
+    ScanArea area;
+    if (!value.IsObject()) {
+        return area;
+    }
+
+    Napi::Object obj = value.As<Napi::Object>();
+    area.left = GetDouble(obj, "left", 0.0);
+    area.top = GetDouble(obj, "top", 0.0);
+    area.width = GetDouble(obj, "width", 0.0);
+    area.height = GetDouble(obj, "height", 0.0);
+
+    // Anything unusable means "whole paper size" rather than an error
+    if (!std::isfinite(area.left) || !std::isfinite(area.top) || !std::isfinite(area.width) ||
+        !std::isfinite(area.height) || area.left < 0.0 || area.top < 0.0) {
+        return ScanArea{};
+    }
+    return area;
+}
+
+} // namespace
+
+ScanSettings ParseScanSettings(const Napi::Value& value) {
+    ScanSettings settings{300, "color", "auto", false, false, 0, 0};
+
+    if (!value.IsObject()) {
+        return settings;
+    }
+
+    Napi::Object obj = value.As<Napi::Object>();
+    settings.resolution = GetInt(obj, "resolution", settings.resolution);
+    settings.colorMode = GetString(obj, "colorMode", "color");
+    settings.paperSize = GetString(obj, "paperSize", "auto");
+    settings.useADF = GetBool(obj, "useADF", false);
+    settings.duplex = GetBool(obj, "duplex", false);
+    settings.brightness = GetInt(obj, "brightness", 0);
+    settings.contrast = GetInt(obj, "contrast", 0);
+    settings.compression = GetString(obj, "compression", "none");
+    settings.jpegQuality = GetInt(obj, "jpegQuality", settings.jpegQuality);
+    settings.scanArea = ParseScanArea(obj.Get("scanArea"));
+    settings.usePreviewCrop = GetBool(obj, "usePreviewCrop", false);
+    settings.binarize = GetString(obj, "binarize", "none");
+    settings.binarizeThreshold = GetInt(obj, "binarizeThreshold", settings.binarizeThreshold);
+    settings.highWaterMark = static_cast<size_t>(std::max(0.0, GetDouble(obj, "highWaterMark", 0.0)));
+    settings.skipBlankPages = GetString(obj, "skipBlankPages", "none");
+    settings.blankThreshold = std::max(0.0, GetDouble(obj, "blankThreshold", settings.blankThreshold));
+    settings.separation = GetString(obj, "separation", "none");
+    settings.separatorBarcode = GetString(obj, "separatorBarcode", "");
+    settings.keepSeparators = GetBool(obj, "keepSeparators", false);
+    settings.thumbnailLevels = std::max(0, std::min(GetInt(obj, "thumbnails", 0), kMaxThumbnailLevels));
+
+    return settings;
+}
+
+PdfOutputOptions ParsePdfOutput(const Napi::Value& value) {
+    PdfOutputOptions output;
+
+    if (!value.IsObject()) {
+        return output;
+    }
+
+    Napi::Object obj = value.As<Napi::Object>();
+    output.path = GetString(obj, "pdfPath", "");
+    output.info.title = GetString(obj, "title", "");
+    output.info.author = GetString(obj, "author", "");
+    output.info.subject = GetString(obj, "subject", "");
+    output.info.creator = GetString(obj, "creator", "PaperFlow");
+    output.info.producer = GetString(obj, "producer", "PaperFlow");
+
+    // Keywords may be a string or a string[] (PDFConversionOptions)
+    Napi::Value keywords = obj.Get("keywords");
+    if (keywords.IsArray()) {
+        Napi::Array list = keywords.As<Napi::Array>();
+        for (uint32_t i = 0; i < list.Length(); i++) {
+            Napi::Value keyword = list.Get(i);
+            if (!keyword.IsString()) continue;
+            if (!output.info.keywords.empty()) output.info.keywords += " ";
+            output.info.keywords += keyword.As<Napi::String>().Utf8Value();
+        }
+    } else {
+        output.info.keywords = GetString(obj, "keywords", "");
+    }
+
+    return output;
+}
+
+SpoolOptions ParseSpoolOutput(const Napi::Value& value) {
+    SpoolOptions spool;
+
+    if (!value.IsObject()) {
+        return spool;
+    }
+
+    Napi::Object obj = value.As<Napi::Object>();
+    spool.path = GetString(obj, "spoolPath", "");
+    spool.resume = GetBool(obj, "resume", false);
+    return spool;
+}
+
+Napi::Object CapabilitiesToObject(Napi::Env env, const ScannerCapabilities& capabilities) {
+    Napi::Object obj = Napi::Object::New(env);
+    obj.Set("hasFlatbed", capabilities.hasFlatbed);
+    obj.Set("hasADF", capabilities.hasADF);
+    obj.Set("duplex", capabilities.duplex);
+
+    Napi::Array resolutions = Napi::Array::New(env, capabilities.resolutions.size());
+    for (size_t i = 0; i < capabilities.resolutions.size(); i++) {
+        resolutions.Set(static_cast<uint32_t>(i), capabilities.resolutions[i]);
+    }
+    obj.Set("resolutions", resolutions);
+
+    Napi::Array colorModes = Napi::Array::New(env, capabilities.colorModes.size());
+    for (size_t i = 0; i < capabilities.colorModes.size(); i++) {
+        colorModes.Set(static_cast<uint32_t>(i), capabilities.colorModes[i]);
+    }
+    obj.Set("colorModes", colorModes);
+
+    Napi::Array paperSizes = Napi::Array::New(env, capabilities.paperSizes.size());
+    for (size_t i = 0; i < capabilities.paperSizes.size(); i++) {
+        paperSizes.Set(static_cast<uint32_t>(i), capabilities.paperSizes[i]);
+    }
+    obj.Set("paperSizes", paperSizes);
+
+    obj.Set("maxWidth", capabilities.maxWidth);
+    obj.Set("maxHeight", capabilities.maxHeight);
+
+    Napi::Array compression = Napi::Array::New(env, capabilities.compression.size());
+    for (size_t i = 0; i < capabilities.compression.size(); i++) {
+        compression.Set(static_cast<uint32_t>(i), capabilities.compression[i]);
+    }
+    obj.Set("compression", compression);
+
+    return obj;
+}
+
+Napi::Object DeviceToObject(Napi::Env env, const ScannerDevice& device) {
+    Napi::Object obj = Napi::Object::New(env);
+    obj.Set("id", device.id);
+    obj.Set("name", device.name);
+    obj.Set("manufacturer", device.manufacturer);
+    obj.Set("model", device.model);
+    obj.Set("available", device.available);
+    obj.Set("platform", device.platform);
+    obj.Set("capabilities", CapabilitiesToObject(env, device.capabilities));
+    return obj;
+}
+
+Napi::Array DevicesToArray(Napi::Env env, const std::vector<ScannerDevice>& devices) {
+    Napi::Array array = Napi::Array::New(env, devices.size());
+    for (size_t i = 0; i < devices.size(); i++) {
+        array.Set(static_cast<uint32_t>(i), DeviceToObject(env, devices[i]));
+    }
+    return array;
+}
+
+Napi::Value PixelsToBuffer(Napi::Env env, const std::shared_ptr<PixelBuffer>& pixels) {
+    // Wrap the transfer buffer without copying; the finalizer drops our
+    // reference once JavaScript is done with it. NewOrCopy falls back to
+    // a single copy where external buffers are disallowed (V8 sandbox).
+    auto* hint = new std::shared_ptr<PixelBuffer>(pixels);
+    return Napi::Buffer<uint8_t>::NewOrCopy(env, pixels->Data(), pixels->Size(), ReleasePixels, hint);
+}
+
+Napi::Object ScanAreaToObject(Napi::Env env, const ScanArea& area) {
+    Napi::Object obj = Napi::Object::New(env);
+    obj.Set("left", area.left);
+    obj.Set("top", area.top);
+    obj.Set("width", area.width);
+    obj.Set("height", area.height);
+    return obj;
+}
+
+Napi::Array ThumbnailsToArray(Napi::Env env, const std::vector<PageThumbnail>& thumbnails) {
+    Napi::Array array = Napi::Array::New(env, thumbnails.size());
+    for (size_t i = 0; i < thumbnails.size(); i++) {
+        const PageThumbnail& thumbnail = thumbnails[i];
+        Napi::Object obj = Napi::Object::New(env);
+        obj.Set("width", thumbnail.width);
+        obj.Set("height", thumbnail.height);
+        obj.Set("stride", thumbnail.stride);
+        obj.Set("channels", Channels(thumbnail.pixelFormat));
+        obj.Set("pixelFormat", PixelFormatName(thumbnail.pixelFormat));
+        obj.Set("scale", thumbnail.scale);
+        obj.Set("pixels", PixelsToBuffer(env, thumbnail.pixels));
+        array.Set(static_cast<uint32_t>(i), obj);
+    }
+    return array;
+}
+
+Napi::Object ScanResultToObject(Napi::Env env, const ScanResult& result) {
+    Napi::Object obj = Napi::Object::New(env);
+    obj.Set("success", result.success);
+
+    if (!result.success) {
+        obj.Set("errorMessage", result.errorMessage);
+        return obj;
+    }
+
+    if (result.pixels) {
+        obj.Set("pixels", PixelsToBuffer(env, result.pixels));
+    }
+    if (result.encoded) {
+        obj.Set("data", PixelsToBuffer(env, result.encoded));
+    }
+    obj.Set("encoding", ImageEncodingName(result.encoding));
+
+    obj.Set("width", result.width);
+    obj.Set("height", result.height);
+    obj.Set("stride", result.stride);
+    obj.Set("bitDepth", BitDepth(result.pixelFormat));
+    obj.Set("channels", Channels(result.pixelFormat));
+    obj.Set("pixelFormat", PixelFormatName(result.pixelFormat));
+    obj.Set("resolution", result.resolution);
+    obj.Set("colorMode", result.colorMode);
+    if (result.scanArea.IsSet()) {
+        obj.Set("scanArea", ScanAreaToObject(env, result.scanArea));
+    }
+    if (result.spoolIndex >= 0) {
+        obj.Set("spoolIndex", result.spoolIndex);
+    }
+    if (result.pageIndex >= 0) {
+        obj.Set("pageIndex", result.pageIndex);
+    }
+    if (result.documentIndex >= 0) {
+        obj.Set("documentIndex", result.documentIndex);
+    }
+    if (!result.thumbnails.empty()) {
+        obj.Set("thumbnails", ThumbnailsToArray(env, result.thumbnails));
+    }
+
+    return obj;
+}
+
+Napi::Object SpoolPageToObject(Napi::Env env, const std::shared_ptr<SpoolReader>& spool, int index) {
+    const SpoolPage& page = spool->Page(index);
+    Napi::Object obj = Napi::Object::New(env);
+    obj.Set("success", true);
+
+    // The mapping is copy-on-write, so handing it out writable is safe;
+    // the finalizer keeps it mapped while JavaScript holds the Buffer
+    auto* hint = new std::shared_ptr<SpoolReader>(spool);
+    Napi::Value data = Napi::Buffer<uint8_t>::NewOrCopy(env, const_cast<uint8_t*>(page.data), page.size,
+                                                        ReleaseSpool, hint);
+    obj.Set(page.encoding == ImageEncoding::Raw ? "pixels" : "data", data);
+    obj.Set("encoding", ImageEncodingName(page.encoding));
+
+    obj.Set("width", page.width);
+    obj.Set("height", page.height);
+    obj.Set("stride", page.stride);
+    obj.Set("bitDepth", BitDepth(page.pixelFormat));
+    obj.Set("channels", Channels(page.pixelFormat));
+    obj.Set("pixelFormat", PixelFormatName(page.pixelFormat));
+    obj.Set("resolution", page.resolution);
+    obj.Set("colorMode", page.colorMode);
+    if (page.scanArea.IsSet()) {
+        obj.Set("scanArea", ScanAreaToObject(env, page.scanArea));
+    }
+    obj.Set("spoolIndex", page.index);
+
+    return obj;
+}
+
+Napi::Object ScanBandToObject(Napi::Env env, const ScanBand& band) {
+    Napi::Object obj = Napi::Object::New(env);
+    obj.Set("pageIndex", band.pageIndex);
+    obj.Set("firstRow", band.firstRow);
+    obj.Set("rows", band.rows);
+    obj.Set("lastBand", band.lastBand);
+    obj.Set("width", band.geometry.width);
+    obj.Set("pageHeight", band.geometry.height);
+    obj.Set("stride", band.geometry.stride);
+    obj.Set("bitDepth", BitDepth(band.geometry.pixelFormat));
+    obj.Set("channels", Channels(band.geometry.pixelFormat));
+    obj.Set("pixelFormat", PixelFormatName(band.geometry.pixelFormat));
+    obj.Set("resolution", band.geometry.resolution);
+    obj.Set("pixels", PixelsToBuffer(env, band.pixels));
+    return obj;
+}
+
+namespace {
+
+double NsToMs(uint64_t ns) {
+    return static_cast<double>(ns) / 1e6;
+}
+
+} // namespace
+
+Napi::Object PageMetricsToObject(Napi::Env env, const PageMetrics& page) {
+    Napi::Object stages = Napi::Object::New(env);
+    for (int i = 0; i < kMetricStageCount; i++) {
+        stages.Set(MetricStageName(static_cast<MetricStage>(i)), NsToMs(page.stageNs[i]));
+    }
+
+    Napi::Object obj = Napi::Object::New(env);
+    obj.Set("pageIndex", page.pageIndex);
+    obj.Set("bytesTransferred", static_cast<double>(page.bytesTransferred));
+    obj.Set("stages", stages);
+    return obj;
+}
+
+Napi::Object MetricsToObject(Napi::Env env, const MetricsSnapshot& metrics, const BufferPoolStats& buffers) {
+    Napi::Object stages = Napi::Object::New(env);
+    for (int i = 0; i < kMetricStageCount; i++) {
+        const StageStats& stats = metrics.stages[i];
+        Napi::Object stage = Napi::Object::New(env);
+        stage.Set("count", static_cast<double>(stats.count));
+        stage.Set("totalMs", NsToMs(stats.totalNs));
+        stage.Set("maxMs", NsToMs(stats.maxNs));
+        stage.Set("meanMs", stats.count > 0 ? NsToMs(stats.totalNs) / static_cast<double>(stats.count) : 0.0);
+        stages.Set(MetricStageName(static_cast<MetricStage>(i)), stage);
+    }
+
+    Napi::Object bytes = Napi::Object::New(env);
+    bytes.Set("transferred", static_cast<double>(metrics.bytesTransferred));
+    bytes.Set("encoded", static_cast<double>(metrics.bytesEncoded));
+    bytes.Set("delivered", static_cast<double>(metrics.bytesDelivered));
+
+    Napi::Object queue = Napi::Object::New(env);
+    queue.Set("depth", static_cast<double>(metrics.queueDepth));
+    queue.Set("maxDepth", static_cast<double>(metrics.maxQueueDepth));
+    queue.Set("bytes", static_cast<double>(metrics.queuedBytes));
+    queue.Set("maxBytes", static_cast<double>(metrics.maxQueuedBytes));
+
+    Napi::Object bufferPool = Napi::Object::New(env);
+    bufferPool.Set("hits", static_cast<double>(buffers.hits));
+    bufferPool.Set("misses", static_cast<double>(buffers.misses));
+    bufferPool.Set("pooledBytes", static_cast<double>(buffers.pooledBytes));
+    bufferPool.Set("pooledBuffers", static_cast<double>(buffers.pooledBuffers));
+
+    Imaging::ThreadPool& pool = Imaging::ThreadPool::Shared();
+    Napi::Object threadPool = Napi::Object::New(env);
+    threadPool.Set("threads", pool.ThreadCount());
+    threadPool.Set("queuedTasks", pool.QueuedTasks());
+
+    Napi::Array recent = Napi::Array::New(env, metrics.recentPages.size());
+    for (size_t i = 0; i < metrics.recentPages.size(); i++) {
+        recent.Set(static_cast<uint32_t>(i), PageMetricsToObject(env, metrics.recentPages[i]));
+    }
+
+    Napi::Object obj = Napi::Object::New(env);
+    obj.Set("scans", static_cast<double>(metrics.scans));
+    obj.Set("pages", static_cast<double>(metrics.pages));
+    obj.Set("stages", stages);
+    obj.Set("bytes", bytes);
+    obj.Set("queue", queue);
+    obj.Set("bufferPool", bufferPool);
+    obj.Set("threadPool", threadPool);
+    obj.Set("recentPages", recent);
+    return obj;
+}
+
+} // namespace ScannerCore
@@ -0,0 +1,101 @@
+/**
+ * Scanner Core N-API Conversions
+ *
+ * Conversions between JavaScript objects and the platform-neutral
+ * scanner structs. Must only be called on the JavaScript thread.
+ */
+
+#ifndef SCANNER_CORE_NAPI_CONVERT_H
+#define SCANNER_CORE_NAPI_CONVERT_H
+
+#include <napi.h>
+#include <memory>
+#include <vector>
+#include "bandStream.h"
+#include "bufferPool.h"
+#include "pdfWriter.h"
+#include "scanMetrics.h"
+#include "scanTypes.h"
+#include "spoolFile.h"
+
+namespace ScannerCore {
+
+/**
+ * Read scan settings from a JavaScript ScanSettings object.
+ * Missing fields fall back to 300 dpi color "auto" paper.
+ */
+ScanSettings ParseScanSettings(const Napi::Value& value);
+
+/**
+ * Read batch output options ({ pdfPath, title, author, subject,
+ * keywords, creator, producer }). Returns an empty path when absent.
+ */
+PdfOutputOptions ParsePdfOutput(const Napi::Value& value);
+
+/**
+ * Read batch spool options ({ spoolPath, resume }) from the same object
+ */
+SpoolOptions ParseSpoolOutput(const Napi::Value& value);
+
+/**
+ * Build the JavaScript ScannerCapabilities object
+ */
+Napi::Object CapabilitiesToObject(Napi::Env env, const ScannerCapabilities& capabilities);
+
+/**
+ * Build the JavaScript ScannerDevice object
+ */
+Napi::Object DeviceToObject(Napi::Env env, const ScannerDevice& device);
+
+/**
+ * Build a JavaScript array of ScannerDevice objects
+ */
+Napi::Array DevicesToArray(Napi::Env env, const std::vector<ScannerDevice>& devices);
+
+/**
+ * Wrap native pixels in a Node Buffer without copying where allowed
+ */
+Napi::Value PixelsToBuffer(Napi::Env env, const std::shared_ptr<PixelBuffer>& pixels);
+
+/**
+ * Build a { left, top, width, height } object (inches)
+ */
+Napi::Object ScanAreaToObject(Napi::Env env, const ScanArea& area);
+
+/**
+ * Build a JavaScript array of { width, height, stride, channels,
+ * pixelFormat, scale, pixels } objects, largest level first
+ */
+Napi::Array ThumbnailsToArray(Napi::Env env, const std::vector<PageThumbnail>& thumbnails);
+
+/**
+ * Build the JavaScript result object for a finished scan.
+ */
+Napi::Object ScanResultToObject(Napi::Env env, const ScanResult& result);
+
+/**
+ * Build the JavaScript object for a spooled page. The data Buffer
+ * refers to the spool mapping, which it keeps alive.
+ */
+Napi::Object SpoolPageToObject(Napi::Env env, const std::shared_ptr<SpoolReader>& spool, int index);
+
+/**
+ * Build the JavaScript object for one streamed scanline band.
+ */
+Napi::Object ScanBandToObject(Napi::Env env, const ScanBand& band);
+
+/**
+ * Build { pageIndex, bytesTransferred, stages: { <stage>: ms } } for one
+ * finished page
+ */
+Napi::Object PageMetricsToObject(Napi::Env env, const PageMetrics& page);
+
+/**
+ * Build the JavaScript ScanMetrics object from a counter snapshot and
+ * the session's buffer pool counters
+ */
+Napi::Object MetricsToObject(Napi::Env env, const MetricsSnapshot& metrics, const BufferPoolStats& buffers);
+
+} // namespace ScannerCore
+
+#endif // SCANNER_CORE_NAPI_CONVERT_H
@@ -0,0 +1,124 @@
+/**
+ * Scanner Core Page Queue Implementation
+ */
+
+#include "pageQueue.h"
+#include <algorithm>
+#include <chrono>
+
+namespace ScannerCore {
+
+ByteBudget::ByteBudget(size_t highWaterMark)
+    : highWaterMark_(highWaterMark > 0 ? highWaterMark : kDefaultHighWaterMark) {}
+
+bool ByteBudget::Acquire(size_t bytes) {
+    size_t held = held_.load();
+    for (;;) {
+        if (closed_) {
+            return false;
+        }
+        if (held == 0 || held + bytes <= highWaterMark_) {
+            if (held_.compare_exchange_weak(held, held + bytes)) {
+                return true;
+            }
+            continue;
+        }
+
+        // Over the mark: sleep until Release() or Close(). Both counters
+        // are sequentially consistent, so either Release() sees the waiter
+        // or the re-check below sees the released bytes.
+        std::unique_lock<std::mutex> lock(mutex_);
+        waiters_++;
+        held = held_.load();
+        if (!closed_ && held != 0 && held + bytes > highWaterMark_) {
+            released_.wait(lock);
+            held = held_.load();
+        }
+        waiters_--;
+    }
+}
+
+void ByteBudget::Release(size_t bytes) {
+    held_ -= bytes;
+    if (waiters_ > 0) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        released_.notify_all();
+    }
+}
+
+void ByteBudget::Close() {
+    closed_ = true;
+    std::lock_guard<std::mutex> lock(mutex_);
+    released_.notify_all();
+}
+
+PageQueue::PageQueue(size_t highWaterMark, size_t slots)
+    : ring_(slots),
+      budget_(highWaterMark),
+      slotShare_((budget_.HighWaterMark() + ring_.Capacity() - 1) / ring_.Capacity()) {}
+
+size_t PageQueue::Charge(size_t bytes) const {
+    return std::max(bytes, slotShare_);
+}
+
+size_t PageQueue::Reserve(size_t bytes) {
+    const size_t charged = Charge(bytes);
+    return budget_.Acquire(charged) ? charged : 0;
+}
+
+void PageQueue::Release(size_t charged) {
+    if (charged > 0) {
+        budget_.Release(charged);
+    }
+}
+
+bool PageQueue::Push(ScanResult page, size_t charged) {
+    Entry entry{std::move(page), charged};
+
+    // Charges keep the ring from filling up, so this loop is a fallback.
+    // The ring's indices are not sequentially consistent with waiting_,
+    // so the wait is bounded rather than relying on the wake-up alone.
+    while (!ring_.TryPush(entry)) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        waiting_++;
+        if (!closed_ && ring_.Size() == ring_.Capacity()) {
+            notFull_.wait_for(lock, std::chrono::milliseconds(10));
+        }
+        waiting_--;
+        if (closed_) {
+            Release(charged);
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<ScanResult> PageQueue::PopAll() {
+    std::vector<ScanResult> drained;
+    size_t released = 0;
+    Entry entry;
+    while (ring_.TryPop(entry)) {
+        drained.push_back(std::move(entry.page));
+        released += entry.charged;
+    }
+
+    Release(released);
+    if (waiting_ > 0) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        notFull_.notify_all();
+    }
+    return drained;
+}
+
+void PageQueue::Close() {
+    closed_ = true;
+    budget_.Close();
+    std::lock_guard<std::mutex> lock(mutex_);
+    notFull_.notify_all();
+}
+
+size_t PageQueue::Size() const {
+    return ring_.Size();
+}
+
+} // namespace ScannerCore
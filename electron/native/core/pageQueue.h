@@ -0,0 +1,113 @@
+/**
+ * Scanner Core Page Queue
+ *
+ * Back-pressure between the acquisition thread, the processing pool and
+ * the JavaScript thread. Pages travel through a lock-free SPSC ring; the
+ * memory they hold is accounted in bytes against a high-water mark, and
+ * the acquisition thread reserves a page's bytes before the driver moves
+ * on. Once the mark is reached the reservation blocks, which pauses the
+ * transfer (the next sheet is not started, bands are not read) rather
+ * than letting buffered pages grow without limit.
+ */
+
+#ifndef SCANNER_CORE_PAGE_QUEUE_H
+#define SCANNER_CORE_PAGE_QUEUE_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+#include "scanTypes.h"
+#include "spscRing.h"
+
+namespace ScannerCore {
+
+/**
+ * Default bytes buffered between acquisition and JavaScript
+ */
+constexpr size_t kDefaultHighWaterMark = 256u * 1024 * 1024;
+
+/**
+ * Page slots in the ring (the byte mark normally binds first)
+ */
+constexpr size_t kPageQueueSlots = 64;
+
+/**
+ * Byte counter with a high-water mark. Acquire() and Release() are
+ * lock-free until a caller has to wait.
+ */
+class ByteBudget {
+public:
+    explicit ByteBudget(size_t highWaterMark = kDefaultHighWaterMark);
+
+    // Block until bytes fit under the mark. A request is always admitted
+    // when nothing is held, so one oversized page cannot stall the scan.
+    // Returns false once closed.
+    bool Acquire(size_t bytes);
+
+    void Release(size_t bytes);
+
+    // Wake and fail every waiter, now and later
+    void Close();
+
+    size_t Held() const { return held_.load(); }
+    size_t HighWaterMark() const { return highWaterMark_; }
+
+private:
+    const size_t highWaterMark_;
+    std::atomic<size_t> held_{0};
+    std::atomic<bool> closed_{false};
+    std::atomic<int> waiters_{0};
+    std::mutex mutex_;
+    std::condition_variable released_;
+};
+
+class PageQueue {
+public:
+    explicit PageQueue(size_t highWaterMark = kDefaultHighWaterMark, size_t slots = kPageQueueSlots);
+
+    // Bytes a page of `bytes` is charged: at least one slot's share of
+    // the mark, so reservations never outnumber the ring's slots
+    size_t Charge(size_t bytes) const;
+
+    // Acquisition side: block until a page of `bytes` fits under the
+    // mark and return its charge, or 0 once closed
+    size_t Reserve(size_t bytes);
+
+    // Give back all or part of a charge, e.g. when a page is dropped or
+    // its pixels have been written out
+    void Release(size_t charged);
+
+    // Producer side (one thread at a time). `charged` is released when
+    // JavaScript takes the page. Blocks only while every slot is taken;
+    // returns false (and releases the charge) once closed.
+    bool Push(ScanResult page, size_t charged);
+
+    // Consumer side; never blocks
+    std::vector<ScanResult> PopAll();
+
+    // Wake the producer and reject further pages
+    void Close();
+
+    size_t Size() const;
+    size_t BufferedBytes() const { return budget_.Held(); }
+
+private:
+    struct Entry {
+        ScanResult page{};
+        size_t charged = 0;
+    };
+
+    SpscRing<Entry> ring_;
+    ByteBudget budget_;
+    size_t slotShare_;
+    std::atomic<bool> closed_{false};
+    std::atomic<int> waiting_{0};
+    std::mutex mutex_;
+    std::condition_variable notFull_;
+};
+
+} // namespace ScannerCore
+
+#endif // SCANNER_CORE_PAGE_QUEUE_H
@@ -0,0 +1,292 @@
+/**
+ * Scanner Core Streaming PDF Writer Implementation
+ */
+
+#include "pdfWriter.h"
+#include "fileIo.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+namespace ScannerCore {
+
+namespace {
+
+// Objects with fixed numbers; page objects are numbered after these
+constexpr int kCatalogObject = 1;
+constexpr int kPagesObject = 2;
+constexpr int kInfoObject = 3;
+
+/**
+ * PDF text string: literal for printable ASCII, UTF-16BE hex otherwise
+ */
+std::string TextString(const std::string& utf8) {
+    bool ascii = true;
+    for (unsigned char c : utf8) {
+        if (c < 0x20 || c > 0x7E) {
+            ascii = false;
+            break;
+        }
+    }
+
+    if (ascii) {
+        std::string out = "(";
+        for (char c : utf8) {
+            if (c == '(' || c == ')' || c == '\\') out += '\\';
+            out += c;
+        }
+        return out + ")";
+    }
+
+    std::string out = "<FEFF";
+    char hex[8];
+    for (size_t i = 0; i < utf8.size();) {
+        unsigned char c = static_cast<unsigned char>(utf8[i]);
+        uint32_t cp;
+        int extra;
+        if (c < 0x80) { cp = c; extra = 0; }
+        else if ((c & 0xE0) == 0xC0) { cp = c & 0x1F; extra = 1; }
+        else if ((c & 0xF0) == 0xE0) { cp = c & 0x0F; extra = 2; }
+        else { cp = c & 0x07; extra = 3; }
+        i++;
+        for (int k = 0; k < extra && i < utf8.size(); k++, i++) {
+            cp = (cp << 6) | (static_cast<unsigned char>(utf8[i]) & 0x3F);
+        }
+
+        if (cp >= 0x10000) {
+            cp -= 0x10000;
+            std::snprintf(hex, sizeof(hex), "%04X", 0xD800 + (cp >> 10));
+            out += hex;
+            cp = 0xDC00 + (cp & 0x3FF);
+        }
+        std::snprintf(hex, sizeof(hex), "%04X", cp);
+        out += hex;
+    }
+    return out + ">";
+}
+
+std::string PdfDate(std::time_t time) {
+    std::tm utc{};
+#ifdef _WIN32
+    gmtime_s(&utc, &time);
+#else
+    gmtime_r(&time, &utc);
+#endif
+    char buffer[32];
+    std::strftime(buffer, sizeof(buffer), "(D:%Y%m%d%H%M%SZ)", &utc);
+    return buffer;
+}
+
+std::string Format(const char* format, double a, double b) {
+    char buffer[128];
+    std::snprintf(buffer, sizeof(buffer), format, a, b);
+    return buffer;
+}
+
+} // namespace
+
+PdfWriter::PdfWriter() : fd_(-1), offset_(0) {}
+
+PdfWriter::~PdfWriter() {
+    if (fd_ >= 0) {
+        std::string error;
+        Close(error);
+    }
+}
+
+bool PdfWriter::Open(const std::string& path, const PdfInfo& info, std::string& error) {
+    fd_ = OpenFile(path, FileMode::WriteTruncate);
+    if (fd_ < 0) {
+        error = "Cannot open PDF output: " + std::string(std::strerror(errno));
+        return false;
+    }
+
+    offset_ = 0;
+    objectOffsets_.assign(kInfoObject, 0);
+    pageObjects_.clear();
+
+    // Binary comment marks the file as 8-bit for transfer tools
+    bool ok = Write("%PDF-1.5\n%\xE2\xE3\xCF\xD3\n");
+
+    objectOffsets_[kCatalogObject - 1] = offset_;
+    ok = ok && Write("1 0 obj\n<< /Type /Catalog /Pages 2 0 R >>\nendobj\n");
+
+    std::string dict = "<< /CreationDate " + PdfDate(std::time(nullptr));
+    if (!info.title.empty()) dict += " /Title " + TextString(info.title);
+    if (!info.author.empty()) dict += " /Author " + TextString(info.author);
+    if (!info.subject.empty()) dict += " /Subject " + TextString(info.subject);
+    if (!info.keywords.empty()) dict += " /Keywords " + TextString(info.keywords);
+    if (!info.creator.empty()) dict += " /Creator " + TextString(info.creator);
+    if (!info.producer.empty()) dict += " /Producer " + TextString(info.producer);
+    dict += " >>";
+
+    objectOffsets_[kInfoObject - 1] = offset_;
+    ok = ok && Write("3 0 obj\n" + dict + "\nendobj\n");
+
+    if (!ok) {
+        error = "Failed to write PDF header";
+    }
+    return ok;
+}
+
+int PdfWriter::BeginObject() {
+    objectOffsets_.push_back(offset_);
+    return static_cast<int>(objectOffsets_.size());
+}
+
+bool PdfWriter::Write(const void* data, size_t size) {
+    if (!WriteAll(fd_, static_cast<const uint8_t*>(data), size)) {
+        return false;
+    }
+    offset_ += size;
+    return true;
+}
+
+bool PdfWriter::WriteImageData(const PdfImage& page) {
+    if (page.encoding != ImageEncoding::Raw) {
+        return Write(page.data, page.size);
+    }
+
+    // Raw samples: drop row padding, 16-bit samples become big-endian
+    const size_t rowBytes = static_cast<size_t>(MinStride(page.pixelFormat, page.width));
+    const bool wide = BitDepth(page.pixelFormat) == 16;
+    std::vector<uint8_t> row(wide ? rowBytes : 0);
+
+    for (int y = 0; y < page.height; y++) {
+        const uint8_t* src = page.data + static_cast<size_t>(y) * page.stride;
+        if (wide) {
+            for (size_t i = 0; i < rowBytes; i += 2) {
+                uint16_t sample;
+                std::memcpy(&sample, src + i, sizeof(sample));
+                row[i] = static_cast<uint8_t>(sample >> 8);
+                row[i + 1] = static_cast<uint8_t>(sample & 0xFF);
+            }
+            src = row.data();
+        }
+        if (!Write(src, rowBytes)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool PdfWriter::AddPage(const ScanResult& page, std::string& error) {
+    if (!page.success || (!page.encoded && !page.pixels)) {
+        error = "Page has no image data";
+        return false;
+    }
+
+    const PixelBuffer& data = page.encoded ? *page.encoded : *page.pixels;
+    PdfImage image{page.width, page.height, page.stride, page.pixelFormat, page.resolution,
+                   page.encoded ? page.encoding : ImageEncoding::Raw, data.Data(), data.Size()};
+    return AddImage(image, error);
+}
+
+bool PdfWriter::AddImage(const PdfImage& page, std::string& error) {
+    if (fd_ < 0) {
+        error = "PDF output is not open";
+        return false;
+    }
+    if (!page.data || page.width <= 0 || page.height <= 0) {
+        error = "Page has no image data";
+        return false;
+    }
+
+    // Raw rows must all be present; encoded streams are taken as they are
+    const size_t rowBytes = static_cast<size_t>(MinStride(page.pixelFormat, page.width));
+    const size_t rawBytes = rowBytes * page.height;
+    if (page.encoding == ImageEncoding::Raw &&
+        (static_cast<size_t>(page.stride) < rowBytes ||
+         page.size < static_cast<size_t>(page.stride) * (page.height - 1) + rowBytes)) {
+        error = "Page image data is truncated";
+        return false;
+    }
+
+    const bool color = Channels(page.pixelFormat) == 3;
+    size_t length = page.encoding != ImageEncoding::Raw ? page.size : rawBytes;
+
+    std::string dict = "<< /Type /XObject /Subtype /Image";
+    dict += " /Width " + std::to_string(page.width) + " /Height " + std::to_string(page.height);
+    dict += color ? " /ColorSpace /DeviceRGB" : " /ColorSpace /DeviceGray";
+
+    switch (page.encoding) {
+        case ImageEncoding::Jpeg:
+            dict += " /BitsPerComponent 8 /Filter /DCTDecode";
+            break;
+        case ImageEncoding::CcittG4:
+            dict += " /BitsPerComponent 1 /Filter /CCITTFaxDecode /DecodeParms << /K -1 /Columns " +
+                    std::to_string(page.width) + " /Rows " + std::to_string(page.height) + " /BlackIs1 false >>";
+            break;
+        case ImageEncoding::Raw:
+            dict += " /BitsPerComponent " + std::to_string(BitDepth(page.pixelFormat));
+            break;
+    }
+    dict += " /Length " + std::to_string(length) + " >>";
+
+    const int imageObject = BeginObject();
+    bool ok = Write(std::to_string(imageObject) + " 0 obj\n" + dict + "\nstream\n") &&
+              WriteImageData(page) &&
+              Write("\nendstream\nendobj\n");
+
+    // Page size in points from the scan resolution
+    const double dpi = page.resolution > 0 ? page.resolution : 300;
+    const double width = page.width * 72.0 / dpi;
+    const double height = page.height * 72.0 / dpi;
+
+    const std::string content = Format("q\n%.4f 0 0 %.4f 0 0 cm\n/Im0 Do\nQ\n", width, height);
+    const int contentObject = BeginObject();
+    ok = ok && Write(std::to_string(contentObject) + " 0 obj\n<< /Length " + std::to_string(content.size()) +
+                     " >>\nstream\n" + content + "endstream\nendobj\n");
+
+    const int pageObject = BeginObject();
+    ok = ok && Write(std::to_string(pageObject) + " 0 obj\n<< /Type /Page /Parent 2 0 R" +
+                     Format(" /MediaBox [0 0 %.4f %.4f]", width, height) +
+                     " /Resources << /XObject << /Im0 " + std::to_string(imageObject) + " 0 R >> >>" +
+                     " /Contents " + std::to_string(contentObject) + " 0 R >>\nendobj\n");
+
+    if (!ok) {
+        error = "Failed to write PDF page: " + std::string(std::strerror(errno));
+        return false;
+    }
+
+    pageObjects_.push_back(pageObject);
+    return true;
+}
+
+bool PdfWriter::Close(std::string& error) {
+    if (fd_ < 0) {
+        return true;
+    }
+
+    std::string kids;
+    for (int object : pageObjects_) {
+        kids += std::to_string(object) + " 0 R ";
+    }
+
+    objectOffsets_[kPagesObject - 1] = offset_;
+    bool ok = Write("2 0 obj\n<< /Type /Pages /Kids [" + kids + "] /Count " +
+                    std::to_string(pageObjects_.size()) + " >>\nendobj\n");
+
+    const uint64_t xrefOffset = offset_;
+    std::string xref = "xref\n0 " + std::to_string(objectOffsets_.size() + 1) + "\n0000000000 65535 f \n";
+    char entry[32];
+    for (uint64_t objectOffset : objectOffsets_) {
+        std::snprintf(entry, sizeof(entry), "%010llu 00000 n \n", static_cast<unsigned long long>(objectOffset));
+        xref += entry;
+    }
+    xref += "trailer\n<< /Size " + std::to_string(objectOffsets_.size() + 1) +
+            " /Root 1 0 R /Info 3 0 R >>\nstartxref\n" + std::to_string(xrefOffset) + "\n%%EOF\n";
+    ok = ok && Write(xref);
+
+    ok = SyncFile(fd_) && ok;
+    ok = CloseFile(fd_) && ok;
+    fd_ = -1;
+
+    if (!ok) {
+        error = "Failed to finish PDF output";
+    }
+    return ok;
+}
+
+} // namespace ScannerCore
@@ -0,0 +1,94 @@
+/**
+ * Scanner Core Streaming PDF Writer
+ *
+ * Appends one image page at a time to a PDF file. Already-compressed
+ * JPEG and CCITT G4 pages are embedded as-is (/DCTDecode,
+ * /CCITTFaxDecode) and each page is written to the file descriptor as
+ * soon as it is added, so memory use does not grow with the page count.
+ * The page tree, xref table and trailer are written by Close().
+ */
+
+#ifndef SCANNER_CORE_PDF_WRITER_H
+#define SCANNER_CORE_PDF_WRITER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "scanTypes.h"
+
+namespace ScannerCore {
+
+/**
+ * Document information dictionary entries (UTF-8)
+ */
+struct PdfInfo {
+    std::string title;
+    std::string author;
+    std::string subject;
+    std::string keywords;
+    std::string creator;
+    std::string producer;
+};
+
+/**
+ * Direct-to-PDF output requested for a batch; disabled when path is empty
+ */
+struct PdfOutputOptions {
+    std::string path;
+    PdfInfo info;
+};
+
+/**
+ * One page image, borrowed for the duration of AddImage(). `data` holds
+ * the encoded stream, or raw rows `stride` bytes apart.
+ */
+struct PdfImage {
+    int width;
+    int height;
+    int stride;
+    PixelFormat pixelFormat;
+    int resolution;
+    ImageEncoding encoding;
+    const uint8_t* data;
+    size_t size;
+};
+
+class PdfWriter {
+public:
+    PdfWriter();
+    ~PdfWriter();
+
+    PdfWriter(const PdfWriter&) = delete;
+    PdfWriter& operator=(const PdfWriter&) = delete;
+
+    bool Open(const std::string& path, const PdfInfo& info, std::string& error);
+
+    // Add a scanned page sized from its resolution
+    bool AddPage(const ScanResult& page, std::string& error);
+
+    // Same from memory the caller owns (e.g. a mapped page spool)
+    bool AddImage(const PdfImage& image, std::string& error);
+
+    // Write the page tree, xref and trailer and close the file
+    bool Close(std::string& error);
+
+    bool IsOpen() const { return fd_ >= 0; }
+    int PageCount() const { return static_cast<int>(pageObjects_.size()); }
+    uint64_t BytesWritten() const { return offset_; }
+
+private:
+    int BeginObject();
+    bool Write(const void* data, size_t size);
+    bool Write(const std::string& text) { return Write(text.data(), text.size()); }
+    bool WriteImageData(const PdfImage& page);
+
+    int fd_;
+    uint64_t offset_;
+    std::vector<uint64_t> objectOffsets_; // index = object number - 1
+    std::vector<int> pageObjects_;
+};
+
+} // namespace ScannerCore
+
+#endif // SCANNER_CORE_PDF_WRITER_H
@@ -0,0 +1,124 @@
+/**
+ * Scanner Core Pixel Buffer
+ *
+ * Owned storage for an acquired page, either raw pixels or the encoded
+ * image. Buffers are handed to JavaScript without copying and released
+ * by an external finalizer.
+ */
+
+#ifndef SCANNER_CORE_PIXEL_BUFFER_H
+#define SCANNER_CORE_PIXEL_BUFFER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ScannerCore {
+
+/**
+ * Raw pixel layout delivered by a driver transfer
+ */
+enum class PixelFormat {
+    BlackWhite1, // 1 bit per pixel, MSB first, 0 = black
+    Gray8,
+    Gray16,      // native-endian samples
+    Rgb24,
+    Rgb48        // native-endian samples
+};
+
+/**
+ * Compressed representation of a page
+ */
+enum class ImageEncoding {
+    Raw,     // uncompressed PixelFormat samples
+    Jpeg,    // baseline JFIF
+    CcittG4  // CCITT T.6, 0 = black (PDF /BlackIs1 false)
+};
+
+/**
+ * Driver transfer buffer. Shared so that the JavaScript ArrayBuffer and
+ * any native pipeline stage can hold the same pixels.
+ */
+class PixelBuffer {
+public:
+    explicit PixelBuffer(size_t size) : data_(size), size_(size) {}
+    explicit PixelBuffer(std::vector<uint8_t>&& data) : data_(std::move(data)), size_(data_.size()) {}
+
+    uint8_t* Data() { return data_.data(); }
+    const uint8_t* Data() const { return data_.data(); }
+    size_t Size() const { return size_; }
+    size_t Capacity() const { return data_.size(); }
+
+    // Shrink the logical size without reallocating
+    void Truncate(size_t size) { if (size < size_) size_ = size; }
+
+    // Reuse the allocation for a new logical size (contents are stale)
+    bool Reset(size_t size) {
+        if (size > data_.size()) return false;
+        size_ = size;
+        return true;
+    }
+
+private:
+    std::vector<uint8_t> data_;
+    size_t size_;
+};
+
+/**
+ * Bits per sample for a pixel format
+ */
+inline int BitDepth(PixelFormat format) {
+    switch (format) {
+        case PixelFormat::BlackWhite1: return 1;
+        case PixelFormat::Gray16:
+        case PixelFormat::Rgb48: return 16;
+        default: return 8;
+    }
+}
+
+/**
+ * Samples per pixel for a pixel format
+ */
+inline int Channels(PixelFormat format) {
+    return (format == PixelFormat::Rgb24 || format == PixelFormat::Rgb48) ? 3 : 1;
+}
+
+/**
+ * Minimum row stride in bytes, rounded up to whole bytes
+ */
+inline int MinStride(PixelFormat format, int width) {
+    return (width * Channels(format) * BitDepth(format) + 7) / 8;
+}
+
+/**
+ * Pixel format name exposed to JavaScript
+ */
+inline const char* PixelFormatName(PixelFormat format) {
+    switch (format) {
+        case PixelFormat::BlackWhite1: return "bw1";
+        case PixelFormat::Gray8: return "gray8";
+        case PixelFormat::Gray16: return "gray16";
+        case PixelFormat::Rgb24: return "rgb24";
+        case PixelFormat::Rgb48: return "rgb48";
+    }
+    return "gray8";
+}
+
+/**
+ * Pixel format a driver is asked for given the requested color mode
+ */
+inline PixelFormat PixelFormatForColorMode(const std::string& colorMode, int bitDepth = 8) {
+    if (colorMode == "blackwhite") {
+        return PixelFormat::BlackWhite1;
+    }
+    if (colorMode == "grayscale") {
+        return bitDepth > 8 ? PixelFormat::Gray16 : PixelFormat::Gray8;
+    }
+    return bitDepth > 8 ? PixelFormat::Rgb48 : PixelFormat::Rgb24;
+}
+
+} // namespace ScannerCore
+
+#endif // SCANNER_CORE_PIXEL_BUFFER_H
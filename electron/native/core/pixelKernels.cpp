@@ -0,0 +1,225 @@
+/**
+ * Scanner Core Pixel Format Kernels Implementation
+ */
+
+#include "pixelKernels.h"
+#include <array>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SCANNER_CORE_SSE2 1
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define SCANNER_CORE_NEON 1
+#endif
+
+// AVX2 kernels are compiled for every x86 build and only run where the
+// CPU reports AVX2 (and the OS saves the YMM registers)
+#if defined(SCANNER_CORE_SSE2) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define SCANNER_CORE_AVX2 1
+#define SCANNER_CORE_TARGET_AVX2 __attribute__((target("avx2")))
+#elif defined(SCANNER_CORE_SSE2) && defined(_MSC_VER)
+#include <immintrin.h>
+#include <intrin.h>
+#define SCANNER_CORE_AVX2 1
+#define SCANNER_CORE_TARGET_AVX2
+#endif
+
+namespace ScannerCore {
+
+namespace {
+
+SimdLevel DetectSimdLevel() {
+#if defined(SCANNER_CORE_AVX2) && defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] >= 7) {
+        __cpuid(info, 1);
+        const bool osxsave = (info[2] & (1 << 27)) != 0;
+        const bool avx = (info[2] & (1 << 28)) != 0;
+        __cpuidex(info, 7, 0);
+        const bool avx2 = (info[1] & (1 << 5)) != 0;
+        if (osxsave && avx && avx2 && (_xgetbv(0) & 0x6) == 0x6) {
+            return SimdLevel::Avx2;
+        }
+    }
+#elif defined(SCANNER_CORE_AVX2)
+    if (__builtin_cpu_supports("avx2")) {
+        return SimdLevel::Avx2;
+    }
+#endif
+
+#if defined(SCANNER_CORE_SSE2)
+    return SimdLevel::Sse2;
+#elif defined(SCANNER_CORE_NEON)
+    return SimdLevel::Neon;
+#else
+    return SimdLevel::Scalar;
+#endif
+}
+
+/**
+ * dst[i] = high byte of the i-th native-endian 16-bit sample
+ */
+template <SimdLevel S>
+void NarrowSamples(const uint8_t* src, size_t count, uint8_t* dst);
+
+void NarrowTail(const uint8_t* src, size_t begin, size_t count, uint8_t* dst) {
+    for (size_t i = begin; i < count; i++) {
+        uint16_t v;
+        std::memcpy(&v, src + i * 2, sizeof(v));
+        dst[i] = static_cast<uint8_t>(v >> 8);
+    }
+}
+
+template <>
+void NarrowSamples<SimdLevel::Scalar>(const uint8_t* src, size_t count, uint8_t* dst) {
+    NarrowTail(src, 0, count, dst);
+}
+
+#if defined(SCANNER_CORE_SSE2)
+template <>
+void NarrowSamples<SimdLevel::Sse2>(const uint8_t* src, size_t count, uint8_t* dst) {
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 2));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 2 + 16));
+        const __m128i packed = _mm_packus_epi16(_mm_srli_epi16(a, 8), _mm_srli_epi16(b, 8));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), packed);
+    }
+    NarrowTail(src, i, count, dst);
+}
+#endif
+
+#if defined(SCANNER_CORE_AVX2)
+SCANNER_CORE_TARGET_AVX2 void NarrowSamplesAvx2(const uint8_t* src, size_t count, uint8_t* dst) {
+    size_t i = 0;
+    for (; i + 32 <= count; i += 32) {
+        const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * 2));
+        const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * 2 + 32));
+        // packus works per 128-bit lane; restore the sample order afterwards
+        const __m256i packed = _mm256_packus_epi16(_mm256_srli_epi16(a, 8), _mm256_srli_epi16(b, 8));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_permute4x64_epi64(packed, 0xD8));
+    }
+    NarrowTail(src, i, count, dst);
+}
+
+template <>
+void NarrowSamples<SimdLevel::Avx2>(const uint8_t* src, size_t count, uint8_t* dst) {
+    NarrowSamplesAvx2(src, count, dst);
+}
+#endif
+
+#if defined(SCANNER_CORE_NEON)
+template <>
+void NarrowSamples<SimdLevel::Neon>(const uint8_t* src, size_t count, uint8_t* dst) {
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        const uint16x8_t a = vreinterpretq_u16_u8(vld1q_u8(src + i * 2));
+        const uint16x8_t b = vreinterpretq_u16_u8(vld1q_u8(src + i * 2 + 16));
+        vst1q_u8(dst + i, vcombine_u8(vshrn_n_u16(a, 8), vshrn_n_u16(b, 8)));
+    }
+    NarrowTail(src, i, count, dst);
+}
+#endif
+
+/**
+ * Eight output bytes for every input byte of a 1-bit row, MSB first
+ */
+constexpr std::array<std::array<uint8_t, 8>, 256> MakeBitExpansion() {
+    std::array<std::array<uint8_t, 8>, 256> table{};
+    for (int byte = 0; byte < 256; byte++) {
+        for (int bit = 0; bit < 8; bit++) {
+            table[byte][bit] = (byte >> (7 - bit)) & 1 ? 255 : 0;
+        }
+    }
+    return table;
+}
+
+constexpr std::array<std::array<uint8_t, 8>, 256> kBitExpansion = MakeBitExpansion();
+
+void ExpandBits(const uint8_t* src, int width, uint8_t* dst) {
+    const int whole = width / 8;
+    for (int i = 0; i < whole; i++) {
+        std::memcpy(dst + i * 8, kBitExpansion[src[i]].data(), 8);
+    }
+    if (width % 8) {
+        std::memcpy(dst + whole * 8, kBitExpansion[src[whole]].data(), width % 8);
+    }
+}
+
+// The 1-bit expansion is a table lookup at every level; 16-bit formats
+// narrow with the level's vector width
+template <PixelFormat F, SimdLevel S>
+void RowTo8(const uint8_t* src, int width, uint8_t* dst) {
+    if constexpr (F == PixelFormat::BlackWhite1) {
+        ExpandBits(src, width, dst);
+    } else {
+        constexpr size_t channels = F == PixelFormat::Rgb48 ? 3 : 1;
+        NarrowSamples<S>(src, static_cast<size_t>(width) * channels, dst);
+    }
+}
+
+template <SimdLevel S>
+RowTo8Fn RowTo8For(PixelFormat format) {
+    switch (format) {
+        case PixelFormat::BlackWhite1: return &RowTo8<PixelFormat::BlackWhite1, S>;
+        case PixelFormat::Gray16: return &RowTo8<PixelFormat::Gray16, S>;
+        case PixelFormat::Rgb48: return &RowTo8<PixelFormat::Rgb48, S>;
+        case PixelFormat::Gray8:
+        case PixelFormat::Rgb24: return nullptr;
+    }
+    return nullptr;
+}
+
+} // namespace
+
+SimdLevel ActiveSimdLevel() {
+    static const SimdLevel level = DetectSimdLevel();
+    return level;
+}
+
+const char* SimdLevelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::Scalar: return "scalar";
+        case SimdLevel::Sse2: return "sse2";
+        case SimdLevel::Avx2: return "avx2";
+        case SimdLevel::Neon: return "neon";
+    }
+    return "scalar";
+}
+
+RowTo8Fn SelectRowTo8(PixelFormat format) {
+    switch (ActiveSimdLevel()) {
+#if defined(SCANNER_CORE_AVX2)
+        case SimdLevel::Avx2: return RowTo8For<SimdLevel::Avx2>(format);
+#endif
+#if defined(SCANNER_CORE_SSE2)
+        case SimdLevel::Sse2: return RowTo8For<SimdLevel::Sse2>(format);
+#endif
+#if defined(SCANNER_CORE_NEON)
+        case SimdLevel::Neon: return RowTo8For<SimdLevel::Neon>(format);
+#endif
+        default: return RowTo8For<SimdLevel::Scalar>(format);
+    }
+}
+
+void RowConverter::BeginPage(PixelFormat format, int width) {
+    convert_ = SelectRowTo8(format);
+    width_ = width;
+    if (convert_) {
+        row_.resize(static_cast<size_t>(width) * Channels(format));
+    }
+}
+
+const uint8_t* RowConverter::Convert(const uint8_t* row) {
+    if (!convert_) {
+        return row;
+    }
+    convert_(row, width_, row_.data());
+    return row_.data();
+}
+
+} // namespace ScannerCore
@@ -0,0 +1,78 @@
+/**
+ * Scanner Core Pixel Format Kernels
+ *
+ * Row conversions between the formats drivers deliver (1-bit, 8/16-bit
+ * gray, 24/48-bit RGB) and the 8-bit samples the post-processing stages
+ * work on. Each conversion is a template instantiated per pixel format
+ * and SIMD level; the instruction set is detected once per process, so
+ * choosing a kernel is a table lookup at page start and the row loop
+ * itself never branches on format or CPU. SSE2 and NEON are the
+ * compile-time baseline for x86-64 and arm64; AVX2 is used when the
+ * CPU has it.
+ */
+
+#ifndef SCANNER_CORE_PIXEL_KERNELS_H
+#define SCANNER_CORE_PIXEL_KERNELS_H
+
+#include <cstdint>
+#include <vector>
+#include "pixelBuffer.h"
+
+namespace ScannerCore {
+
+enum class SimdLevel {
+    Scalar,
+    Sse2,
+    Avx2,
+    Neon
+};
+
+/**
+ * Best instruction set both compiled in and supported by this CPU
+ */
+SimdLevel ActiveSimdLevel();
+
+const char* SimdLevelName(SimdLevel level);
+
+/**
+ * Convert one row of `width` pixels to 8 bits per sample, keeping the
+ * channel count. 1-bit rows become Gray8 (1 = white = 255); 16-bit
+ * native-endian samples keep their high byte.
+ */
+using RowTo8Fn = void (*)(const uint8_t* src, int width, uint8_t* dst);
+
+/**
+ * Kernel for `format` at the active SIMD level; null for Gray8 and
+ * Rgb24, which need no conversion
+ */
+RowTo8Fn SelectRowTo8(PixelFormat format);
+
+/**
+ * 8-bit format matching `format`'s channels (Gray8 or Rgb24)
+ */
+inline PixelFormat EightBitFormat(PixelFormat format) {
+    return Channels(format) == 3 ? PixelFormat::Rgb24 : PixelFormat::Gray8;
+}
+
+/**
+ * Per-page row conversion with its own scratch row
+ */
+class RowConverter {
+public:
+    void BeginPage(PixelFormat format, int width);
+
+    // The row as 8-bit samples: `row` itself for 8-bit formats, else the
+    // scratch row, valid until the next call
+    const uint8_t* Convert(const uint8_t* row);
+
+    bool Converts() const { return convert_ != nullptr; }
+
+private:
+    RowTo8Fn convert_ = nullptr;
+    int width_ = 0;
+    std::vector<uint8_t> row_;
+};
+
+} // namespace ScannerCore
+
+#endif // SCANNER_CORE_PIXEL_KERNELS_H
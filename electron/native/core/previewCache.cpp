@@ -0,0 +1,61 @@
+/**
+ * Scanner Core Preview Cache Implementation
+ */
+
+#include "previewCache.h"
+
+namespace ScannerCore {
+
+constexpr size_t PreviewCache::kMaxEntries;
+constexpr std::chrono::seconds PreviewCache::kMaxAge;
+
+std::string PreviewCache::Key(const ScanSettings& settings) {
+    // Resolution and color mode do not move the document on the bed
+    return settings.paperSize;
+}
+
+void PreviewCache::Store(const ScanSettings& settings, std::shared_ptr<const PreviewEntry> entry) {
+    const std::string key = Key(settings);
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    entries_.remove_if([&key](const auto& cached) { return cached.first == key; });
+    entries_.emplace_front(key, std::move(entry));
+    while (entries_.size() > kMaxEntries) {
+        entries_.pop_back();
+    }
+}
+
+std::shared_ptr<const PreviewEntry> PreviewCache::Find(const ScanSettings& settings) const {
+    const std::string key = Key(settings);
+    const auto now = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    for (const auto& cached : entries_) {
+        if (cached.first == key) {
+            return now - cached.second->captured <= kMaxAge ? cached.second : nullptr;
+        }
+    }
+    return nullptr;
+}
+
+void PreviewCache::Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+}
+
+bool ApplyPreviewCrop(ScanSettings& settings, const PreviewCache& cache) {
+    // An explicit area wins; feeder sheets are never where the preview saw them
+    if (!settings.usePreviewCrop || settings.scanArea.IsSet() || settings.useADF) {
+        return false;
+    }
+
+    std::shared_ptr<const PreviewEntry> entry = cache.Find(settings);
+    if (!entry || !entry->document.detected || !entry->document.area.IsSet()) {
+        return false;
+    }
+
+    settings.scanArea = entry->document.area;
+    return true;
+}
+
+} // namespace ScannerCore
@@ -0,0 +1,76 @@
+/**
+ * Scanner Core Preview Cache
+ *
+ * Remembers the last few preview frames of a device together with the
+ * document detected in them, keyed by the settings that decide the bed
+ * geometry. A following full-resolution scan can take the document's
+ * crop rectangle as its hardware scan area and transfer only that part
+ * of the bed.
+ */
+
+#ifndef SCANNER_CORE_PREVIEW_CACHE_H
+#define SCANNER_CORE_PREVIEW_CACHE_H
+
+#include <chrono>
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include "scanTypes.h"
+
+namespace ScannerCore {
+
+/**
+ * Document found in a preview frame. Pixel coordinates refer to the
+ * preview frame; area is the crop rectangle on the bed in inches.
+ */
+struct PreviewDocument {
+    bool detected = false;
+    double cornersX[4] = {};  // clockwise from top-left
+    double cornersY[4] = {};
+    double cropX = 0.0;
+    double cropY = 0.0;
+    double cropWidth = 0.0;
+    double cropHeight = 0.0;
+    double confidence = 0.0;
+    ScanArea area;
+};
+
+struct PreviewEntry {
+    ScanResult frame;
+    PreviewDocument document;
+    std::chrono::steady_clock::time_point captured;
+};
+
+class PreviewCache {
+public:
+    // Entries kept per device
+    static constexpr size_t kMaxEntries = 4;
+
+    // A crop older than this is not reused (the document may have moved)
+    static constexpr std::chrono::seconds kMaxAge{300};
+
+    void Store(const ScanSettings& settings, std::shared_ptr<const PreviewEntry> entry);
+
+    // Most recent preview for these settings, or nullptr when none is fresh
+    std::shared_ptr<const PreviewEntry> Find(const ScanSettings& settings) const;
+
+    void Clear();
+
+private:
+    static std::string Key(const ScanSettings& settings);
+
+    mutable std::mutex mutex_;
+    std::list<std::pair<std::string, std::shared_ptr<const PreviewEntry>>> entries_;  // most recent first
+};
+
+/**
+ * When settings ask for it, set scanArea from the cached preview's
+ * document. Returns true if an area was applied.
+ */
+bool ApplyPreviewCrop(ScanSettings& settings, const PreviewCache& cache);
+
+} // namespace ScannerCore
+
+#endif // SCANNER_CORE_PREVIEW_CACHE_H
@@ -0,0 +1,291 @@
+/**
+ * Scanner Core Preview Worker Implementation
+ */
+
+#include "previewWorker.h"
+#include "documentDetect.h"
+#include "napiConvert.h"
+#include <algorithm>
+#include <exception>
+
+namespace ScannerCore {
+
+namespace {
+
+/**
+ * Document detection on the preview frame, mapped back to bed inches
+ */
+PreviewDocument DetectPreviewDocument(const ScanResult& frame) {
+    PreviewDocument document;
+    if (!frame.pixels || frame.resolution <= 0) {
+        return document;
+    }
+
+    Imaging::ImageView view{frame.pixels->Data(), frame.width, frame.height, frame.stride,
+                            Channels(frame.pixelFormat)};
+    Imaging::DetectionResult detection = Imaging::DetectDocument(view);
+
+    document.detected = detection.detected;
+    for (int i = 0; i < 4; i++) {
+        document.cornersX[i] = detection.corners[i].x;
+        document.cornersY[i] = detection.corners[i].y;
+    }
+    document.cropX = detection.cropRect.x;
+    document.cropY = detection.cropRect.y;
+    document.cropWidth = detection.cropRect.width;
+    document.cropHeight = detection.cropRect.height;
+    document.confidence = detection.confidence;
+
+    if (detection.detected) {
+        const double dpi = frame.resolution;
+        const double bedWidth = frame.width / dpi;
+        const double bedHeight = frame.height / dpi;
+        const double left = std::max(0.0, document.cropX / dpi - kPreviewCropMargin);
+        const double top = std::max(0.0, document.cropY / dpi - kPreviewCropMargin);
+        const double right = std::min(bedWidth, (document.cropX + document.cropWidth) / dpi + kPreviewCropMargin);
+        const double bottom = std::min(bedHeight, (document.cropY + document.cropHeight) / dpi + kPreviewCropMargin);
+        document.area = ScanArea{left, top, right - left, bottom - top};
+    }
+
+    return document;
+}
+
+Napi::Object PreviewDocumentToObject(Napi::Env env, const PreviewDocument& document) {
+    Napi::Object obj = Napi::Object::New(env);
+    obj.Set("detected", document.detected);
+
+    Napi::Array corners = Napi::Array::New(env, 4);
+    for (uint32_t i = 0; i < 4; i++) {
+        Napi::Object corner = Napi::Object::New(env);
+        corner.Set("x", document.cornersX[i]);
+        corner.Set("y", document.cornersY[i]);
+        corners.Set(i, corner);
+    }
+    obj.Set("corners", corners);
+
+    Napi::Object crop = Napi::Object::New(env);
+    crop.Set("x", document.cropX);
+    crop.Set("y", document.cropY);
+    crop.Set("width", document.cropWidth);
+    crop.Set("height", document.cropHeight);
+    obj.Set("cropRect", crop);
+
+    obj.Set("confidence", document.confidence);
+    if (document.area.IsSet()) {
+        obj.Set("scanArea", ScanAreaToObject(env, document.area));
+    }
+    return obj;
+}
+
+/**
+ * AsyncWorker that acquires, decimates and analyses one preview frame
+ */
+class PreviewWorker : public Napi::AsyncWorker {
+public:
+    PreviewWorker(Napi::Env env, const ScanSettings& settings, BandAcquireFn acquire, std::shared_ptr<ScanState> state)
+        : Napi::AsyncWorker(env, "ScannerPreview"),
+          deferred_(Napi::Promise::Deferred::New(env)),
+          settings_(settings),
+          acquire_(std::move(acquire)),
+          state_(std::move(state)),
+          failure_{} {}
+
+    Napi::Promise GetPromise() const { return deferred_.Promise(); }
+
+protected:
+    void Execute() override {
+        // Worker thread: driver calls only, no N-API access
+        try {
+            PageAssembler page(settings_, state_->buffers);
+            DecimatingSink decimate(page, settings_.resolution);
+            BandWriter writer(decimate, kDefaultBandRows, state_->buffers);
+            writer.SetCancelToken(&state_->cancel);
+            std::string error;
+
+            // Driver failures resolve { success: false } as scan() does
+            const bool acquired = acquire_(settings_, 1, writer, error);
+            if (!acquired || writer.Cancelled()) {
+                failure_.success = false;
+                failure_.errorMessage = writer.Cancelled()        ? kScanCancelledMessage
+                                        : !page.Error().empty() ? page.Error()
+                                        : error.empty()         ? "Preview failed"
+                                                                : error;
+                return;
+            }
+
+            auto entry = std::make_shared<PreviewEntry>();
+            entry->frame = page.TakeResult(settings_);
+            if (!entry->frame.success) {
+                failure_ = std::move(entry->frame);
+                return;
+            }
+            entry->document = DetectPreviewDocument(entry->frame);
+            entry->captured = std::chrono::steady_clock::now();
+
+            state_->previews.Store(settings_, entry);
+            entry_ = std::move(entry);
+        } catch (const std::exception& e) {
+            SetError(e.what());
+        }
+    }
+
+    void OnOK() override {
+        state_->scanning = false;
+        if (!entry_) {
+            deferred_.Resolve(ScanResultToObject(Env(), failure_));
+            return;
+        }
+        Napi::Object result = ScanResultToObject(Env(), entry_->frame);
+        result.Set("document", PreviewDocumentToObject(Env(), entry_->document));
+        deferred_.Resolve(result);
+    }
+
+    void OnError(const Napi::Error& error) override {
+        state_->scanning = false;
+        deferred_.Reject(error.Value());
+    }
+
+private:
+    Napi::Promise::Deferred deferred_;
+    ScanSettings settings_;
+    BandAcquireFn acquire_;
+    std::shared_ptr<ScanState> state_;
+    std::shared_ptr<const PreviewEntry> entry_;
+    ScanResult failure_;
+};
+
+} // namespace
+
+DecimatingSink::DecimatingSink(BandSink& next, int targetResolution)
+    : next_(next),
+      target_(targetResolution),
+      factor_(1),
+      passthrough_(true),
+      channels_(1),
+      in_{},
+      out_{},
+      accumulated_(0),
+      outRow_(0) {}
+
+void DecimatingSink::BeginPage(int pageIndex, const PageGeometry& geometry) {
+    in_ = geometry;
+    channels_ = Channels(geometry.pixelFormat);
+
+    // Drivers that report no resolution are assumed to have honoured the request
+    factor_ = (target_ > 0 && geometry.resolution > target_) ? geometry.resolution / target_ : 1;
+    passthrough_ = factor_ == 1 &&
+                   (geometry.pixelFormat == PixelFormat::Gray8 || geometry.pixelFormat == PixelFormat::Rgb24);
+
+    out_ = geometry;
+    out_.width = std::max(1, geometry.width / factor_);
+    out_.height = geometry.height > 0 ? std::max(1, geometry.height / factor_) : 0;
+    out_.pixelFormat = channels_ == 3 ? PixelFormat::Rgb24 : PixelFormat::Gray8;
+    out_.stride = out_.width * channels_;
+    out_.resolution = geometry.resolution > 0 ? geometry.resolution / factor_ : 0;
+
+    rows_.BeginPage(geometry.pixelFormat, geometry.width);
+    sums_.assign(static_cast<size_t>(out_.stride), 0);
+    accumulated_ = 0;
+    outRow_ = 0;
+
+    next_.BeginPage(pageIndex, passthrough_ ? in_ : out_);
+}
+
+void DecimatingSink::AccumulateRow(const uint8_t* row) {
+    const int width = out_.width * factor_;  // trailing columns are dropped
+    uint32_t* sums = sums_.data();
+
+    const uint8_t* samples = rows_.Convert(row);  // 1 = white = 255
+    for (int x = 0; x < width; x++) {
+        uint32_t* dst = sums + (x / factor_) * channels_;
+        for (int c = 0; c < channels_; c++) {
+            dst[c] += samples[x * channels_ + c];
+        }
+    }
+}
+
+void DecimatingSink::EmitRow(uint8_t* dst) {
+    const uint32_t area = static_cast<uint32_t>(factor_ * factor_);
+    for (size_t i = 0; i < sums_.size(); i++) {
+        dst[i] = static_cast<uint8_t>((sums_[i] + area / 2) / area);
+    }
+    std::fill(sums_.begin(), sums_.end(), 0);
+    accumulated_ = 0;
+}
+
+bool DecimatingSink::OnBand(const ScanBand& band) {
+    if (passthrough_) {
+        return next_.OnBand(band);
+    }
+
+    const int produced = (accumulated_ + band.rows) / factor_;
+    std::shared_ptr<PixelBuffer> pixels =
+        produced > 0 ? std::make_shared<PixelBuffer>(static_cast<size_t>(produced) * out_.stride) : nullptr;
+
+    int emitted = 0;
+    for (int y = 0; y < band.rows; y++) {
+        AccumulateRow(band.pixels->Data() + static_cast<size_t>(y) * in_.stride);
+        if (++accumulated_ == factor_) {
+            EmitRow(pixels->Data() + static_cast<size_t>(emitted) * out_.stride);
+            emitted++;
+        }
+    }
+
+    if (emitted == 0) {
+        return true;
+    }
+
+    ScanBand out;
+    out.pixels = std::move(pixels);
+    out.pageIndex = band.pageIndex;
+    out.firstRow = outRow_;
+    out.rows = emitted;
+    out.lastBand = band.lastBand;
+    out.geometry = out_;
+    outRow_ += emitted;
+
+    return next_.OnBand(out);
+}
+
+bool DecimatingSink::EndPage(int pageIndex) {
+    // A trailing partial block of rows is dropped
+    return next_.EndPage(pageIndex);
+}
+
+ScanSettings PreviewSettings(const ScanSettings& settings) {
+    ScanSettings preview = settings;
+    preview.preview = true;
+    preview.resolution = kPreviewResolution;
+    preview.useADF = false;
+    preview.duplex = false;
+    preview.compression = "none";
+    preview.scanArea = ScanArea{};
+    preview.usePreviewCrop = false;
+    preview.binarize = "none";
+
+    // Edges are detected on gray levels, not thresholded pixels
+    if (preview.colorMode == "blackwhite") {
+        preview.colorMode = "grayscale";
+    }
+    return preview;
+}
+
+Napi::Value QueuePreview(Napi::Env env,
+                         const ScanSettings& settings,
+                         BandAcquireFn acquire,
+                         const std::shared_ptr<ScanState>& state) {
+    if (state->scanning.exchange(true)) {
+        Napi::Promise::Deferred deferred = Napi::Promise::Deferred::New(env);
+        deferred.Reject(Napi::Error::New(env, "Scan already in progress").Value());
+        return deferred.Promise();
+    }
+    state->cancel.Reset();
+
+    PreviewWorker* worker = new PreviewWorker(env, PreviewSettings(settings), std::move(acquire), state);
+    Napi::Promise promise = worker->GetPromise();
+    worker->Queue();
+
+    return promise;
+}
+
+} // namespace ScannerCore
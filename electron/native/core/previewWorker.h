@@ -0,0 +1,85 @@
+/**
+ * Scanner Core Preview Worker
+ *
+ * Fast low-resolution preview: the driver is asked for its hardware
+ * preview mode and, if it still delivers more pixels than needed, bands
+ * are box-decimated on the acquisition thread before a page is ever
+ * assembled. The document quad is detected natively on the small frame
+ * and both go into the scanner's PreviewCache.
+ */
+
+#ifndef SCANNER_CORE_PREVIEW_WORKER_H
+#define SCANNER_CORE_PREVIEW_WORKER_H
+
+#include <napi.h>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "bandStream.h"
+#include "pixelKernels.h"
+#include "previewCache.h"
+#include "scanWorker.h"
+
+namespace ScannerCore {
+
+/**
+ * Preview resolution requested from the driver
+ */
+constexpr int kPreviewResolution = 75;
+
+/**
+ * Margin added around the detected document when it becomes a scan area
+ */
+constexpr double kPreviewCropMargin = 0.125; // inches
+
+/**
+ * Sink that box-averages bands down to a target resolution and forwards
+ * them as 8-bit gray or RGB. Passes 8-bit bands through untouched when
+ * the driver already delivers the target resolution.
+ */
+class DecimatingSink : public BandSink {
+public:
+    DecimatingSink(BandSink& next, int targetResolution);
+
+    void BeginPage(int pageIndex, const PageGeometry& geometry) override;
+    bool OnBand(const ScanBand& band) override;
+    bool EndPage(int pageIndex) override;
+
+    int Factor() const { return factor_; }
+
+private:
+    void AccumulateRow(const uint8_t* row);
+    void EmitRow(uint8_t* dst);
+
+    BandSink& next_;
+    int target_;
+    int factor_;
+    bool passthrough_;
+    int channels_;
+    PageGeometry in_;
+    PageGeometry out_;
+    RowConverter rows_;
+    std::vector<uint32_t> sums_;  // per output sample of the pending row
+    int accumulated_;             // input rows summed into sums_
+    int outRow_;
+};
+
+/**
+ * Settings a preview of `settings` is acquired with
+ */
+ScanSettings PreviewSettings(const ScanSettings& settings);
+
+/**
+ * Queue a preview acquisition. Resolves with the preview frame plus a
+ * `document` object ({ detected, corners, cropRect, confidence,
+ * scanArea? }) and caches both in state's PreviewCache. A failed or
+ * cancelled preview resolves { success: false, errorMessage } like scan().
+ */
+Napi::Value QueuePreview(Napi::Env env,
+                         const ScanSettings& settings,
+                         BandAcquireFn acquire,
+                         const std::shared_ptr<ScanState>& state);
+
+} // namespace ScannerCore
+
+#endif // SCANNER_CORE_PREVIEW_WORKER_H
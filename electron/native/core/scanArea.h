@@ -0,0 +1,58 @@
+/**
+ * Scanner Core Scan Area Helpers
+ *
+ * Conversions from a ScanArea (inches, top-left origin) to the units
+ * each driver negotiates its hardware region in: TWAIN TW_FRAME in
+ * inches, SANE tl-x/tl-y/br-x/br-y in millimetres, WIA extents in
+ * pixels at the scan resolution.
+ */
+
+#ifndef SCANNER_CORE_SCAN_AREA_H
+#define SCANNER_CORE_SCAN_AREA_H
+
+#include <algorithm>
+#include <cmath>
+#include "scanTypes.h"
+
+namespace ScannerCore {
+
+constexpr double kMillimetersPerInch = 25.4;
+
+/**
+ * Scan area in whole pixels at a resolution
+ */
+struct ScanAreaPixels {
+    int x;
+    int y;
+    int width;
+    int height;
+};
+
+inline ScanAreaPixels ScanAreaToPixels(const ScanArea& area, int resolution) {
+    // Round outwards so the requested region is always fully covered
+    const int left = static_cast<int>(std::floor(area.left * resolution));
+    const int top = static_cast<int>(std::floor(area.top * resolution));
+    const int right = static_cast<int>(std::ceil((area.left + area.width) * resolution));
+    const int bottom = static_cast<int>(std::ceil((area.top + area.height) * resolution));
+    return ScanAreaPixels{left, top, right - left, bottom - top};
+}
+
+/**
+ * Clip an area to a bed of maxWidth x maxHeight inches. Returns an
+ * unset area if nothing of it lies on the bed.
+ */
+inline ScanArea ClampScanArea(const ScanArea& area, double maxWidth, double maxHeight) {
+    const double left = std::max(0.0, area.left);
+    const double top = std::max(0.0, area.top);
+    const double right = maxWidth > 0.0 ? std::min(maxWidth, area.left + area.width) : area.left + area.width;
+    const double bottom = maxHeight > 0.0 ? std::min(maxHeight, area.top + area.height) : area.top + area.height;
+
+    if (right <= left || bottom <= top) {
+        return ScanArea{};
+    }
+    return ScanArea{left, top, right - left, bottom - top};
+}
+
+} // namespace ScannerCore
+
+#endif // SCANNER_CORE_SCAN_AREA_H
@@ -0,0 +1,152 @@
+/**
+ * Scanner Core Scan Metrics Implementation
+ */
+
+#include "scanMetrics.h"
+#include <chrono>
+
+namespace ScannerCore {
+
+const char* MetricStageName(MetricStage stage) {
+    switch (stage) {
+        case MetricStage::DeviceSetup: return "deviceSetup";
+        case MetricStage::Transfer: return "transfer";
+        case MetricStage::Assemble: return "assemble";
+        case MetricStage::Binarize: return "binarize";
+        case MetricStage::Encode: return "encode";
+        case MetricStage::PdfWrite: return "pdfWrite";
+        case MetricStage::Spool: return "spool";
+        case MetricStage::QueueWait: return "queueWait";
+        case MetricStage::IpcHandoff: return "ipcHandoff";
+    }
+    return "unknown";
+}
+
+uint64_t ScanMetrics::Now() {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+}
+
+void ScanMetrics::StoreMax(std::atomic<uint64_t>& target, uint64_t value) {
+    uint64_t current = target.load(std::memory_order_relaxed);
+    while (value > current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+void ScanMetrics::BeginScan() {
+    scans_++;
+    std::lock_guard<std::mutex> lock(pagesMutex_);
+    openPages_.clear();
+    handoffStart_.clear();
+}
+
+void ScanMetrics::Record(MetricStage stage, uint64_t ns, int page) {
+    const int i = static_cast<int>(stage);
+    count_[i].fetch_add(1, std::memory_order_relaxed);
+    totalNs_[i].fetch_add(ns, std::memory_order_relaxed);
+    StoreMax(maxNs_[i], ns);
+
+    if (page >= 0) {
+        std::lock_guard<std::mutex> lock(pagesMutex_);
+        PageMetrics& record = openPages_[page];
+        record.pageIndex = page;
+        record.stageNs[i] += ns;
+    }
+}
+
+void ScanMetrics::AddTransferred(uint64_t bytes, int page) {
+    bytesTransferred_.fetch_add(bytes, std::memory_order_relaxed);
+    if (page >= 0) {
+        std::lock_guard<std::mutex> lock(pagesMutex_);
+        PageMetrics& record = openPages_[page];
+        record.pageIndex = page;
+        record.bytesTransferred += bytes;
+    }
+}
+
+void ScanMetrics::SetQueue(size_t depth, size_t bytes) {
+    queueDepth_.store(depth, std::memory_order_relaxed);
+    queuedBytes_.store(bytes, std::memory_order_relaxed);
+    StoreMax(maxQueueDepth_, depth);
+    StoreMax(maxQueuedBytes_, bytes);
+}
+
+void ScanMetrics::MarkHandoff(int page) {
+    const uint64_t now = Now();
+    std::lock_guard<std::mutex> lock(pagesMutex_);
+    handoffStart_[page] = now;
+}
+
+void ScanMetrics::FinishPage(int page) {
+    uint64_t start = 0;
+    {
+        std::lock_guard<std::mutex> lock(pagesMutex_);
+        auto it = handoffStart_.find(page);
+        if (it != handoffStart_.end()) {
+            start = it->second;
+            handoffStart_.erase(it);
+        }
+    }
+    if (start != 0) {
+        Record(MetricStage::IpcHandoff, Now() - start, page);
+    }
+
+    PageMetrics record;
+    PageListener listener;
+    {
+        std::lock_guard<std::mutex> lock(pagesMutex_);
+        auto it = openPages_.find(page);
+        if (it == openPages_.end()) {
+            return;
+        }
+        record = it->second;
+        openPages_.erase(it);
+
+        recentPages_.push_back(record);
+        if (recentPages_.size() > kRecentPageMetrics) {
+            recentPages_.pop_front();
+        }
+        listener = listener_;
+    }
+    pages_++;
+
+    if (listener) {
+        listener(record);
+    }
+}
+
+void ScanMetrics::DiscardPage(int page) {
+    std::lock_guard<std::mutex> lock(pagesMutex_);
+    openPages_.erase(page);
+    handoffStart_.erase(page);
+}
+
+void ScanMetrics::SetPageListener(PageListener listener) {
+    std::lock_guard<std::mutex> lock(pagesMutex_);
+    listener_ = std::move(listener);
+}
+
+MetricsSnapshot ScanMetrics::Snapshot() const {
+    MetricsSnapshot snapshot;
+    for (int i = 0; i < kMetricStageCount; i++) {
+        snapshot.stages[i].count = count_[i].load(std::memory_order_relaxed);
+        snapshot.stages[i].totalNs = totalNs_[i].load(std::memory_order_relaxed);
+        snapshot.stages[i].maxNs = maxNs_[i].load(std::memory_order_relaxed);
+    }
+    snapshot.scans = scans_;
+    snapshot.pages = pages_;
+    snapshot.bytesTransferred = bytesTransferred_;
+    snapshot.bytesEncoded = bytesEncoded_;
+    snapshot.bytesDelivered = bytesDelivered_;
+    snapshot.queueDepth = queueDepth_;
+    snapshot.maxQueueDepth = maxQueueDepth_;
+    snapshot.queuedBytes = queuedBytes_;
+    snapshot.maxQueuedBytes = maxQueuedBytes_;
+
+    std::lock_guard<std::mutex> lock(pagesMutex_);
+    snapshot.recentPages.assign(recentPages_.begin(), recentPages_.end());
+    return snapshot;
+}
+
+} // namespace ScannerCore
@@ -0,0 +1,157 @@
+/**
+ * Scanner Core Scan Metrics
+ *
+ * Per-stage latency and throughput counters for one scanner session.
+ * Stages record steady_clock durations into lock-free totals and, when
+ * a page index is given, into that page's timing record; finished page
+ * records are kept for the last few pages and can be pushed to a
+ * listener (the JavaScript metrics event stream). Stages without a
+ * `ScanMetrics*` skip the clock reads entirely.
+ */
+
+#ifndef SCANNER_CORE_SCAN_METRICS_H
+#define SCANNER_CORE_SCAN_METRICS_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace ScannerCore {
+
+enum class MetricStage {
+    DeviceSetup,  // acquisition start, or the previous page's end, to BeginPage (warm-up, sheet feed)
+    Transfer,     // BeginPage to EndPage on the driver thread, minus pipeline time
+    Assemble,     // band copies into the page buffer
+    Binarize,     // gray conversion and thresholding
+    Encode,       // JPEG / G4 encoding
+    PdfWrite,     // PDF page append
+    Spool,        // spool page append and commit
+    QueueWait,    // acquisition paused at the high-water mark
+    IpcHandoff    // handed to JavaScript until the callback returned
+};
+
+constexpr int kMetricStageCount = 9;
+
+const char* MetricStageName(MetricStage stage);
+
+struct StageStats {
+    uint64_t count = 0;
+    uint64_t totalNs = 0;
+    uint64_t maxNs = 0;
+};
+
+struct PageMetrics {
+    int pageIndex = -1;
+    uint64_t stageNs[kMetricStageCount] = {};
+    uint64_t bytesTransferred = 0;
+};
+
+struct MetricsSnapshot {
+    StageStats stages[kMetricStageCount];
+    uint64_t scans = 0;
+    uint64_t pages = 0;
+    uint64_t bytesTransferred = 0;  // raw bytes from the driver
+    uint64_t bytesEncoded = 0;      // encoder output
+    uint64_t bytesDelivered = 0;    // handed to JavaScript
+    uint64_t queueDepth = 0;        // pages waiting for JavaScript
+    uint64_t maxQueueDepth = 0;
+    uint64_t queuedBytes = 0;       // bytes booked against the high-water mark
+    uint64_t maxQueuedBytes = 0;
+    std::vector<PageMetrics> recentPages;  // oldest first
+};
+
+/**
+ * Finished page records kept for getMetrics()
+ */
+constexpr size_t kRecentPageMetrics = 32;
+
+class ScanMetrics {
+public:
+    using PageListener = std::function<void(const PageMetrics& page)>;
+
+    // steady_clock in nanoseconds
+    static uint64_t Now();
+
+    // Start of an acquisition; drops page records an aborted scan left open
+    void BeginScan();
+
+    // Add a stage duration, to the page's record too when page >= 0
+    void Record(MetricStage stage, uint64_t ns, int page = -1);
+
+    void AddTransferred(uint64_t bytes, int page = -1);
+    void AddEncoded(uint64_t bytes) { bytesEncoded_ += bytes; }
+    void AddDelivered(uint64_t bytes) { bytesDelivered_ += bytes; }
+
+    // Current page queue gauge; maxima are kept
+    void SetQueue(size_t depth, size_t bytes);
+
+    // The page has been queued for JavaScript; FinishPage() records the
+    // time from here as its IPC handoff
+    void MarkHandoff(int page);
+
+    // The page has reached JavaScript: close its record and notify
+    void FinishPage(int page);
+
+    // Forget a page that will not reach JavaScript (a dropped blank page)
+    void DiscardPage(int page);
+
+    void SetPageListener(PageListener listener);
+
+    MetricsSnapshot Snapshot() const;
+
+private:
+    static void StoreMax(std::atomic<uint64_t>& target, uint64_t value);
+
+    std::atomic<uint64_t> count_[kMetricStageCount] = {};
+    std::atomic<uint64_t> totalNs_[kMetricStageCount] = {};
+    std::atomic<uint64_t> maxNs_[kMetricStageCount] = {};
+    std::atomic<uint64_t> scans_{0};
+    std::atomic<uint64_t> pages_{0};
+    std::atomic<uint64_t> bytesTransferred_{0};
+    std::atomic<uint64_t> bytesEncoded_{0};
+    std::atomic<uint64_t> bytesDelivered_{0};
+    std::atomic<uint64_t> queueDepth_{0};
+    std::atomic<uint64_t> maxQueueDepth_{0};
+    std::atomic<uint64_t> queuedBytes_{0};
+    std::atomic<uint64_t> maxQueuedBytes_{0};
+
+    // Page records are touched a few times per page, not per band
+    mutable std::mutex pagesMutex_;
+    std::map<int, PageMetrics> openPages_;
+    std::map<int, uint64_t> handoffStart_;
+    std::deque<PageMetrics> recentPages_;
+    PageListener listener_;
+};
+
+/**
+ * Records the lifetime of the scope as one stage; no-op without metrics
+ */
+class StageTimer {
+public:
+    StageTimer(ScanMetrics* metrics, MetricStage stage, int page = -1)
+        : metrics_(metrics), stage_(stage), page_(page), start_(metrics ? ScanMetrics::Now() : 0) {}
+
+    ~StageTimer() {
+        if (metrics_) {
+            metrics_->Record(stage_, ScanMetrics::Now() - start_, page_);
+        }
+    }
+
+    StageTimer(const StageTimer&) = delete;
+    StageTimer& operator=(const StageTimer&) = delete;
+
+private:
+    ScanMetrics* metrics_;
+    MetricStage stage_;
+    int page_;
+    uint64_t start_;
+};
+
+} // namespace ScannerCore
+
+#endif // SCANNER_CORE_SCAN_METRICS_H
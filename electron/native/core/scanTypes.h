@@ -0,0 +1,137 @@
+/**
+ * Scanner Core Types
+ *
+ * Platform-neutral scanner data structures shared by the TWAIN, WIA,
+ * SANE, ImageCapture and eSCL native addons.
+ */
+
+#ifndef SCANNER_CORE_SCAN_TYPES_H
+#define SCANNER_CORE_SCAN_TYPES_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "pixelBuffer.h"
+
+namespace ScannerCore {
+
+/**
+ * Scanner capabilities
+ */
+struct ScannerCapabilities {
+    bool hasFlatbed;
+    bool hasADF;
+    bool duplex;
+    std::vector<int> resolutions;
+    std::vector<std::string> colorModes;
+    std::vector<std::string> paperSizes;
+    double maxWidth;
+    double maxHeight;
+    std::vector<std::string> compression;  // encodings the device produces itself ("jpeg", "ccitt-g4")
+};
+
+/**
+ * Scanner device information
+ */
+struct ScannerDevice {
+    std::string id;
+    std::string name;
+    std::string manufacturer;
+    std::string model;
+    std::string platform;
+    bool available;
+    ScannerCapabilities capabilities;
+};
+
+/**
+ * Region of the scan bed in inches from its top-left corner
+ */
+struct ScanArea {
+    double left = 0.0;
+    double top = 0.0;
+    double width = 0.0;  // 0 = the whole paper size
+    double height = 0.0;
+
+    bool IsSet() const { return width > 0.0 && height > 0.0; }
+};
+
+/**
+ * Scan settings
+ */
+struct ScanSettings {
+    int resolution;
+    std::string colorMode;
+    std::string paperSize;
+    bool useADF;
+    bool duplex;
+    int brightness;
+    int contrast;
+    std::string compression = "none"; // "none", "jpeg", "ccitt-g4" or "auto"
+    int jpegQuality = 85;
+    bool preview = false;         // driver preview mode: low resolution, flatbed
+    ScanArea scanArea = {};       // hardware scan area; unset = full paper size
+    bool usePreviewCrop = false;  // take scanArea from the last preview's document
+    std::string binarize = "none"; // native thresholding: "none", "fixed", "otsu", "sauvola" or "bradley"
+    int binarizeThreshold = 128;   // "fixed" only
+    size_t highWaterMark = 0;      // bytes buffered before acquisition pauses; 0 = default
+    std::string skipBlankPages = "none"; // batch pages dropped when blank: "none", "backs" or "all"
+    double blankThreshold = 0.3;   // ink coverage in percent at or below which a page is blank
+    std::string separation = "none"; // batch separator sheets that start a new document: "none", "patch", "barcode" or "any"
+    std::string separatorBarcode = {}; // prefix a separator barcode must start with; empty = any Code 39
+    bool keepSeparators = false;   // separator sheets open their document instead of being dropped
+    int thumbnailLevels = 0;       // reduced copies built per page, each 1/4 the size of the last (0-3)
+};
+
+/**
+ * Reduced copy of a page: 8-bit gray or RGB, `scale` times smaller than
+ * the page on each side
+ */
+struct PageThumbnail {
+    std::shared_ptr<PixelBuffer> pixels;
+    int width = 0;
+    int height = 0;
+    int stride = 0;
+    PixelFormat pixelFormat = PixelFormat::Gray8;
+    int scale = 1;
+};
+
+/**
+ * Scan result
+ *
+ * Pixels stay in the driver's transfer buffer; stride is in bytes and
+ * may include row padding. Compressed scans carry the encoded image in
+ * `encoded` instead and leave `pixels` empty.
+ */
+struct ScanResult {
+    bool success;
+    std::string errorMessage;
+    std::shared_ptr<PixelBuffer> pixels;
+    int width;
+    int height;
+    int stride;
+    PixelFormat pixelFormat;
+    int resolution;
+    std::string colorMode;
+    ImageEncoding encoding;
+    std::shared_ptr<PixelBuffer> encoded;
+    ScanArea scanArea = {};  // area that was scanned, when not the full paper size
+    int spoolIndex = -1;     // record in the batch spool once the page has been spooled
+    int pageIndex = -1;      // batch pages: position in acquisition order, dropped blank pages included
+    int documentIndex = -1;  // batch pages split by separator sheets: document the page belongs to
+    std::vector<PageThumbnail> thumbnails;  // largest first, when settings.thumbnailLevels is set
+};
+
+/**
+ * Bytes a page keeps in memory (pixels, encoded image and thumbnails)
+ */
+inline size_t PageBytes(const ScanResult& page) {
+    size_t bytes = (page.pixels ? page.pixels->Size() : 0) + (page.encoded ? page.encoded->Size() : 0);
+    for (const PageThumbnail& thumbnail : page.thumbnails) {
+        bytes += thumbnail.pixels ? thumbnail.pixels->Size() : 0;
+    }
+    return bytes;
+}
+
+} // namespace ScannerCore
+
+#endif // SCANNER_CORE_SCAN_TYPES_H
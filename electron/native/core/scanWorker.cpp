@@ -0,0 +1,86 @@
+/**
+ * Scanner Core Async Scan Worker Implementation
+ */
+
+#include "scanWorker.h"
+#include "napiConvert.h"
+#include <exception>
+
+namespace ScannerCore {
+
+ScanWorker::ScanWorker(Napi::Env env,
+                       const ScanSettings& settings,
+                       BandAcquireFn acquire,
+                       std::shared_ptr<ScanState> state)
+    : Napi::AsyncWorker(env, "ScannerScan"),
+      deferred_(Napi::Promise::Deferred::New(env)),
+      settings_(settings),
+      acquire_(std::move(acquire)),
+      state_(std::move(state)),
+      result_{} {}
+
+Napi::Promise ScanWorker::GetPromise() const {
+    return deferred_.Promise();
+}
+
+void ScanWorker::Execute() {
+    // Worker thread: driver calls only, no N-API access
+    try {
+        state_->metrics.BeginScan();
+        state_->buffers->ConfigureForScan(settings_, kDefaultBandRows);
+        result_ = AcquireFullPage(acquire_, settings_, state_->buffers, &state_->metrics, &state_->cancel);
+    } catch (const std::exception& e) {
+        SetError(e.what());
+    }
+}
+
+void ScanWorker::OnOK() {
+    state_->scanning = false;
+    state_->metrics.MarkHandoff(0);
+    deferred_.Resolve(ScanResultToObject(Env(), result_));
+    state_->metrics.AddDelivered(PageBytes(result_));
+    state_->metrics.FinishPage(0);
+}
+
+void ScanWorker::OnError(const Napi::Error& error) {
+    state_->scanning = false;
+    deferred_.Reject(error.Value());
+}
+
+Napi::Value QueueScan(Napi::Env env,
+                      const ScanSettings& settings,
+                      BandAcquireFn acquire,
+                      const std::shared_ptr<ScanState>& state) {
+    if (state->scanning.exchange(true)) {
+        Napi::Promise::Deferred deferred = Napi::Promise::Deferred::New(env);
+        deferred.Reject(Napi::Error::New(env, "Scan already in progress").Value());
+        return deferred.Promise();
+    }
+    state->cancel.Reset();
+
+    ScanWorker* worker = new ScanWorker(env, settings, std::move(acquire), state);
+    Napi::Promise promise = worker->GetPromise();
+    worker->Queue();
+
+    return promise;
+}
+
+bool CancelAcquisition(ScanState& state) {
+    if (!state.scanning) {
+        return false;
+    }
+    state.cancel.Cancel();
+    return true;
+}
+
+Napi::Object ScanStatusToObject(Napi::Env env, const ScanState& state) {
+    Napi::Object status = Napi::Object::New(env);
+    status.Set("isScanning", state.scanning.load());
+    return status;
+}
+
+Napi::Object ScanMetricsToObject(Napi::Env env, const ScanState& state) {
+    return MetricsToObject(env, state.metrics.Snapshot(), state.buffers->Stats());
+}
+
+} // namespace ScannerCore
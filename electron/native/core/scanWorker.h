@@ -0,0 +1,94 @@
+/**
+ * Scanner Core Async Scan Worker
+ *
+ * Runs a driver acquisition on the libuv thread pool so the Electron
+ * main process keeps serving IPC while a page is being transferred.
+ */
+
+#ifndef SCANNER_CORE_SCAN_WORKER_H
+#define SCANNER_CORE_SCAN_WORKER_H
+
+#include <napi.h>
+#include <atomic>
+#include <memory>
+#include "bandStream.h"
+#include "bufferPool.h"
+#include "cancelToken.h"
+#include "previewCache.h"
+#include "scanMetrics.h"
+#include "scanTypes.h"
+
+namespace ScannerCore {
+
+/**
+ * Acquisition state shared between a scanner object and its in-flight worker
+ */
+struct ScanState {
+    std::atomic<bool> scanning{false};
+
+    // Page and band buffers recycled across scans on this scanner
+    std::shared_ptr<BufferPool> buffers = BufferPool::Create();
+
+    // Recent previews and their detected documents
+    PreviewCache previews;
+
+    // Stage timings and counters across this scanner's acquisitions
+    ScanMetrics metrics;
+
+    // Set by cancelScan(); reset when the next acquisition starts
+    CancelToken cancel;
+};
+
+/**
+ * AsyncWorker that assembles a full page and resolves a Promise with it
+ */
+class ScanWorker : public Napi::AsyncWorker {
+public:
+    ScanWorker(Napi::Env env,
+               const ScanSettings& settings,
+               BandAcquireFn acquire,
+               std::shared_ptr<ScanState> state);
+
+    Napi::Promise GetPromise() const;
+
+protected:
+    void Execute() override;
+    void OnOK() override;
+    void OnError(const Napi::Error& error) override;
+
+private:
+    Napi::Promise::Deferred deferred_;
+    ScanSettings settings_;
+    BandAcquireFn acquire_;
+    std::shared_ptr<ScanState> state_;
+    ScanResult result_;
+};
+
+/**
+ * Queue an acquisition and return its Promise. Rejects immediately if
+ * another scan is already running on the same scanner.
+ */
+Napi::Value QueueScan(Napi::Env env,
+                      const ScanSettings& settings,
+                      BandAcquireFn acquire,
+                      const std::shared_ptr<ScanState>& state);
+
+/**
+ * Ask the scanner's in-flight acquisition to stop. Returns false when
+ * no scan is running.
+ */
+bool CancelAcquisition(ScanState& state);
+
+/**
+ * Build the { isScanning } status object for a scanner
+ */
+Napi::Object ScanStatusToObject(Napi::Env env, const ScanState& state);
+
+/**
+ * Build the ScanMetrics object for a scanner's acquisitions so far
+ */
+Napi::Object ScanMetricsToObject(Napi::Env env, const ScanState& state);
+
+} // namespace ScannerCore
+
+#endif // SCANNER_CORE_SCAN_WORKER_H
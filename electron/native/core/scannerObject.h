@@ -0,0 +1,472 @@
+/**
+ * Scanner Core Scanner Object
+ *
+ * The JavaScript class every scanner addon exports. A platform wrapper
+ * derives from ScannerObject<Wrapper> and supplies only its backend;
+ * device registry, sessions, the scan / stream / batch / preview
+ * pipelines, cancellation, metrics and spooling are shared, so each
+ * pipeline change reaches every platform at once. The backend provides,
+ * all static:
+ *
+ *   using Session = ...;  // ScanSession subclass holding the driver handle
+ *   std::vector<ScannerDevice> ProbeDevices();             // registry thread
+ *   std::shared_ptr<ScanSession> OpenDevice(const std::string& deviceId,
+ *                                           std::string& error);  // JS thread
+ *   bool AcquirePages(Session&, const ScanSettings&, int maxPages,
+ *                     BandWriter&, std::string& error);    // acquisition thread
+ *
+ * and may hide LoadDriver() (nothing to load by default), ExtraMethods()
+ * (backend-specific JavaScript methods), OnInitialize() (hot-plug
+ * monitors) and OnClose() (driver shutdown once every session is closed).
+ * The wrapper befriends ScannerObject<Wrapper> so its backend can stay
+ * private.
+ */
+
+#ifndef SCANNER_CORE_SCANNER_OBJECT_H
+#define SCANNER_CORE_SCANNER_OBJECT_H
+
+#include <napi.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "bandStream.h"
+#include "deviceEvents.h"
+#include "deviceRegistry.h"
+#include "initWorker.h"
+#include "metricsEvents.h"
+#include "napiConvert.h"
+#include "scanTypes.h"
+#include "scanWorker.h"
+#include "sessionManager.h"
+#include "spoolWorker.h"
+
+namespace ScannerCore {
+
+template <typename Backend>
+class ScannerObject : public Napi::ObjectWrap<Backend> {
+public:
+    using Descriptor = Napi::ClassPropertyDescriptor<Backend>;
+
+    /**
+     * Define the class with the shared methods plus the backend's
+     * ExtraMethods(), and export it as `name`
+     */
+    static Napi::Object Export(Napi::Env env, Napi::Object exports, const char* name);
+
+protected:
+    explicit ScannerObject(const Napi::CallbackInfo& info);
+
+    // Backend hooks
+    static bool LoadDriver(std::string& error) {
+        (void)error;
+        return true;
+    }
+    static std::vector<Descriptor> ExtraMethods() { return {}; }
+    void OnInitialize() {}
+    void OnClose() {}
+
+    Napi::Value Initialize(const Napi::CallbackInfo& info);
+    Napi::Value EnumerateDevices(const Napi::CallbackInfo& info);
+    Napi::Value RefreshDevices(const Napi::CallbackInfo& info);
+    Napi::Value OnDeviceChange(const Napi::CallbackInfo& info);
+    Napi::Value SelectDevice(const Napi::CallbackInfo& info);
+    Napi::Value GetCapabilities(const Napi::CallbackInfo& info);
+    Napi::Value Scan(const Napi::CallbackInfo& info);
+    Napi::Value ScanStream(const Napi::CallbackInfo& info);
+    Napi::Value ScanBatch(const Napi::CallbackInfo& info);
+    Napi::Value Preview(const Napi::CallbackInfo& info);
+    Napi::Value CancelScan(const Napi::CallbackInfo& info);
+    Napi::Value GetScanStatus(const Napi::CallbackInfo& info);
+    Napi::Value GetMetrics(const Napi::CallbackInfo& info);
+    Napi::Value OnMetrics(const Napi::CallbackInfo& info);
+    Napi::Value OpenSession(const Napi::CallbackInfo& info);
+    Napi::Value CloseSession(const Napi::CallbackInfo& info);
+    Napi::Value GetSessions(const Napi::CallbackInfo& info);
+    Napi::Value SessionScan(const Napi::CallbackInfo& info);
+    Napi::Value SessionScanStream(const Napi::CallbackInfo& info);
+    Napi::Value SessionScanBatch(const Napi::CallbackInfo& info);
+    Napi::Value SessionPreview(const Napi::CallbackInfo& info);
+    Napi::Value SessionCancelScan(const Napi::CallbackInfo& info);
+    Napi::Value SessionGetScanStatus(const Napi::CallbackInfo& info);
+    Napi::Value SessionGetMetrics(const Napi::CallbackInfo& info);
+    Napi::Value Close(const Napi::CallbackInfo& info);
+
+    // Acquisition entry point bound to one session
+    static BandAcquireFn AcquireFor(const std::shared_ptr<ScanSession>& session);
+
+    // False, after throwing "Scanner not initialized", before initialize()
+    // or after close()
+    bool RequireInitialized(const Napi::CallbackInfo& info) const;
+
+    // The selected session, or throws "No device selected" and returns null
+    std::shared_ptr<ScanSession> Selected(const Napi::CallbackInfo& info) const;
+
+    bool isInitialized_;
+    SessionManager sessions_;
+    std::shared_ptr<ScanSession> selected_;  // session used by scan() & co.
+    bool ownsSelected_;                      // opened by selectDevice(), not openSession()
+    std::shared_ptr<DeviceEventEmitter> deviceEvents_;
+    std::shared_ptr<MetricsEventEmitter> metricsEvents_;
+    std::shared_ptr<DeviceRegistry> registry_;
+};
+
+template <typename Backend>
+Napi::Object ScannerObject<Backend>::Export(Napi::Env env, Napi::Object exports, const char* name) {
+    using Wrap = Napi::ObjectWrap<Backend>;
+    std::vector<Descriptor> methods = {
+        Wrap::InstanceMethod("initialize", &ScannerObject::Initialize),
+        Wrap::InstanceMethod("enumerateDevices", &ScannerObject::EnumerateDevices),
+        Wrap::InstanceMethod("refreshDevices", &ScannerObject::RefreshDevices),
+        Wrap::InstanceMethod("onDeviceChange", &ScannerObject::OnDeviceChange),
+        Wrap::InstanceMethod("selectDevice", &ScannerObject::SelectDevice),
+        Wrap::InstanceMethod("getCapabilities", &ScannerObject::GetCapabilities),
+        Wrap::InstanceMethod("scan", &ScannerObject::Scan),
+        Wrap::InstanceMethod("scanStream", &ScannerObject::ScanStream),
+        Wrap::InstanceMethod("scanBatch", &ScannerObject::ScanBatch),
+        Wrap::InstanceMethod("preview", &ScannerObject::Preview),
+        Wrap::InstanceMethod("cancelScan", &ScannerObject::CancelScan),
+        Wrap::InstanceMethod("getScanStatus", &ScannerObject::GetScanStatus),
+        Wrap::InstanceMethod("getMetrics", &ScannerObject::GetMetrics),
+        Wrap::InstanceMethod("onMetrics", &ScannerObject::OnMetrics),
+        Wrap::InstanceMethod("openSession", &ScannerObject::OpenSession),
+        Wrap::InstanceMethod("closeSession", &ScannerObject::CloseSession),
+        Wrap::InstanceMethod("getSessions", &ScannerObject::GetSessions),
+        Wrap::InstanceMethod("sessionScan", &ScannerObject::SessionScan),
+        Wrap::InstanceMethod("sessionScanStream", &ScannerObject::SessionScanStream),
+        Wrap::InstanceMethod("sessionScanBatch", &ScannerObject::SessionScanBatch),
+        Wrap::InstanceMethod("sessionPreview", &ScannerObject::SessionPreview),
+        Wrap::InstanceMethod("sessionCancelScan", &ScannerObject::SessionCancelScan),
+        Wrap::InstanceMethod("sessionGetScanStatus", &ScannerObject::SessionGetScanStatus),
+        Wrap::InstanceMethod("sessionGetMetrics", &ScannerObject::SessionGetMetrics),
+        Wrap::InstanceMethod("close", &ScannerObject::Close),
+        Wrap::StaticMethod("spoolToPdf", &SpoolToPdf),
+        Wrap::StaticMethod("readSpool", &ReadSpool),
+        Wrap::StaticMethod("readSpoolPage", &ReadSpoolPage),
+    };
+    std::vector<Descriptor> extra = Backend::ExtraMethods();
+    methods.insert(methods.end(), extra.begin(), extra.end());
+
+    Napi::Function func = Wrap::DefineClass(env, name, methods);
+
+    Napi::FunctionReference* constructor = new Napi::FunctionReference();
+    *constructor = Napi::Persistent(func);
+    env.SetInstanceData(constructor);
+
+    exports.Set(name, func);
+    return exports;
+}
+
+template <typename Backend>
+ScannerObject<Backend>::ScannerObject(const Napi::CallbackInfo& info)
+    : Napi::ObjectWrap<Backend>(info),
+      isInitialized_(false),
+      sessions_(&Backend::OpenDevice),
+      ownsSelected_(false),
+      registry_(std::make_shared<DeviceRegistry>(&Backend::ProbeDevices, &Backend::LoadDriver)) {}
+
+template <typename Backend>
+Napi::Value ScannerObject<Backend>::Initialize(const Napi::CallbackInfo& info) {
+    // The driver loads and the first probe runs in the background
+    static_cast<Backend*>(this)->OnInitialize();
+    isInitialized_ = true;
+    return QueueInitialize(info.Env(), registry_);
+}
+
+template <typename Backend>
+bool ScannerObject<Backend>::RequireInitialized(const Napi::CallbackInfo& info) const {
+    if (!isInitialized_) {
+        Napi::Error::New(info.Env(), "Scanner not initialized").ThrowAsJavaScriptException();
+    }
+    return isInitialized_;
+}
+
+template <typename Backend>
+Napi::Value ScannerObject<Backend>::EnumerateDevices(const Napi::CallbackInfo& info) {
+    if (!RequireInitialized(info)) {
+        return info.Env().Null();
+    }
+    return DevicesToArray(info.Env(), registry_->Devices());
+}
+
+template <typename Backend>
+Napi::Value ScannerObject<Backend>::RefreshDevices(const Napi::CallbackInfo& info) {
+    if (!RequireInitialized(info)) {
+        return info.Env().Null();
+    }
+    registry_->Invalidate();
+    return Napi::Boolean::New(info.Env(), true);
+}
+
+template <typename Backend>
+Napi::Value ScannerObject<Backend>::OnDeviceChange(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 1 || !info[0].IsFunction()) {
+        Napi::TypeError::New(env, "Callback expected").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    deviceEvents_ = std::make_shared<DeviceEventEmitter>(env, info[0].As<Napi::Function>());
+    std::shared_ptr<DeviceEventEmitter> events = deviceEvents_;
+    registry_->SetChangeListener([events](const ScannerDevice& device, bool connected) {
+        events->Emit(device, connected);
+    });
+    return env.Undefined();
+}
+
+template <typename Backend>
+Napi::Value ScannerObject<Backend>::SelectDevice(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (!RequireInitialized(info)) {
+        return env.Null();
+    }
+    if (info.Length() < 1 || !info[0].IsString()) {
+        Napi::TypeError::New(env, "Device ID expected").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    const std::string deviceId = info[0].As<Napi::String>().Utf8Value();
+    if (selected_ && selected_->deviceId == deviceId) {
+        return Napi::Boolean::New(env, true);
+    }
+
+    // Switching devices closes the session selectDevice() opened for the
+    // previous one; a session the caller opened itself stays open
+    const bool release = selected_ && ownsSelected_;
+    if (release && selected_->state->scanning) {
+        Napi::Error::New(env, "Scan in progress on the selected device").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    std::string error;
+    bool created = false;
+    std::shared_ptr<ScanSession> session = sessions_.Open(deviceId, error, &created);
+    if (!session) {
+        Napi::Error::New(env, error).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    if (release) {
+        sessions_.Close(selected_->id, error);
+    }
+    selected_ = session;
+    ownsSelected_ = created;
+    return Napi::Boolean::New(env, true);
+}
+
+template <typename Backend>
+Napi::Value ScannerObject<Backend>::GetCapabilities(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    ScannerDevice device;
+    if (!selected_ || !registry_->Find(selected_->deviceId, device)) {
+        return Napi::Object::New(env);
+    }
+    return CapabilitiesToObject(env, device.capabilities);
+}
+
+template <typename Backend>
+std::shared_ptr<ScanSession> ScannerObject<Backend>::Selected(const Napi::CallbackInfo& info) const {
+    if (!RequireInitialized(info)) {
+        return nullptr;
+    }
+    if (!selected_) {
+        Napi::Error::New(info.Env(), "No device selected").ThrowAsJavaScriptException();
+    }
+    return selected_;
+}
+
+template <typename Backend>
+Napi::Value ScannerObject<Backend>::Scan(const Napi::CallbackInfo& info) {
+    std::shared_ptr<ScanSession> session = Selected(info);
+    if (!session) {
+        return info.Env().Null();
+    }
+    return QueueSessionScan(info, 0, session, AcquireFor(session));
+}
+
+template <typename Backend>
+Napi::Value ScannerObject<Backend>::ScanStream(const Napi::CallbackInfo& info) {
+    std::shared_ptr<ScanSession> session = Selected(info);
+    if (!session) {
+        return info.Env().Null();
+    }
+    return QueueSessionScanStream(info, 0, session, AcquireFor(session));
+}
+
+template <typename Backend>
+Napi::Value ScannerObject<Backend>::ScanBatch(const Napi::CallbackInfo& info) {
+    std::shared_ptr<ScanSession> session = Selected(info);
+    if (!session) {
+        return info.Env().Null();
+    }
+    return QueueSessionScanBatch(info, 0, session, AcquireFor(session));
+}
+
+template <typename Backend>
+Napi::Value ScannerObject<Backend>::Preview(const Napi::CallbackInfo& info) {
+    std::shared_ptr<ScanSession> session = Selected(info);
+    if (!session) {
+        return info.Env().Null();
+    }
+    return QueueSessionPreview(info, 0, session, AcquireFor(session));
+}
+
+template <typename Backend>
+BandAcquireFn ScannerObject<Backend>::AcquireFor(const std::shared_ptr<ScanSession>& session) {
+    // The acquisition keeps the session (and its driver handle) alive
+    std::shared_ptr<typename Backend::Session> device = std::static_pointer_cast<typename Backend::Session>(session);
+    return [device](const ScanSettings& s, int pages, BandWriter& w, std::string& e) {
+        return Backend::AcquirePages(*device, s, pages, w, e);
+    };
+}
+
+template <typename Backend>
+Napi::Value ScannerObject<Backend>::CancelScan(const Napi::CallbackInfo& info) {
+    return CancelSessionScan(info.Env(), selected_.get());
+}
+
+template <typename Backend>
+Napi::Value ScannerObject<Backend>::GetScanStatus(const Napi::CallbackInfo& info) {
+    return SessionStatusToObject(info.Env(), selected_.get());
+}
+
+template <typename Backend>
+Napi::Value ScannerObject<Backend>::GetMetrics(const Napi::CallbackInfo& info) {
+    return SessionMetricsToObject(info.Env(), selected_.get());
+}
+
+template <typename Backend>
+Napi::Value ScannerObject<Backend>::OnMetrics(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 1 || !info[0].IsFunction()) {
+        Napi::TypeError::New(env, "Callback expected").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    metricsEvents_ = std::make_shared<MetricsEventEmitter>(env, info[0].As<Napi::Function>());
+    std::shared_ptr<MetricsEventEmitter> events = metricsEvents_;
+    sessions_.SetMetricsListener([events](int sessionId, const std::string& deviceId, const PageMetrics& page) {
+        events->Emit(sessionId, deviceId, page);
+    });
+
+    return env.Undefined();
+}
+
+template <typename Backend>
+Napi::Value ScannerObject<Backend>::OpenSession(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (!RequireInitialized(info)) {
+        return env.Null();
+    }
+    if (info.Length() < 1 || !info[0].IsString()) {
+        Napi::TypeError::New(env, "Device ID expected").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    std::string error;
+    std::shared_ptr<ScanSession> session = sessions_.Open(info[0].As<Napi::String>().Utf8Value(), error);
+    if (!session) {
+        Napi::Error::New(env, error).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    if (session == selected_) {
+        ownsSelected_ = false;
+    }
+    return Napi::Number::New(env, session->id);
+}
+
+template <typename Backend>
+Napi::Value ScannerObject<Backend>::CloseSession(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    std::shared_ptr<ScanSession> session = SessionFromArgs(info, sessions_);
+    if (!session) {
+        return env.Null();
+    }
+    std::string error;
+    if (!sessions_.Close(session->id, error)) {
+        Napi::Error::New(env, error).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    if (selected_ == session) {
+        selected_.reset();
+        ownsSelected_ = false;
+    }
+    return Napi::Boolean::New(env, true);
+}
+
+template <typename Backend>
+Napi::Value ScannerObject<Backend>::GetSessions(const Napi::CallbackInfo& info) {
+    return SessionsToArray(info.Env(), sessions_);
+}
+
+template <typename Backend>
+Napi::Value ScannerObject<Backend>::SessionScan(const Napi::CallbackInfo& info) {
+    std::shared_ptr<ScanSession> session = SessionFromArgs(info, sessions_);
+    if (!session) {
+        return info.Env().Null();
+    }
+    return QueueSessionScan(info, 1, session, AcquireFor(session));
+}
+
+template <typename Backend>
+Napi::Value ScannerObject<Backend>::SessionScanStream(const Napi::CallbackInfo& info) {
+    std::shared_ptr<ScanSession> session = SessionFromArgs(info, sessions_);
+    if (!session) {
+        return info.Env().Null();
+    }
+    return QueueSessionScanStream(info, 1, session, AcquireFor(session));
+}
+
+template <typename Backend>
+Napi::Value ScannerObject<Backend>::SessionScanBatch(const Napi::CallbackInfo& info) {
+    std::shared_ptr<ScanSession> session = SessionFromArgs(info, sessions_);
+    if (!session) {
+        return info.Env().Null();
+    }
+    return QueueSessionScanBatch(info, 1, session, AcquireFor(session));
+}
+
+template <typename Backend>
+Napi::Value ScannerObject<Backend>::SessionPreview(const Napi::CallbackInfo& info) {
+    std::shared_ptr<ScanSession> session = SessionFromArgs(info, sessions_);
+    if (!session) {
+        return info.Env().Null();
+    }
+    return QueueSessionPreview(info, 1, session, AcquireFor(session));
+}
+
+template <typename Backend>
+Napi::Value ScannerObject<Backend>::SessionCancelScan(const Napi::CallbackInfo& info) {
+    std::shared_ptr<ScanSession> session = SessionFromArgs(info, sessions_);
+    if (!session) {
+        return info.Env().Null();
+    }
+    return CancelSessionScan(info.Env(), session.get());
+}
+
+template <typename Backend>
+Napi::Value ScannerObject<Backend>::SessionGetScanStatus(const Napi::CallbackInfo& info) {
+    std::shared_ptr<ScanSession> session = SessionFromArgs(info, sessions_);
+    if (!session) {
+        return info.Env().Null();
+    }
+    return SessionStatusToObject(info.Env(), session.get());
+}
+
+template <typename Backend>
+Napi::Value ScannerObject<Backend>::SessionGetMetrics(const Napi::CallbackInfo& info) {
+    std::shared_ptr<ScanSession> session = SessionFromArgs(info, sessions_);
+    if (!session) {
+        return info.Env().Null();
+    }
+    return SessionMetricsToObject(info.Env(), session.get());
+}
+
+template <typename Backend>
+Napi::Value ScannerObject<Backend>::Close(const Napi::CallbackInfo& info) {
+    sessions_.CloseAll();
+    selected_.reset();
+    ownsSelected_ = false;
+    static_cast<Backend*>(this)->OnClose();
+    isInitialized_ = false;
+    return Napi::Boolean::New(info.Env(), true);
+}
+
+} // namespace ScannerCore
+
+#endif // SCANNER_CORE_SCANNER_OBJECT_H
@@ -0,0 +1,355 @@
+/**
+ * Scanner Core Separator Sheet Detection Implementation
+ */
+
+#include "separatorSheet.h"
+#include "binarize.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+namespace ScannerCore {
+
+namespace {
+
+// Patch sampling grid
+constexpr int kPatchSamplesPerInch = 100;
+constexpr int kPatchColumnsPerInch = 16;
+
+// Full-resolution rows read for barcodes
+constexpr int kBarcodeRowsPerInch = 20;
+
+// Patch samples darker than this are bar
+constexpr int kInkLevel = 128;
+
+// Patch bars and spaces, and the blank paper around the code, in inches
+constexpr double kPatchMinElement = 0.04;
+constexpr double kPatchMaxElement = 0.35;
+constexpr double kPatchQuietZone = 0.15;
+
+// A wide element is at least this many times the narrowest of its kind
+constexpr double kWideRatio = 1.7;
+
+// Code 39 wide elements against the narrow ones
+constexpr double kCode39WideRatio = 1.5;
+
+// Sampled columns (half an inch) that must read the same patch code
+constexpr int kPatchMinColumns = 8;
+
+// Rows that must read the same barcode value
+constexpr int kBarcodeMinRows = 2;
+
+// Rows with less contrast than this hold no barcode
+constexpr int kMinRowContrast = 64;
+
+/**
+ * Patch code bar widths, leading edge first: W wide, N narrow
+ */
+struct PatchPattern {
+    const char* type;
+    const char* bars;
+};
+
+const PatchPattern kPatchPatterns[] = {
+    {"patchT", "WNNW"},
+    {"patch2", "WNWN"},
+    {"patch3", "WWNN"},
+};
+
+const char kCode39Alphabet[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ-. $/+%";
+
+// Wide elements of each Code 39 character, first bar in the top bit
+const uint16_t kCode39Patterns[] = {
+    0x034, 0x121, 0x061, 0x160, 0x031, 0x130, 0x070, 0x025, 0x124, 0x064,
+    0x109, 0x049, 0x148, 0x019, 0x118, 0x058, 0x00D, 0x10C, 0x04C, 0x01C,
+    0x103, 0x043, 0x142, 0x013, 0x112, 0x052, 0x007, 0x106, 0x046, 0x016,
+    0x181, 0x0C1, 0x1C0, 0x091, 0x190, 0x0D0, 0x085, 0x184, 0x0C4, 0x0A8,
+    0x0A2, 0x08A, 0x02A,
+};
+constexpr uint16_t kCode39Asterisk = 0x094;
+
+/**
+ * Patch code on one column, from its light/dark runs (light first and
+ * last); empty when there is none
+ */
+const char* DecodePatchColumn(const std::vector<uint16_t>& runs, int minElement, int maxElement, int quietZone) {
+    for (size_t bar = 1; bar + 7 < runs.size(); bar += 2) {
+        if (runs[bar - 1] < quietZone || runs[bar + 7] < quietZone) {
+            continue;
+        }
+        bool sized = true;
+        for (size_t i = bar; i < bar + 7; i++) {
+            sized = sized && runs[i] >= minElement && runs[i] <= maxElement;
+        }
+        if (!sized) {
+            continue;
+        }
+
+        const int narrowest = std::min({runs[bar], runs[bar + 2], runs[bar + 4], runs[bar + 6]});
+        char bars[5] = {};
+        char reversed[5] = {};
+        for (int i = 0; i < 4; i++) {
+            bars[i] = runs[bar + 2 * i] >= narrowest * kWideRatio ? 'W' : 'N';
+            reversed[3 - i] = bars[i];
+        }
+        // Sheets fed upside down read the code back to front
+        for (const PatchPattern& pattern : kPatchPatterns) {
+            if (std::strcmp(bars, pattern.bars) == 0 || std::strcmp(reversed, pattern.bars) == 0) {
+                return pattern.type;
+            }
+        }
+    }
+    return "";
+}
+
+/**
+ * Wide/narrow pattern of the nine elements at runs[at], or -1; `width`
+ * receives their total width
+ */
+int Code39Pattern(const std::vector<int>& runs, size_t at, bool reversed, int& width) {
+    int sorted[9];
+    width = 0;
+    for (int i = 0; i < 9; i++) {
+        sorted[i] = runs[at + i];
+        width += sorted[i];
+    }
+    std::sort(sorted, sorted + 9, [](int a, int b) { return a > b; });
+    if (sorted[2] < sorted[3] * kCode39WideRatio) {
+        return -1;
+    }
+
+    int pattern = 0;
+    for (int i = 0; i < 9; i++) {
+        const int element = reversed ? 8 - i : i;
+        if (runs[at + element] >= sorted[2]) {
+            pattern |= 1 << (8 - i);
+        }
+    }
+    return pattern;
+}
+
+char Code39Char(int pattern) {
+    for (size_t i = 0; i < sizeof(kCode39Patterns) / sizeof(kCode39Patterns[0]); i++) {
+        if (kCode39Patterns[i] == pattern) {
+            return kCode39Alphabet[i];
+        }
+    }
+    return 0;
+}
+
+/**
+ * First Code 39 symbol along a row's runs (light first and last).
+ * Reversed reads the row right to left, for sheets fed upside down.
+ */
+bool DecodeCode39(const std::vector<int>& runs, bool reversed, std::string& text) {
+    for (size_t start = 1; start + 9 < runs.size(); start += 2) {
+        int width = 0;
+        if (Code39Pattern(runs, start, reversed, width) != kCode39Asterisk || runs[start - 1] * 2 < width) {
+            continue;
+        }
+
+        std::string value;
+        size_t at = start + 10;
+        while (at + 9 < runs.size() && runs[at - 1] * 3 <= width) {
+            int charWidth = 0;
+            const int pattern = Code39Pattern(runs, at, reversed, charWidth);
+            if (pattern < 0 || std::abs(charWidth - width) * 4 > width) {
+                break;
+            }
+            if (pattern == kCode39Asterisk) {
+                if (!value.empty() && runs[at + 9] * 2 >= width) {
+                    if (reversed) {
+                        std::reverse(value.begin(), value.end());
+                    }
+                    text = value;
+                    return true;
+                }
+                break;
+            }
+            const char c = Code39Char(pattern);
+            if (c == 0) {
+                break;
+            }
+            value += c;
+            at += 10;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+bool ParseSeparationMode(const std::string& name, SeparationMode& mode) {
+    if (name == "none") {
+        mode = SeparationMode::Off;
+    } else if (name == "patch") {
+        mode = SeparationMode::Patch;
+    } else if (name == "barcode") {
+        mode = SeparationMode::Barcode;
+    } else if (name == "any") {
+        mode = SeparationMode::Any;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool SeparatorEligible(const ScanSettings& settings, int pageIndex) {
+    SeparationMode mode = SeparationMode::Off;
+    ParseSeparationMode(settings.separation, mode);
+    return mode != SeparationMode::Off && (!settings.duplex || pageIndex % 2 == 0);
+}
+
+SeparatorDetector::SeparatorDetector(const ScanSettings& settings)
+    : patch_(false), barcode_(false), barcodePrefix_(settings.separatorBarcode) {
+    SeparationMode mode = SeparationMode::Off;
+    ParseSeparationMode(settings.separation, mode);
+    patch_ = mode == SeparationMode::Patch || mode == SeparationMode::Any;
+    barcode_ = mode == SeparationMode::Barcode || mode == SeparationMode::Any;
+}
+
+void SeparatorDetector::BeginPage(const PageGeometry& geometry) {
+    geometry_ = geometry;
+    measuring_ = geometry.encoding == ImageEncoding::Raw && geometry.width > 0 && (patch_ || barcode_);
+    row_ = 0;
+
+    const int resolution = geometry.resolution > 0 ? geometry.resolution : 300;
+    sampleStep_ = std::max(1, resolution / kPatchSamplesPerInch);
+    barcodeStep_ = std::max(1, resolution / kBarcodeRowsPerInch);
+    columnStep_ = std::max(1, resolution / kPatchColumnsPerInch);
+
+    rows_.BeginPage(geometry.pixelFormat, geometry.width);
+    gray_.resize(geometry.width);
+
+    const int columns = patch_ ? geometry.width / columnStep_ : 0;
+    columnRuns_.assign(columns, std::vector<uint16_t>(1, 0));
+    columnDark_.assign(columns, 0);
+
+    barcodes_.clear();
+    foundBarcode_.clear();
+}
+
+void SeparatorDetector::OnBand(const ScanBand& band) {
+    if (!measuring_ || !band.pixels) {
+        return;
+    }
+    for (int r = 0; r < band.rows; r++, row_++) {
+        const bool patchRow = patch_ && row_ % sampleStep_ == 0;
+        const bool barcodeRow = barcode_ && foundBarcode_.empty() && row_ % barcodeStep_ == 0;
+        if (!patchRow && !barcodeRow) {
+            continue;
+        }
+
+        const uint8_t* gray = rows_.Convert(band.pixels->Data() + static_cast<size_t>(r) * geometry_.stride);
+        if (Channels(geometry_.pixelFormat) == 3) {
+            Imaging::ToGrayRow(gray, geometry_.width, 3, gray_.data());
+            gray = gray_.data();
+        }
+        if (patchRow) {
+            AddRow(gray);
+        }
+        if (barcodeRow) {
+            ReadBarcodeRow(gray);
+        }
+    }
+}
+
+void SeparatorDetector::AddRow(const uint8_t* gray) {
+    // Each column sample is the mean of about 1/100 inch of the row
+    const int span = sampleStep_;
+    for (size_t column = 0; column < columnRuns_.size(); column++) {
+        const int x = static_cast<int>(column) * columnStep_ + (columnStep_ - span) / 2;
+        int sum = 0;
+        for (int i = 0; i < span; i++) {
+            sum += gray[x + i];
+        }
+        const uint8_t dark = sum < kInkLevel * span;
+
+        std::vector<uint16_t>& runs = columnRuns_[column];
+        if (dark != columnDark_[column]) {
+            runs.push_back(0);
+            columnDark_[column] = dark;
+        }
+        if (runs.back() < UINT16_MAX) {
+            runs.back()++;
+        }
+    }
+}
+
+void SeparatorDetector::ReadBarcodeRow(const uint8_t* gray) {
+    const int width = geometry_.width;
+    const auto range = std::minmax_element(gray, gray + width);
+    if (*range.second - *range.first < kMinRowContrast) {
+        return;
+    }
+    const int threshold = (*range.first + *range.second) / 2;
+
+    // Light/dark run lengths, starting and ending with light
+    runs_.assign(1, 0);
+    bool dark = false;
+    for (int x = 0; x < width; x++) {
+        const bool pixelDark = gray[x] < threshold;
+        if (pixelDark != dark) {
+            runs_.push_back(0);
+            dark = pixelDark;
+        }
+        runs_.back()++;
+    }
+    if (dark) {
+        runs_.push_back(0);
+    }
+
+    std::string value;
+    if (!DecodeCode39(runs_, false, value) && !DecodeCode39(runs_, true, value)) {
+        return;
+    }
+    if (value.compare(0, barcodePrefix_.size(), barcodePrefix_) != 0) {
+        return;
+    }
+    if (++barcodes_[value] >= kBarcodeMinRows) {
+        foundBarcode_ = value;
+    }
+}
+
+SeparatorMark SeparatorDetector::Finish() {
+    SeparatorMark mark;
+    if (!measuring_) {
+        return mark;
+    }
+    if (!foundBarcode_.empty()) {
+        mark.type = "code39";
+        mark.value = foundBarcode_;
+        return mark;
+    }
+    if (!patch_) {
+        return mark;
+    }
+
+    const int resolution = geometry_.resolution > 0 ? geometry_.resolution : 300;
+    const double samplesPerInch = static_cast<double>(resolution) / sampleStep_;
+    const int minElement = std::max(1, static_cast<int>(kPatchMinElement * samplesPerInch));
+    const int maxElement = static_cast<int>(kPatchMaxElement * samplesPerInch + 0.5);
+    const int quietZone = static_cast<int>(kPatchQuietZone * samplesPerInch);
+
+    // The bars cross the sheet, so the code must read alike on a run of
+    // neighbouring columns; text and pictures do not
+    const char* previous = "";
+    int agreeing = 0;
+    for (size_t column = 0; column < columnRuns_.size(); column++) {
+        std::vector<uint16_t>& runs = columnRuns_[column];
+        if (columnDark_[column]) {
+            runs.push_back(0);
+            columnDark_[column] = 0;
+        }
+        const char* type = DecodePatchColumn(runs, minElement, maxElement, quietZone);
+        agreeing = *type && std::strcmp(type, previous) == 0 ? agreeing + 1 : 1;
+        previous = type;
+        if (*type && agreeing >= kPatchMinColumns) {
+            mark.type = type;
+            return mark;
+        }
+    }
+    return mark;
+}
+
+} // namespace ScannerCore
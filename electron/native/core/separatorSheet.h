@@ -0,0 +1,99 @@
+/**
+ * Scanner Core Separator Sheet Detection
+ *
+ * Recognises the separator sheets a mailroom puts between documents in
+ * an ADF stack, while the sheet's bands arrive, so a batch can split the
+ * feed into documents without a second pass over the pixels. Two kinds
+ * of separator are read:
+ *
+ * - Patch codes T, 2 and 3: four bars parallel to the leading edge,
+ *   read down columns sampled every 1/16 inch from rows taken every
+ *   1/100 inch.
+ * - Code 39 barcodes with vertical bars, read across full-resolution
+ *   rows taken every 1/20 inch, in either direction.
+ */
+
+#ifndef SCANNER_CORE_SEPARATOR_SHEET_H
+#define SCANNER_CORE_SEPARATOR_SHEET_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+#include "bandStream.h"
+#include "pixelKernels.h"
+
+namespace ScannerCore {
+
+/**
+ * Which codes mark a separator sheet ("none", "patch", "barcode", "any")
+ */
+enum class SeparationMode {
+    Off,
+    Patch,
+    Barcode,
+    Any
+};
+
+bool ParseSeparationMode(const std::string& name, SeparationMode& mode);
+
+/**
+ * True when batch page `pageIndex` is checked for a separator code.
+ * Duplex stacks are checked on the fronts; the back of a separator
+ * sheet belongs to it.
+ */
+bool SeparatorEligible(const ScanSettings& settings, int pageIndex);
+
+/**
+ * Code found on a sheet; `type` is empty when there is none
+ */
+struct SeparatorMark {
+    std::string type;   // "patchT", "patch2", "patch3" or "code39"
+    std::string value;  // barcode text
+
+    bool Found() const { return !type.empty(); }
+};
+
+class SeparatorDetector {
+public:
+    // settings.separation and settings.separatorBarcode select the codes
+    explicit SeparatorDetector(const ScanSettings& settings);
+
+    void BeginPage(const PageGeometry& geometry);
+    void OnBand(const ScanBand& band);
+
+    // The separator code on the page, if any. Pages the device
+    // compressed are never separators.
+    SeparatorMark Finish();
+
+private:
+    void AddRow(const uint8_t* gray);
+    void ReadBarcodeRow(const uint8_t* gray);
+
+    bool patch_;
+    bool barcode_;
+    std::string barcodePrefix_;
+
+    PageGeometry geometry_{};
+    bool measuring_ = false;
+    int row_ = 0;               // page row of the next scanline
+    int sampleStep_ = 1;        // rows between patch samples
+    int barcodeStep_ = 1;       // rows between barcode reads
+    int columnStep_ = 1;        // pixels between patch columns
+    RowConverter rows_;
+    std::vector<uint8_t> gray_;
+
+    // Patch columns: alternating light/dark run lengths in samples,
+    // starting with light
+    std::vector<std::vector<uint16_t>> columnRuns_;
+    std::vector<uint8_t> columnDark_;
+
+    // Barcode values read so far, with the number of rows each was read on
+    std::map<std::string, int> barcodes_;
+    std::string foundBarcode_;
+    std::vector<int> runs_;
+};
+
+} // namespace ScannerCore
+
+#endif // SCANNER_CORE_SEPARATOR_SHEET_H
@@ -0,0 +1,226 @@
+/**
+ * Scanner Core Session Manager Implementation
+ */
+
+#include "sessionManager.h"
+#include "batchWorker.h"
+#include "napiConvert.h"
+#include "previewWorker.h"
+#include "streamWorker.h"
+
+namespace ScannerCore {
+
+SessionManager::SessionManager(SessionOpenFn open) : open_(std::move(open)), nextId_(1) {}
+
+std::shared_ptr<ScanSession> SessionManager::Open(const std::string& deviceId, std::string& error, bool* created) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (created) {
+        *created = false;
+    }
+
+    // A driver handle can only be opened once per device
+    for (const auto& entry : sessions_) {
+        if (entry.second->deviceId == deviceId) {
+            return entry.second;
+        }
+    }
+
+    std::shared_ptr<ScanSession> session = open_(deviceId, error);
+    if (!session) {
+        if (error.empty()) {
+            error = "Could not open device " + deviceId;
+        }
+        return nullptr;
+    }
+
+    session->id = nextId_++;
+    session->deviceId = deviceId;
+    AttachMetrics(*session);
+    sessions_[session->id] = session;
+    if (created) {
+        *created = true;
+    }
+    return session;
+}
+
+void SessionManager::SetMetricsListener(SessionMetricsFn listener) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    metricsListener_ = std::move(listener);
+    for (const auto& entry : sessions_) {
+        AttachMetrics(*entry.second);
+    }
+}
+
+void SessionManager::AttachMetrics(ScanSession& session) {
+    if (!metricsListener_) {
+        session.state->metrics.SetPageListener(nullptr);
+        return;
+    }
+    // The listener holds the id, not the session, so it cannot keep a
+    // closed session alive
+    SessionMetricsFn listener = metricsListener_;
+    const int id = session.id;
+    const std::string deviceId = session.deviceId;
+    session.state->metrics.SetPageListener([listener, id, deviceId](const PageMetrics& page) {
+        listener(id, deviceId, page);
+    });
+}
+
+std::shared_ptr<ScanSession> SessionManager::Find(int id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = sessions_.find(id);
+    return it != sessions_.end() ? it->second : nullptr;
+}
+
+bool SessionManager::Close(int id, std::string& error) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = sessions_.find(id);
+    if (it == sessions_.end()) {
+        error = "Unknown scan session";
+        return false;
+    }
+    if (it->second->state->scanning) {
+        error = "Scan in progress on session";
+        return false;
+    }
+    sessions_.erase(it);
+    return true;
+}
+
+void SessionManager::CloseAll() {
+    std::map<int, std::shared_ptr<ScanSession>> closed;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed.swap(sessions_);
+    }
+}
+
+std::vector<std::shared_ptr<ScanSession>> SessionManager::Sessions() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<std::shared_ptr<ScanSession>> sessions;
+    sessions.reserve(sessions_.size());
+    for (const auto& entry : sessions_) {
+        sessions.push_back(entry.second);
+    }
+    return sessions;
+}
+
+std::shared_ptr<ScanSession> SessionFromArgs(const Napi::CallbackInfo& info, const SessionManager& sessions) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1 || !info[0].IsNumber()) {
+        Napi::TypeError::New(env, "Session ID expected").ThrowAsJavaScriptException();
+        return nullptr;
+    }
+
+    std::shared_ptr<ScanSession> session = sessions.Find(info[0].As<Napi::Number>().Int32Value());
+    if (!session) {
+        Napi::Error::New(env, "Unknown scan session").ThrowAsJavaScriptException();
+    }
+    return session;
+}
+
+Napi::Value QueueSessionScan(const Napi::CallbackInfo& info,
+                             size_t first,
+                             const std::shared_ptr<ScanSession>& session,
+                             BandAcquireFn acquire) {
+    Napi::Env env = info.Env();
+    ScanSettings settings = ParseScanSettings(info.Length() > first ? info[first] : env.Undefined());
+    ApplyPreviewCrop(settings, session->state->previews);
+
+    // Acquisition runs off the main thread; the returned Promise settles
+    // once the transfer has finished
+    return QueueScan(env, settings, std::move(acquire), session->state);
+}
+
+Napi::Value QueueSessionScanStream(const Napi::CallbackInfo& info,
+                                   size_t first,
+                                   const std::shared_ptr<ScanSession>& session,
+                                   BandAcquireFn acquire) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < first + 2 || !info[first + 1].IsFunction()) {
+        Napi::TypeError::New(env, "Band callback expected").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    ScanSettings settings = ParseScanSettings(info[first]);
+    ApplyPreviewCrop(settings, session->state->previews);
+    return QueueScanStream(env, settings, std::move(acquire), info[first + 1].As<Napi::Function>(), session->state);
+}
+
+Napi::Value QueueSessionScanBatch(const Napi::CallbackInfo& info,
+                                  size_t first,
+                                  const std::shared_ptr<ScanSession>& session,
+                                  BandAcquireFn acquire) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < first + 3 || !info[first + 1].IsNumber() || !info[first + 2].IsFunction()) {
+        Napi::TypeError::New(env, "Page count and page callback expected").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    ScanSettings settings = ParseScanSettings(info[first]);
+    ApplyPreviewCrop(settings, session->state->previews);
+    int maxPages = info[first + 1].As<Napi::Number>().Int32Value();
+
+    // The output options may carry an onThumbnails callback as well
+    Napi::Function onThumbnails;
+    if (info[first + 3].IsObject()) {
+        Napi::Value callback = info[first + 3].As<Napi::Object>().Get("onThumbnails");
+        if (callback.IsFunction()) {
+            onThumbnails = callback.As<Napi::Function>();
+        }
+    }
+
+    return QueueScanBatch(env, settings, maxPages, std::move(acquire), info[first + 2].As<Napi::Function>(),
+                          session->state, ParsePdfOutput(info[first + 3]), ParseSpoolOutput(info[first + 3]),
+                          onThumbnails);
+}
+
+Napi::Value QueueSessionPreview(const Napi::CallbackInfo& info,
+                                size_t first,
+                                const std::shared_ptr<ScanSession>& session,
+                                BandAcquireFn acquire) {
+    Napi::Env env = info.Env();
+    ScanSettings settings = ParseScanSettings(info.Length() > first ? info[first] : env.Undefined());
+    return QueuePreview(env, settings, std::move(acquire), session->state);
+}
+
+Napi::Object SessionStatusToObject(Napi::Env env, const ScanSession* session) {
+    if (session) {
+        return ScanStatusToObject(env, *session->state);
+    }
+    Napi::Object status = Napi::Object::New(env);
+    status.Set("isScanning", false);
+    return status;
+}
+
+Napi::Value CancelSessionScan(Napi::Env env, ScanSession* session) {
+    return Napi::Boolean::New(env, session != nullptr && CancelAcquisition(*session->state));
+}
+
+Napi::Object SessionMetricsToObject(Napi::Env env, const ScanSession* session) {
+    if (session) {
+        return ScanMetricsToObject(env, *session->state);
+    }
+    // Same shape with nothing recorded
+    ScanState idle;
+    return ScanMetricsToObject(env, idle);
+}
+
+Napi::Array SessionsToArray(Napi::Env env, const SessionManager& sessions) {
+    std::vector<std::shared_ptr<ScanSession>> open = sessions.Sessions();
+    Napi::Array array = Napi::Array::New(env, open.size());
+
+    for (size_t i = 0; i < open.size(); i++) {
+        Napi::Object obj = Napi::Object::New(env);
+        obj.Set("sessionId", open[i]->id);
+        obj.Set("deviceId", open[i]->deviceId);
+        obj.Set("isScanning", open[i]->state->scanning.load());
+        array.Set(static_cast<uint32_t>(i), obj);
+    }
+    return array;
+}
+
+} // namespace ScannerCore
@@ -0,0 +1,139 @@
+/**
+ * Scanner Core Session Manager
+ *
+ * Keeps several devices open on one scanner object at once. Every
+ * session owns its driver handle (a subclass of ScanSession per
+ * wrapper), its own ScanState and therefore its own buffer pool, so
+ * two or three ADF scanners on one PC can feed concurrently, each on
+ * its own acquisition thread.
+ */
+
+#ifndef SCANNER_CORE_SESSION_MANAGER_H
+#define SCANNER_CORE_SESSION_MANAGER_H
+
+#include <napi.h>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "bandStream.h"
+#include "scanWorker.h"
+
+namespace ScannerCore {
+
+/**
+ * One open device. Wrappers derive from it to hold the driver handle
+ * and release that handle in their destructor, which runs once the
+ * session is closed and no acquisition references it any more.
+ */
+struct ScanSession {
+    virtual ~ScanSession() = default;
+
+    int id = 0;
+    std::string deviceId;
+    std::shared_ptr<ScanState> state = std::make_shared<ScanState>();
+
+    // Compressed transfers the driver offers, queried when the device is
+    // opened; see TransferEncodingFor()
+    std::vector<ImageEncoding> transferEncodings;
+};
+
+/**
+ * Opens the driver handle for a device; returns nullptr and sets error
+ * on failure. Called on the JavaScript thread.
+ */
+using SessionOpenFn = std::function<std::shared_ptr<ScanSession>(const std::string& deviceId,
+                                                                 std::string& error)>;
+
+/**
+ * Receives every session's finished page metrics. Called on whichever
+ * thread finished the page.
+ */
+using SessionMetricsFn = std::function<void(int sessionId, const std::string& deviceId, const PageMetrics& page)>;
+
+class SessionManager {
+public:
+    explicit SessionManager(SessionOpenFn open);
+
+    // Existing session for the device, or a newly opened one (then
+    // *created is set)
+    std::shared_ptr<ScanSession> Open(const std::string& deviceId, std::string& error, bool* created = nullptr);
+
+    std::shared_ptr<ScanSession> Find(int id) const;
+
+    // Fails while the session is scanning
+    bool Close(int id, std::string& error);
+
+    // Forget every session; in-flight scans keep theirs until they finish
+    void CloseAll();
+
+    std::vector<std::shared_ptr<ScanSession>> Sessions() const;
+
+    // Route page metrics of every open and future session to `listener`
+    void SetMetricsListener(SessionMetricsFn listener);
+
+private:
+    void AttachMetrics(ScanSession& session);
+
+    SessionOpenFn open_;
+    SessionMetricsFn metricsListener_;
+    mutable std::mutex mutex_;
+    std::map<int, std::shared_ptr<ScanSession>> sessions_;
+    int nextId_;
+};
+
+/**
+ * Look up the session whose id is info[0]. Throws and returns nullptr
+ * if the argument is missing or names no open session.
+ */
+std::shared_ptr<ScanSession> SessionFromArgs(const Napi::CallbackInfo& info, const SessionManager& sessions);
+
+/**
+ * scan / scanStream / scanBatch / preview on a session. `first` is the
+ * index of the settings argument; the remaining arguments follow it
+ * exactly as in the selected-device methods. Settings with
+ * usePreviewCrop take their scan area from the session's last preview.
+ */
+Napi::Value QueueSessionScan(const Napi::CallbackInfo& info,
+                             size_t first,
+                             const std::shared_ptr<ScanSession>& session,
+                             BandAcquireFn acquire);
+Napi::Value QueueSessionScanStream(const Napi::CallbackInfo& info,
+                                   size_t first,
+                                   const std::shared_ptr<ScanSession>& session,
+                                   BandAcquireFn acquire);
+Napi::Value QueueSessionScanBatch(const Napi::CallbackInfo& info,
+                                  size_t first,
+                                  const std::shared_ptr<ScanSession>& session,
+                                  BandAcquireFn acquire);
+Napi::Value QueueSessionPreview(const Napi::CallbackInfo& info,
+                                size_t first,
+                                const std::shared_ptr<ScanSession>& session,
+                                BandAcquireFn acquire);
+
+/**
+ * { isScanning } for a session; a null session is idle
+ */
+Napi::Object SessionStatusToObject(Napi::Env env, const ScanSession* session);
+
+/**
+ * Cancel the session's in-flight scan. Returns a Boolean right away:
+ * false when the session is idle (or null)
+ */
+Napi::Value CancelSessionScan(Napi::Env env, ScanSession* session);
+
+/**
+ * ScanMetrics for a session; a null session reports no activity
+ */
+Napi::Object SessionMetricsToObject(Napi::Env env, const ScanSession* session);
+
+/**
+ * [{ sessionId, deviceId, isScanning }] for every open session
+ */
+Napi::Array SessionsToArray(Napi::Env env, const SessionManager& sessions);
+
+} // namespace ScannerCore
+
+#endif // SCANNER_CORE_SESSION_MANAGER_H
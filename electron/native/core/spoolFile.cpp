@@ -0,0 +1,311 @@
+/**
+ * Scanner Core Page Spool Implementation
+ */
+
+#include "spoolFile.h"
+#include <cerrno>
+#include <cstring>
+
+namespace ScannerCore {
+
+namespace {
+
+// Little-endian on every supported target; the structs are written as-is
+constexpr char kSpoolMagic[8] = {'P', 'F', 'S', 'P', 'O', 'O', 'L', '1'};
+constexpr uint32_t kSpoolVersion = 1;
+constexpr uint32_t kRecordMagic = 0x47504650;  // "PFPG"
+
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+    uint32_t pageCount;     // committed pages
+    uint32_t reserved;
+    uint64_t committedEnd;  // file offset after the last committed record
+    uint8_t padding[32];
+};
+static_assert(sizeof(FileHeader) == 64, "spool header layout");
+
+struct RecordHeader {
+    uint32_t magic;
+    uint32_t pageIndex;
+    int32_t width;
+    int32_t height;
+    int32_t stride;
+    int32_t resolution;
+    uint8_t pixelFormat;
+    uint8_t encoding;
+    uint16_t reserved;
+    uint32_t checksum;
+    uint64_t dataSize;
+    double scanArea[4];  // left, top, width, height in inches
+    char colorMode[24];
+};
+static_assert(sizeof(RecordHeader) == 96, "spool record layout");
+
+// Records start on 8-byte boundaries
+uint64_t Align8(uint64_t offset) {
+    return (offset + 7) & ~static_cast<uint64_t>(7);
+}
+
+FileHeader MakeHeader(int pageCount, uint64_t end) {
+    FileHeader header{};
+    std::memcpy(header.magic, kSpoolMagic, sizeof(kSpoolMagic));
+    header.version = kSpoolVersion;
+    header.headerSize = sizeof(FileHeader);
+    header.pageCount = static_cast<uint32_t>(pageCount);
+    header.committedEnd = end;
+    return header;
+}
+
+bool ValidHeader(const FileHeader& header) {
+    return std::memcmp(header.magic, kSpoolMagic, sizeof(kSpoolMagic)) == 0 && header.version == kSpoolVersion &&
+           header.headerSize == sizeof(FileHeader) && header.committedEnd >= sizeof(FileHeader);
+}
+
+} // namespace
+
+uint32_t SpoolChecksum(const uint8_t* data, size_t size) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ data[i]) * 16777619u;
+    }
+    return hash;
+}
+
+SpoolWriter::~SpoolWriter() {
+    std::string error;
+    Close(error);
+}
+
+bool SpoolWriter::Open(const std::string& path, bool resume, std::string& error) {
+    // A new spool replaces the old file instead of truncating it: Buffers
+    // readSpool() handed out may still map its pages, and cutting the
+    // file from under them would fault on their next access
+    if (!resume && !RemoveFile(path)) {
+        error = "Cannot replace spool: " + std::string(std::strerror(errno));
+        return false;
+    }
+
+    fd_ = OpenFile(path, FileMode::ReadWrite);
+    if (fd_ < 0) {
+        error = "Cannot open spool: " + std::string(std::strerror(errno));
+        return false;
+    }
+
+    pageCount_ = 0;
+    corruptPages_ = 0;
+    end_ = sizeof(FileHeader);
+    offsets_.clear();
+
+    if (resume && FileSize(fd_) > 0) {
+        SpoolReader reader;
+        if (!reader.Open(path, error)) {
+            CloseFile(fd_);
+            fd_ = -1;
+            return false;
+        }
+        pageCount_ = reader.IntactPages();
+        corruptPages_ = reader.PageCount() - pageCount_;
+        for (int i = 0; i < pageCount_; i++) {
+            offsets_.push_back(reader.Page(i).offset);
+        }
+        if (pageCount_ > 0) {
+            end_ = reader.Page(pageCount_ - 1).end;
+        }
+    }
+
+    // A resumed spool keeps its size. A record torn by a crash or failing
+    // its checksum lies past the committed end, where readers never look,
+    // and the next append overwrites it. Shrinking the file would fault
+    // live readers' views, and Windows refuses it while one is open.
+    if (!Commit()) {
+        error = "Cannot initialise spool: " + std::string(std::strerror(errno));
+        CloseFile(fd_);
+        fd_ = -1;
+        return false;
+    }
+    return true;
+}
+
+bool SpoolWriter::Commit() {
+    FileHeader header = MakeHeader(pageCount_, end_);
+    return WriteAt(fd_, 0, &header, sizeof(header)) && SyncFile(fd_);
+}
+
+bool SpoolWriter::Append(const ScanResult& page, std::string& error) {
+    if (fd_ < 0) {
+        error = "Spool is not open";
+        return false;
+    }
+    const std::shared_ptr<PixelBuffer>& data = page.encoded ? page.encoded : page.pixels;
+    if (!page.success || !data) {
+        error = "Page has no image data";
+        return false;
+    }
+
+    RecordHeader record{};
+    record.magic = kRecordMagic;
+    record.pageIndex = static_cast<uint32_t>(pageCount_);
+    record.width = page.width;
+    record.height = page.height;
+    record.stride = page.stride;
+    record.resolution = page.resolution;
+    record.pixelFormat = static_cast<uint8_t>(page.pixelFormat);
+    record.encoding = static_cast<uint8_t>(page.encoded ? page.encoding : ImageEncoding::Raw);
+    record.checksum = SpoolChecksum(data->Data(), data->Size());
+    record.dataSize = data->Size();
+    record.scanArea[0] = page.scanArea.left;
+    record.scanArea[1] = page.scanArea.top;
+    record.scanArea[2] = page.scanArea.width;
+    record.scanArea[3] = page.scanArea.height;
+    std::strncpy(record.colorMode, page.colorMode.c_str(), sizeof(record.colorMode) - 1);
+
+    const uint64_t next = Align8(end_ + sizeof(record) + data->Size());
+    const uint8_t padding[8] = {};
+
+    // Record first, then the header that commits it
+    bool ok = WriteAt(fd_, end_, &record, sizeof(record)) && WriteAll(fd_, data->Data(), data->Size()) &&
+              WriteAll(fd_, padding, static_cast<size_t>(next - end_ - sizeof(record) - data->Size())) &&
+              SyncFile(fd_);
+    if (ok) {
+        offsets_.push_back(end_);
+        pageCount_++;
+        end_ = next;
+        ok = Commit();
+    }
+
+    if (!ok) {
+        error = "Failed to write spool page: " + std::string(std::strerror(errno));
+    }
+    return ok;
+}
+
+bool SpoolWriter::Close(std::string& error) {
+    if (fd_ < 0) {
+        return true;
+    }
+    bool ok = CloseFile(fd_);
+    fd_ = -1;
+    if (!ok) {
+        error = "Failed to close spool";
+    }
+    return ok;
+}
+
+bool SpoolReader::MapHeader(const std::string& path,
+                            uint64_t& committedEnd,
+                            uint32_t& pageCount,
+                            std::string& error) {
+    pages_.clear();
+    if (!file_.Open(path, error)) {
+        return false;
+    }
+
+    FileHeader header;
+    if (file_.Size() < sizeof(header)) {
+        error = "Not a page spool: " + path;
+        return false;
+    }
+    std::memcpy(&header, file_.Data(), sizeof(header));
+    if (!ValidHeader(header) || header.committedEnd > file_.Size()) {
+        error = "Not a page spool: " + path;
+        return false;
+    }
+    committedEnd = header.committedEnd;
+    pageCount = header.pageCount;
+    return true;
+}
+
+bool SpoolReader::ParseRecord(uint32_t index, uint64_t offset, uint64_t committedEnd, SpoolPage& page) const {
+    RecordHeader record;
+    if (offset + sizeof(record) > committedEnd) {
+        return false;
+    }
+    std::memcpy(&record, file_.Data() + offset, sizeof(record));
+    if (record.magic != kRecordMagic || record.pageIndex != index ||
+        record.dataSize > committedEnd - offset - sizeof(record) ||
+        record.encoding > static_cast<uint8_t>(ImageEncoding::CcittG4) ||
+        record.pixelFormat > static_cast<uint8_t>(PixelFormat::Rgb48)) {
+        return false;
+    }
+
+    page.index = static_cast<int>(index);
+    page.width = record.width;
+    page.height = record.height;
+    page.stride = record.stride;
+    page.pixelFormat = static_cast<PixelFormat>(record.pixelFormat);
+    page.resolution = record.resolution;
+    page.encoding = static_cast<ImageEncoding>(record.encoding);
+    page.colorMode.assign(record.colorMode, strnlen(record.colorMode, sizeof(record.colorMode)));
+    page.scanArea = ScanArea{record.scanArea[0], record.scanArea[1], record.scanArea[2], record.scanArea[3]};
+    page.checksum = record.checksum;
+    page.data = file_.Data() + offset + sizeof(record);
+    page.size = static_cast<size_t>(record.dataSize);
+    page.offset = offset;
+    page.end = Align8(offset + sizeof(record) + record.dataSize);
+    return true;
+}
+
+bool SpoolReader::Open(const std::string& path, std::string& error) {
+    uint64_t committedEnd = 0;
+    uint32_t pageCount = 0;
+    if (!MapHeader(path, committedEnd, pageCount, error)) {
+        return false;
+    }
+
+    // Only the record headers are read; page data stays on disk until used
+    uint64_t offset = sizeof(FileHeader);
+    for (uint32_t i = 0; i < pageCount; i++) {
+        SpoolPage page;
+        if (!ParseRecord(i, offset, committedEnd, page)) {
+            error = "Spool is corrupt at page " + std::to_string(i);
+            pages_.clear();
+            return false;
+        }
+        offset = page.end;
+        pages_.push_back(std::move(page));
+    }
+    return true;
+}
+
+bool SpoolReader::OpenPage(const std::string& path, int index, uint64_t offset, std::string& error) {
+    uint64_t committedEnd = 0;
+    uint32_t pageCount = 0;
+    if (!MapHeader(path, committedEnd, pageCount, error)) {
+        return false;
+    }
+
+    SpoolPage page;
+    if (index < 0 || static_cast<uint32_t>(index) >= pageCount || offset < sizeof(FileHeader) ||
+        offset != Align8(offset) || !ParseRecord(static_cast<uint32_t>(index), offset, committedEnd, page)) {
+        error = "No spool page " + std::to_string(index) + " at this handle";
+        return false;
+    }
+    pages_.push_back(std::move(page));
+    return true;
+}
+
+bool SpoolReader::Verify(int index) const {
+    const SpoolPage& page = pages_[index];
+    return SpoolChecksum(page.data, page.size) == page.checksum;
+}
+
+bool SpoolReader::VerifyAll(std::string& error) const {
+    const int intact = IntactPages();
+    if (intact < PageCount()) {
+        error = "Spool page " + std::to_string(intact) + " fails its checksum";
+        return false;
+    }
+    return true;
+}
+
+int SpoolReader::IntactPages() const {
+    int count = 0;
+    while (count < PageCount() && Verify(count)) {
+        count++;
+    }
+    return count;
+}
+
+} // namespace ScannerCore
@@ -0,0 +1,138 @@
+/**
+ * Scanner Core Page Spool
+ *
+ * Append-only file of finished (normally compressed) pages for batch
+ * jobs too large to keep in memory. A 64-byte header records how many
+ * pages are committed and where the committed data ends; each record
+ * is a fixed page header followed by its image bytes. A page counts as
+ * committed only once its bytes and then the header have reached the
+ * disk, so after a crash the batch resumes after the last committed
+ * page. Every record also carries a checksum of its image bytes:
+ * readers refuse a page that fails it, and a resumed spool continues
+ * after the page before it.
+ *
+ * Readers map the whole file and hand page data to the PDF writer or
+ * JavaScript without copying. A page handle also records where its
+ * record starts, so one page is read without indexing the others.
+ */
+
+#ifndef SCANNER_CORE_SPOOL_FILE_H
+#define SCANNER_CORE_SPOOL_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "fileIo.h"
+#include "pdfWriter.h"
+#include "scanTypes.h"
+
+namespace ScannerCore {
+
+/**
+ * Spool output requested for a batch; disabled when path is empty
+ */
+struct SpoolOptions {
+    std::string path;
+    bool resume = false;  // keep the committed pages of an existing spool
+};
+
+/**
+ * One committed page; `data` points into the reader's mapping
+ */
+struct SpoolPage {
+    int index;
+    int width;
+    int height;
+    int stride;
+    PixelFormat pixelFormat;
+    int resolution;
+    ImageEncoding encoding;
+    std::string colorMode;
+    ScanArea scanArea;
+    uint32_t checksum;
+    const uint8_t* data;
+    size_t size;
+    uint64_t offset;  // file offset of its record
+    uint64_t end;     // file offset after its record
+
+    PdfImage Image() const {
+        return PdfImage{width, height, stride, pixelFormat, resolution, encoding, data, size};
+    }
+};
+
+class SpoolWriter {
+public:
+    SpoolWriter() = default;
+    ~SpoolWriter();
+
+    SpoolWriter(const SpoolWriter&) = delete;
+    SpoolWriter& operator=(const SpoolWriter&) = delete;
+
+    // Create the spool, replacing any file at `path`, or with `resume`
+    // reopen it and drop anything after the last committed page whose
+    // data matches its checksum
+    bool Open(const std::string& path, bool resume, std::string& error);
+
+    // Append and commit a page (encoded data, else raw pixels)
+    bool Append(const ScanResult& page, std::string& error);
+
+    bool Close(std::string& error);
+
+    bool IsOpen() const { return fd_ >= 0; }
+    int PageCount() const { return pageCount_; }
+    uint64_t BytesWritten() const { return end_; }
+
+    // File offset of a committed page's record, for SpoolReader::OpenPage()
+    uint64_t PageOffset(int index) const { return offsets_[index]; }
+
+    // Committed pages a resumed spool lost to a checksum mismatch
+    int CorruptPages() const { return corruptPages_; }
+
+private:
+    bool Commit();
+
+    int fd_ = -1;
+    int pageCount_ = 0;
+    int corruptPages_ = 0;
+    uint64_t end_ = 0;
+    std::vector<uint64_t> offsets_;
+};
+
+class SpoolReader {
+public:
+    // Map the spool and index its committed pages
+    bool Open(const std::string& path, std::string& error);
+
+    // Map the spool and index only committed page `index`, whose record
+    // starts at `offset`; that page is then Page(0)
+    bool OpenPage(const std::string& path, int index, uint64_t offset, std::string& error);
+
+    int PageCount() const { return static_cast<int>(pages_.size()); }
+    const SpoolPage& Page(int index) const { return pages_[index]; }
+
+    // Compare a page's data against its checksum
+    bool Verify(int index) const;
+
+    // Verify() every page; `error` names the first that fails
+    bool VerifyAll(std::string& error) const;
+
+    // Leading pages that pass Verify()
+    int IntactPages() const;
+
+private:
+    bool MapHeader(const std::string& path, uint64_t& committedEnd, uint32_t& pageCount, std::string& error);
+    bool ParseRecord(uint32_t index, uint64_t offset, uint64_t committedEnd, SpoolPage& page) const;
+
+    MappedFile file_;
+    std::vector<SpoolPage> pages_;
+};
+
+/**
+ * Checksum stored with each page (FNV-1a, 32-bit)
+ */
+uint32_t SpoolChecksum(const uint8_t* data, size_t size);
+
+} // namespace ScannerCore
+
+#endif // SCANNER_CORE_SPOOL_FILE_H
@@ -0,0 +1,203 @@
+/**
+ * Scanner Core Spool Worker Implementation
+ */
+
+#include "spoolWorker.h"
+#include "napiConvert.h"
+#include "pdfWriter.h"
+#include "spoolFile.h"
+#include <memory>
+#include <string>
+
+namespace ScannerCore {
+
+namespace {
+
+class SpoolToPdfWorker : public Napi::AsyncWorker {
+public:
+    SpoolToPdfWorker(Napi::Env env, std::string spoolPath, PdfOutputOptions pdf)
+        : Napi::AsyncWorker(env, "ScannerSpoolToPdf"),
+          deferred_(Napi::Promise::Deferred::New(env)),
+          spoolPath_(std::move(spoolPath)),
+          pdf_(std::move(pdf)) {}
+
+    Napi::Promise GetPromise() const { return deferred_.Promise(); }
+
+    void Execute() override {
+        SpoolReader reader;
+        PdfWriter writer;
+        success_ = reader.Open(spoolPath_, error_) && writer.Open(pdf_.path, pdf_.info, error_);
+
+        for (int i = 0; success_ && i < reader.PageCount(); i++) {
+            if (!reader.Verify(i)) {
+                success_ = false;
+                error_ = "Spool page " + std::to_string(i) + " fails its checksum";
+                break;
+            }
+            success_ = writer.AddImage(reader.Page(i).Image(), error_);
+            pageCount_ += success_ ? 1 : 0;
+        }
+
+        std::string closeError;
+        if (!writer.Close(closeError) && success_) {
+            success_ = false;
+            error_ = closeError;
+        }
+        bytes_ = writer.BytesWritten();
+    }
+
+    void OnOK() override {
+        Napi::Env env = Env();
+        Napi::Object summary = Napi::Object::New(env);
+        summary.Set("success", success_);
+        summary.Set("pageCount", pageCount_);
+        summary.Set("pdfPath", pdf_.path);
+        summary.Set("pdfBytes", static_cast<double>(bytes_));
+        if (!error_.empty()) {
+            summary.Set("errorMessage", error_);
+        }
+        deferred_.Resolve(summary);
+    }
+
+    void OnError(const Napi::Error& error) override {
+        deferred_.Reject(error.Value());
+    }
+
+private:
+    Napi::Promise::Deferred deferred_;
+    std::string spoolPath_;
+    PdfOutputOptions pdf_;
+    bool success_ = false;
+    int pageCount_ = 0;
+    uint64_t bytes_ = 0;
+    std::string error_;
+};
+
+class ReadSpoolWorker : public Napi::AsyncWorker {
+public:
+    ReadSpoolWorker(Napi::Env env, std::string spoolPath)
+        : Napi::AsyncWorker(env, "ScannerReadSpool"),
+          deferred_(Napi::Promise::Deferred::New(env)),
+          spoolPath_(std::move(spoolPath)),
+          reader_(std::make_shared<SpoolReader>()) {}
+
+    Napi::Promise GetPromise() const { return deferred_.Promise(); }
+
+    void Execute() override {
+        std::string error;
+        if (!reader_->Open(spoolPath_, error) || !reader_->VerifyAll(error)) {
+            SetError(error);
+        }
+    }
+
+    void OnOK() override {
+        Napi::Env env = Env();
+        Napi::Array pages = Napi::Array::New(env, reader_->PageCount());
+        for (int i = 0; i < reader_->PageCount(); i++) {
+            pages.Set(static_cast<uint32_t>(i), SpoolPageToObject(env, reader_, i));
+        }
+        deferred_.Resolve(pages);
+    }
+
+    void OnError(const Napi::Error& error) override {
+        deferred_.Reject(error.Value());
+    }
+
+private:
+    Napi::Promise::Deferred deferred_;
+    std::string spoolPath_;
+    std::shared_ptr<SpoolReader> reader_;
+};
+
+class ReadSpoolPageWorker : public Napi::AsyncWorker {
+public:
+    ReadSpoolPageWorker(Napi::Env env, std::string spoolPath, int index, uint64_t offset)
+        : Napi::AsyncWorker(env, "ScannerReadSpoolPage"),
+          deferred_(Napi::Promise::Deferred::New(env)),
+          spoolPath_(std::move(spoolPath)),
+          index_(index),
+          offset_(offset),
+          reader_(std::make_shared<SpoolReader>()) {}
+
+    Napi::Promise GetPromise() const { return deferred_.Promise(); }
+
+    void Execute() override {
+        std::string error;
+        if (!reader_->OpenPage(spoolPath_, index_, offset_, error)) {
+            SetError(error);
+        } else if (!reader_->Verify(0)) {
+            SetError("Spool page " + std::to_string(index_) + " fails its checksum");
+        }
+    }
+
+    void OnOK() override {
+        deferred_.Resolve(SpoolPageToObject(Env(), reader_, 0));
+    }
+
+    void OnError(const Napi::Error& error) override {
+        deferred_.Reject(error.Value());
+    }
+
+private:
+    Napi::Promise::Deferred deferred_;
+    std::string spoolPath_;
+    int index_;
+    uint64_t offset_;
+    std::shared_ptr<SpoolReader> reader_;
+};
+
+} // namespace
+
+Napi::Value SpoolToPdf(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    PdfOutputOptions pdf = ParsePdfOutput(info.Length() > 1 ? info[1] : env.Undefined());
+    if (info.Length() < 2 || !info[0].IsString() || pdf.path.empty()) {
+        Napi::TypeError::New(env, "Spool path and { pdfPath } expected").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    SpoolToPdfWorker* worker = new SpoolToPdfWorker(env, info[0].As<Napi::String>().Utf8Value(), std::move(pdf));
+    Napi::Promise promise = worker->GetPromise();
+    worker->Queue();
+    return promise;
+}
+
+Napi::Value ReadSpool(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1 || !info[0].IsString()) {
+        Napi::TypeError::New(env, "Spool path expected").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    ReadSpoolWorker* worker = new ReadSpoolWorker(env, info[0].As<Napi::String>().Utf8Value());
+    Napi::Promise promise = worker->GetPromise();
+    worker->Queue();
+    return promise;
+}
+
+Napi::Value ReadSpoolPage(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    const char* expected = "Spool page handle { spoolPath, index, offset } expected";
+    if (info.Length() < 1 || !info[0].IsObject()) {
+        Napi::TypeError::New(env, expected).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    Napi::Object handle = info[0].As<Napi::Object>();
+    if (!handle.Get("spoolPath").IsString() || !handle.Get("index").IsNumber() || !handle.Get("offset").IsNumber()) {
+        Napi::TypeError::New(env, expected).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    ReadSpoolPageWorker* worker =
+        new ReadSpoolPageWorker(env, handle.Get("spoolPath").As<Napi::String>().Utf8Value(),
+                                handle.Get("index").As<Napi::Number>().Int32Value(),
+                                static_cast<uint64_t>(handle.Get("offset").As<Napi::Number>().Int64Value()));
+    Napi::Promise promise = worker->GetPromise();
+    worker->Queue();
+    return promise;
+}
+
+} // namespace ScannerCore
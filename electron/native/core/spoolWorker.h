@@ -0,0 +1,40 @@
+/**
+ * Scanner Core Spool Worker
+ *
+ * JavaScript entry points for batch page spools (see spoolFile.h),
+ * registered as static methods on every scanner class. All map the
+ * spool on a libuv worker thread; none copies page data.
+ */
+
+#ifndef SCANNER_CORE_SPOOL_WORKER_H
+#define SCANNER_CORE_SPOOL_WORKER_H
+
+#include <napi.h>
+
+namespace ScannerCore {
+
+/**
+ * spoolToPdf(spoolPath, { pdfPath, title, author, subject, keywords })
+ * writes every committed page into a PDF, embedding the spooled JPEG
+ * and G4 streams as-is. Resolves with { success, pageCount, pdfPath,
+ * pdfBytes, errorMessage? }.
+ */
+Napi::Value SpoolToPdf(const Napi::CallbackInfo& info);
+
+/**
+ * readSpool(spoolPath) resolves with the committed pages as scan
+ * results in page order, each with a `spoolIndex` and a data Buffer
+ * over the mapped file.
+ */
+Napi::Value ReadSpool(const Napi::CallbackInfo& info);
+
+/**
+ * readSpoolPage({ spoolPath, index, offset }) resolves with the one page
+ * a batch summary's page handle names, as readSpool() returns it. Only
+ * that record is read and checked against its checksum.
+ */
+Napi::Value ReadSpoolPage(const Napi::CallbackInfo& info);
+
+} // namespace ScannerCore
+
+#endif // SCANNER_CORE_SPOOL_WORKER_H
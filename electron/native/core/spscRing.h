@@ -0,0 +1,74 @@
+/**
+ * Scanner Core SPSC Ring
+ *
+ * Fixed-capacity lock-free ring for one producer and one consumer
+ * thread. The producer may change threads between pushes as long as
+ * successive pushes are ordered (as with chained pool tasks); the same
+ * holds for the consumer.
+ */
+
+#ifndef SCANNER_CORE_SPSC_RING_H
+#define SCANNER_CORE_SPSC_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace ScannerCore {
+
+template <typename T>
+class SpscRing {
+public:
+    // Capacity is rounded up to a power of two
+    explicit SpscRing(size_t capacity) : mask_(RoundUp(capacity) - 1), slots_(mask_ + 1) {}
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    // Producer side; false if the ring is full (value is left untouched)
+    bool TryPush(T& value) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_.load(std::memory_order_acquire) > mask_) {
+            return false;
+        }
+        slots_[tail & mask_] = std::move(value);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side; false if the ring is empty
+    bool TryPop(T& value) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        value = std::move(slots_[head & mask_]);
+        slots_[head & mask_] = T();
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t Size() const {
+        return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+    }
+
+    size_t Capacity() const { return mask_ + 1; }
+
+private:
+    static size_t RoundUp(size_t n) {
+        size_t p = 2;
+        while (p < n) p <<= 1;
+        return p;
+    }
+
+    const size_t mask_;
+    std::vector<T> slots_;
+    // Separate cache lines so producer and consumer do not false-share
+    alignas(64) std::atomic<size_t> head_{0};
+    alignas(64) std::atomic<size_t> tail_{0};
+};
+
+} // namespace ScannerCore
+
+#endif // SCANNER_CORE_SPSC_RING_H
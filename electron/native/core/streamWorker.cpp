@@ -0,0 +1,179 @@
+/**
+ * Scanner Core Stream Worker Implementation
+ */
+
+#include "streamWorker.h"
+#include "bitonalSink.h"
+#include "napiConvert.h"
+#include "pageQueue.h"
+#include <exception>
+#include <string>
+#include <thread>
+
+namespace ScannerCore {
+
+namespace {
+
+/**
+ * State owned by one streaming acquisition. Deleted by the TSFN
+ * finalizer once every queued band has been delivered.
+ */
+struct StreamContext {
+    StreamContext(Napi::Env env, size_t highWaterMark)
+        : deferred(Napi::Promise::Deferred::New(env)), budget(highWaterMark) {}
+
+    Napi::Promise::Deferred deferred;
+    Napi::ThreadSafeFunction tsfn;
+    std::thread thread;
+    ScanSettings settings;
+    BandAcquireFn acquire;
+    std::shared_ptr<ScanState> state;
+    int bandRows = kDefaultBandRows;
+    ByteBudget budget;  // band bytes not yet handed to JavaScript
+
+    bool success = false;
+    bool cancelled = false;
+    std::string errorMessage;
+    int pageCount = 0;
+    int bandCount = 0;
+};
+
+/**
+ * Forwards bands to JavaScript, blocking while the TSFN queue is full or
+ * the bands in flight reach the byte high-water mark. Blocking here
+ * stops the driver reading mid-page. Each band's handoff (queued until
+ * the callback returns) counts towards its page's IPC time.
+ */
+class TsfnBandSink : public BandSink {
+public:
+    TsfnBandSink(const Napi::ThreadSafeFunction& tsfn, ByteBudget& budget, ScanMetrics* metrics)
+        : tsfn_(tsfn), budget_(budget), metrics_(metrics) {}
+
+    bool OnBand(const ScanBand& band) override {
+        const size_t bytes = band.pixels ? band.pixels->Size() : 0;
+        {
+            StageTimer timer(metrics_, MetricStage::QueueWait, band.pageIndex);
+            if (!budget_.Acquire(bytes)) {
+                return false;
+            }
+        }
+
+        ScanBand* pending = new ScanBand(band);
+        ByteBudget* budget = &budget_;
+        ScanMetrics* metrics = metrics_;
+        const uint64_t queuedNs = ScanMetrics::Now();
+        napi_status status = tsfn_.BlockingCall(pending, [budget, bytes, metrics, queuedNs](
+                                                             Napi::Env env, Napi::Function onBand, ScanBand* data) {
+            if (env != nullptr) {
+                onBand.Call({ScanBandToObject(env, *data)});
+                metrics->Record(MetricStage::IpcHandoff, ScanMetrics::Now() - queuedNs, data->pageIndex);
+                metrics->AddDelivered(bytes);
+                if (data->lastBand) {
+                    metrics->FinishPage(data->pageIndex);
+                }
+            }
+            delete data;
+            budget->Release(bytes);
+        });
+
+        if (status != napi_ok) {
+            // Environment is shutting down; stop the transfer
+            delete pending;
+            budget_.Release(bytes);
+            return false;
+        }
+        return true;
+    }
+
+private:
+    const Napi::ThreadSafeFunction& tsfn_;
+    ByteBudget& budget_;
+    ScanMetrics* metrics_;
+};
+
+void RunStream(StreamContext* context) {
+    ScanMetrics* metrics = &context->state->metrics;
+    metrics->BeginScan();
+    TsfnBandSink sink(context->tsfn, context->budget, metrics);
+    context->state->buffers->ConfigureForScan(context->settings, context->bandRows);
+    BitonalSink bitonal(sink, context->settings, context->state->buffers, context->bandRows);
+    bitonal.SetMetrics(metrics);
+    BandWriter writer(bitonal, context->bandRows, context->state->buffers, metrics);
+    writer.SetCancelToken(&context->state->cancel);
+
+    // Wake the sink if it is waiting for JavaScript to take bands
+    CancelHook wake(&context->state->cancel, [context]() { context->budget.Close(); });
+
+    // Bands go out as pixels, so the driver must not compress the page
+    ScanSettings driver = AcquisitionSettings(context->settings);
+    driver.compression = "none";
+
+    try {
+        context->success = context->acquire(driver, 1, writer, context->errorMessage);
+    } catch (const std::exception& e) {
+        context->success = false;
+        context->errorMessage = e.what();
+    }
+
+    if (writer.Cancelled()) {
+        context->success = false;
+        context->cancelled = true;
+        context->errorMessage = kScanCancelledMessage;
+    }
+
+    context->pageCount = writer.BandCount() > 0 ? writer.PageCount() : 0;
+    context->bandCount = writer.BandCount();
+
+    context->tsfn.Release();
+}
+
+void FinishStream(Napi::Env env, void* /*data*/, StreamContext* context) {
+    context->thread.join();
+    context->state->scanning = false;
+
+    Napi::Object summary = Napi::Object::New(env);
+    summary.Set("success", context->success);
+    summary.Set("pageCount", context->pageCount);
+    summary.Set("bandCount", context->bandCount);
+    if (context->cancelled) {
+        summary.Set("cancelled", true);
+    }
+    if (!context->success) {
+        summary.Set("errorMessage", context->errorMessage.empty() ? "Scan failed" : context->errorMessage);
+    }
+    context->deferred.Resolve(summary);
+
+    delete context;
+}
+
+} // namespace
+
+Napi::Value QueueScanStream(Napi::Env env,
+                            const ScanSettings& settings,
+                            BandAcquireFn acquire,
+                            Napi::Function onBand,
+                            const std::shared_ptr<ScanState>& state,
+                            int bandRows) {
+    if (state->scanning.exchange(true)) {
+        Napi::Promise::Deferred deferred = Napi::Promise::Deferred::New(env);
+        deferred.Reject(Napi::Error::New(env, "Scan already in progress").Value());
+        return deferred.Promise();
+    }
+    state->cancel.Reset();
+
+    StreamContext* context = new StreamContext(env, settings.highWaterMark);
+    context->settings = settings;
+    context->acquire = std::move(acquire);
+    context->state = state;
+    context->bandRows = bandRows;
+
+    context->tsfn = Napi::ThreadSafeFunction::New(
+        env, onBand, "ScannerScanStream", kMaxQueuedBands, 1, context, FinishStream, (void*)nullptr);
+
+    Napi::Promise promise = context->deferred.Promise();
+    context->thread = std::thread(RunStream, context);
+
+    return promise;
+}
+
+} // namespace ScannerCore
@@ -0,0 +1,41 @@
+/**
+ * Scanner Core Stream Worker
+ *
+ * Runs a band acquisition on a dedicated thread and pushes each band to
+ * a JavaScript callback through a Napi::ThreadSafeFunction. The TSFN
+ * queue is bounded in bands and settings.highWaterMark bounds it in
+ * bytes, so a slow consumer throttles the transfer instead of letting
+ * native memory grow past a few bands.
+ */
+
+#ifndef SCANNER_CORE_STREAM_WORKER_H
+#define SCANNER_CORE_STREAM_WORKER_H
+
+#include <napi.h>
+#include <memory>
+#include "bandStream.h"
+#include "scanWorker.h"
+
+namespace ScannerCore {
+
+/**
+ * Maximum number of bands waiting for the JavaScript thread
+ */
+constexpr size_t kMaxQueuedBands = 4;
+
+/**
+ * Start a streaming acquisition. onBand is called on the JavaScript
+ * thread with each band; the returned Promise resolves with a
+ * { success, pageCount, bandCount, errorMessage? } summary after the
+ * last band has been delivered.
+ */
+Napi::Value QueueScanStream(Napi::Env env,
+                            const ScanSettings& settings,
+                            BandAcquireFn acquire,
+                            Napi::Function onBand,
+                            const std::shared_ptr<ScanState>& state,
+                            int bandRows = kDefaultBandRows);
+
+} // namespace ScannerCore
+
+#endif // SCANNER_CORE_STREAM_WORKER_H
@@ -0,0 +1,161 @@
+/**
+ * Scanner Core Thumbnail Pyramid Implementation
+ */
+
+#include "thumbnailPyramid.h"
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SCANNER_CORE_SSE2 1
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define SCANNER_CORE_NEON 1
+#endif
+
+namespace ScannerCore {
+
+namespace {
+
+/**
+ * sums[i] += row[i]; four rows of 8-bit samples fit the 16-bit sums
+ */
+void AccumulateRow(const uint8_t* row, uint16_t* sums, int count) {
+    int i = 0;
+
+#if defined(SCANNER_CORE_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= count; i += 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i));
+        __m128i* lo = reinterpret_cast<__m128i*>(sums + i);
+        __m128i* hi = reinterpret_cast<__m128i*>(sums + i + 8);
+        _mm_storeu_si128(lo, _mm_add_epi16(_mm_loadu_si128(lo), _mm_unpacklo_epi8(v, zero)));
+        _mm_storeu_si128(hi, _mm_add_epi16(_mm_loadu_si128(hi), _mm_unpackhi_epi8(v, zero)));
+    }
+#elif defined(SCANNER_CORE_NEON)
+    for (; i + 16 <= count; i += 16) {
+        const uint8x16_t v = vld1q_u8(row + i);
+        vst1q_u16(sums + i, vaddw_u8(vld1q_u16(sums + i), vget_low_u8(v)));
+        vst1q_u16(sums + i + 8, vaddw_u8(vld1q_u16(sums + i + 8), vget_high_u8(v)));
+    }
+#endif
+
+    for (; i < count; i++) {
+        sums[i] += row[i];
+    }
+}
+
+} // namespace
+
+ThumbnailPyramid::ThumbnailPyramid(int levels)
+    : levels_(std::max(0, std::min(levels, kMaxThumbnailLevels))) {}
+
+void ThumbnailPyramid::BeginPage(const PageGeometry& geometry) {
+    geometry_ = geometry;
+    building_ = levels_ > 0 && geometry.encoding == ImageEncoding::Raw && geometry.width > 0;
+    pyramid_.clear();
+    if (!building_) {
+        return;
+    }
+
+    channels_ = Channels(geometry.pixelFormat);
+    rows_.BeginPage(geometry.pixelFormat, geometry.width);
+
+    int inWidth = geometry.width;
+    int scale = 1;
+    pyramid_.resize(levels_);
+    for (Level& level : pyramid_) {
+        scale *= kThumbnailFactor;
+        level.inWidth = inWidth;
+        level.width = (inWidth + kThumbnailFactor - 1) / kThumbnailFactor;
+        level.scale = scale;
+        level.sums.assign(static_cast<size_t>(inWidth) * channels_, 0);
+        if (geometry.height > 0) {
+            const int rows = (geometry.height + scale - 1) / scale;
+            level.pixels.reserve(static_cast<size_t>(rows) * level.width * channels_);
+        }
+        inWidth = level.width;
+    }
+}
+
+void ThumbnailPyramid::OnBand(const ScanBand& band) {
+    if (!building_ || !band.pixels) {
+        return;
+    }
+
+    for (int r = 0; r < band.rows; r++) {
+        AddRow(0, rows_.Convert(band.pixels->Data() + static_cast<size_t>(r) * geometry_.stride));
+    }
+}
+
+void ThumbnailPyramid::AddRow(size_t level, const uint8_t* row) {
+    Level& l = pyramid_[level];
+    AccumulateRow(row, l.sums.data(), l.inWidth * channels_);
+    if (++l.pending == kThumbnailFactor) {
+        EmitRow(level);
+    }
+}
+
+void ThumbnailPyramid::EmitRow(size_t level) {
+    Level& l = pyramid_[level];
+    const int channels = channels_;
+    const size_t offset = l.pixels.size();
+    l.pixels.resize(offset + static_cast<size_t>(l.width) * channels);
+    uint8_t* dst = l.pixels.data() + offset;
+
+    for (int x = 0; x < l.width; x++) {
+        // The last column block may be narrower, the last row block shorter
+        const int first = x * kThumbnailFactor;
+        const int span = std::min(kThumbnailFactor, l.inWidth - first);
+        const uint32_t count = static_cast<uint32_t>(span * l.pending);
+        const uint16_t* sums = l.sums.data() + static_cast<size_t>(first) * channels;
+        for (int c = 0; c < channels; c++) {
+            uint32_t sum = 0;
+            for (int k = 0; k < span; k++) {
+                sum += sums[k * channels + c];
+            }
+            dst[x * channels + c] = static_cast<uint8_t>((sum + count / 2) / count);
+        }
+    }
+
+    std::fill(l.sums.begin(), l.sums.end(), 0);
+    l.pending = 0;
+    l.rows++;
+
+    if (level + 1 < pyramid_.size()) {
+        AddRow(level + 1, dst);
+    }
+}
+
+std::vector<PageThumbnail> ThumbnailPyramid::Take() {
+    std::vector<PageThumbnail> thumbnails;
+    if (!building_) {
+        return thumbnails;
+    }
+    building_ = false;
+
+    // Top down: flushing a level can complete a row of the next one
+    for (size_t i = 0; i < pyramid_.size(); i++) {
+        if (pyramid_[i].pending > 0) {
+            EmitRow(i);
+        }
+    }
+
+    for (Level& level : pyramid_) {
+        if (level.rows == 0) {
+            break;
+        }
+        PageThumbnail thumbnail;
+        thumbnail.width = level.width;
+        thumbnail.height = level.rows;
+        thumbnail.stride = level.width * channels_;
+        thumbnail.pixelFormat = channels_ == 3 ? PixelFormat::Rgb24 : PixelFormat::Gray8;
+        thumbnail.scale = level.scale;
+        thumbnail.pixels = std::make_shared<PixelBuffer>(std::move(level.pixels));
+        thumbnails.push_back(std::move(thumbnail));
+    }
+    pyramid_.clear();
+    return thumbnails;
+}
+
+} // namespace ScannerCore
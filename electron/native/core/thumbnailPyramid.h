@@ -0,0 +1,62 @@
+/**
+ * Scanner Core Thumbnail Pyramid
+ *
+ * Builds reduced copies of a page from its bands as they arrive, so
+ * the UI can show a scanned page without the full-resolution pixels
+ * crossing into JavaScript. Each level is a 4x4 box average of the one
+ * above it (1/4, 1/16 and 1/64 of the page side); columns are summed
+ * with SIMD and every level only ever holds four pending input rows.
+ */
+
+#ifndef SCANNER_CORE_THUMBNAIL_PYRAMID_H
+#define SCANNER_CORE_THUMBNAIL_PYRAMID_H
+
+#include <cstdint>
+#include <vector>
+#include "bandStream.h"
+#include "pixelKernels.h"
+
+namespace ScannerCore {
+
+/**
+ * Most levels a page gets, and the side reduction between levels
+ */
+constexpr int kMaxThumbnailLevels = 3;
+constexpr int kThumbnailFactor = 4;
+
+class ThumbnailPyramid {
+public:
+    explicit ThumbnailPyramid(int levels = 0);
+
+    void BeginPage(const PageGeometry& geometry);
+    void OnBand(const ScanBand& band);
+
+    // The finished levels, largest first; empty when disabled or the
+    // page was compressed by the device
+    std::vector<PageThumbnail> Take();
+
+private:
+    struct Level {
+        int inWidth = 0;
+        int width = 0;
+        int scale = 1;
+        std::vector<uint16_t> sums;  // column sums of the pending rows
+        int pending = 0;             // input rows summed into sums
+        std::vector<uint8_t> pixels;
+        int rows = 0;
+    };
+
+    void AddRow(size_t level, const uint8_t* row);
+    void EmitRow(size_t level);
+
+    int levels_;
+    bool building_ = false;
+    int channels_ = 1;
+    PageGeometry geometry_{};
+    std::vector<Level> pyramid_;
+    RowConverter rows_;  // page rows as 8-bit gray or RGB
+};
+
+} // namespace ScannerCore
+
+#endif // SCANNER_CORE_THUMBNAIL_PYRAMID_H
@@ -0,0 +1,99 @@
+{
+  "variables": {
+    "conditions": [
+      ["OS=='win'", {
+        "libjpeg_turbo_dir%": "C:/libjpeg-turbo64"
+      }, {
+        "libjpeg_turbo_dir%": "/opt/homebrew/opt/jpeg-turbo"
+      }]
+    ]
+  },
+  "target_defaults": {
+    "cflags!": ["-fno-exceptions"],
+    "cflags_cc!": ["-fno-exceptions"],
+    "include_dirs": [
+      "../core",
+      "../imaging"
+    ],
+    "conditions": [
+      ["OS=='linux'", {
+        "libraries": [
+          "-ljpeg"
+        ]
+      }],
+      ["OS=='mac'", {
+        "include_dirs": [
+          "<(libjpeg_turbo_dir)/include"
+        ],
+        "link_settings": {
+          "libraries": [
+            "<(libjpeg_turbo_dir)/lib/libjpeg.a"
+          ]
+        }
+      }],
+      ["OS=='win'", {
+        "include_dirs": [
+          "<(libjpeg_turbo_dir)/include"
+        ],
+        "libraries": [
+          "<(libjpeg_turbo_dir)/lib/jpeg-static.lib"
+        ]
+      }]
+    ]
+  },
+  "targets": [
+    {
+      "target_name": "escl_wrapper",
+      "sources": [
+        "esclWrapper.cpp",
+        "esclJob.cpp",
+        "esclProtocol.cpp",
+        "httpConnection.cpp",
+        "mdnsBrowser.cpp",
+        "../core/bandStream.cpp",
+        "../core/batchWorker.cpp",
+        "../core/bitonalSink.cpp",
+        "../core/blankPage.cpp",
+        "../core/bufferPool.cpp",
+        "../core/cancelToken.cpp",
+        "../core/ccittG4Encoder.cpp",
+        "../core/deviceEvents.cpp",
+        "../core/deviceRegistry.cpp",
+        "../core/fileIo.cpp",
+        "../core/imageEncoder.cpp",
+        "../core/initWorker.cpp",
+        "../core/jpegDecoder.cpp",
+        "../core/jpegEncoder.cpp",
+        "../core/metricsEvents.cpp",
+        "../core/napiConvert.cpp",
+        "../core/pageQueue.cpp",
+        "../core/pdfWriter.cpp",
+        "../core/pixelKernels.cpp",
+        "../core/previewCache.cpp",
+        "../core/previewWorker.cpp",
+        "../core/scanMetrics.cpp",
+        "../core/scanWorker.cpp",
+        "../core/separatorSheet.cpp",
+        "../core/sessionManager.cpp",
+        "../core/spoolFile.cpp",
+        "../core/spoolWorker.cpp",
+        "../core/streamWorker.cpp",
+        "../core/thumbnailPyramid.cpp",
+        "../imaging/binarize.cpp",
+        "../imaging/documentDetect.cpp",
+        "../imaging/threadPool.cpp"
+      ],
+      "include_dirs": [
+        "<!@(node -p \"require('node-addon-api').include\")"
+      ],
+      "defines": ["NAPI_DISABLE_CPP_EXCEPTIONS"],
+      "conditions": [
+        ["OS=='win'", {
+          "libraries": [
+            "ws2_32.lib"
+          ]
+        }]
+      ]
+    }
+  ]
+}
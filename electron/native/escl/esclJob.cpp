@@ -0,0 +1,331 @@
+/**
+ * eSCL Scan Job Implementation
+ */
+
+#include "esclJob.h"
+#include "binarize.h"
+#include "httpConnection.h"
+#include "jpegDecoder.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace EsclWrapper {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Page body bytes handed to the pipeline per Write()
+constexpr size_t kBodyChunk = 64 * 1024;
+
+// Scanlines decoded per Write()
+constexpr int kDecodeRows = 16;
+
+// NextDocument answers 503 while the device warms up or feeds a sheet
+constexpr auto kBusyRetry = std::chrono::milliseconds(500);
+constexpr auto kBusyTimeout = std::chrono::seconds(120);
+constexpr auto kStopPoll = std::chrono::milliseconds(50);
+
+// Black and white pages: gray above this is white, as the fixed binarizer
+constexpr uint8_t kBlackWhiteThreshold = 128;
+
+enum class NextStatus {
+    Page,    // 200: the response body is the page
+    Done,    // 404: no more pages in the job
+    Failed
+};
+
+struct NextDocument {
+    NextStatus status = NextStatus::Failed;
+    std::string error;
+};
+
+/**
+ * GET NextDocument until the device has a page or ends the job
+ */
+NextDocument RequestNextDocument(HttpConnection& connection, const std::string& path, const std::atomic<bool>& stop) {
+    NextDocument next;
+    const Clock::time_point deadline = Clock::now() + kBusyTimeout;
+    for (;;) {
+        HttpResponse response;
+        if (!connection.Request("GET", path, "", "", response, next.error)) {
+            return next;
+        }
+        if (response.status == 200) {
+            next.status = NextStatus::Page;
+            return next;
+        }
+        if (!connection.DiscardBody(next.error)) {
+            return next;
+        }
+        if (response.status == 404) {
+            next.status = NextStatus::Done;
+            return next;
+        }
+        if (response.status != 503) {
+            next.error = "Scanner returned HTTP " + std::to_string(response.status) + " for the next page";
+            return next;
+        }
+
+        if (Clock::now() >= deadline) {
+            next.error = "Timed out waiting for the scanner";
+            return next;
+        }
+        for (Clock::time_point retry = Clock::now() + kBusyRetry; Clock::now() < retry;) {
+            if (stop) {
+                next.error = "Connection aborted";
+                return next;
+            }
+            std::this_thread::sleep_for(kStopPoll);
+        }
+    }
+}
+
+/**
+ * Write the device's JFIF stream as the page, chunk by chunk
+ */
+bool StreamEncodedPage(HttpConnection& connection,
+                       const ScannerCore::ScanSettings& settings,
+                       ScannerCore::BandWriter& writer,
+                       std::vector<uint8_t>& chunk,
+                       bool& more,
+                       std::string& error) {
+    // Nominal geometry; the frame header has the real size
+    ScannerCore::PageGeometry geometry{};
+    ScannerCore::PagePixelSize(settings, geometry.width, geometry.height);
+    geometry.height = 0;
+    geometry.pixelFormat = settings.colorMode == "color" ? ScannerCore::PixelFormat::Rgb24
+                                                          : ScannerCore::PixelFormat::Gray8;
+    geometry.stride = ScannerCore::MinStride(geometry.pixelFormat, geometry.width);
+    geometry.resolution = std::max(1, settings.resolution);
+    geometry.encoding = ScannerCore::ImageEncoding::Jpeg;
+    if (!writer.BeginPage(geometry)) {
+        error = "Scanner sent a page without a usable size";
+        return false;
+    }
+
+    chunk.resize(kBodyChunk);
+    for (;;) {
+        const long read = connection.ReadBody(chunk.data(), chunk.size(), error);
+        if (read < 0) {
+            return false;
+        }
+        if (read == 0) {
+            break;
+        }
+        if (!writer.Write(chunk.data(), static_cast<size_t>(read))) {
+            error = "Transfer stopped";
+            return false;
+        }
+    }
+
+    more = writer.EndPage();
+    return true;
+}
+
+/**
+ * Decode the device's JFIF stream as it arrives and write its rows in
+ * the settings' pixel format
+ */
+bool StreamDecodedPage(HttpConnection& connection,
+                       const ScannerCore::ScanSettings& settings,
+                       ScannerCore::BandWriter& writer,
+                       std::vector<uint8_t>& rows,
+                       bool& more,
+                       std::string& error) {
+    ScannerCore::JpegDecoder decoder([&connection](uint8_t* data, size_t size, std::string& sourceError) {
+        return connection.ReadBody(data, size, sourceError);
+    });
+    ScannerCore::PageGeometry decoded{};
+    if (!decoder.Begin(decoded, error)) {
+        return false;
+    }
+
+    // Devices may answer a gray request with RGB; reduce to what was asked
+    ScannerCore::PageGeometry geometry = decoded;
+    geometry.resolution = std::max(1, settings.resolution);
+    if (settings.colorMode == "blackwhite") {
+        geometry.pixelFormat = ScannerCore::PixelFormat::BlackWhite1;
+    } else if (settings.colorMode != "color") {
+        geometry.pixelFormat = ScannerCore::PixelFormat::Gray8;
+    }
+    geometry.stride = ScannerCore::MinStride(geometry.pixelFormat, geometry.width);
+
+    const bool convert = geometry.pixelFormat != decoded.pixelFormat;
+    const int channels = ScannerCore::Channels(decoded.pixelFormat);
+    const size_t decodedStride = static_cast<size_t>(decoded.stride);
+    const size_t stride = static_cast<size_t>(geometry.stride);
+    std::vector<uint8_t> gray(convert ? static_cast<size_t>(geometry.width) : 0);
+    std::vector<uint8_t> threshold(geometry.pixelFormat == ScannerCore::PixelFormat::BlackWhite1
+                                       ? static_cast<size_t>(geometry.width)
+                                       : 0,
+                                   kBlackWhiteThreshold);
+    rows.resize(decodedStride * kDecodeRows);
+
+    if (!writer.BeginPage(geometry)) {
+        error = "Scanner sent a page without a usable size";
+        return false;
+    }
+    for (;;) {
+        const int count = decoder.ReadRows(rows.data(), kDecodeRows, error);
+        if (count < 0) {
+            return false;
+        }
+        if (count == 0) {
+            break;
+        }
+
+        if (convert) {
+            // Narrower rows are packed in place, front to back
+            for (int i = 0; i < count; i++) {
+                const uint8_t* src = rows.data() + decodedStride * i;
+                uint8_t* dst = rows.data() + stride * i;
+                if (channels == 1) {
+                    std::memcpy(gray.data(), src, gray.size());
+                } else {
+                    Imaging::ToGrayRow(src, geometry.width, channels, gray.data());
+                }
+                if (threshold.empty()) {
+                    std::memcpy(dst, gray.data(), gray.size());
+                } else {
+                    Imaging::PackRow(gray.data(), threshold.data(), geometry.width, dst);
+                }
+            }
+        }
+
+        if (!writer.Write(rows.data(), stride * static_cast<size_t>(count))) {
+            error = "Transfer stopped";
+            return false;
+        }
+    }
+
+    more = writer.EndPage();
+    // Padding after the EOI marker, so the connection takes the next request
+    return connection.DiscardBody(error);
+}
+
+/**
+ * Release the device from a job that was not read to its end
+ */
+void DeleteJob(const EsclEndpoint& endpoint, const std::string& job) {
+    HttpConnection connection(endpoint.host, endpoint.port);
+    HttpResponse response;
+    std::string body;
+    std::string error;
+    connection.Exchange("DELETE", job, "", "", response, body, error);
+}
+
+} // namespace
+
+bool AcquireEsclPages(const EsclEndpoint& endpoint,
+                      const ScannerCore::ScannerCapabilities& capabilities,
+                      const ScannerCore::ScanSettings& settings,
+                      ScannerCore::ImageEncoding transfer,
+                      int maxPages,
+                      ScannerCore::BandWriter& writer,
+                      std::string& error) {
+    HttpConnection first(endpoint.host, endpoint.port);
+    HttpConnection second(endpoint.host, endpoint.port);
+    HttpConnection* connections[2] = {&first, &second};
+
+    // A blocked read or a busy wait returns as soon as the scan is cancelled
+    std::atomic<bool> stop(false);
+    ScannerCore::CancelHook abort(writer.Token(), [&]() {
+        stop = true;
+        first.Abort();
+        second.Abort();
+    });
+
+    HttpResponse response;
+    std::string reply;
+    if (!first.Exchange("POST", endpoint.root + "/ScanJobs", "text/xml",
+                        BuildScanSettings(settings, capabilities), response, reply, error)) {
+        if (writer.Cancelled()) {
+            error = ScannerCore::kScanCancelledMessage;
+        }
+        return false;
+    }
+    if (response.status != 201) {
+        error = response.status == 503
+                    ? "Scanner is busy"
+                    : "Scanner refused the scan job (HTTP " + std::to_string(response.status) + ")";
+        return false;
+    }
+    std::string job = JobPath(response.Header("location"));
+    if (job.empty()) {
+        error = "Scanner returned no scan job location";
+        return false;
+    }
+    if (job.front() != '/') {
+        job = endpoint.root + "/ScanJobs/" + job;
+    }
+    const std::string nextPath = job + "/NextDocument";
+
+    std::vector<uint8_t> buffer;
+    int current = 0;
+    int pages = 0;
+    bool finished = false;  // the device ended the job itself
+    bool success = true;
+    NextDocument next = RequestNextDocument(first, nextPath, stop);
+    for (;;) {
+        if (next.status == NextStatus::Done) {
+            finished = true;
+            break;
+        }
+        if (next.status == NextStatus::Failed) {
+            error = next.error;
+            success = false;
+            break;
+        }
+
+        HttpConnection& page = *connections[current];
+        HttpConnection& following = *connections[1 - current];
+
+        // Ask for the next page while this one downloads
+        const bool prefetch = maxPages <= 0 || pages + 1 < maxPages;
+        NextDocument prefetched;
+        std::thread prefetcher;
+        if (prefetch) {
+            prefetcher = std::thread([&]() { prefetched = RequestNextDocument(following, nextPath, stop); });
+        }
+
+        bool more = true;
+        const bool streamed = transfer == ScannerCore::ImageEncoding::Jpeg
+                                  ? StreamEncodedPage(page, settings, writer, buffer, more, error)
+                                  : StreamDecodedPage(page, settings, writer, buffer, more, error);
+        if (!streamed || !more) {
+            stop = true;
+            following.Abort();
+        }
+        if (prefetcher.joinable()) {
+            prefetcher.join();
+        }
+        if (!streamed) {
+            success = false;
+            break;
+        }
+
+        pages++;
+        if (!more || !prefetch) {
+            break;
+        }
+        next = prefetched;
+        current = 1 - current;
+    }
+
+    // Pages left in the feeder stay with the job until it is deleted
+    if (!finished) {
+        DeleteJob(endpoint, job);
+    }
+    if (writer.Cancelled()) {
+        error = ScannerCore::kScanCancelledMessage;
+        return false;
+    }
+    return success;
+}
+
+} // namespace EsclWrapper
@@ -0,0 +1,39 @@
+/**
+ * eSCL Scan Job
+ *
+ * Runs one eSCL job through the shared band pipeline: POST ScanJobs,
+ * then NextDocument until the device answers 404. Two keep-alive
+ * connections take turns, so while one streams page N into the
+ * BandWriter the other is already waiting on NextDocument for page
+ * N+1 and the device feeds the next sheet during the download. Page
+ * bodies go from the socket straight into the pipeline, either as the
+ * device's JPEG or decoded scanline by scanline; no page is ever
+ * buffered whole here.
+ */
+
+#ifndef ESCL_JOB_H
+#define ESCL_JOB_H
+
+#include <string>
+#include "bandStream.h"
+#include "esclProtocol.h"
+
+namespace EsclWrapper {
+
+/**
+ * Acquire up to maxPages pages (0 = until the feeder is empty). With
+ * transfer == Jpeg the device's JFIF stream is the page, otherwise it
+ * is decoded to the settings' pixel format. Stopping early or a cancel
+ * on writer.Token() deletes the job on the device.
+ */
+bool AcquireEsclPages(const EsclEndpoint& endpoint,
+                      const ScannerCore::ScannerCapabilities& capabilities,
+                      const ScannerCore::ScanSettings& settings,
+                      ScannerCore::ImageEncoding transfer,
+                      int maxPages,
+                      ScannerCore::BandWriter& writer,
+                      std::string& error);
+
+} // namespace EsclWrapper
+
+#endif // ESCL_JOB_H
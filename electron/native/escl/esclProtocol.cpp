@@ -0,0 +1,347 @@
+/**
+ * eSCL Protocol Helpers Implementation
+ */
+
+#include "esclProtocol.h"
+#include "bufferPool.h"
+#include "scanArea.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+namespace EsclWrapper {
+
+namespace {
+
+// eSCL length unit
+constexpr double kEsclUnitsPerInch = 300.0;
+
+// Bed sizes are rounded by devices; a paper size this close still fits
+constexpr double kPaperTolerance = 0.05;
+
+struct PaperSize {
+    const char* name;
+    double width;
+    double height;
+};
+
+const PaperSize kPaperSizes[] = {
+    {"letter", 8.5, 11.0},
+    {"legal", 8.5, 14.0},
+    {"a4", 8.27, 11.69},
+    {"a5", 5.83, 8.27},
+};
+
+/**
+ * Contents of every element named `name`, whatever its namespace
+ * prefix. eSCL documents are flat enough that elements of one name never
+ * nest, so the first matching end tag closes each one.
+ */
+std::vector<std::string> Elements(const std::string& xml, const std::string& name) {
+    std::vector<std::string> contents;
+    size_t pos = 0;
+    while ((pos = xml.find('<', pos)) != std::string::npos) {
+        pos++;
+        if (pos >= xml.size() || xml[pos] == '/' || xml[pos] == '?' || xml[pos] == '!') {
+            continue;
+        }
+
+        const size_t nameEnd = xml.find_first_of(" \t\r\n/>", pos);
+        if (nameEnd == std::string::npos) {
+            break;
+        }
+        const std::string qualified = xml.substr(pos, nameEnd - pos);
+        const size_t colon = qualified.find(':');
+        const std::string local = colon == std::string::npos ? qualified : qualified.substr(colon + 1);
+        if (local != name) {
+            continue;
+        }
+
+        const size_t tagEnd = xml.find('>', nameEnd);
+        if (tagEnd == std::string::npos) {
+            break;
+        }
+        if (xml[tagEnd - 1] == '/') {
+            contents.emplace_back();
+            pos = tagEnd + 1;
+            continue;
+        }
+
+        const size_t close = xml.find("</" + qualified, tagEnd + 1);
+        if (close == std::string::npos) {
+            break;
+        }
+        contents.push_back(xml.substr(tagEnd + 1, close - tagEnd - 1));
+        pos = close + 2;
+    }
+    return contents;
+}
+
+std::string Unescape(const std::string& text) {
+    static const struct {
+        const char* entity;
+        char value;
+    } kEntities[] = {{"&amp;", '&'}, {"&lt;", '<'}, {"&gt;", '>'}, {"&quot;", '"'}, {"&apos;", '\''}};
+
+    std::string result;
+    result.reserve(text.size());
+    for (size_t i = 0; i < text.size(); i++) {
+        bool replaced = false;
+        if (text[i] == '&') {
+            for (const auto& entry : kEntities) {
+                if (text.compare(i, std::char_traits<char>::length(entry.entity), entry.entity) == 0) {
+                    result += entry.value;
+                    i += std::char_traits<char>::length(entry.entity) - 1;
+                    replaced = true;
+                    break;
+                }
+            }
+        }
+        if (!replaced) {
+            result += text[i];
+        }
+    }
+
+    const size_t begin = result.find_first_not_of(" \t\r\n");
+    const size_t end = result.find_last_not_of(" \t\r\n");
+    return begin == std::string::npos ? std::string() : result.substr(begin, end - begin + 1);
+}
+
+std::string Text(const std::string& xml, const std::string& name) {
+    const std::vector<std::string> elements = Elements(xml, name);
+    return elements.empty() ? std::string() : Unescape(elements.front());
+}
+
+bool Contains(const std::vector<std::string>& values, const std::string& value) {
+    return std::find(values.begin(), values.end(), value) != values.end();
+}
+
+void AddUnique(std::vector<std::string>& values, const std::string& value) {
+    if (!Contains(values, value)) {
+        values.push_back(value);
+    }
+}
+
+/**
+ * Merge one PlatenInputCaps / AdfSimplexInputCaps / AdfDuplexInputCaps
+ */
+void MergeInputCaps(const std::string& caps, ScannerCore::ScannerCapabilities& capabilities) {
+    const double maxWidth = std::atof(Text(caps, "MaxWidth").c_str()) / kEsclUnitsPerInch;
+    const double maxHeight = std::atof(Text(caps, "MaxHeight").c_str()) / kEsclUnitsPerInch;
+    capabilities.maxWidth = std::max(capabilities.maxWidth, maxWidth);
+    capabilities.maxHeight = std::max(capabilities.maxHeight, maxHeight);
+
+    for (const std::string& mode : Elements(caps, "ColorMode")) {
+        const std::string value = Unescape(mode);
+        if (value == "RGB24") {
+            AddUnique(capabilities.colorModes, "color");
+        } else if (value == "Grayscale8") {
+            // Black and white is thresholded from the gray JPEG
+            AddUnique(capabilities.colorModes, "grayscale");
+            AddUnique(capabilities.colorModes, "blackwhite");
+        }
+    }
+
+    for (const std::string& resolution : Elements(caps, "DiscreteResolution")) {
+        const int dpi = std::atoi(Text(resolution, "XResolution").c_str());
+        if (dpi > 0 && std::find(capabilities.resolutions.begin(), capabilities.resolutions.end(), dpi) ==
+                           capabilities.resolutions.end()) {
+            capabilities.resolutions.push_back(dpi);
+        }
+    }
+
+    std::vector<std::string> formats = Elements(caps, "DocumentFormat");
+    for (const std::string& format : Elements(caps, "DocumentFormatExt")) {
+        formats.push_back(format);
+    }
+    for (const std::string& format : formats) {
+        if (Unescape(format) == "image/jpeg") {
+            AddUnique(capabilities.compression, "jpeg");
+        }
+    }
+}
+
+} // namespace
+
+std::string EsclEndpoint::Url() const {
+    const std::string authority = host.find(':') == std::string::npos ? host : "[" + host + "]";
+    return "http://" + authority + ":" + std::to_string(port) + root;
+}
+
+bool ParseEsclUrl(const std::string& url, EsclEndpoint& endpoint, std::string& error) {
+    const std::string scheme = "http://";
+    if (url.compare(0, 8, "https://") == 0) {
+        // There is no TLS transport; scanners are reached over plain HTTP only
+        error = "HTTPS scanner URLs are not supported";
+        return false;
+    }
+    if (url.compare(0, scheme.size(), scheme) != 0) {
+        error = "Scanner URL must start with http://";
+        return false;
+    }
+
+    const size_t hostBegin = scheme.size();
+    size_t pathBegin = url.find('/', hostBegin);
+    if (pathBegin == std::string::npos) {
+        pathBegin = url.size();
+    }
+    std::string authority = url.substr(hostBegin, pathBegin - hostBegin);
+
+    EsclEndpoint parsed;
+    size_t portColon = std::string::npos;
+    if (!authority.empty() && authority.front() == '[') {
+        // IPv6 literal
+        const size_t bracket = authority.find(']');
+        if (bracket == std::string::npos) {
+            error = "Invalid scanner URL " + url;
+            return false;
+        }
+        parsed.host = authority.substr(1, bracket - 1);
+        if (bracket + 1 < authority.size() && authority[bracket + 1] == ':') {
+            portColon = bracket + 1;
+        }
+    } else {
+        portColon = authority.rfind(':');
+        parsed.host = authority.substr(0, portColon);
+    }
+    if (portColon != std::string::npos) {
+        parsed.port = std::atoi(authority.c_str() + portColon + 1);
+    }
+    if (parsed.host.empty() || parsed.port <= 0 || parsed.port > 65535) {
+        error = "Invalid scanner URL " + url;
+        return false;
+    }
+
+    std::string root = url.substr(pathBegin);
+    while (!root.empty() && root.back() == '/') {
+        root.pop_back();
+    }
+    if (!root.empty()) {
+        parsed.root = root;
+    }
+
+    endpoint = parsed;
+    return true;
+}
+
+bool ParseCapabilities(const std::string& xml, ScannerCore::ScannerDevice& device) {
+    const std::vector<std::string> documents = Elements(xml, "ScannerCapabilities");
+    if (documents.empty()) {
+        return false;
+    }
+    const std::string& document = documents.front();
+
+    const std::string makeAndModel = Text(document, "MakeAndModel");
+    if (!makeAndModel.empty()) {
+        device.name = makeAndModel;
+        const size_t space = makeAndModel.find(' ');
+        device.manufacturer = makeAndModel.substr(0, space);
+        device.model = space == std::string::npos ? makeAndModel : makeAndModel.substr(space + 1);
+    }
+    const std::string manufacturer = Text(document, "Manufacturer");
+    if (!manufacturer.empty()) {
+        device.manufacturer = manufacturer;
+    }
+
+    ScannerCore::ScannerCapabilities capabilities{};
+    for (const std::string& platen : Elements(document, "PlatenInputCaps")) {
+        capabilities.hasFlatbed = true;
+        MergeInputCaps(platen, capabilities);
+    }
+    for (const std::string& adf : Elements(document, "AdfSimplexInputCaps")) {
+        capabilities.hasADF = true;
+        MergeInputCaps(adf, capabilities);
+    }
+    for (const std::string& adf : Elements(document, "AdfDuplexInputCaps")) {
+        capabilities.hasADF = true;
+        capabilities.duplex = true;
+        MergeInputCaps(adf, capabilities);
+    }
+
+    std::sort(capabilities.resolutions.begin(), capabilities.resolutions.end());
+    if (capabilities.resolutions.empty()) {
+        // Only a ResolutionRange: offer the usual steps
+        capabilities.resolutions = {75, 150, 300, 600};
+    }
+    if (capabilities.colorModes.empty()) {
+        capabilities.colorModes = {"color"};
+    }
+    for (const PaperSize& paper : kPaperSizes) {
+        if (capabilities.maxWidth <= 0.0 ||
+            (paper.width <= capabilities.maxWidth + kPaperTolerance &&
+             paper.height <= capabilities.maxHeight + kPaperTolerance)) {
+            capabilities.paperSizes.push_back(paper.name);
+        }
+    }
+
+    device.capabilities = capabilities;
+    return true;
+}
+
+std::string BuildScanSettings(const ScannerCore::ScanSettings& settings,
+                              const ScannerCore::ScannerCapabilities& capabilities) {
+    // Region in eSCL units: the hardware area when set, else the paper
+    ScannerCore::ScanArea area = settings.scanArea;
+    if (!area.IsSet()) {
+        ScannerCore::ScanSettings paper = settings;
+        paper.resolution = static_cast<int>(kEsclUnitsPerInch);
+        int width = 0;
+        int height = 0;
+        ScannerCore::PagePixelSize(paper, width, height);
+        area = ScannerCore::ScanArea{0.0, 0.0, width / kEsclUnitsPerInch, height / kEsclUnitsPerInch};
+    }
+    const ScannerCore::ScanArea clamped =
+        ScannerCore::ClampScanArea(area, capabilities.maxWidth, capabilities.maxHeight);
+    if (clamped.IsSet()) {
+        area = clamped;
+    }
+    const ScannerCore::ScanAreaPixels region =
+        ScannerCore::ScanAreaToPixels(area, static_cast<int>(kEsclUnitsPerInch));
+
+    const bool feeder = settings.useADF && !settings.preview && capabilities.hasADF;
+    const char* colorMode = settings.colorMode == "color" ? "RGB24" : "Grayscale8";
+    const std::string resolution = std::to_string(std::max(1, settings.resolution));
+
+    std::string xml;
+    xml += "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+    xml += "<scan:ScanSettings xmlns:scan=\"http://schemas.hp.com/imaging/escl/2011/05/03\" "
+           "xmlns:pwg=\"http://www.pwg.org/schemas/2010/12/sm\">\n";
+    xml += "  <pwg:Version>2.0</pwg:Version>\n";
+    xml += std::string("  <scan:Intent>") + (settings.preview ? "Preview" : "Document") + "</scan:Intent>\n";
+    xml += "  <pwg:ScanRegions>\n";
+    xml += "    <pwg:ScanRegion>\n";
+    xml += "      <pwg:Height>" + std::to_string(region.height) + "</pwg:Height>\n";
+    xml += "      <pwg:ContentRegionUnits>escl:ThreeHundredthsOfInches</pwg:ContentRegionUnits>\n";
+    xml += "      <pwg:Width>" + std::to_string(region.width) + "</pwg:Width>\n";
+    xml += "      <pwg:XOffset>" + std::to_string(region.x) + "</pwg:XOffset>\n";
+    xml += "      <pwg:YOffset>" + std::to_string(region.y) + "</pwg:YOffset>\n";
+    xml += "    </pwg:ScanRegion>\n";
+    xml += "  </pwg:ScanRegions>\n";
+    xml += std::string("  <pwg:InputSource>") + (feeder ? "Feeder" : "Platen") + "</pwg:InputSource>\n";
+    if (feeder && capabilities.duplex) {
+        xml += std::string("  <scan:Duplex>") + (settings.duplex ? "true" : "false") + "</scan:Duplex>\n";
+    }
+    xml += std::string("  <scan:ColorMode>") + colorMode + "</scan:ColorMode>\n";
+    xml += "  <scan:XResolution>" + resolution + "</scan:XResolution>\n";
+    xml += "  <scan:YResolution>" + resolution + "</scan:YResolution>\n";
+    xml += "  <pwg:DocumentFormat>image/jpeg</pwg:DocumentFormat>\n";
+    xml += "  <scan:DocumentFormatExt>image/jpeg</scan:DocumentFormatExt>\n";
+    xml += "</scan:ScanSettings>\n";
+    return xml;
+}
+
+std::string JobPath(const std::string& location) {
+    std::string path = location;
+    const size_t scheme = path.find("://");
+    if (scheme != std::string::npos) {
+        const size_t slash = path.find('/', scheme + 3);
+        path = slash == std::string::npos ? std::string() : path.substr(slash);
+    }
+    while (!path.empty() && path.back() == '/') {
+        path.pop_back();
+    }
+    return path;
+}
+
+} // namespace EsclWrapper
@@ -0,0 +1,55 @@
+/**
+ * eSCL Protocol Helpers
+ *
+ * The XML side of eSCL (Mopria / AirScan): scanner URLs, the
+ * ScannerCapabilities document mapped onto ScannerCapabilities, and
+ * the ScanSettings document posted to start a job. eSCL lengths are in
+ * 1/300 inch.
+ */
+
+#ifndef ESCL_PROTOCOL_H
+#define ESCL_PROTOCOL_H
+
+#include <string>
+#include "scanTypes.h"
+
+namespace EsclWrapper {
+
+/**
+ * Where a scanner's eSCL service lives: http://host:port/root
+ */
+struct EsclEndpoint {
+    std::string host;
+    int port = 80;
+    std::string root = "/eSCL";  // no trailing slash
+
+    std::string Url() const;
+};
+
+/**
+ * Parse "http://host[:port][/root]"; an empty path means /eSCL
+ */
+bool ParseEsclUrl(const std::string& url, EsclEndpoint& endpoint, std::string& error);
+
+/**
+ * Fill device name and capabilities from a ScannerCapabilities
+ * document; false if the document is not one
+ */
+bool ParseCapabilities(const std::string& xml, ScannerCore::ScannerDevice& device);
+
+/**
+ * ScanSettings document for a scan, asking for a JPEG stream. Black and
+ * white is requested as Grayscale8; JPEG has no 1-bit mode.
+ */
+std::string BuildScanSettings(const ScannerCore::ScanSettings& settings,
+                              const ScannerCore::ScannerCapabilities& capabilities);
+
+/**
+ * Job path from a ScanJobs response Location header, which may be an
+ * absolute URL or a path
+ */
+std::string JobPath(const std::string& location);
+
+} // namespace EsclWrapper
+
+#endif // ESCL_PROTOCOL_H
@@ -0,0 +1,195 @@
+/**
+ * eSCL Scanner Wrapper Implementation
+ */
+
+#include "esclWrapper.h"
+#include "esclJob.h"
+#include "httpConnection.h"
+#include "imageEncoder.h"
+#include "mdnsBrowser.h"
+#include <algorithm>
+#include <map>
+#include <mutex>
+
+namespace EsclWrapper {
+
+namespace {
+
+const char* const kDeviceIdPrefix = "escl:";
+
+// How long each probe listens for mDNS answers
+constexpr int kBrowseTimeoutMs = 1500;
+
+/**
+ * Scanner found by the mDNS browse or added with addDevice(), with what
+ * its last probe returned
+ */
+struct KnownScanner {
+    EsclEndpoint endpoint;
+    ScannerDevice device;
+    std::string serviceName;  // mDNS instance name, when discovered
+    bool manual = false;      // added with addDevice(); kept when the browse misses it
+    bool reachable = false;
+};
+
+// Shared by every EsclScanner in the process, keyed by device id
+std::mutex scannersMutex;
+std::map<std::string, KnownScanner> scanners;
+
+bool FetchCapabilities(const EsclEndpoint& endpoint, ScannerDevice& device) {
+    HttpConnection connection(endpoint.host, endpoint.port);
+    HttpResponse response;
+    std::string body;
+    std::string error;
+    return connection.Exchange("GET", endpoint.root + "/ScannerCapabilities", "", "", response, body, error) &&
+           response.status == 200 && ParseCapabilities(body, device);
+}
+
+} // namespace
+
+EsclScanner::EsclScanner(const Napi::CallbackInfo& info) : ScannerObject<EsclScanner>(info) {}
+
+bool EsclScanner::LoadDriver(std::string& error) {
+    // Discovery and transfers only need the socket library
+    return InitSockets(error);
+}
+
+std::vector<ScannerDevice> EsclScanner::ProbeDevices() {
+    // Browse first, so scanners that joined the network show up in this probe
+    const std::vector<DiscoveredScanner> discovered = BrowseEsclScanners(kBrowseTimeoutMs);
+
+    std::vector<EsclEndpoint> endpoints;
+    {
+        std::lock_guard<std::mutex> lock(scannersMutex);
+        std::map<std::string, const DiscoveredScanner*> found;
+        for (const DiscoveredScanner& scanner : discovered) {
+            found[kDeviceIdPrefix + scanner.endpoint.Url()] = &scanner;
+        }
+        // Discovered scanners that stopped answering are dropped
+        for (auto it = scanners.begin(); it != scanners.end();) {
+            if (!it->second.manual && found.count(it->first) == 0) {
+                it = scanners.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        for (const auto& entry : found) {
+            KnownScanner& scanner = scanners[entry.first];
+            scanner.endpoint = entry.second->endpoint;
+            scanner.serviceName = entry.second->serviceName;
+        }
+
+        for (const auto& entry : scanners) {
+            endpoints.push_back(entry.second.endpoint);
+        }
+    }
+
+    // Network round trips stay outside the lock
+    std::vector<std::pair<ScannerDevice, bool>> probed;
+    for (const EsclEndpoint& endpoint : endpoints) {
+        ScannerDevice device{};
+        const bool reachable = FetchCapabilities(endpoint, device);
+        probed.emplace_back(device, reachable);
+    }
+
+    std::vector<ScannerDevice> devices;
+    std::lock_guard<std::mutex> lock(scannersMutex);
+    for (size_t i = 0; i < endpoints.size(); i++) {
+        const std::string id = kDeviceIdPrefix + endpoints[i].Url();
+        auto it = scanners.find(id);
+        if (it == scanners.end()) {
+            continue;
+        }
+        KnownScanner& scanner = it->second;
+        scanner.reachable = probed[i].second;
+        if (scanner.reachable) {
+            scanner.device = probed[i].first;
+        }
+        // An unreachable scanner keeps what it reported last
+        if (scanner.device.name.empty()) {
+            scanner.device.name = scanner.serviceName.empty() ? endpoints[i].host : scanner.serviceName;
+        }
+        scanner.device.id = id;
+        scanner.device.platform = "escl";
+        scanner.device.available = scanner.reachable;
+        devices.push_back(scanner.device);
+    }
+    return devices;
+}
+
+std::shared_ptr<ScannerCore::ScanSession> EsclScanner::OpenDevice(const std::string& deviceId, std::string& error) {
+    std::lock_guard<std::mutex> lock(scannersMutex);
+    auto it = scanners.find(deviceId);
+    if (it == scanners.end()) {
+        error = "Unknown eSCL device " + deviceId;
+        return nullptr;
+    }
+    if (!it->second.reachable) {
+        error = "Scanner " + it->second.endpoint.Url() + " is not reachable";
+        return nullptr;
+    }
+
+    const ScannerCapabilities& capabilities = it->second.device.capabilities;
+    if (std::find(capabilities.compression.begin(), capabilities.compression.end(), "jpeg") ==
+        capabilities.compression.end()) {
+        error = "Scanner does not offer JPEG transfer";
+        return nullptr;
+    }
+
+    auto session = std::make_shared<EsclSession>();
+    session->endpoint = it->second.endpoint;
+    session->capabilities = capabilities;
+    session->transferEncodings = {ScannerCore::ImageEncoding::Jpeg};
+    return session;
+}
+
+bool EsclScanner::AcquirePages(EsclSession& session,
+                               const ScanSettings& settings,
+                               int maxPages,
+                               ScannerCore::BandWriter& writer,
+                               std::string& error) {
+    // The device always sends JPEG; it is either the page or decoded
+    const ScannerCore::ImageEncoding transfer =
+        ScannerCore::TransferEncodingFor(settings, session.transferEncodings);
+    return AcquireEsclPages(session.endpoint, session.capabilities, settings, transfer, maxPages, writer, error);
+}
+
+std::vector<EsclScanner::Descriptor> EsclScanner::ExtraMethods() {
+    return {
+        InstanceMethod("addDevice", &EsclScanner::AddDevice),
+    };
+}
+
+Napi::Value EsclScanner::AddDevice(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 1 || !info[0].IsString()) {
+        Napi::TypeError::New(env, "Scanner URL expected").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    EsclEndpoint endpoint;
+    std::string error;
+    if (!ParseEsclUrl(info[0].As<Napi::String>().Utf8Value(), endpoint, error)) {
+        Napi::TypeError::New(env, error).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    const std::string id = kDeviceIdPrefix + endpoint.Url();
+    {
+        std::lock_guard<std::mutex> lock(scannersMutex);
+        KnownScanner& scanner = scanners[id];
+        scanner.endpoint = endpoint;
+        scanner.manual = true;
+    }
+    // The next probe fetches its capabilities
+    registry_->Invalidate();
+    return Napi::String::New(env, id);
+}
+
+Napi::Object Init(Napi::Env env, Napi::Object exports) {
+    return EsclScanner::Export(env, exports, "EsclScanner");
+}
+
+NODE_API_MODULE(escl_wrapper, Init)
+
+} // namespace EsclWrapper
@@ -0,0 +1,68 @@
+/**
+ * eSCL Scanner Wrapper Header
+ *
+ * Native Node.js addon for network scanners speaking eSCL (Mopria,
+ * AirScan) over HTTP, on every platform. Scanners are found by an mDNS
+ * browse for _uscan._tcp or added by URL. Pages are pulled from the
+ * device on keep-alive connections and streamed into the shared
+ * acquisition pipeline.
+ */
+
+#ifndef ESCL_WRAPPER_H
+#define ESCL_WRAPPER_H
+
+#include <napi.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "esclProtocol.h"
+#include "scanTypes.h"
+#include "scannerObject.h"
+
+namespace EsclWrapper {
+
+using ScannerCore::ScannerDevice;
+using ScannerCore::ScannerCapabilities;
+using ScannerCore::ScanSettings;
+using ScannerCore::ScanResult;
+
+/**
+ * Scanner a session talks to. eSCL is stateless between jobs, so
+ * opening a device only fixes its address and capabilities.
+ */
+struct EsclSession : ScannerCore::ScanSession {
+    EsclEndpoint endpoint;
+    ScannerCapabilities capabilities;
+};
+
+class EsclScanner : public ScannerCore::ScannerObject<EsclScanner> {
+public:
+    EsclScanner(const Napi::CallbackInfo& info);
+
+private:
+    friend class ScannerCore::ScannerObject<EsclScanner>;
+    using Session = EsclSession;
+
+    // Driver load, runs once on the registry thread before the first probe
+    static bool LoadDriver(std::string& error);
+
+    static std::vector<Descriptor> ExtraMethods();
+    Napi::Value AddDevice(const Napi::CallbackInfo& info);
+
+    // Driver device probe, runs on the registry thread
+    static std::vector<ScannerDevice> ProbeDevices();
+
+    // Driver session open, runs on the JavaScript thread
+    static std::shared_ptr<ScannerCore::ScanSession> OpenDevice(const std::string& deviceId, std::string& error);
+
+    // Driver acquisition, runs on the session's acquisition thread
+    static bool AcquirePages(EsclSession& session,
+                             const ScanSettings& settings,
+                             int maxPages,
+                             ScannerCore::BandWriter& writer,
+                             std::string& error);
+};
+
+} // namespace EsclWrapper
+
+#endif // ESCL_WRAPPER_H
@@ -0,0 +1,508 @@
+/**
+ * eSCL HTTP Connection Implementation
+ */
+
+#include "httpConnection.h"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+
+namespace EsclWrapper {
+
+namespace {
+
+#ifdef _WIN32
+const SocketHandle kInvalidSocket = static_cast<SocketHandle>(INVALID_SOCKET);
+#else
+const SocketHandle kInvalidSocket = -1;
+#endif
+
+// Receive buffer for heads, chunk headers and small bodies
+constexpr size_t kBufferSize = 64 * 1024;
+
+// Longest head line accepted
+constexpr size_t kMaxLineLength = 16 * 1024;
+
+// A device warming up its lamp or feeding the first sheet can take this
+// long to start answering NextDocument
+constexpr int kReceiveTimeoutMs = 120 * 1000;
+
+#ifdef MSG_NOSIGNAL
+constexpr int kSendFlags = MSG_NOSIGNAL;
+#else
+constexpr int kSendFlags = 0;
+#endif
+
+void CloseSocket(SocketHandle socket) {
+#ifdef _WIN32
+    closesocket(static_cast<SOCKET>(socket));
+#else
+    close(socket);
+#endif
+}
+
+std::string ToLower(std::string text) {
+    std::transform(text.begin(), text.end(), text.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return text;
+}
+
+std::string Trim(const std::string& text) {
+    size_t begin = 0;
+    size_t end = text.size();
+    while (begin < end && std::isspace(static_cast<unsigned char>(text[begin]))) {
+        begin++;
+    }
+    while (end > begin && std::isspace(static_cast<unsigned char>(text[end - 1]))) {
+        end--;
+    }
+    return text.substr(begin, end - begin);
+}
+
+} // namespace
+
+std::string HttpResponse::Header(const std::string& name) const {
+    auto it = headers.find(ToLower(name));
+    return it == headers.end() ? std::string() : it->second;
+}
+
+bool InitSockets(std::string& error) {
+#ifdef _WIN32
+    WSADATA data;
+    const int result = WSAStartup(MAKEWORD(2, 2), &data);
+    if (result != 0) {
+        error = "WSAStartup failed (" + std::to_string(result) + ")";
+        return false;
+    }
+#else
+    (void)error;
+#endif
+    return true;
+}
+
+HttpConnection::HttpConnection(std::string host, int port)
+    : host_(std::move(host)),
+      port_(port),
+      socket_(kInvalidSocket),
+      aborted_(false),
+      reused_(false),
+      keepAlive_(true),
+      buffer_(kBufferSize),
+      begin_(0),
+      end_(0),
+      framing_(BodyFraming::None),
+      remaining_(0),
+      lastChunk_(false),
+      received_(0) {}
+
+HttpConnection::~HttpConnection() {
+    Close();
+}
+
+bool HttpConnection::Connect(std::string& error) {
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_protocol = IPPROTO_TCP;
+
+    addrinfo* addresses = nullptr;
+    const std::string port = std::to_string(port_);
+    if (getaddrinfo(host_.c_str(), port.c_str(), &hints, &addresses) != 0 || !addresses) {
+        error = "Cannot resolve scanner address " + host_;
+        return false;
+    }
+
+    SocketHandle connected = kInvalidSocket;
+    for (addrinfo* address = addresses; address && connected == kInvalidSocket; address = address->ai_next) {
+        SocketHandle candidate = static_cast<SocketHandle>(
+            socket(address->ai_family, address->ai_socktype, address->ai_protocol));
+        if (candidate == kInvalidSocket) {
+            continue;
+        }
+        if (connect(candidate, address->ai_addr, static_cast<int>(address->ai_addrlen)) == 0) {
+            connected = candidate;
+        } else {
+            CloseSocket(candidate);
+        }
+    }
+    freeaddrinfo(addresses);
+
+    if (connected == kInvalidSocket) {
+        error = "Cannot connect to scanner at " + host_ + ":" + port;
+        return false;
+    }
+
+    // Small requests go out at once; page reads time out instead of hanging
+    int noDelay = 1;
+    setsockopt(connected, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&noDelay), sizeof(noDelay));
+#ifdef _WIN32
+    DWORD timeout = kReceiveTimeoutMs;
+    setsockopt(static_cast<SOCKET>(connected), SOL_SOCKET, SO_RCVTIMEO,
+               reinterpret_cast<const char*>(&timeout), sizeof(timeout));
+#else
+    timeval timeout{};
+    timeout.tv_sec = kReceiveTimeoutMs / 1000;
+    setsockopt(connected, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+#endif
+#ifdef SO_NOSIGPIPE
+    int noSigpipe = 1;
+    setsockopt(connected, SOL_SOCKET, SO_NOSIGPIPE, &noSigpipe, sizeof(noSigpipe));
+#endif
+
+    std::lock_guard<std::mutex> lock(socketMutex_);
+    socket_ = connected;
+    if (aborted_) {
+        // Abort() ran while connecting
+        error = "Connection aborted";
+        return false;
+    }
+    return true;
+}
+
+void HttpConnection::Close() {
+    std::lock_guard<std::mutex> lock(socketMutex_);
+    if (socket_ != kInvalidSocket) {
+        CloseSocket(socket_);
+        socket_ = kInvalidSocket;
+    }
+    reused_ = false;
+    begin_ = end_ = 0;
+    framing_ = BodyFraming::None;
+}
+
+void HttpConnection::Abort() {
+    aborted_ = true;
+    std::lock_guard<std::mutex> lock(socketMutex_);
+    if (socket_ != kInvalidSocket) {
+#ifdef _WIN32
+        shutdown(static_cast<SOCKET>(socket_), SD_BOTH);
+#else
+        shutdown(socket_, SHUT_RDWR);
+#endif
+    }
+}
+
+void HttpConnection::Reset() {
+    Close();
+    aborted_ = false;
+}
+
+bool HttpConnection::SendAll(const char* data, size_t size, std::string& error) {
+    while (size > 0) {
+        const int chunk = static_cast<int>(std::min<size_t>(size, 1 << 20));
+        const auto sent = send(socket_, data, chunk, kSendFlags);
+        if (sent < 0) {
+#ifndef _WIN32
+            if (errno == EINTR) {
+                continue;
+            }
+#endif
+            error = aborted_ ? "Connection aborted" : "Sending to the scanner failed";
+            return false;
+        }
+        data += sent;
+        size -= static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+bool HttpConnection::Fill(std::string& error) {
+    if (begin_ > 0) {
+        std::memmove(buffer_.data(), buffer_.data() + begin_, end_ - begin_);
+        end_ -= begin_;
+        begin_ = 0;
+    }
+    if (end_ == buffer_.size()) {
+        error = "Scanner response line too long";
+        return false;
+    }
+
+    for (;;) {
+        const auto read = recv(socket_, reinterpret_cast<char*>(buffer_.data() + end_),
+                               static_cast<int>(buffer_.size() - end_), 0);
+        if (read > 0) {
+            end_ += static_cast<size_t>(read);
+            received_ += static_cast<uint64_t>(read);
+            return true;
+        }
+#ifndef _WIN32
+        if (read < 0 && errno == EINTR) {
+            continue;
+        }
+        if (read < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            error = "Timed out waiting for the scanner";
+            return false;
+        }
+#endif
+        if (aborted_) {
+            error = "Connection aborted";
+        } else {
+            error = read == 0 ? "Scanner closed the connection" : "Receiving from the scanner failed";
+        }
+        return false;
+    }
+}
+
+bool HttpConnection::ReadLine(std::string& line, std::string& error) {
+    for (;;) {
+        const uint8_t* begin = buffer_.data() + begin_;
+        const uint8_t* end = buffer_.data() + end_;
+        const uint8_t* newline = std::find(begin, end, '\n');
+        if (newline != end) {
+            line.assign(reinterpret_cast<const char*>(begin), newline - begin);
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+            begin_ += static_cast<size_t>(newline - begin) + 1;
+            return true;
+        }
+        if (Buffered() >= kMaxLineLength) {
+            error = "Scanner response line too long";
+            return false;
+        }
+        if (!Fill(error)) {
+            return false;
+        }
+    }
+}
+
+bool HttpConnection::SendRequest(const std::string& method,
+                                 const std::string& path,
+                                 const std::string& contentType,
+                                 const std::string& body,
+                                 std::string& error) {
+    std::string head = method + " " + path + " HTTP/1.1\r\n";
+    const std::string host = host_.find(':') == std::string::npos ? host_ : "[" + host_ + "]";
+    head += "Host: " + host + ":" + std::to_string(port_) + "\r\n";
+    head += "User-Agent: PaperFlow\r\n";
+    head += "Connection: keep-alive\r\n";
+    if (!body.empty() || method == "POST" || method == "PUT") {
+        if (!contentType.empty()) {
+            head += "Content-Type: " + contentType + "\r\n";
+        }
+        head += "Content-Length: " + std::to_string(body.size()) + "\r\n";
+    }
+    head += "\r\n";
+
+    return SendAll(head.data(), head.size(), error) && SendAll(body.data(), body.size(), error);
+}
+
+bool HttpConnection::ReadHead(const std::string& method, HttpResponse& response, std::string& error) {
+    std::string line;
+    bool http10 = false;
+
+    // Skip interim 1xx responses
+    do {
+        if (!ReadLine(line, error)) {
+            return false;
+        }
+        if (line.compare(0, 5, "HTTP/") != 0 || line.size() < 12) {
+            error = "Scanner sent an invalid HTTP response";
+            return false;
+        }
+        http10 = line.compare(5, 3, "1.0") == 0;
+        response.status = std::atoi(line.c_str() + 9);
+        response.headers.clear();
+
+        for (;;) {
+            if (!ReadLine(line, error)) {
+                return false;
+            }
+            if (line.empty()) {
+                break;
+            }
+            const size_t colon = line.find(':');
+            if (colon != std::string::npos) {
+                response.headers[ToLower(Trim(line.substr(0, colon)))] = Trim(line.substr(colon + 1));
+            }
+        }
+    } while (response.status >= 100 && response.status < 200);
+
+    const std::string connection = ToLower(response.Header("connection"));
+    keepAlive_ = http10 ? connection.find("keep-alive") != std::string::npos
+                        : connection.find("close") == std::string::npos;
+
+    remaining_ = 0;
+    lastChunk_ = false;
+    const std::string length = response.Header("content-length");
+    if (method == "HEAD" || response.status == 204 || response.status == 304) {
+        framing_ = BodyFraming::None;
+    } else if (ToLower(response.Header("transfer-encoding")).find("chunked") != std::string::npos) {
+        framing_ = BodyFraming::Chunked;
+    } else if (!length.empty()) {
+        remaining_ = std::strtoull(length.c_str(), nullptr, 10);
+        framing_ = remaining_ > 0 ? BodyFraming::Length : BodyFraming::None;
+    } else {
+        framing_ = BodyFraming::UntilClose;
+        keepAlive_ = false;
+    }
+
+    if (framing_ == BodyFraming::None) {
+        reused_ = true;
+        if (!keepAlive_) {
+            Close();
+        }
+    }
+    return true;
+}
+
+bool HttpConnection::Request(const std::string& method,
+                             const std::string& path,
+                             const std::string& contentType,
+                             const std::string& body,
+                             HttpResponse& response,
+                             std::string& error) {
+    if (aborted_) {
+        error = "Connection aborted";
+        return false;
+    }
+    // An unread body from the previous response would be taken for the head
+    if (framing_ != BodyFraming::None) {
+        std::string ignored;
+        if (!DiscardBody(ignored)) {
+            Close();
+        }
+    }
+
+    for (int attempt = 0; attempt < 2; attempt++) {
+        if (socket_ == kInvalidSocket && !Connect(error)) {
+            return false;
+        }
+
+        const bool reused = reused_;
+        received_ = 0;
+        if (SendRequest(method, path, contentType, body, error) && ReadHead(method, response, error)) {
+            return true;
+        }
+
+        // Devices drop idle keep-alive connections; only a request that
+        // got no answer at all on a reused connection is safe to resend
+        Close();
+        if (!reused || received_ > 0 || aborted_) {
+            return false;
+        }
+    }
+    return false;
+}
+
+bool HttpConnection::Exchange(const std::string& method,
+                              const std::string& path,
+                              const std::string& contentType,
+                              const std::string& body,
+                              HttpResponse& response,
+                              std::string& responseBody,
+                              std::string& error) {
+    if (!Request(method, path, contentType, body, response, error)) {
+        return false;
+    }
+
+    responseBody.clear();
+    uint8_t chunk[16 * 1024];
+    for (;;) {
+        const long read = ReadBody(chunk, sizeof(chunk), error);
+        if (read < 0) {
+            return false;
+        }
+        if (read == 0) {
+            return true;
+        }
+        responseBody.append(reinterpret_cast<const char*>(chunk), static_cast<size_t>(read));
+    }
+}
+
+long HttpConnection::ReadBody(uint8_t* data, size_t size, std::string& error) {
+    for (;;) {
+        switch (framing_) {
+            case BodyFraming::None:
+                return 0;
+
+            case BodyFraming::Chunked:
+                if (remaining_ == 0) {
+                    std::string line;
+                    if (lastChunk_) {
+                        // Trailer section up to the empty line
+                        do {
+                            if (!ReadLine(line, error)) {
+                                return -1;
+                            }
+                        } while (!line.empty());
+                        break;
+                    }
+                    if (!ReadLine(line, error)) {
+                        return -1;
+                    }
+                    if (line.empty()) {
+                        continue;  // CRLF that ends the previous chunk
+                    }
+                    remaining_ = std::strtoull(line.c_str(), nullptr, 16);
+                    if (remaining_ == 0) {
+                        lastChunk_ = true;
+                    }
+                    continue;
+                }
+                [[fallthrough]];
+            case BodyFraming::Length:
+            case BodyFraming::UntilClose: {
+                if (Buffered() == 0) {
+                    std::string fillError;
+                    if (!Fill(fillError)) {
+                        if (framing_ == BodyFraming::UntilClose && !aborted_) {
+                            break;  // end of the body
+                        }
+                        error = fillError;
+                        return -1;
+                    }
+                }
+                size_t count = std::min(size, Buffered());
+                if (framing_ != BodyFraming::UntilClose) {
+                    count = static_cast<size_t>(std::min<uint64_t>(count, remaining_));
+                    remaining_ -= count;
+                }
+                std::memcpy(data, buffer_.data() + begin_, count);
+                begin_ += count;
+                if (framing_ == BodyFraming::Length && remaining_ == 0) {
+                    framing_ = BodyFraming::Done;
+                }
+                return static_cast<long>(count);
+            }
+
+            case BodyFraming::Done:
+                break;
+        }
+
+        // Body complete
+        framing_ = BodyFraming::None;
+        reused_ = true;
+        if (!keepAlive_) {
+            Close();
+        }
+        return 0;
+    }
+}
+
+bool HttpConnection::DiscardBody(std::string& error) {
+    uint8_t chunk[16 * 1024];
+    for (;;) {
+        const long read = ReadBody(chunk, sizeof(chunk), error);
+        if (read <= 0) {
+            return read == 0;
+        }
+    }
+}
+
+} // namespace EsclWrapper
@@ -0,0 +1,125 @@
+/**
+ * eSCL HTTP Connection
+ *
+ * Minimal HTTP/1.1 client over one persistent (keep-alive) TCP
+ * connection, enough for eSCL: small XML exchanges plus page bodies
+ * that are read incrementally, with Content-Length, chunked or
+ * connection-close framing. A request on a connection the device has
+ * dropped while idle is retried once on a fresh one.
+ */
+
+#ifndef ESCL_HTTP_CONNECTION_H
+#define ESCL_HTTP_CONNECTION_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace EsclWrapper {
+
+#ifdef _WIN32
+using SocketHandle = uintptr_t;
+#else
+using SocketHandle = int;
+#endif
+
+/**
+ * Status line and headers of a response; header names are lower case
+ */
+struct HttpResponse {
+    int status = 0;
+    std::map<std::string, std::string> headers;
+
+    std::string Header(const std::string& name) const;
+};
+
+class HttpConnection {
+public:
+    HttpConnection(std::string host, int port);
+    ~HttpConnection();
+
+    HttpConnection(const HttpConnection&) = delete;
+    HttpConnection& operator=(const HttpConnection&) = delete;
+
+    // Send a request and read the response head; the body is then read
+    // with ReadBody() (or skipped by the next request)
+    bool Request(const std::string& method,
+                 const std::string& path,
+                 const std::string& contentType,
+                 const std::string& body,
+                 HttpResponse& response,
+                 std::string& error);
+
+    // Request() plus the whole (small) response body
+    bool Exchange(const std::string& method,
+                  const std::string& path,
+                  const std::string& contentType,
+                  const std::string& body,
+                  HttpResponse& response,
+                  std::string& responseBody,
+                  std::string& error);
+
+    // Next part of the response body: bytes read, 0 at its end, -1 on error
+    long ReadBody(uint8_t* data, size_t size, std::string& error);
+
+    // Read and drop the rest of the body so the connection can be reused
+    bool DiscardBody(std::string& error);
+
+    // Unblock a request or read in progress on another thread; the
+    // connection fails until Reset()
+    void Abort();
+    void Reset();
+
+private:
+    enum class BodyFraming {
+        None,
+        Length,
+        Chunked,
+        UntilClose,
+        Done                  // body read, connection state not yet settled
+    };
+
+    bool Connect(std::string& error);
+    void Close();
+    bool SendRequest(const std::string& method,
+                     const std::string& path,
+                     const std::string& contentType,
+                     const std::string& body,
+                     std::string& error);
+    bool ReadHead(const std::string& method, HttpResponse& response, std::string& error);
+    bool ReadLine(std::string& line, std::string& error);
+    bool SendAll(const char* data, size_t size, std::string& error);
+    // Read more bytes into buffer_; false on error or end of stream
+    bool Fill(std::string& error);
+    size_t Buffered() const { return end_ - begin_; }
+
+    std::string host_;
+    int port_;
+    std::mutex socketMutex_;  // socket_ against Abort() from another thread
+    SocketHandle socket_;
+    std::atomic<bool> aborted_;
+    bool reused_;             // a request already completed on socket_
+    bool keepAlive_;
+
+    std::vector<uint8_t> buffer_;
+    size_t begin_;
+    size_t end_;
+
+    BodyFraming framing_;
+    uint64_t remaining_;      // Length: body bytes left; Chunked: bytes left in the chunk
+    bool lastChunk_;
+    uint64_t received_;       // bytes received since the current request was sent
+};
+
+/**
+ * Process-wide socket library setup (WSAStartup on Windows)
+ */
+bool InitSockets(std::string& error);
+
+} // namespace EsclWrapper
+
+#endif // ESCL_HTTP_CONNECTION_H
@@ -0,0 +1,411 @@
+/**
+ * eSCL mDNS Discovery Implementation
+ */
+
+#include "mdnsBrowser.h"
+#include "httpConnection.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <map>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+
+namespace EsclWrapper {
+
+namespace {
+
+#ifdef _WIN32
+const SocketHandle kInvalidSocket = static_cast<SocketHandle>(INVALID_SOCKET);
+#else
+const SocketHandle kInvalidSocket = -1;
+#endif
+
+const char* const kServiceType = "_uscan._tcp.local";
+const char* const kMdnsGroup = "224.0.0.251";
+constexpr int kMdnsPort = 5353;
+
+constexpr uint16_t kTypeA = 1;
+constexpr uint16_t kTypePtr = 12;
+constexpr uint16_t kTypeTxt = 16;
+constexpr uint16_t kTypeSrv = 33;
+constexpr uint16_t kClassIn = 1;
+
+// Largest mDNS packet (RFC 6762 section 17)
+constexpr size_t kMaxPacket = 9000;
+
+// Compression pointers followed per name before it counts as a loop
+constexpr int kMaxPointers = 16;
+
+void CloseSocket(SocketHandle socket) {
+#ifdef _WIN32
+    closesocket(static_cast<SOCKET>(socket));
+#else
+    close(socket);
+#endif
+}
+
+std::string ToLower(std::string text) {
+    std::transform(text.begin(), text.end(), text.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return text;
+}
+
+std::string JoinLabels(const std::vector<std::string>& labels) {
+    std::string name;
+    for (const std::string& label : labels) {
+        if (!name.empty()) {
+            name += '.';
+        }
+        name += label;
+    }
+    return name;
+}
+
+struct ServiceRecord {
+    std::string target;  // host name, lower case
+    int port = 0;
+    std::string sender;  // address the record came from
+};
+
+/**
+ * Records gathered from every response of one browse, keyed by lower
+ * case owner name
+ */
+struct BrowseAnswers {
+    std::vector<std::vector<std::string>> instances;  // PTR targets of the service type, as labels
+    std::map<std::string, ServiceRecord> services;
+    std::map<std::string, std::map<std::string, std::string>> txt;
+    std::map<std::string, std::string> addresses;
+};
+
+/**
+ * Bounds-checked reader over one DNS message
+ */
+class DnsMessage {
+public:
+    DnsMessage(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+    bool U16(size_t& offset, uint16_t& value) const {
+        if (offset + 2 > size_) {
+            return false;
+        }
+        value = static_cast<uint16_t>(data_[offset] << 8 | data_[offset + 1]);
+        offset += 2;
+        return true;
+    }
+
+    bool U32(size_t& offset, uint32_t& value) const {
+        uint16_t high = 0;
+        uint16_t low = 0;
+        if (!U16(offset, high) || !U16(offset, low)) {
+            return false;
+        }
+        value = static_cast<uint32_t>(high) << 16 | low;
+        return true;
+    }
+
+    // Labels of the (possibly compressed) name at offset; offset moves
+    // past the name as it appears there
+    bool Name(size_t& offset, std::vector<std::string>& labels) const {
+        labels.clear();
+        size_t at = offset;
+        bool jumped = false;
+        for (int pointers = 0; at < size_;) {
+            const uint8_t length = data_[at];
+            if (length == 0) {
+                if (!jumped) {
+                    offset = at + 1;
+                }
+                return true;
+            }
+            if ((length & 0xC0) == 0xC0) {
+                if (at + 1 >= size_ || ++pointers > kMaxPointers) {
+                    return false;
+                }
+                if (!jumped) {
+                    offset = at + 2;
+                    jumped = true;
+                }
+                at = static_cast<size_t>(length & 0x3F) << 8 | data_[at + 1];
+                continue;
+            }
+            if ((length & 0xC0) != 0 || at + 1 + length > size_) {
+                return false;
+            }
+            labels.emplace_back(reinterpret_cast<const char*>(data_ + at + 1), length);
+            at += 1 + length;
+        }
+        return false;
+    }
+
+    const uint8_t* Data() const { return data_; }
+
+private:
+    const uint8_t* data_;
+    size_t size_;
+};
+
+std::vector<uint8_t> BuildQuery() {
+    std::vector<uint8_t> query = {
+        0, 0,  // id
+        0, 0,  // flags: standard query
+        0, 1,  // one question
+        0, 0, 0, 0, 0, 0,
+    };
+    const std::string type = kServiceType;
+    size_t begin = 0;
+    while (begin < type.size()) {
+        size_t end = type.find('.', begin);
+        if (end == std::string::npos) {
+            end = type.size();
+        }
+        query.push_back(static_cast<uint8_t>(end - begin));
+        query.insert(query.end(), type.begin() + begin, type.begin() + end);
+        begin = end + 1;
+    }
+    query.push_back(0);
+    query.insert(query.end(), {0, kTypePtr, 0, kClassIn});
+    return query;
+}
+
+/**
+ * Add the records of one response; malformed packets are dropped from
+ * the first record that does not parse
+ */
+void ParseResponse(const uint8_t* data, size_t size, const std::string& sender, BrowseAnswers& answers) {
+    const DnsMessage message(data, size);
+    size_t offset = 0;
+    uint16_t id = 0;
+    uint16_t flags = 0;
+    uint16_t questions = 0;
+    uint16_t answerCount = 0;
+    uint16_t authorityCount = 0;
+    uint16_t additionalCount = 0;
+    if (!message.U16(offset, id) || !message.U16(offset, flags) || !message.U16(offset, questions) ||
+        !message.U16(offset, answerCount) || !message.U16(offset, authorityCount) ||
+        !message.U16(offset, additionalCount) || (flags & 0x8000) == 0) {
+        return;
+    }
+
+    std::vector<std::string> labels;
+    for (int i = 0; i < questions; i++) {
+        uint16_t type = 0;
+        uint16_t cls = 0;
+        if (!message.Name(offset, labels) || !message.U16(offset, type) || !message.U16(offset, cls)) {
+            return;
+        }
+    }
+
+    const int records = answerCount + authorityCount + additionalCount;
+    for (int i = 0; i < records; i++) {
+        uint16_t type = 0;
+        uint16_t cls = 0;
+        uint32_t ttl = 0;
+        uint16_t length = 0;
+        if (!message.Name(offset, labels) || !message.U16(offset, type) || !message.U16(offset, cls) ||
+            !message.U32(offset, ttl) || !message.U16(offset, length) || offset + length > size) {
+            return;
+        }
+        const std::string owner = ToLower(JoinLabels(labels));
+        const size_t end = offset + length;
+        size_t at = offset;
+        offset = end;
+
+        // The top bit of the class is the cache-flush flag; a TTL of 0
+        // is a goodbye for a service that is going away
+        if ((cls & 0x7FFF) != kClassIn || ttl == 0) {
+            continue;
+        }
+
+        switch (type) {
+        case kTypePtr: {
+            std::vector<std::string> instance;
+            if (owner == kServiceType && message.Name(at, instance) && !instance.empty()) {
+                answers.instances.push_back(instance);
+            }
+            break;
+        }
+        case kTypeSrv: {
+            uint16_t priority = 0;
+            uint16_t weight = 0;
+            uint16_t port = 0;
+            std::vector<std::string> target;
+            if (message.U16(at, priority) && message.U16(at, weight) && message.U16(at, port) &&
+                message.Name(at, target)) {
+                answers.services[owner] = ServiceRecord{ToLower(JoinLabels(target)), port, sender};
+            }
+            break;
+        }
+        case kTypeTxt: {
+            std::map<std::string, std::string>& entries = answers.txt[owner];
+            while (at < end) {
+                const size_t entryLength = message.Data()[at];
+                if (at + 1 + entryLength > end) {
+                    break;
+                }
+                const std::string entry(reinterpret_cast<const char*>(message.Data() + at + 1), entryLength);
+                const size_t equals = entry.find('=');
+                if (equals != std::string::npos && equals > 0) {
+                    entries[ToLower(entry.substr(0, equals))] = entry.substr(equals + 1);
+                }
+                at += 1 + entryLength;
+            }
+            break;
+        }
+        case kTypeA:
+            if (length == 4) {
+                const uint8_t* address = message.Data() + at;
+                answers.addresses[owner] = std::to_string(address[0]) + "." + std::to_string(address[1]) + "." +
+                                           std::to_string(address[2]) + "." + std::to_string(address[3]);
+            }
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+std::vector<DiscoveredScanner> ResolveAnswers(const BrowseAnswers& answers) {
+    std::vector<DiscoveredScanner> scanners;
+    for (const std::vector<std::string>& instance : answers.instances) {
+        const std::string key = ToLower(JoinLabels(instance));
+        auto service = answers.services.find(key);
+        if (service == answers.services.end() || service->second.port <= 0) {
+            continue;
+        }
+
+        DiscoveredScanner scanner;
+        scanner.serviceName = instance.front();
+
+        // The host's A record, else the address that answered
+        auto address = answers.addresses.find(service->second.target);
+        if (address != answers.addresses.end()) {
+            scanner.endpoint.host = address->second;
+        } else if (!service->second.sender.empty()) {
+            scanner.endpoint.host = service->second.sender;
+        } else {
+            scanner.endpoint.host = service->second.target;
+        }
+        scanner.endpoint.port = service->second.port;
+
+        auto txt = answers.txt.find(key);
+        if (txt != answers.txt.end()) {
+            auto root = txt->second.find("rs");
+            if (root != txt->second.end()) {
+                std::string path = root->second;
+                while (!path.empty() && path.back() == '/') {
+                    path.pop_back();
+                }
+                scanner.endpoint.root = path.empty() || path.front() == '/' ? path : "/" + path;
+            }
+            auto model = txt->second.find("ty");
+            if (model != txt->second.end()) {
+                scanner.model = model->second;
+            }
+        }
+
+        const std::string url = scanner.endpoint.Url();
+        const bool known = std::any_of(scanners.begin(), scanners.end(),
+                                       [&url](const DiscoveredScanner& other) { return other.endpoint.Url() == url; });
+        if (!known) {
+            scanners.push_back(std::move(scanner));
+        }
+    }
+    return scanners;
+}
+
+} // namespace
+
+std::vector<DiscoveredScanner> BrowseEsclScanners(int timeoutMs) {
+    const SocketHandle udp = static_cast<SocketHandle>(socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP));
+    if (udp == kInvalidSocket) {
+        return {};
+    }
+
+#ifdef _WIN32
+    const DWORD ttl = 255;
+#else
+    const unsigned char ttl = 255;  // BSD sockets take a byte here
+#endif
+    setsockopt(udp, IPPROTO_IP, IP_MULTICAST_TTL, reinterpret_cast<const char*>(&ttl), sizeof(ttl));
+
+    sockaddr_in group{};
+    group.sin_family = AF_INET;
+    group.sin_port = htons(kMdnsPort);
+    inet_pton(AF_INET, kMdnsGroup, &group.sin_addr);
+
+    const std::vector<uint8_t> query = BuildQuery();
+    auto send = [&]() {
+        sendto(udp, reinterpret_cast<const char*>(query.data()), static_cast<int>(query.size()), 0,
+               reinterpret_cast<const sockaddr*>(&group), sizeof(group));
+    };
+
+    // The query goes out twice, the second time halfway through, in
+    // case the first was lost
+    const auto start = std::chrono::steady_clock::now();
+    const auto deadline = start + std::chrono::milliseconds(timeoutMs);
+    const auto resend = start + std::chrono::milliseconds(timeoutMs / 2);
+    bool resent = false;
+    send();
+
+    BrowseAnswers answers;
+    std::vector<uint8_t> packet(kMaxPacket);
+    for (;;) {
+        const auto now = std::chrono::steady_clock::now();
+        if (now >= deadline) {
+            break;
+        }
+        if (!resent && now >= resend) {
+            send();
+            resent = true;
+        }
+        const auto wakeAt = resent ? deadline : resend;
+        const long long waitUs =
+            std::chrono::duration_cast<std::chrono::microseconds>(wakeAt - now).count();
+
+        fd_set readable;
+        FD_ZERO(&readable);
+        FD_SET(udp, &readable);
+        timeval wait{};
+        wait.tv_sec = static_cast<long>(waitUs / 1000000);
+        wait.tv_usec = static_cast<long>(waitUs % 1000000);
+        const int ready = select(static_cast<int>(udp) + 1, &readable, nullptr, nullptr, &wait);
+        if (ready < 0) {
+            break;
+        }
+        if (ready == 0) {
+            continue;
+        }
+
+        sockaddr_in from{};
+        socklen_t fromLength = sizeof(from);
+        const long received = static_cast<long>(recvfrom(udp, reinterpret_cast<char*>(packet.data()),
+                                                         static_cast<int>(packet.size()), 0,
+                                                         reinterpret_cast<sockaddr*>(&from), &fromLength));
+        if (received <= 0) {
+            continue;
+        }
+        char sender[INET_ADDRSTRLEN] = {};
+        inet_ntop(AF_INET, &from.sin_addr, sender, sizeof(sender));
+        ParseResponse(packet.data(), static_cast<size_t>(received), sender, answers);
+    }
+
+    CloseSocket(udp);
+    return ResolveAnswers(answers);
+}
+
+} // namespace EsclWrapper
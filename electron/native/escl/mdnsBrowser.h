@@ -0,0 +1,40 @@
+/**
+ * eSCL mDNS Discovery
+ *
+ * One-shot DNS-SD browse for `_uscan._tcp.local` over multicast DNS.
+ * A PTR query goes to 224.0.0.251:5353 from an ephemeral port, so
+ * responders answer it directly (a legacy unicast query, RFC 6762
+ * section 6.7). Answers are collected for a short window. Every service
+ * instance is resolved from its SRV (host, port), TXT (`rs` root, `ty`
+ * model) and A records, which scanners send in the same response. The
+ * browse is IPv4 only and never binds port 5353, so it does not collide
+ * with Avahi, mDNSResponder or the Windows DNS client.
+ */
+
+#ifndef ESCL_MDNS_BROWSER_H
+#define ESCL_MDNS_BROWSER_H
+
+#include <string>
+#include <vector>
+#include "esclProtocol.h"
+
+namespace EsclWrapper {
+
+/**
+ * A scanner that answered the browse
+ */
+struct DiscoveredScanner {
+    std::string serviceName;  // instance label, e.g. "Office MFP"
+    std::string model;        // TXT "ty"
+    EsclEndpoint endpoint;
+};
+
+/**
+ * Browse for eSCL scanners for up to timeoutMs. Returns what answered;
+ * network errors just yield fewer (or no) scanners.
+ */
+std::vector<DiscoveredScanner> BrowseEsclScanners(int timeoutMs);
+
+} // namespace EsclWrapper
+
+#endif // ESCL_MDNS_BROWSER_H
@@ -9,26 +9,51 @@
 #define IMAGECAPTURE_WRAPPER_H
 
 #include <napi.h>
+#include <memory>
 #include <string>
+#include <vector>
+#include "scanTypes.h"
+#include "scannerObject.h"
 
 namespace ImageCaptureWrapper {
 
-class ImageCaptureScanner : public Napi::ObjectWrap<ImageCaptureScanner> {
+using ScannerCore::ScannerDevice;
+using ScannerCore::ScanSettings;
+using ScannerCore::ScanResult;
+
+/**
+ * Open ImageCapture scanner held by a scan session
+ */
+struct ImageCaptureSession : ScannerCore::ScanSession {
+    // TODO: ICScannerDevice with an open session; requestCloseSession in the destructor
+};
+
+class ImageCaptureScanner : public ScannerCore::ScannerObject<ImageCaptureScanner> {
 public:
-    static Napi::Object Init(Napi::Env env, Napi::Object exports);
     ImageCaptureScanner(const Napi::CallbackInfo& info);
 
 private:
-    Napi::Value Initialize(const Napi::CallbackInfo& info);
-    Napi::Value EnumerateDevices(const Napi::CallbackInfo& info);
-    Napi::Value SelectDevice(const Napi::CallbackInfo& info);
-    Napi::Value GetCapabilities(const Napi::CallbackInfo& info);
-    Napi::Value Scan(const Napi::CallbackInfo& info);
-    Napi::Value CancelScan(const Napi::CallbackInfo& info);
-    Napi::Value Close(const Napi::CallbackInfo& info);
-
-    bool isInitialized_;
-    std::string selectedDeviceId_;
+    friend class ScannerCore::ScannerObject<ImageCaptureScanner>;
+    using Session = ImageCaptureSession;
+
+    // Driver load, runs once on the registry thread before the first probe
+    static bool LoadDriver(std::string& error);
+
+    // Driver teardown on close()
+    void OnClose();
+
+    // Driver device probe, runs on the registry thread
+    static std::vector<ScannerDevice> ProbeDevices();
+
+    // Driver session open, runs on the JavaScript thread
+    static std::shared_ptr<ScannerCore::ScanSession> OpenDevice(const std::string& deviceId, std::string& error);
+
+    // Driver acquisition, runs on the session's acquisition thread
+    static bool AcquirePages(ImageCaptureSession& session,
+                             const ScanSettings& settings,
+                             int maxPages,
+                             ScannerCore::BandWriter& writer,
+                             std::string& error);
 };
 
 } // namespace ImageCaptureWrapper
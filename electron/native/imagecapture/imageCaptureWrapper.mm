@@ -6,86 +6,80 @@
  */
 
 #include "imageCaptureWrapper.h"
+#include "scanArea.h"
 
 // Note: On macOS, this would include:
 // #import <ImageCaptureCore/ImageCaptureCore.h>
 
 namespace ImageCaptureWrapper {
 
-Napi::Object ImageCaptureScanner::Init(Napi::Env env, Napi::Object exports) {
-    Napi::Function func = DefineClass(env, "ImageCaptureScanner", {
-        InstanceMethod("initialize", &ImageCaptureScanner::Initialize),
-        InstanceMethod("enumerateDevices", &ImageCaptureScanner::EnumerateDevices),
-        InstanceMethod("selectDevice", &ImageCaptureScanner::SelectDevice),
-        InstanceMethod("getCapabilities", &ImageCaptureScanner::GetCapabilities),
-        InstanceMethod("scan", &ImageCaptureScanner::Scan),
-        InstanceMethod("cancelScan", &ImageCaptureScanner::CancelScan),
-        InstanceMethod("close", &ImageCaptureScanner::Close),
-    });
-
-    Napi::FunctionReference* constructor = new Napi::FunctionReference();
-    *constructor = Napi::Persistent(func);
-    env.SetInstanceData(constructor);
-
-    exports.Set("ImageCaptureScanner", func);
-    return exports;
-}
-
-ImageCaptureScanner::ImageCaptureScanner(const Napi::CallbackInfo& info)
-    : Napi::ObjectWrap<ImageCaptureScanner>(info), isInitialized_(false) {}
-
-Napi::Value ImageCaptureScanner::Initialize(const Napi::CallbackInfo& info) {
-    Napi::Env env = info.Env();
-    // TODO: Create ICDeviceBrowser and start scanning for devices
-    isInitialized_ = true;
-    return Napi::Boolean::New(env, true);
-}
-
-Napi::Value ImageCaptureScanner::EnumerateDevices(const Napi::CallbackInfo& info) {
-    Napi::Env env = info.Env();
-    // TODO: Return devices from ICDeviceBrowser
-    return Napi::Array::New(env);
-}
-
-Napi::Value ImageCaptureScanner::SelectDevice(const Napi::CallbackInfo& info) {
-    Napi::Env env = info.Env();
-    if (info.Length() < 1 || !info[0].IsString()) {
-        Napi::TypeError::New(env, "Device ID expected").ThrowAsJavaScriptException();
-        return env.Null();
-    }
-    selectedDeviceId_ = info[0].As<Napi::String>().Utf8Value();
-    // TODO: Open connection to ICScannerDevice
-    return Napi::Boolean::New(env, true);
+ImageCaptureScanner::ImageCaptureScanner(const Napi::CallbackInfo& info) : ScannerObject<ImageCaptureScanner>(info) {}
+
+bool ImageCaptureScanner::LoadDriver(std::string& error) {
+    // TODO: Create ICDeviceBrowser and start scanning for devices; the
+    // browser reports on the main run loop, so create it there with
+    // dispatch_async(dispatch_get_main_queue(), ...) and do not wait: the
+    // JavaScript thread may be blocked in enumerateDevices() meanwhile.
+    // The delegate's didAddDevice: / didRemoveDevice: call
+    // registry_->Invalidate().
+    // On failure set error and return false.
+    (void)error;
+    return true;
 }
 
-Napi::Value ImageCaptureScanner::GetCapabilities(const Napi::CallbackInfo& info) {
-    Napi::Env env = info.Env();
-    // TODO: Query ICScannerDevice capabilities
-    return Napi::Object::New(env);
+void ImageCaptureScanner::OnClose() {
+    // TODO: Stop the ICDeviceBrowser; device connections close with their sessions
 }
 
-Napi::Value ImageCaptureScanner::Scan(const Napi::CallbackInfo& info) {
-    Napi::Env env = info.Env();
-    // TODO: Use ICScannerFunctionalUnit to perform scan
-    Napi::Object result = Napi::Object::New(env);
-    result.Set("success", false);
-    result.Set("errorMessage", "ImageCapture scanning not implemented");
-    return result;
+std::vector<ScannerDevice> ImageCaptureScanner::ProbeDevices() {
+    // TODO: Return ICScannerDevice entries from the ICDeviceBrowser
+    return {};
 }
 
-Napi::Value ImageCaptureScanner::CancelScan(const Napi::CallbackInfo& info) {
-    // TODO: Cancel ongoing scan
-    return Napi::Boolean::New(info.Env(), true);
+std::shared_ptr<ScannerCore::ScanSession> ImageCaptureScanner::OpenDevice(const std::string& deviceId, std::string& error) {
+    // TODO: requestOpenSession on the ICScannerDevice for deviceId; Jpeg in
+    // session->transferEncodings when the device's transferMode supports
+    // ICScannerTransferModeFileBased with the public.jpeg document UTI
+    (void)deviceId;
+    (void)error;
+    return std::make_shared<ImageCaptureSession>();
 }
 
-Napi::Value ImageCaptureScanner::Close(const Napi::CallbackInfo& info) {
-    // TODO: Close device connection
-    isInitialized_ = false;
-    return Napi::Boolean::New(info.Env(), true);
+bool ImageCaptureScanner::AcquirePages(ImageCaptureSession& session,
+                                       const ScanSettings& settings,
+                                       int maxPages,
+                                       ScannerCore::BandWriter& writer,
+                                       std::string& error) {
+    // TODO: Use ICScannerFunctionalUnitDocumentFeeder with
+    // ICScannerTransferModeMemoryBased; forward each didScanToBandData:
+    // callback to writer.Write() and call writer.EndPage() per document,
+    // cancelling the scan when it returns false or maxPages is reached
+    //
+    // settings.preview: flatbed functional unit at its lowest
+    // supportedResolutions entry >= settings.resolution
+    //
+    // settings.scanArea (inches, when set): functional unit measurementUnit =
+    // ICScannerMeasurementUnitInches and scanArea = NSMakeRect(left,
+    // physicalSize.height - top - height, width, height) (bottom-left origin)
+    //
+    // TransferEncodingFor(settings, session.transferEncodings) == Jpeg:
+    // ICScannerTransferModeFileBased with documentUTI = public.jpeg; read
+    // each didScanToURL: file into writer.Write() after BeginPage() with
+    // geometry.encoding = ImageEncoding::Jpeg
+    //
+    // Cancellation: CancelHook on writer.Token() that calls
+    // [device cancelScan] on the main queue, so a band that is not coming
+    // does not hold the acquisition thread
+    (void)session;
+    (void)settings;
+    (void)maxPages;
+    (void)writer;
+    error = "ImageCapture scanning not implemented";
+    return false;
 }
 
 Napi::Object Init(Napi::Env env, Napi::Object exports) {
-    return ImageCaptureScanner::Init(env, exports);
+    return ImageCaptureScanner::Export(env, exports, "ImageCaptureScanner");
 }
 
 NODE_API_MODULE(imagecapture_wrapper, Init)
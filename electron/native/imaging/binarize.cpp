@@ -0,0 +1,387 @@
+/**
+ * Bitonal Conversion Implementation
+ */
+
+#include "binarize.h"
+#include "threadPool.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define IMAGING_SSE2 1
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define IMAGING_NEON 1
+#endif
+
+namespace Imaging {
+
+namespace {
+
+// BT.601 luma weights in 8.8 fixed point (sum = 256), matching applyGrayscale
+constexpr int kLumaR = 77;
+constexpr int kLumaG = 150;
+constexpr int kLumaB = 29;
+
+// Rows per thread-pool task. Each strip primes its own window, so strips
+// must be tall compared to the window.
+constexpr int kStripRows = 256;
+
+// Sauvola dynamic range of the standard deviation
+constexpr double kSauvolaRange = 128.0;
+
+// Largest window whose squared box sum still fits in 32 bits
+constexpr int kMaxWindow = 255;
+
+#if defined(IMAGING_SSE2)
+// movemask puts pixel 0 in bit 0; BlackWhite1 wants it in the MSB
+struct BitReverseTable {
+    uint8_t value[256];
+    BitReverseTable() {
+        for (int i = 0; i < 256; i++) {
+            int r = 0;
+            for (int b = 0; b < 8; b++) {
+                r |= ((i >> b) & 1) << (7 - b);
+            }
+            value[i] = static_cast<uint8_t>(r);
+        }
+    }
+};
+const BitReverseTable kBitReverse;
+#endif
+
+inline int Luma(const uint8_t* px, int channels) {
+    if (channels < 3) {
+        return px[0];
+    }
+    return (kLumaR * px[0] + kLumaG * px[1] + kLumaB * px[2] + 128) >> 8;
+}
+
+/**
+ * Local thresholds for rows [begin, end). The window's column sums roll
+ * down the strip (one row in, one row out) and each row's horizontal
+ * prefix over them is the matching slice of the integral image, so
+ * memory stays O(width) instead of two full-page integral planes.
+ * Sums are unsigned 32-bit and wrap; box differences stay exact because
+ * a single window never exceeds 2^32.
+ */
+void LocalThresholdStrip(const GrayImage& gray, const BinarizeOptions& options, int window,
+                         int begin, int end, BitonalImage& out) {
+    const int width = gray.width;
+    const int height = gray.height;
+    const int radius = window / 2;
+    const bool sauvola = options.method == ThresholdMethod::Sauvola;
+    const double bradleyScale = 1.0 - options.percent / 100.0;
+
+    std::vector<uint32_t> colSum(width, 0);
+    std::vector<uint32_t> colSq(width, 0);
+    std::vector<uint32_t> rowSum(width + 1, 0);
+    std::vector<uint32_t> rowSq(width + 1, 0);
+    std::vector<uint8_t> threshold(width);
+
+    auto addRow = [&](int y, bool add) {
+        const uint8_t* row = gray.Row(y);
+        if (add) {
+            for (int x = 0; x < width; x++) {
+                uint32_t v = row[x];
+                colSum[x] += v;
+                colSq[x] += v * v;
+            }
+        } else {
+            for (int x = 0; x < width; x++) {
+                uint32_t v = row[x];
+                colSum[x] -= v;
+                colSq[x] -= v * v;
+            }
+        }
+    };
+
+    int top = std::max(0, begin - radius);
+    int bottom = std::min(height - 1, begin + radius);
+    for (int y = top; y <= bottom; y++) {
+        addRow(y, true);
+    }
+
+    for (int y = begin; y < end; y++) {
+        if (y > begin) {
+            if (y + radius < height) {
+                addRow(y + radius, true);
+                bottom = y + radius;
+            }
+            if (y - radius - 1 >= 0) {
+                addRow(y - radius - 1, false);
+                top = y - radius;
+            }
+        }
+        const int rows = bottom - top + 1;
+
+        for (int x = 0; x < width; x++) {
+            rowSum[x + 1] = rowSum[x] + colSum[x];
+            rowSq[x + 1] = rowSq[x] + colSq[x];
+        }
+
+        for (int x = 0; x < width; x++) {
+            const int x1 = std::max(0, x - radius);
+            const int x2 = std::min(width - 1, x + radius);
+            const double count = static_cast<double>((x2 - x1 + 1) * rows);
+            const double mean = (rowSum[x2 + 1] - rowSum[x1]) / count;
+
+            double t;
+            if (sauvola) {
+                const double variance = std::max(0.0, (rowSq[x2 + 1] - rowSq[x1]) / count - mean * mean);
+                t = mean * (1.0 + options.k * (std::sqrt(variance) / kSauvolaRange - 1.0));
+            } else {
+                t = mean * bradleyScale;
+            }
+            // gray > t  <=>  gray > floor(t) for integer gray
+            threshold[x] = static_cast<uint8_t>(std::min(255.0, std::max(0.0, std::floor(t))));
+        }
+
+        PackRow(gray.Row(y), threshold.data(), width,
+                out.data.data() + static_cast<size_t>(y) * out.stride);
+    }
+}
+
+} // namespace
+
+bool ParseThresholdMethod(const std::string& name, ThresholdMethod& method) {
+    if (name == "fixed") {
+        method = ThresholdMethod::Fixed;
+    } else if (name == "otsu") {
+        method = ThresholdMethod::Otsu;
+    } else if (name == "sauvola") {
+        method = ThresholdMethod::Sauvola;
+    } else if (name == "bradley") {
+        method = ThresholdMethod::Bradley;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+void ToGrayRow(const uint8_t* src, int width, int channels, uint8_t* dst) {
+    int x = 0;
+
+    if (channels < 3) {
+        if (channels == 1) {
+            std::copy(src, src + width, dst);
+            return;
+        }
+        for (; x < width; x++) {
+            dst[x] = src[x * channels];
+        }
+        return;
+    }
+
+#if defined(IMAGING_SSE2)
+    // Four pixels per register as R G B x in 16-bit lanes; madd gives
+    // R*wr + G*wg and B*wb per pixel, the shuffles add the halves
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i weights = _mm_setr_epi16(kLumaR, kLumaG, kLumaB, 0, kLumaR, kLumaG, kLumaB, 0);
+    const __m128i round = _mm_set1_epi32(128);
+
+    auto luma4 = [&](__m128i px) {
+        __m128i lo = _mm_madd_epi16(_mm_unpacklo_epi8(px, zero), weights);
+        __m128i hi = _mm_madd_epi16(_mm_unpackhi_epi8(px, zero), weights);
+        __m128 a = _mm_castsi128_ps(lo);
+        __m128 b = _mm_castsi128_ps(hi);
+        __m128i even = _mm_castps_si128(_mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+        __m128i odd = _mm_castps_si128(_mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+        return _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(even, odd), round), 8);
+    };
+
+    if (channels == 4) {
+        for (; x + 8 <= width; x += 8) {
+            __m128i p0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x * 4));
+            __m128i p1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x * 4 + 16));
+            __m128i y16 = _mm_packs_epi32(luma4(p0), luma4(p1));
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + x), _mm_packus_epi16(y16, zero));
+        }
+    } else {
+        // SSE2 has no byte shuffle: assemble RGB triples into RGB0 words
+        auto gather = [&](int i) {
+            const uint8_t* p = src + i * 3;
+            return _mm_setr_epi32(
+                p[0] | (p[1] << 8) | (p[2] << 16), p[3] | (p[4] << 8) | (p[5] << 16),
+                p[6] | (p[7] << 8) | (p[8] << 16), p[9] | (p[10] << 8) | (p[11] << 16));
+        };
+        for (; x + 8 <= width; x += 8) {
+            __m128i y16 = _mm_packs_epi32(luma4(gather(x)), luma4(gather(x + 4)));
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + x), _mm_packus_epi16(y16, zero));
+        }
+    }
+#elif defined(IMAGING_NEON)
+    const uint8x8_t wr = vdup_n_u8(kLumaR);
+    const uint8x8_t wg = vdup_n_u8(kLumaG);
+    const uint8x8_t wb = vdup_n_u8(kLumaB);
+    if (channels == 4) {
+        for (; x + 8 <= width; x += 8) {
+            uint8x8x4_t px = vld4_u8(src + x * 4);
+            uint16x8_t sum = vmlal_u8(vmlal_u8(vmull_u8(px.val[0], wr), px.val[1], wg), px.val[2], wb);
+            vst1_u8(dst + x, vrshrn_n_u16(sum, 8));
+        }
+    } else {
+        for (; x + 8 <= width; x += 8) {
+            uint8x8x3_t px = vld3_u8(src + x * 3);
+            uint16x8_t sum = vmlal_u8(vmlal_u8(vmull_u8(px.val[0], wr), px.val[1], wg), px.val[2], wb);
+            vst1_u8(dst + x, vrshrn_n_u16(sum, 8));
+        }
+    }
+#endif
+
+    for (; x < width; x++) {
+        dst[x] = static_cast<uint8_t>(Luma(src + x * channels, channels));
+    }
+}
+
+GrayImage ToGray(const ImageView& src) {
+    GrayImage gray(src.width, src.height);
+    for (int y = 0; y < src.height; y++) {
+        ToGrayRow(src.data + static_cast<size_t>(y) * src.stride, src.width, src.channels, gray.Row(y));
+    }
+    return gray;
+}
+
+void GrayHistogram(const GrayImage& gray, uint32_t histogram[256]) {
+    // Four interleaved tables avoid stalls on runs of equal values
+    // (paper background)
+    uint32_t bins[4][256] = {};
+    const uint8_t* p = gray.data.data();
+    const size_t count = gray.data.size();
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        bins[0][p[i]]++;
+        bins[1][p[i + 1]]++;
+        bins[2][p[i + 2]]++;
+        bins[3][p[i + 3]]++;
+    }
+    for (; i < count; i++) {
+        bins[0][p[i]]++;
+    }
+    for (int v = 0; v < 256; v++) {
+        histogram[v] = bins[0][v] + bins[1][v] + bins[2][v] + bins[3][v];
+    }
+}
+
+int OtsuThreshold(const uint32_t histogram[256]) {
+    double total = 0.0;
+    double weighted = 0.0;
+    for (int v = 0; v < 256; v++) {
+        total += histogram[v];
+        weighted += static_cast<double>(v) * histogram[v];
+    }
+    if (total == 0.0) {
+        return 128;
+    }
+
+    // Maximise the between-class variance over all split points
+    double background = 0.0;
+    double backgroundSum = 0.0;
+    double best = -1.0;
+    int threshold = 128;
+    for (int t = 0; t < 256; t++) {
+        background += histogram[t];
+        if (background == 0.0) {
+            continue;
+        }
+        const double foreground = total - background;
+        if (foreground == 0.0) {
+            break;
+        }
+        backgroundSum += static_cast<double>(t) * histogram[t];
+        const double meanBack = backgroundSum / background;
+        const double meanFore = (weighted - backgroundSum) / foreground;
+        const double between = background * foreground * (meanBack - meanFore) * (meanBack - meanFore);
+        if (between > best) {
+            best = between;
+            threshold = t;
+        }
+    }
+    return threshold;
+}
+
+int BinarizeWindow(const BinarizeOptions& options) {
+    int window = options.windowSize;
+    if (window <= 0) {
+        window = std::max(15, options.resolution / 8);
+    }
+    window = std::min(window, kMaxWindow);
+    return window | 1;
+}
+
+void PackRow(const uint8_t* gray, const uint8_t* threshold, int width, uint8_t* packed) {
+    int x = 0;
+
+#if defined(IMAGING_SSE2)
+    // Unsigned compare via the sign-flip trick, 16 pixels -> 2 bytes
+    const __m128i bias = _mm_set1_epi8(static_cast<char>(0x80));
+    for (; x + 16 <= width; x += 16) {
+        __m128i g = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(gray + x)), bias);
+        __m128i t = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(threshold + x)), bias);
+        int mask = _mm_movemask_epi8(_mm_cmpgt_epi8(g, t));
+        packed[x / 8] = kBitReverse.value[mask & 0xFF];
+        packed[x / 8 + 1] = kBitReverse.value[(mask >> 8) & 0xFF];
+    }
+#elif defined(IMAGING_NEON)
+    static const uint8_t kBits[16] = {128, 64, 32, 16, 8, 4, 2, 1, 128, 64, 32, 16, 8, 4, 2, 1};
+    const uint8x16_t bits = vld1q_u8(kBits);
+    for (; x + 16 <= width; x += 16) {
+        uint8x16_t white = vandq_u8(vcgtq_u8(vld1q_u8(gray + x), vld1q_u8(threshold + x)), bits);
+        packed[x / 8] = vaddv_u8(vget_low_u8(white));
+        packed[x / 8 + 1] = vaddv_u8(vget_high_u8(white));
+    }
+#endif
+
+    for (; x < width; x += 8) {
+        uint8_t byte = 0;
+        const int n = std::min(8, width - x);
+        for (int b = 0; b < n; b++) {
+            if (gray[x + b] > threshold[x + b]) {
+                byte |= static_cast<uint8_t>(0x80 >> b);
+            }
+        }
+        packed[x / 8] = byte;
+    }
+}
+
+BitonalImage Binarize(const GrayImage& gray, const BinarizeOptions& options) {
+    BitonalImage out;
+    out.width = gray.width;
+    out.height = gray.height;
+    out.stride = (gray.width + 7) / 8;
+    out.data.assign(static_cast<size_t>(out.stride) * out.height, 0);
+    if (gray.width <= 0 || gray.height <= 0) {
+        return out;
+    }
+
+    if (options.method == ThresholdMethod::Fixed || options.method == ThresholdMethod::Otsu) {
+        int level = options.threshold;
+        if (options.method == ThresholdMethod::Otsu) {
+            uint32_t histogram[256];
+            GrayHistogram(gray, histogram);
+            level = OtsuThreshold(histogram);
+        }
+        const std::vector<uint8_t> threshold(gray.width, static_cast<uint8_t>(std::min(255, std::max(0, level))));
+
+        ThreadPool::Shared().ParallelFor(gray.height, kStripRows, [&](int begin, int end) {
+            for (int y = begin; y < end; y++) {
+                PackRow(gray.Row(y), threshold.data(), gray.width,
+                        out.data.data() + static_cast<size_t>(y) * out.stride);
+            }
+        });
+        return out;
+    }
+
+    const int window = BinarizeWindow(options);
+    ThreadPool::Shared().ParallelFor(gray.height, kStripRows, [&](int begin, int end) {
+        LocalThresholdStrip(gray, options, window, begin, end, out);
+    });
+    return out;
+}
+
+BitonalImage Binarize(const ImageView& src, const BinarizeOptions& options) {
+    return Binarize(ToGray(src), options);
+}
+
+} // namespace Imaging
@@ -0,0 +1,100 @@
+/**
+ * Bitonal Conversion
+ *
+ * Native counterparts of ImageCompression.convertToBlackAndWhite and
+ * adaptiveThreshold in src/lib/scanner/imageCompression.ts. Kernels take
+ * the raw scan buffer, convert it to gray with BT.601 weights (same as
+ * applyGrayscale), threshold it globally (fixed or Otsu) or locally
+ * (Sauvola or Bradley over a rolling integral image) and pack the result
+ * to 1 bit per pixel, MSB first, 0 = black (PixelFormat::BlackWhite1).
+ */
+
+#ifndef IMAGING_BINARIZE_H
+#define IMAGING_BINARIZE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "imageTypes.h"
+
+namespace Imaging {
+
+enum class ThresholdMethod {
+    Fixed,    // gray > threshold is white
+    Otsu,     // global threshold from the page histogram
+    Sauvola,  // local mean and deviation
+    Bradley   // local mean minus a percentage
+};
+
+/**
+ * Binarization options. windowSize 0 picks about 1/8 inch at the given
+ * resolution (at least 15 pixels, as in the JavaScript implementation).
+ */
+struct BinarizeOptions {
+    ThresholdMethod method = ThresholdMethod::Otsu;
+    int threshold = 128;     // Fixed only
+    int windowSize = 0;      // Sauvola and Bradley, odd, in pixels
+    double k = 0.34;         // Sauvola sensitivity
+    double percent = 15.0;   // Bradley: darker than mean by this much is black
+    int resolution = 0;      // used to size the window when windowSize is 0
+};
+
+/**
+ * Packed 1-bpp image, rows padded to whole bytes
+ */
+struct BitonalImage {
+    std::vector<uint8_t> data;
+    int width = 0;
+    int height = 0;
+    int stride = 0;
+};
+
+/**
+ * Parse "fixed", "otsu", "sauvola" or "bradley"
+ */
+bool ParseThresholdMethod(const std::string& name, ThresholdMethod& method);
+
+/**
+ * BT.601 grayscale conversion of an 8-bit gray/RGB/RGBA buffer
+ */
+GrayImage ToGray(const ImageView& src);
+
+/**
+ * Convert one row of `width` pixels into dst
+ */
+void ToGrayRow(const uint8_t* src, int width, int channels, uint8_t* dst);
+
+/**
+ * 256-bin histogram of a gray image
+ */
+void GrayHistogram(const GrayImage& gray, uint32_t histogram[256]);
+
+/**
+ * Otsu's threshold: pixels above the returned value are white
+ */
+int OtsuThreshold(const uint32_t histogram[256]);
+
+/**
+ * Effective local window for options at an image size
+ */
+int BinarizeWindow(const BinarizeOptions& options);
+
+/**
+ * Pack one row: bit set (white) where gray[x] > threshold[x]
+ */
+void PackRow(const uint8_t* gray, const uint8_t* threshold, int width, uint8_t* packed);
+
+/**
+ * Threshold and pack a gray image. Rows are split across the shared
+ * thread pool.
+ */
+BitonalImage Binarize(const GrayImage& gray, const BinarizeOptions& options);
+
+/**
+ * Grayscale conversion followed by Binarize
+ */
+BitonalImage Binarize(const ImageView& src, const BinarizeOptions& options);
+
+} // namespace Imaging
+
+#endif // IMAGING_BINARIZE_H
@@ -0,0 +1,67 @@
+{
+  "variables": {
+    "conditions": [
+      ["OS=='win'", {
+        "libjpeg_turbo_dir%": "C:/libjpeg-turbo64"
+      }, {
+        "libjpeg_turbo_dir%": "/opt/homebrew/opt/jpeg-turbo"
+      }]
+    ]
+  },
+  "targets": [
+    {
+      "target_name": "imaging_kernels",
+      "cflags!": ["-fno-exceptions"],
+      "cflags_cc!": ["-fno-exceptions"],
+      "cflags_cc": ["-O3"],
+      "sources": [
+        "imagingAddon.cpp",
+        "binarize.cpp",
+        "documentDetect.cpp",
+        "ocrPrep.cpp",
+        "perspectiveWarp.cpp",
+        "threadPool.cpp",
+        "../core/jpegEncoder.cpp",
+        "../core/pixelKernels.cpp"
+      ],
+      "include_dirs": [
+        "<!@(node -p \"require('node-addon-api').include\")",
+        "../core"
+      ],
+      "defines": ["NAPI_DISABLE_CPP_EXCEPTIONS"],
+      "conditions": [
+        ["OS=='linux'", {
+          "libraries": [
+            "-ljpeg"
+          ]
+        }],
+        ["OS=='mac'", {
+          "xcode_settings": {
+            "GCC_OPTIMIZATION_LEVEL": "3"
+          },
+          "include_dirs": [
+            "<(libjpeg_turbo_dir)/include"
+          ],
+          "link_settings": {
+            "libraries": [
+              "<(libjpeg_turbo_dir)/lib/libjpeg.a"
+            ]
+          }
+        }],
+        ["OS=='win'", {
+          "msvs_settings": {
+            "VCCLCompilerTool": {
+              "Optimization": 2
+            }
+          },
+          "include_dirs": [
+            "<(libjpeg_turbo_dir)/include"
+          ],
+          "libraries": [
+            "<(libjpeg_turbo_dir)/lib/jpeg-static.lib"
+          ]
+        }]
+      ]
+    }
+  ]
+}
@@ -0,0 +1,483 @@
+/**
+ * Document Edge Detection Implementation
+ */
+
+#include "documentDetect.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define IMAGING_SSE2 1
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define IMAGING_NEON 1
+#endif
+
+namespace Imaging {
+
+namespace {
+
+// BT.709 luma weights in 8.8 fixed point (sum = 256)
+constexpr int kLumaR = 54;
+constexpr int kLumaG = 183;
+constexpr int kLumaB = 19;
+
+// Minimum edge pixels for a connected component to be considered
+constexpr size_t kMinContourPixels = 50;
+
+inline int Luma(const uint8_t* px, int channels) {
+    if (channels < 3) {
+        return px[0];
+    }
+    return (kLumaR * px[0] + kLumaG * px[1] + kLumaB * px[2] + 128) >> 8;
+}
+
+/**
+ * Horizontal + vertical taps for one Sobel row triple. The SIMD paths
+ * handle 8 pixels per iteration; the scalar tail finishes the row.
+ */
+void SobelRow(const uint8_t* r0, const uint8_t* r1, const uint8_t* r2, int width,
+              int16_t* gx, int16_t* gy, uint16_t* mag) {
+    int x = 1;
+
+#if defined(IMAGING_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    for (; x + 8 < width; x += 8) {
+        __m128i a0 = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(r0 + x - 1)), zero);
+        __m128i a1 = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(r0 + x)), zero);
+        __m128i a2 = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(r0 + x + 1)), zero);
+        __m128i b0 = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(r1 + x - 1)), zero);
+        __m128i b2 = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(r1 + x + 1)), zero);
+        __m128i c0 = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(r2 + x - 1)), zero);
+        __m128i c1 = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(r2 + x)), zero);
+        __m128i c2 = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(r2 + x + 1)), zero);
+
+        // gx = (a2 - a0) + 2 (b2 - b0) + (c2 - c0)
+        __m128i sx = _mm_add_epi16(_mm_sub_epi16(a2, a0), _mm_sub_epi16(c2, c0));
+        sx = _mm_add_epi16(sx, _mm_slli_epi16(_mm_sub_epi16(b2, b0), 1));
+        // gy = (c0 + 2 c1 + c2) - (a0 + 2 a1 + a2)
+        __m128i sy = _mm_sub_epi16(_mm_add_epi16(_mm_add_epi16(c0, c2), _mm_slli_epi16(c1, 1)),
+                                   _mm_add_epi16(_mm_add_epi16(a0, a2), _mm_slli_epi16(a1, 1)));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(gx + x), sx);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(gy + x), sy);
+
+        // |g| = sqrt(gx^2 + gy^2) in float, 4 lanes at a time
+        __m128i lo = _mm_madd_epi16(_mm_unpacklo_epi16(sx, sy), _mm_unpacklo_epi16(sx, sy));
+        __m128i hi = _mm_madd_epi16(_mm_unpackhi_epi16(sx, sy), _mm_unpackhi_epi16(sx, sy));
+        __m128i mlo = _mm_cvtps_epi32(_mm_sqrt_ps(_mm_cvtepi32_ps(lo)));
+        __m128i mhi = _mm_cvtps_epi32(_mm_sqrt_ps(_mm_cvtepi32_ps(hi)));
+        // Magnitudes are <= 1443, so a signed pack is lossless
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(mag + x), _mm_packs_epi32(mlo, mhi));
+    }
+#elif defined(IMAGING_NEON)
+    for (; x + 8 < width; x += 8) {
+        int16x8_t a0 = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(r0 + x - 1)));
+        int16x8_t a1 = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(r0 + x)));
+        int16x8_t a2 = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(r0 + x + 1)));
+        int16x8_t b0 = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(r1 + x - 1)));
+        int16x8_t b2 = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(r1 + x + 1)));
+        int16x8_t c0 = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(r2 + x - 1)));
+        int16x8_t c1 = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(r2 + x)));
+        int16x8_t c2 = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(r2 + x + 1)));
+
+        int16x8_t sx = vaddq_s16(vsubq_s16(a2, a0), vsubq_s16(c2, c0));
+        sx = vaddq_s16(sx, vshlq_n_s16(vsubq_s16(b2, b0), 1));
+        int16x8_t sy = vsubq_s16(vaddq_s16(vaddq_s16(c0, c2), vshlq_n_s16(c1, 1)),
+                                 vaddq_s16(vaddq_s16(a0, a2), vshlq_n_s16(a1, 1)));
+
+        vst1q_s16(gx + x, sx);
+        vst1q_s16(gy + x, sy);
+
+        int32x4_t lo = vmlal_s16(vmull_s16(vget_low_s16(sx), vget_low_s16(sx)), vget_low_s16(sy), vget_low_s16(sy));
+        int32x4_t hi = vmlal_s16(vmull_s16(vget_high_s16(sx), vget_high_s16(sx)), vget_high_s16(sy), vget_high_s16(sy));
+        uint32x4_t mlo = vcvtnq_u32_f32(vsqrtq_f32(vcvtq_f32_s32(lo)));
+        uint32x4_t mhi = vcvtnq_u32_f32(vsqrtq_f32(vcvtq_f32_s32(hi)));
+        vst1q_u16(mag + x, vcombine_u16(vmovn_u32(mlo), vmovn_u32(mhi)));
+    }
+#endif
+
+    for (; x < width - 1; x++) {
+        int sx = (r0[x + 1] - r0[x - 1]) + 2 * (r1[x + 1] - r1[x - 1]) + (r2[x + 1] - r2[x - 1]);
+        int sy = (r2[x - 1] + 2 * r2[x] + r2[x + 1]) - (r0[x - 1] + 2 * r0[x] + r0[x + 1]);
+        gx[x] = static_cast<int16_t>(sx);
+        gy[x] = static_cast<int16_t>(sy);
+        mag[x] = static_cast<uint16_t>(std::lround(std::sqrt(static_cast<double>(sx * sx + sy * sy))));
+    }
+}
+
+/**
+ * Andrew's monotone chain convex hull
+ */
+std::vector<Point> ConvexHull(std::vector<Point> points) {
+    if (points.size() < 3) {
+        return points;
+    }
+
+    std::sort(points.begin(), points.end(), [](const Point& a, const Point& b) {
+        return a.x < b.x || (a.x == b.x && a.y < b.y);
+    });
+
+    auto cross = [](const Point& o, const Point& a, const Point& b) {
+        return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+    };
+
+    std::vector<Point> hull(points.size() * 2);
+    size_t k = 0;
+    for (size_t i = 0; i < points.size(); i++) {
+        while (k >= 2 && cross(hull[k - 2], hull[k - 1], points[i]) <= 0) k--;
+        hull[k++] = points[i];
+    }
+    for (size_t i = points.size() - 1, lower = k + 1; i > 0; i--) {
+        while (k >= lower && cross(hull[k - 2], hull[k - 1], points[i - 1]) <= 0) k--;
+        hull[k++] = points[i - 1];
+    }
+    hull.resize(k - 1);
+    return hull;
+}
+
+double QuadArea(const Point quad[4]) {
+    // Shoelace formula
+    double area = 0;
+    for (int i = 0; i < 4; i++) {
+        const Point& a = quad[i];
+        const Point& b = quad[(i + 1) % 4];
+        area += a.x * b.y - b.x * a.y;
+    }
+    return std::abs(area) / 2;
+}
+
+/**
+ * Corners of a hull as the extremes of x+y and x-y, ordered clockwise
+ * from top-left (matches orderCorners in the JavaScript implementation
+ * for documents skewed by less than 45 degrees)
+ */
+void HullToQuad(const std::vector<Point>& hull, Point quad[4]) {
+    quad[0] = quad[1] = quad[2] = quad[3] = hull.front();
+    for (const Point& p : hull) {
+        if (p.x + p.y < quad[0].x + quad[0].y) quad[0] = p; // top-left
+        if (p.x - p.y > quad[1].x - quad[1].y) quad[1] = p; // top-right
+        if (p.x + p.y > quad[2].x + quad[2].y) quad[2] = p; // bottom-right
+        if (p.x - p.y < quad[3].x - quad[3].y) quad[3] = p; // bottom-left
+    }
+}
+
+bool IsValidDocumentShape(const Point quad[4], double width, double height) {
+    double area = QuadArea(quad);
+    double imageArea = width * height;
+
+    // Document should cover between 10% and 95% of the image
+    if (area < imageArea * 0.1 || area > imageArea * 0.95) {
+        return false;
+    }
+
+    double qWidth = std::max(std::hypot(quad[1].x - quad[0].x, quad[1].y - quad[0].y),
+                             std::hypot(quad[2].x - quad[3].x, quad[2].y - quad[3].y));
+    double qHeight = std::max(std::hypot(quad[3].x - quad[0].x, quad[3].y - quad[0].y),
+                              std::hypot(quad[2].x - quad[1].x, quad[2].y - quad[1].y));
+    if (std::min(qWidth, qHeight) <= 0) {
+        return false;
+    }
+
+    // Documents are usually between 1:3 and 3:1
+    return std::max(qWidth, qHeight) / std::min(qWidth, qHeight) <= 3;
+}
+
+double Confidence(const Point quad[4], double width, double height) {
+    double confidence = std::min(QuadArea(quad) / (width * height) * 2, 1.0);
+
+    // Reduce confidence for very skewed shapes
+    double qWidth = std::hypot(quad[1].x - quad[0].x, quad[1].y - quad[0].y);
+    double qHeight = std::hypot(quad[3].x - quad[0].x, quad[3].y - quad[0].y);
+    if (std::min(qWidth, qHeight) > 0 && std::max(qWidth, qHeight) / std::min(qWidth, qHeight) > 2) {
+        confidence *= 0.8;
+    }
+
+    return confidence;
+}
+
+} // namespace
+
+int DetectionScale(int width, int height, int maxDimension) {
+    int longest = std::max(width, height);
+    if (maxDimension <= 0 || longest <= maxDimension) {
+        return 1;
+    }
+    return (longest + maxDimension - 1) / maxDimension;
+}
+
+GrayImage GrayDownsample(const ImageView& src, int factor) {
+    factor = std::max(1, factor);
+    GrayImage out(src.width / factor, src.height / factor);
+    if (out.width == 0 || out.height == 0) {
+        return out;
+    }
+
+    std::vector<uint32_t> acc(out.width);
+    const uint32_t area = static_cast<uint32_t>(factor * factor);
+
+    for (int oy = 0; oy < out.height; oy++) {
+        std::fill(acc.begin(), acc.end(), 0);
+
+        // Single pass over the source rows: luma and box sum fused
+        for (int dy = 0; dy < factor; dy++) {
+            const uint8_t* row = src.data + static_cast<size_t>(oy * factor + dy) * src.stride;
+            for (int ox = 0; ox < out.width; ox++) {
+                const uint8_t* px = row + static_cast<size_t>(ox * factor) * src.channels;
+                uint32_t sum = 0;
+                for (int dx = 0; dx < factor; dx++, px += src.channels) {
+                    sum += Luma(px, src.channels);
+                }
+                acc[ox] += sum;
+            }
+        }
+
+        uint8_t* dst = out.Row(oy);
+        for (int ox = 0; ox < out.width; ox++) {
+            dst[ox] = static_cast<uint8_t>((acc[ox] + area / 2) / area);
+        }
+    }
+
+    return out;
+}
+
+void GaussianBlur(GrayImage& image, int radius) {
+    if (radius <= 0 || image.width == 0 || image.height == 0) {
+        return;
+    }
+
+    // 1D kernel in 8-bit fixed point; the 2D JavaScript kernel is separable
+    double sigma = radius / 3.0;
+    std::vector<double> weights(2 * radius + 1);
+    double total = 0;
+    for (int i = -radius; i <= radius; i++) {
+        weights[i + radius] = std::exp(-(i * i) / (2 * sigma * sigma));
+        total += weights[i + radius];
+    }
+    std::vector<uint32_t> kernel(weights.size());
+    uint32_t kernelSum = 0;
+    for (size_t i = 0; i < weights.size(); i++) {
+        kernel[i] = static_cast<uint32_t>(std::lround(weights[i] / total * 256));
+        kernelSum += kernel[i];
+    }
+    kernel[radius] += 256 - kernelSum; // exact normalisation
+
+    const int w = image.width;
+    const int h = image.height;
+    std::vector<uint16_t> horizontal(static_cast<size_t>(w) * h);
+
+    // Horizontal pass into 8.8 fixed point, clamped borders
+    for (int y = 0; y < h; y++) {
+        const uint8_t* src = image.Row(y);
+        uint16_t* dst = horizontal.data() + static_cast<size_t>(y) * w;
+        for (int x = 0; x < w; x++) {
+            uint32_t sum = 0;
+            if (x >= radius && x + radius < w) {
+                for (int k = -radius; k <= radius; k++) sum += kernel[k + radius] * src[x + k];
+            } else {
+                for (int k = -radius; k <= radius; k++) sum += kernel[k + radius] * src[std::min(w - 1, std::max(0, x + k))];
+            }
+            dst[x] = static_cast<uint16_t>(sum);
+        }
+    }
+
+    // Vertical pass, row-at-a-time so the inner loop vectorises
+    std::vector<uint32_t> acc(w);
+    for (int y = 0; y < h; y++) {
+        std::fill(acc.begin(), acc.end(), 0);
+        for (int k = -radius; k <= radius; k++) {
+            const uint16_t* src = horizontal.data() + static_cast<size_t>(std::min(h - 1, std::max(0, y + k))) * w;
+            const uint32_t weight = kernel[k + radius];
+            for (int x = 0; x < w; x++) acc[x] += weight * src[x];
+        }
+        uint8_t* dst = image.Row(y);
+        for (int x = 0; x < w; x++) dst[x] = static_cast<uint8_t>((acc[x] + 32768) >> 16);
+    }
+}
+
+void SobelGradients(const GrayImage& src,
+                    std::vector<int16_t>& gx,
+                    std::vector<int16_t>& gy,
+                    std::vector<uint16_t>& magnitude) {
+    const size_t size = static_cast<size_t>(src.width) * src.height;
+    gx.assign(size, 0);
+    gy.assign(size, 0);
+    magnitude.assign(size, 0);
+
+    for (int y = 1; y < src.height - 1; y++) {
+        size_t offset = static_cast<size_t>(y) * src.width;
+        SobelRow(src.Row(y - 1), src.Row(y), src.Row(y + 1), src.width,
+                 gx.data() + offset, gy.data() + offset, magnitude.data() + offset);
+    }
+}
+
+GrayImage CannyEdges(const GrayImage& blurred, int low, int high) {
+    const int w = blurred.width;
+    const int h = blurred.height;
+    GrayImage edges(w, h);
+    if (w < 3 || h < 3) {
+        return edges;
+    }
+
+    std::vector<int16_t> gx, gy;
+    std::vector<uint16_t> mag;
+    SobelGradients(blurred, gx, gy, mag);
+
+    // Non-maximum suppression: keep pixels that peak along the gradient.
+    // 0 = suppressed, 1 = weak, 2 = strong
+    std::vector<uint8_t> cls(static_cast<size_t>(w) * h, 0);
+    std::vector<size_t> stack;
+
+    for (int y = 1; y < h - 1; y++) {
+        for (int x = 1; x < w - 1; x++) {
+            size_t i = static_cast<size_t>(y) * w + x;
+            int m = mag[i];
+            if (m < low) {
+                continue;
+            }
+
+            int ax = std::abs(gx[i]);
+            int ay = std::abs(gy[i]);
+            size_t n1, n2;
+            if (ay * 100 <= ax * 41) {          // ~horizontal gradient (< 22.5 deg)
+                n1 = i - 1;
+                n2 = i + 1;
+            } else if (ay * 100 >= ax * 241) {  // ~vertical gradient (> 67.5 deg)
+                n1 = i - w;
+                n2 = i + w;
+            } else if ((gx[i] > 0) == (gy[i] > 0)) {
+                n1 = i - w - 1;
+                n2 = i + w + 1;
+            } else {
+                n1 = i - w + 1;
+                n2 = i + w - 1;
+            }
+
+            if (m > mag[n1] && m >= mag[n2]) {
+                cls[i] = m >= high ? 2 : 1;
+                if (cls[i] == 2) {
+                    stack.push_back(i);
+                }
+            }
+        }
+    }
+
+    // Hysteresis: grow strong edges through connected weak pixels
+    while (!stack.empty()) {
+        size_t i = stack.back();
+        stack.pop_back();
+        if (edges.data[i] == 255) {
+            continue;
+        }
+        edges.data[i] = 255;
+
+        int x = static_cast<int>(i % w);
+        int y = static_cast<int>(i / w);
+        for (int dy = -1; dy <= 1; dy++) {
+            for (int dx = -1; dx <= 1; dx++) {
+                int nx = x + dx;
+                int ny = y + dy;
+                if (nx < 0 || ny < 0 || nx >= w || ny >= h) continue;
+                size_t n = static_cast<size_t>(ny) * w + nx;
+                if (cls[n] != 0 && edges.data[n] != 255) {
+                    stack.push_back(n);
+                }
+            }
+        }
+    }
+
+    return edges;
+}
+
+DetectionResult DetectDocument(const ImageView& src, const DetectionOptions& options) {
+    DetectionResult result;
+
+    const int factor = DetectionScale(src.width, src.height, options.maxDimension);
+    GrayImage gray = GrayDownsample(src, factor);
+    if (gray.width < 3 || gray.height < 3) {
+        return result;
+    }
+
+    GaussianBlur(gray, options.blurRadius);
+    GrayImage edges = CannyEdges(gray, options.cannyLow, options.cannyHigh);
+
+    const int w = edges.width;
+    const int h = edges.height;
+    std::vector<uint8_t> visited(static_cast<size_t>(w) * h, 0);
+    std::vector<size_t> stack;
+    std::vector<Point> component;
+    double bestArea = 0;
+
+    for (size_t start = 0; start < visited.size(); start++) {
+        if (edges.data[start] != 255 || visited[start]) {
+            continue;
+        }
+
+        // 8-connected component of edge pixels
+        component.clear();
+        stack.push_back(start);
+        visited[start] = 1;
+        while (!stack.empty()) {
+            size_t i = stack.back();
+            stack.pop_back();
+            int x = static_cast<int>(i % w);
+            int y = static_cast<int>(i / w);
+            component.push_back({static_cast<double>(x), static_cast<double>(y)});
+
+            for (int dy = -1; dy <= 1; dy++) {
+                for (int dx = -1; dx <= 1; dx++) {
+                    int nx = x + dx;
+                    int ny = y + dy;
+                    if (nx < 0 || ny < 0 || nx >= w || ny >= h) continue;
+                    size_t n = static_cast<size_t>(ny) * w + nx;
+                    if (edges.data[n] == 255 && !visited[n]) {
+                        visited[n] = 1;
+                        stack.push_back(n);
+                    }
+                }
+            }
+        }
+
+        if (component.size() < kMinContourPixels) {
+            continue;
+        }
+
+        std::vector<Point> hull = ConvexHull(component);
+        if (hull.size() < 4) {
+            continue;
+        }
+
+        Point quad[4];
+        HullToQuad(hull, quad);
+        double area = QuadArea(quad);
+        if (area > bestArea && IsValidDocumentShape(quad, w, h)) {
+            bestArea = area;
+            std::copy(quad, quad + 4, result.corners);
+            result.detected = true;
+        }
+    }
+
+    if (!result.detected) {
+        return result;
+    }
+
+    result.confidence = Confidence(result.corners, w, h);
+
+    // Map back to source pixel coordinates (centre of each box)
+    double minX = src.width, minY = src.height, maxX = 0, maxY = 0;
+    for (Point& p : result.corners) {
+        p.x = std::min<double>(src.width - 1, p.x * factor + factor / 2);
+        p.y = std::min<double>(src.height - 1, p.y * factor + factor / 2);
+        minX = std::min(minX, p.x);
+        minY = std::min(minY, p.y);
+        maxX = std::max(maxX, p.x);
+        maxY = std::max(maxY, p.y);
+    }
+    result.cropRect = {minX, minY, maxX - minX, maxY - minY};
+
+    return result;
+}
+
+} // namespace Imaging
@@ -0,0 +1,78 @@
+/**
+ * Document Edge Detection
+ *
+ * Native counterpart of DocumentDetection.detect in
+ * src/lib/scanner/documentDetection.ts. Runs a fused grayscale +
+ * downsample pass, a separable Gaussian blur, SIMD Sobel gradients with
+ * non-maximum suppression and hysteresis, then fits the largest
+ * document-shaped quadrilateral. Corners are returned in source pixel
+ * coordinates.
+ */
+
+#ifndef IMAGING_DOCUMENT_DETECT_H
+#define IMAGING_DOCUMENT_DETECT_H
+
+#include <cstdint>
+#include <vector>
+#include "imageTypes.h"
+
+namespace Imaging {
+
+/**
+ * Detection options (defaults match the JavaScript implementation)
+ */
+struct DetectionOptions {
+    int cannyLow = 50;
+    int cannyHigh = 150;
+    int blurRadius = 2;
+    int maxDimension = 1024; // longest side of the working image
+};
+
+/**
+ * Same shape as DocumentDetectionResult in src/lib/scanner/types.ts
+ */
+struct DetectionResult {
+    bool detected = false;
+    Point corners[4] = {}; // clockwise from top-left
+    Rect cropRect = {};
+    double confidence = 0.0;
+};
+
+/**
+ * Integer downsample factor that brings the longest side to at most
+ * maxDimension pixels
+ */
+int DetectionScale(int width, int height, int maxDimension);
+
+/**
+ * Fused BT.709 grayscale conversion and factor x factor box downsample
+ */
+GrayImage GrayDownsample(const ImageView& src, int factor);
+
+/**
+ * Separable Gaussian blur in place (sigma = radius / 3)
+ */
+void GaussianBlur(GrayImage& image, int radius);
+
+/**
+ * 3x3 Sobel gradients and L2 magnitude. Border pixels are zero.
+ */
+void SobelGradients(const GrayImage& src,
+                    std::vector<int16_t>& gx,
+                    std::vector<int16_t>& gy,
+                    std::vector<uint16_t>& magnitude);
+
+/**
+ * Canny edge map (255 = edge) with non-maximum suppression and
+ * hysteresis between low and high
+ */
+GrayImage CannyEdges(const GrayImage& blurred, int low, int high);
+
+/**
+ * Detect the document quadrilateral in an 8-bit gray/RGB/RGBA buffer
+ */
+DetectionResult DetectDocument(const ImageView& src, const DetectionOptions& options = {});
+
+} // namespace Imaging
+
+#endif // IMAGING_DOCUMENT_DETECT_H
@@ -0,0 +1,58 @@
+/**
+ * Imaging Kernel Types
+ *
+ * Plain image and geometry types shared by the native imaging kernels.
+ * Kernels operate on raw scan buffers (as delivered by the scanner
+ * addons) and never touch N-API values.
+ */
+
+#ifndef IMAGING_IMAGE_TYPES_H
+#define IMAGING_IMAGE_TYPES_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Imaging {
+
+/**
+ * Read-only view over an interleaved 8-bit buffer
+ */
+struct ImageView {
+    const uint8_t* data;
+    int width;
+    int height;
+    int stride;    // bytes per row
+    int channels;  // 1 (gray), 3 (RGB) or 4 (RGBA)
+};
+
+/**
+ * Owned single-channel 8-bit image, tightly packed
+ */
+struct GrayImage {
+    std::vector<uint8_t> data;
+    int width = 0;
+    int height = 0;
+
+    GrayImage() = default;
+    GrayImage(int w, int h) : data(static_cast<size_t>(w) * h), width(w), height(h) {}
+
+    uint8_t* Row(int y) { return data.data() + static_cast<size_t>(y) * width; }
+    const uint8_t* Row(int y) const { return data.data() + static_cast<size_t>(y) * width; }
+};
+
+struct Point {
+    double x;
+    double y;
+};
+
+struct Rect {
+    double x;
+    double y;
+    double width;
+    double height;
+};
+
+} // namespace Imaging
+
+#endif // IMAGING_IMAGE_TYPES_H
@@ -0,0 +1,700 @@
+/**
+ * Imaging Kernels Addon
+ *
+ * N-API entry points for the native imaging kernels. Every kernel runs
+ * on the libuv thread pool and returns a Promise; input buffers are kept
+ * alive by a reference for the duration of the work.
+ */
+
+#include <napi.h>
+#include <algorithm>
+#include <exception>
+#include <string>
+#include <vector>
+#include "binarize.h"
+#include "documentDetect.h"
+#include "jpegEncoder.h"
+#include "ocrPrep.h"
+#include "perspectiveWarp.h"
+
+namespace Imaging {
+
+namespace {
+
+/**
+ * Image argument block: (buffer, width, height, stride, ...[, options])
+ */
+struct ImageArgs {
+    ImageView view{};
+    Napi::Object options;
+};
+
+int IntOption(const Napi::Object& options, const char* key, int fallback) {
+    if (options.IsEmpty() || !options.Has(key) || !options.Get(key).IsNumber()) {
+        return fallback;
+    }
+    return options.Get(key).As<Napi::Number>().Int32Value();
+}
+
+bool BoolOption(const Napi::Object& options, const char* key, bool fallback) {
+    if (options.IsEmpty() || !options.Has(key) || !options.Get(key).IsBoolean()) {
+        return fallback;
+    }
+    return options.Get(key).As<Napi::Boolean>().Value();
+}
+
+double DoubleOption(const Napi::Object& options, const char* key, double fallback) {
+    if (options.IsEmpty() || !options.Has(key) || !options.Get(key).IsNumber()) {
+        return fallback;
+    }
+    return options.Get(key).As<Napi::Number>().DoubleValue();
+}
+
+std::string StringOption(const Napi::Object& options, const char* key, const std::string& fallback) {
+    if (options.IsEmpty() || !options.Has(key) || !options.Get(key).IsString()) {
+        return fallback;
+    }
+    return options.Get(key).As<Napi::String>().Utf8Value();
+}
+
+/**
+ * Validate the leading image arguments; the options object is read from
+ * info[optionsIndex]. Throws and returns false on invalid input.
+ */
+bool ParseImageArgs(const Napi::CallbackInfo& info, ImageArgs& args, size_t optionsIndex = 4) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 4 || !info[0].IsBuffer() || !info[1].IsNumber() ||
+        !info[2].IsNumber() || !info[3].IsNumber()) {
+        Napi::TypeError::New(env, "Expected (buffer, width, height, stride)").ThrowAsJavaScriptException();
+        return false;
+    }
+
+    Napi::Buffer<uint8_t> buffer = info[0].As<Napi::Buffer<uint8_t>>();
+    args.view.data = buffer.Data();
+    args.view.width = info[1].As<Napi::Number>().Int32Value();
+    args.view.height = info[2].As<Napi::Number>().Int32Value();
+    args.view.stride = info[3].As<Napi::Number>().Int32Value();
+
+    if (info.Length() > optionsIndex && info[optionsIndex].IsObject()) {
+        args.options = info[optionsIndex].As<Napi::Object>();
+    }
+
+    if (args.view.width <= 0 || args.view.height <= 0 || args.view.stride < args.view.width) {
+        Napi::RangeError::New(env, "Invalid image dimensions").ThrowAsJavaScriptException();
+        return false;
+    }
+
+    // Channels default to what the stride implies (gray, RGB or RGBA)
+    int inferred = args.view.stride >= args.view.width * 4 ? 4 : args.view.stride >= args.view.width * 3 ? 3 : 1;
+    args.view.channels = IntOption(args.options, "channels", inferred);
+    if (args.view.channels != 1 && args.view.channels != 3 && args.view.channels != 4) {
+        Napi::RangeError::New(env, "channels must be 1, 3 or 4").ThrowAsJavaScriptException();
+        return false;
+    }
+
+    size_t required = static_cast<size_t>(args.view.stride) * (args.view.height - 1) +
+                      static_cast<size_t>(args.view.width) * args.view.channels;
+    if (args.view.stride < args.view.width * args.view.channels || buffer.Length() < required) {
+        Napi::RangeError::New(env, "Buffer too small for image dimensions").ThrowAsJavaScriptException();
+        return false;
+    }
+
+    return true;
+}
+
+Napi::Object PointToObject(Napi::Env env, const Point& point) {
+    Napi::Object obj = Napi::Object::New(env);
+    obj.Set("x", Napi::Number::New(env, point.x));
+    obj.Set("y", Napi::Number::New(env, point.y));
+    return obj;
+}
+
+Napi::Object DetectionToObject(Napi::Env env, const DetectionResult& result) {
+    Napi::Object obj = Napi::Object::New(env);
+    obj.Set("detected", Napi::Boolean::New(env, result.detected));
+
+    if (result.detected) {
+        Napi::Array corners = Napi::Array::New(env, 4);
+        for (uint32_t i = 0; i < 4; i++) {
+            corners.Set(i, PointToObject(env, result.corners[i]));
+        }
+        obj.Set("corners", corners);
+
+        Napi::Object rect = Napi::Object::New(env);
+        rect.Set("x", Napi::Number::New(env, result.cropRect.x));
+        rect.Set("y", Napi::Number::New(env, result.cropRect.y));
+        rect.Set("width", Napi::Number::New(env, result.cropRect.width));
+        rect.Set("height", Napi::Number::New(env, result.cropRect.height));
+        obj.Set("cropRect", rect);
+    }
+
+    obj.Set("confidence", Napi::Number::New(env, result.confidence));
+    return obj;
+}
+
+/**
+ * Hand an owned pixel vector to JS without copying where the runtime allows
+ */
+void ReleasePixels(Napi::Env, uint8_t*, std::vector<uint8_t>* pixels) {
+    delete pixels;
+}
+
+Napi::Value BytesToBuffer(Napi::Env env, std::vector<uint8_t>&& bytes) {
+    auto* owned = new std::vector<uint8_t>(std::move(bytes));
+    return Napi::Buffer<uint8_t>::NewOrCopy(env, owned->data(), owned->size(), ReleasePixels, owned);
+}
+
+Napi::Object ImageToObject(Napi::Env env, std::vector<uint8_t>&& pixels, int width, int height, int channels) {
+    Napi::Object obj = Napi::Object::New(env);
+    obj.Set("pixels", BytesToBuffer(env, std::move(pixels)));
+    obj.Set("width", Napi::Number::New(env, width));
+    obj.Set("height", Napi::Number::New(env, height));
+    obj.Set("stride", Napi::Number::New(env, width * channels));
+    obj.Set("channels", Napi::Number::New(env, channels));
+    return obj;
+}
+
+bool ParseHomography(const Napi::Value& value, Homography& m) {
+    if (!value.IsObject()) {
+        return false;
+    }
+    Napi::Object obj = value.As<Napi::Object>();
+    const char* keys[] = {"a", "b", "c", "d", "e", "f", "g", "h"};
+    double* fields[] = {&m.a, &m.b, &m.c, &m.d, &m.e, &m.f, &m.g, &m.h};
+    for (int i = 0; i < 8; i++) {
+        Napi::Value field = obj.Get(keys[i]);
+        if (!field.IsNumber()) {
+            return false;
+        }
+        *fields[i] = field.As<Napi::Number>().DoubleValue();
+    }
+    return true;
+}
+
+/**
+ * Document detection worker
+ */
+class DetectWorker : public Napi::AsyncWorker {
+public:
+    DetectWorker(Napi::Env env, Napi::Buffer<uint8_t> buffer, const ImageView& view,
+                 const DetectionOptions& options)
+        : Napi::AsyncWorker(env, "ImagingDetect"),
+          deferred_(Napi::Promise::Deferred::New(env)),
+          view_(view),
+          options_(options),
+          result_{} {
+        bufferRef_ = Napi::Persistent(static_cast<Napi::Object>(buffer));
+    }
+
+    Napi::Promise GetPromise() const { return deferred_.Promise(); }
+
+protected:
+    void Execute() override {
+        try {
+            result_ = DetectDocument(view_, options_);
+        } catch (const std::exception& e) {
+            SetError(e.what());
+        }
+    }
+
+    void OnOK() override {
+        deferred_.Resolve(DetectionToObject(Env(), result_));
+    }
+
+    void OnError(const Napi::Error& error) override {
+        deferred_.Reject(error.Value());
+    }
+
+private:
+    Napi::Promise::Deferred deferred_;
+    Napi::ObjectReference bufferRef_;
+    ImageView view_;
+    DetectionOptions options_;
+    DetectionResult result_;
+};
+
+/**
+ * Perspective warp worker
+ */
+class WarpWorker : public Napi::AsyncWorker {
+public:
+    WarpWorker(Napi::Env env, Napi::Buffer<uint8_t> buffer, const ImageView& view,
+               const Homography& inverse, int outWidth, int outHeight)
+        : Napi::AsyncWorker(env, "ImagingWarp"),
+          deferred_(Napi::Promise::Deferred::New(env)),
+          view_(view),
+          inverse_(inverse),
+          outWidth_(outWidth),
+          outHeight_(outHeight) {
+        bufferRef_ = Napi::Persistent(static_cast<Napi::Object>(buffer));
+    }
+
+    Napi::Promise GetPromise() const { return deferred_.Promise(); }
+
+protected:
+    void Execute() override {
+        try {
+            pixels_ = WarpPerspective(view_, inverse_, outWidth_, outHeight_);
+        } catch (const std::exception& e) {
+            SetError(e.what());
+        }
+    }
+
+    void OnOK() override {
+        deferred_.Resolve(ImageToObject(Env(), std::move(pixels_), outWidth_, outHeight_, view_.channels));
+    }
+
+    void OnError(const Napi::Error& error) override {
+        deferred_.Reject(error.Value());
+    }
+
+private:
+    Napi::Promise::Deferred deferred_;
+    Napi::ObjectReference bufferRef_;
+    ImageView view_;
+    Homography inverse_;
+    int outWidth_;
+    int outHeight_;
+    std::vector<uint8_t> pixels_;
+};
+
+/**
+ * JPEG encode / size estimate worker. RGBA input is encoded as RGB.
+ */
+class JpegWorker : public Napi::AsyncWorker {
+public:
+    JpegWorker(Napi::Env env, Napi::Buffer<uint8_t> buffer, const ImageView& view,
+               int quality, int resolution, size_t targetSize, bool estimateOnly)
+        : Napi::AsyncWorker(env, "ImagingJpeg"),
+          deferred_(Napi::Promise::Deferred::New(env)),
+          view_(view),
+          quality_(quality),
+          resolution_(resolution),
+          targetSize_(targetSize),
+          estimateOnly_(estimateOnly),
+          estimate_(0) {
+        bufferRef_ = Napi::Persistent(static_cast<Napi::Object>(buffer));
+    }
+
+    Napi::Promise GetPromise() const { return deferred_.Promise(); }
+
+protected:
+    void Execute() override {
+        try {
+            const uint8_t* data = view_.data;
+            ScannerCore::PageGeometry geometry{view_.width, view_.height, view_.stride,
+                                               view_.channels == 1 ? ScannerCore::PixelFormat::Gray8
+                                                                   : ScannerCore::PixelFormat::Rgb24,
+                                               resolution_};
+
+            std::vector<uint8_t> rgb;
+            if (view_.channels == 4) {
+                rgb.resize(static_cast<size_t>(view_.width) * view_.height * 3);
+                for (int y = 0; y < view_.height; y++) {
+                    const uint8_t* src = view_.data + static_cast<size_t>(y) * view_.stride;
+                    uint8_t* dst = rgb.data() + static_cast<size_t>(y) * view_.width * 3;
+                    for (int x = 0; x < view_.width; x++, src += 4, dst += 3) {
+                        dst[0] = src[0];
+                        dst[1] = src[1];
+                        dst[2] = src[2];
+                    }
+                }
+                data = rgb.data();
+                geometry.stride = view_.width * 3;
+            }
+
+            std::string error;
+            bool ok = true;
+            if (estimateOnly_) {
+                estimate_ = ScannerCore::EstimateJpegSize(data, geometry, quality_);
+            } else if (targetSize_ > 0) {
+                ok = ScannerCore::EncodeJpegToSize(data, geometry, targetSize_, quality_, output_, quality_, error);
+            } else {
+                ok = ScannerCore::EncodeJpeg(data, geometry, quality_, output_, error);
+            }
+            if (!ok) {
+                SetError(error);
+            }
+        } catch (const std::exception& e) {
+            SetError(e.what());
+        }
+    }
+
+    void OnOK() override {
+        Napi::Env env = Env();
+        if (estimateOnly_) {
+            deferred_.Resolve(Napi::Number::New(env, static_cast<double>(estimate_)));
+            return;
+        }
+
+        Napi::Object obj = Napi::Object::New(env);
+        obj.Set("size", Napi::Number::New(env, static_cast<double>(output_.size())));
+        obj.Set("data", BytesToBuffer(env, std::move(output_)));
+        obj.Set("quality", Napi::Number::New(env, quality_));
+        deferred_.Resolve(obj);
+    }
+
+    void OnError(const Napi::Error& error) override {
+        deferred_.Reject(error.Value());
+    }
+
+private:
+    Napi::Promise::Deferred deferred_;
+    Napi::ObjectReference bufferRef_;
+    ImageView view_;
+    int quality_;
+    int resolution_;
+    size_t targetSize_;
+    bool estimateOnly_;
+    size_t estimate_;
+    std::vector<uint8_t> output_;
+};
+
+/**
+ * Grayscale / binarization worker
+ */
+class BitonalWorker : public Napi::AsyncWorker {
+public:
+    BitonalWorker(Napi::Env env, Napi::Buffer<uint8_t> buffer, const ImageView& view,
+                  const BinarizeOptions& options, bool grayOnly)
+        : Napi::AsyncWorker(env, "ImagingBitonal"),
+          deferred_(Napi::Promise::Deferred::New(env)),
+          view_(view),
+          options_(options),
+          grayOnly_(grayOnly),
+          threshold_(-1) {
+        bufferRef_ = Napi::Persistent(static_cast<Napi::Object>(buffer));
+    }
+
+    Napi::Promise GetPromise() const { return deferred_.Promise(); }
+
+protected:
+    void Execute() override {
+        try {
+            gray_ = ToGray(view_);
+            if (grayOnly_) {
+                return;
+            }
+
+            // Resolve global methods to the level actually used, so it
+            // can be reported back
+            if (options_.method == ThresholdMethod::Otsu) {
+                uint32_t histogram[256];
+                GrayHistogram(gray_, histogram);
+                options_.method = ThresholdMethod::Fixed;
+                options_.threshold = OtsuThreshold(histogram);
+            }
+            if (options_.method == ThresholdMethod::Fixed) {
+                threshold_ = options_.threshold;
+            }
+            bitonal_ = Binarize(gray_, options_);
+            gray_ = GrayImage();
+        } catch (const std::exception& e) {
+            SetError(e.what());
+        }
+    }
+
+    void OnOK() override {
+        Napi::Env env = Env();
+        if (grayOnly_) {
+            deferred_.Resolve(ImageToObject(env, std::move(gray_.data), gray_.width, gray_.height, 1));
+            return;
+        }
+
+        Napi::Object obj = Napi::Object::New(env);
+        obj.Set("pixels", BytesToBuffer(env, std::move(bitonal_.data)));
+        obj.Set("width", Napi::Number::New(env, bitonal_.width));
+        obj.Set("height", Napi::Number::New(env, bitonal_.height));
+        obj.Set("stride", Napi::Number::New(env, bitonal_.stride));
+        obj.Set("bitsPerPixel", Napi::Number::New(env, 1));
+        if (threshold_ >= 0) {
+            obj.Set("threshold", Napi::Number::New(env, threshold_));
+        }
+        deferred_.Resolve(obj);
+    }
+
+    void OnError(const Napi::Error& error) override {
+        deferred_.Reject(error.Value());
+    }
+
+private:
+    Napi::Promise::Deferred deferred_;
+    Napi::ObjectReference bufferRef_;
+    ImageView view_;
+    BinarizeOptions options_;
+    bool grayOnly_;
+    int threshold_;
+    GrayImage gray_;
+    BitonalImage bitonal_;
+};
+
+/**
+ * OCR pre-processing worker. Writes straight into an ArrayBuffer that
+ * was allocated on the JavaScript thread (the output size is known up
+ * front), so the result is an ordinary V8-owned buffer that can be
+ * transferred to the OCR worker without a copy.
+ */
+class OcrPrepWorker : public Napi::AsyncWorker {
+public:
+    OcrPrepWorker(Napi::Env env, Napi::Buffer<uint8_t> buffer, const ImageView& view,
+                  const OcrPrepOptions& options, Napi::ArrayBuffer output)
+        : Napi::AsyncWorker(env, "ImagingOcrPrep"),
+          deferred_(Napi::Promise::Deferred::New(env)),
+          view_(view),
+          options_(options),
+          out_(static_cast<uint8_t*>(output.Data())) {
+        bufferRef_ = Napi::Persistent(static_cast<Napi::Object>(buffer));
+        outputRef_ = Napi::Persistent(static_cast<Napi::Object>(output));
+    }
+
+    Napi::Promise GetPromise() const { return deferred_.Promise(); }
+
+protected:
+    void Execute() override {
+        try {
+            result_ = PrepareForOcr(view_, options_, out_);
+        } catch (const std::exception& e) {
+            SetError(e.what());
+        }
+    }
+
+    void OnOK() override {
+        Napi::Env env = Env();
+        Napi::Object obj = Napi::Object::New(env);
+        obj.Set("data", outputRef_.Value());
+        obj.Set("format", Napi::String::New(env, options_.bitonal ? "pbm" : "pgm"));
+        obj.Set("width", Napi::Number::New(env, result_.width));
+        obj.Set("height", Napi::Number::New(env, result_.height));
+        obj.Set("skewAngle", Napi::Number::New(env, result_.skewAngle));
+        deferred_.Resolve(obj);
+    }
+
+    void OnError(const Napi::Error& error) override {
+        deferred_.Reject(error.Value());
+    }
+
+private:
+    Napi::Promise::Deferred deferred_;
+    Napi::ObjectReference bufferRef_;
+    Napi::ObjectReference outputRef_;
+    ImageView view_;
+    OcrPrepOptions options_;
+    uint8_t* out_;
+    OcrPrepResult result_;
+};
+
+Napi::Value QueueJpeg(const Napi::CallbackInfo& info, bool estimateOnly) {
+    Napi::Env env = info.Env();
+    ImageArgs args;
+    if (!ParseImageArgs(info, args)) {
+        return env.Undefined();
+    }
+
+    int quality = IntOption(args.options, "quality", 85);
+    int resolution = IntOption(args.options, "resolution", 0);
+    int targetSize = IntOption(args.options, "targetSize", 0);
+
+    JpegWorker* worker = new JpegWorker(env, info[0].As<Napi::Buffer<uint8_t>>(), args.view, quality, resolution,
+                                        static_cast<size_t>(std::max(0, targetSize)), estimateOnly);
+    Napi::Promise promise = worker->GetPromise();
+    worker->Queue();
+    return promise;
+}
+
+} // namespace
+
+/**
+ * detectDocument(buffer, width, height, stride, options?) → Promise<DocumentDetectionResult>
+ */
+Napi::Value DetectDocumentAsync(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    ImageArgs args;
+    if (!ParseImageArgs(info, args)) {
+        return env.Undefined();
+    }
+
+    DetectionOptions options;
+    options.cannyLow = IntOption(args.options, "cannyLow", options.cannyLow);
+    options.cannyHigh = IntOption(args.options, "cannyHigh", options.cannyHigh);
+    options.blurRadius = IntOption(args.options, "blurRadius", options.blurRadius);
+    options.maxDimension = IntOption(args.options, "maxDimension", options.maxDimension);
+
+    DetectWorker* worker = new DetectWorker(env, info[0].As<Napi::Buffer<uint8_t>>(), args.view, options);
+    Napi::Promise promise = worker->GetPromise();
+    worker->Queue();
+    return promise;
+}
+
+/**
+ * warpPerspective(buffer, width, height, stride, matrix, outWidth, outHeight, options?)
+ *   → Promise<{ pixels, width, height, stride, channels }>
+ *
+ * `matrix` is the source → destination PerspectiveMatrix from
+ * calculateTransform; pass { inverse: true } if it already maps
+ * destination → source.
+ */
+Napi::Value WarpPerspectiveAsync(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    ImageArgs args;
+    if (!ParseImageArgs(info, args, 7)) {
+        return env.Undefined();
+    }
+
+    Homography matrix;
+    if (info.Length() < 7 || !ParseHomography(info[4], matrix) || !info[5].IsNumber() || !info[6].IsNumber()) {
+        Napi::TypeError::New(env, "Expected (buffer, width, height, stride, matrix, outWidth, outHeight)").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    int outWidth = info[5].As<Napi::Number>().Int32Value();
+    int outHeight = info[6].As<Napi::Number>().Int32Value();
+    if (outWidth <= 0 || outHeight <= 0) {
+        Napi::RangeError::New(env, "Invalid output dimensions").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    Homography inverse = matrix;
+    if (!BoolOption(args.options, "inverse", false) && !InvertHomography(matrix, inverse)) {
+        Napi::Error::New(env, "Transform matrix is not invertible").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    WarpWorker* worker = new WarpWorker(env, info[0].As<Napi::Buffer<uint8_t>>(), args.view, inverse, outWidth, outHeight);
+    Napi::Promise promise = worker->GetPromise();
+    worker->Queue();
+    return promise;
+}
+
+/**
+ * encodeJpeg(buffer, width, height, stride, options?) → Promise<{ data, size, quality }>
+ *
+ * Options: channels, quality (default 85, the upper bound when searching),
+ * targetSize (bytes; picks the highest quality whose estimate fits) and
+ * resolution (written to the JFIF header).
+ */
+Napi::Value EncodeJpegAsync(const Napi::CallbackInfo& info) {
+    return QueueJpeg(info, false);
+}
+
+/**
+ * estimateJpegSize(buffer, width, height, stride, options?) → Promise<number>
+ */
+Napi::Value EstimateJpegSizeAsync(const Napi::CallbackInfo& info) {
+    return QueueJpeg(info, true);
+}
+
+/**
+ * toGrayscale(buffer, width, height, stride, options?)
+ *   → Promise<{ pixels, width, height, stride, channels: 1 }>
+ *
+ * BT.601 weights, the same as ImageCompression.applyGrayscale.
+ */
+Napi::Value ToGrayscaleAsync(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    ImageArgs args;
+    if (!ParseImageArgs(info, args)) {
+        return env.Undefined();
+    }
+
+    BitonalWorker* worker = new BitonalWorker(env, info[0].As<Napi::Buffer<uint8_t>>(), args.view, BinarizeOptions{}, true);
+    Napi::Promise promise = worker->GetPromise();
+    worker->Queue();
+    return promise;
+}
+
+/**
+ * binarize(buffer, width, height, stride, options?)
+ *   → Promise<{ pixels, width, height, stride, bitsPerPixel: 1, threshold? }>
+ *
+ * Options: channels, method ("otsu" default, "fixed", "sauvola",
+ * "bradley"), threshold (fixed), windowSize, resolution (sizes the
+ * default window), k (Sauvola) and percent (Bradley). Pixels are packed
+ * MSB first with 0 = black; `threshold` is the global level used by
+ * "fixed" and "otsu".
+ */
+Napi::Value BinarizeAsync(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    ImageArgs args;
+    if (!ParseImageArgs(info, args)) {
+        return env.Undefined();
+    }
+
+    BinarizeOptions options;
+    if (!ParseThresholdMethod(StringOption(args.options, "method", "otsu"), options.method)) {
+        Napi::RangeError::New(env, "method must be fixed, otsu, sauvola or bradley").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+    options.threshold = IntOption(args.options, "threshold", options.threshold);
+    options.windowSize = IntOption(args.options, "windowSize", options.windowSize);
+    options.resolution = IntOption(args.options, "resolution", options.resolution);
+    options.k = DoubleOption(args.options, "k", options.k);
+    options.percent = DoubleOption(args.options, "percent", options.percent);
+
+    BitonalWorker* worker = new BitonalWorker(env, info[0].As<Napi::Buffer<uint8_t>>(), args.view, options, false);
+    Napi::Promise promise = worker->GetPromise();
+    worker->Queue();
+    return promise;
+}
+
+/**
+ * prepareForOcr(buffer, width, height, stride, options?)
+ *   → Promise<{ data: ArrayBuffer, format: 'pgm' | 'pbm', width, height, skewAngle }>
+ *
+ * Options: channels, deskew (default true), maxSkew (degrees, default 5),
+ * denoise (3x3 median, default true), contrast (default 1.3, gray only),
+ * output ('gray' default or 'bitonal') and for bitonal output the
+ * binarize() options (method defaults to "sauvola"). `data` is a
+ * complete binary PGM/PBM file that Tesseract reads directly.
+ */
+Napi::Value PrepareForOcrAsync(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    ImageArgs args;
+    if (!ParseImageArgs(info, args)) {
+        return env.Undefined();
+    }
+
+    OcrPrepOptions options;
+    options.deskew = BoolOption(args.options, "deskew", options.deskew);
+    options.maxSkew = DoubleOption(args.options, "maxSkew", options.maxSkew);
+    options.denoise = BoolOption(args.options, "denoise", options.denoise);
+    options.contrast = DoubleOption(args.options, "contrast", options.contrast);
+
+    std::string output = StringOption(args.options, "output", "gray");
+    if (output != "gray" && output != "bitonal") {
+        Napi::RangeError::New(env, "output must be gray or bitonal").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+    options.bitonal = output == "bitonal";
+    if (!ParseThresholdMethod(StringOption(args.options, "method", "sauvola"), options.binarize.method)) {
+        Napi::RangeError::New(env, "method must be fixed, otsu, sauvola or bradley").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+    options.binarize.threshold = IntOption(args.options, "threshold", options.binarize.threshold);
+    options.binarize.windowSize = IntOption(args.options, "windowSize", options.binarize.windowSize);
+    options.binarize.resolution = IntOption(args.options, "resolution", options.binarize.resolution);
+    options.binarize.k = DoubleOption(args.options, "k", options.binarize.k);
+    options.binarize.percent = DoubleOption(args.options, "percent", options.binarize.percent);
+
+    Napi::ArrayBuffer data =
+        Napi::ArrayBuffer::New(env, OcrImageSize(args.view.width, args.view.height, options.bitonal));
+    OcrPrepWorker* worker = new OcrPrepWorker(env, info[0].As<Napi::Buffer<uint8_t>>(), args.view, options, data);
+    Napi::Promise promise = worker->GetPromise();
+    worker->Queue();
+    return promise;
+}
+
+Napi::Object Init(Napi::Env env, Napi::Object exports) {
+    exports.Set("detectDocument", Napi::Function::New(env, DetectDocumentAsync, "detectDocument"));
+    exports.Set("warpPerspective", Napi::Function::New(env, WarpPerspectiveAsync, "warpPerspective"));
+    exports.Set("encodeJpeg", Napi::Function::New(env, EncodeJpegAsync, "encodeJpeg"));
+    exports.Set("estimateJpegSize", Napi::Function::New(env, EstimateJpegSizeAsync, "estimateJpegSize"));
+    exports.Set("toGrayscale", Napi::Function::New(env, ToGrayscaleAsync, "toGrayscale"));
+    exports.Set("binarize", Napi::Function::New(env, BinarizeAsync, "binarize"));
+    exports.Set("prepareForOcr", Napi::Function::New(env, PrepareForOcrAsync, "prepareForOcr"));
+    return exports;
+}
+
+NODE_API_MODULE(imaging_kernels, Init)
+
+} // namespace Imaging
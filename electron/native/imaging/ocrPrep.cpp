@@ -0,0 +1,290 @@
+/**
+ * OCR Pre-processing Implementation
+ */
+
+#include "ocrPrep.h"
+#include "documentDetect.h"
+#include "threadPool.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define IMAGING_SSE2 1
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define IMAGING_NEON 1
+#endif
+
+namespace Imaging {
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+
+// Skew is measured on a working copy with this longest side
+constexpr int kSkewMaxDimension = 1536;
+
+// Dark pixels needed for a meaningful projection profile, and the cap on
+// how many are scored per angle
+constexpr size_t kMinSkewPixels = 500;
+constexpr size_t kMaxSkewPixels = 200000;
+
+// Coarse and fine angle steps, and the smallest correction worth a resample
+constexpr double kSkewCoarseStep = 0.5;
+constexpr double kSkewFineStep = 0.05;
+constexpr double kMinSkewCorrection = 0.05;
+
+constexpr int kTileRows = 32;
+
+inline uint8_t MinV(uint8_t a, uint8_t b) { return a < b ? a : b; }
+inline uint8_t MaxV(uint8_t a, uint8_t b) { return a > b ? a : b; }
+
+#if defined(IMAGING_SSE2)
+using Vec16 = __m128i;
+inline Vec16 LoadV(const uint8_t* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+inline void StoreV(uint8_t* p, Vec16 v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+inline Vec16 MinV(Vec16 a, Vec16 b) { return _mm_min_epu8(a, b); }
+inline Vec16 MaxV(Vec16 a, Vec16 b) { return _mm_max_epu8(a, b); }
+#elif defined(IMAGING_NEON)
+using Vec16 = uint8x16_t;
+inline Vec16 LoadV(const uint8_t* p) { return vld1q_u8(p); }
+inline void StoreV(uint8_t* p, Vec16 v) { vst1q_u8(p, v); }
+inline Vec16 MinV(Vec16 a, Vec16 b) { return vminq_u8(a, b); }
+inline Vec16 MaxV(Vec16 a, Vec16 b) { return vmaxq_u8(a, b); }
+#endif
+
+template <typename V>
+inline void SortPair(V& a, V& b) {
+    V lo = MinV(a, b);
+    b = MaxV(a, b);
+    a = lo;
+}
+
+/**
+ * Median of nine with the 19-exchange network (Paeth), branch-free so
+ * the same code runs per byte or per SIMD lane
+ */
+template <typename V>
+inline V Median9(V p[9]) {
+    SortPair(p[1], p[2]); SortPair(p[4], p[5]); SortPair(p[7], p[8]);
+    SortPair(p[0], p[1]); SortPair(p[3], p[4]); SortPair(p[6], p[7]);
+    SortPair(p[1], p[2]); SortPair(p[4], p[5]); SortPair(p[7], p[8]);
+    SortPair(p[0], p[3]); SortPair(p[5], p[8]); SortPair(p[4], p[7]);
+    SortPair(p[3], p[6]); SortPair(p[1], p[4]); SortPair(p[2], p[5]);
+    SortPair(p[4], p[7]); SortPair(p[4], p[2]); SortPair(p[6], p[4]);
+    SortPair(p[4], p[2]);
+    return p[4];
+}
+
+void MedianRow(const uint8_t* r0, const uint8_t* r1, const uint8_t* r2, int width, uint8_t* dst) {
+    int x = 1;
+
+#if defined(IMAGING_SSE2) || defined(IMAGING_NEON)
+    for (; x + 17 <= width; x += 16) {
+        Vec16 p[9] = {LoadV(r0 + x - 1), LoadV(r0 + x), LoadV(r0 + x + 1),
+                      LoadV(r1 + x - 1), LoadV(r1 + x), LoadV(r1 + x + 1),
+                      LoadV(r2 + x - 1), LoadV(r2 + x), LoadV(r2 + x + 1)};
+        StoreV(dst + x, Median9(p));
+    }
+#endif
+
+    for (; x < width - 1; x++) {
+        uint8_t p[9] = {r0[x - 1], r0[x], r0[x + 1], r1[x - 1], r1[x], r1[x + 1], r2[x - 1], r2[x], r2[x + 1]};
+        dst[x] = Median9(p);
+    }
+}
+
+/**
+ * Sum of squared bin counts of the dark pixels projected along lines of
+ * slope tan(degrees); peaks when the projection follows the text lines
+ */
+double ProjectionScore(const std::vector<int>& xs, const std::vector<int>& ys, int width, int height,
+                       double degrees, std::vector<uint32_t>& bins) {
+    const double slope = std::tan(degrees * kPi / 180.0);
+    const int offset = static_cast<int>(std::ceil(std::fabs(slope) * width)) + 1;
+    bins.assign(static_cast<size_t>(height) + 2 * offset, 0);
+
+    for (size_t i = 0; i < xs.size(); i++) {
+        int bin = static_cast<int>(std::lround(ys[i] - xs[i] * slope)) + offset;
+        bins[bin]++;
+    }
+
+    double score = 0.0;
+    for (uint32_t count : bins) {
+        score += static_cast<double>(count) * count;
+    }
+    return score;
+}
+
+} // namespace
+
+std::string OcrImageHeader(int width, int height, bool bitonal) {
+    return std::string(bitonal ? "P4\n" : "P5\n") + std::to_string(width) + " " + std::to_string(height) +
+           (bitonal ? "\n" : "\n255\n");
+}
+
+size_t OcrImageSize(int width, int height, bool bitonal) {
+    const size_t rowBytes = bitonal ? static_cast<size_t>(width + 7) / 8 : static_cast<size_t>(width);
+    return OcrImageHeader(width, height, bitonal).size() + rowBytes * height;
+}
+
+void MedianFilter3x3(GrayImage& image) {
+    if (image.width < 3 || image.height < 3) {
+        return;
+    }
+
+    GrayImage src = image;
+    ThreadPool::Shared().ParallelFor(image.height - 2, kTileRows, [&](int begin, int end) {
+        for (int y = begin + 1; y < end + 1; y++) {
+            MedianRow(src.Row(y - 1), src.Row(y), src.Row(y + 1), image.width, image.Row(y));
+        }
+    });
+}
+
+double EstimateSkew(const GrayImage& gray, double maxDegrees) {
+    if (maxDegrees <= 0.0 || gray.width < 3 || gray.height < 3) {
+        return 0.0;
+    }
+
+    const int factor = DetectionScale(gray.width, gray.height, kSkewMaxDimension);
+    GrayImage small = GrayDownsample(ImageView{gray.data.data(), gray.width, gray.height, gray.width, 1}, factor);
+
+    uint32_t histogram[256];
+    GrayHistogram(small, histogram);
+    const int threshold = OtsuThreshold(histogram);
+
+    size_t dark = 0;
+    for (int v = 0; v <= threshold; v++) {
+        dark += histogram[v];
+    }
+    // Too little ink, or a page that is mostly dark (photo, black border)
+    if (dark < kMinSkewPixels || dark > small.data.size() / 2) {
+        return 0.0;
+    }
+
+    const size_t step = (dark + kMaxSkewPixels - 1) / kMaxSkewPixels;
+    std::vector<int> xs;
+    std::vector<int> ys;
+    xs.reserve(dark / step + 1);
+    ys.reserve(dark / step + 1);
+    size_t seen = 0;
+    for (int y = 0; y < small.height; y++) {
+        const uint8_t* row = small.Row(y);
+        for (int x = 0; x < small.width; x++) {
+            if (row[x] <= threshold && seen++ % step == 0) {
+                xs.push_back(x);
+                ys.push_back(y);
+            }
+        }
+    }
+
+    std::vector<uint32_t> bins;
+    double best = 0.0;
+    double bestScore = ProjectionScore(xs, ys, small.width, small.height, 0.0, bins);
+    auto search = [&](double from, double to, double stepDegrees) {
+        for (double a = from; a <= to + 1e-9; a += stepDegrees) {
+            double score = ProjectionScore(xs, ys, small.width, small.height, a, bins);
+            if (score > bestScore) {
+                bestScore = score;
+                best = a;
+            }
+        }
+    };
+
+    search(-maxDegrees, maxDegrees, kSkewCoarseStep);
+    const double center = best;
+    search(std::max(-maxDegrees, center - kSkewCoarseStep), std::min(maxDegrees, center + kSkewCoarseStep),
+           kSkewFineStep);
+    return best;
+}
+
+GrayImage RotateGray(const GrayImage& gray, double degrees) {
+    GrayImage out(gray.width, gray.height);
+    const double radians = degrees * kPi / 180.0;
+    const double c = std::cos(radians);
+    const double s = std::sin(radians);
+    const double cx = (gray.width - 1) / 2.0;
+    const double cy = (gray.height - 1) / 2.0;
+    const int width = gray.width;
+    const int height = gray.height;
+
+    auto sample = [&](int x, int y) -> int {
+        return x < 0 || y < 0 || x >= width || y >= height ? 255 : gray.Row(y)[x];
+    };
+
+    ThreadPool::Shared().ParallelFor(height, kTileRows, [&](int begin, int end) {
+        for (int y = begin; y < end; y++) {
+            const double dy = y - cy;
+            // Source position of x = 0; steps by (c, s) along the row
+            double sx = cx - c * cx - s * dy;
+            double sy = cy + s * (-cx) + c * dy;
+            uint8_t* dst = out.Row(y);
+
+            for (int x = 0; x < width; x++, sx += c, sy += s) {
+                const int x0 = static_cast<int>(std::floor(sx));
+                const int y0 = static_cast<int>(std::floor(sy));
+                // 8-bit fixed-point bilinear weights
+                const int fx = static_cast<int>((sx - x0) * 256.0);
+                const int fy = static_cast<int>((sy - y0) * 256.0);
+
+                int top, bottom;
+                if (x0 >= 0 && y0 >= 0 && x0 + 1 < width && y0 + 1 < height) {
+                    const uint8_t* p = gray.Row(y0) + x0;
+                    top = p[0] * (256 - fx) + p[1] * fx;
+                    bottom = p[width] * (256 - fx) + p[width + 1] * fx;
+                } else {
+                    top = sample(x0, y0) * (256 - fx) + sample(x0 + 1, y0) * fx;
+                    bottom = sample(x0, y0 + 1) * (256 - fx) + sample(x0 + 1, y0 + 1) * fx;
+                }
+                dst[x] = static_cast<uint8_t>((top * (256 - fy) + bottom * fy + 32768) >> 16);
+            }
+        }
+    });
+
+    return out;
+}
+
+OcrPrepResult PrepareForOcr(const ImageView& src, const OcrPrepOptions& options, uint8_t* out) {
+    OcrPrepResult result;
+    result.width = src.width;
+    result.height = src.height;
+
+    GrayImage gray = ToGray(src);
+    if (options.denoise) {
+        MedianFilter3x3(gray);
+    }
+    if (options.deskew) {
+        result.skewAngle = EstimateSkew(gray, options.maxSkew);
+        if (std::fabs(result.skewAngle) >= kMinSkewCorrection) {
+            gray = RotateGray(gray, result.skewAngle);
+        }
+    }
+
+    const std::string header = OcrImageHeader(gray.width, gray.height, options.bitonal);
+    std::memcpy(out, header.data(), header.size());
+    out += header.size();
+
+    if (options.bitonal) {
+        // PBM stores 1 = black, the inverse of BlackWhite1
+        BitonalImage bitonal = Binarize(gray, options.binarize);
+        for (size_t i = 0; i < bitonal.data.size(); i++) {
+            out[i] = static_cast<uint8_t>(~bitonal.data[i]);
+        }
+        return result;
+    }
+
+    // Same contrast stretch as preprocessForOCR, through a lookup table
+    uint8_t lut[256];
+    for (int v = 0; v < 256; v++) {
+        double adjusted = (v - 128) * options.contrast + 128;
+        lut[v] = static_cast<uint8_t>(std::min(255.0, std::max(0.0, adjusted)));
+    }
+    for (size_t i = 0; i < gray.data.size(); i++) {
+        out[i] = lut[gray.data[i]];
+    }
+    return result;
+}
+
+} // namespace Imaging
@@ -0,0 +1,74 @@
+/**
+ * OCR Pre-processing
+ *
+ * Native replacement for ScanOCR.preprocessForOCR in
+ * src/lib/scanner/scanOcr.ts. Converts a raw scan buffer to gray,
+ * removes speckle with a SIMD 3x3 median, estimates and corrects skew
+ * from the projection profile of dark pixels, then either boosts
+ * contrast (8-bit output) or thresholds the page (1-bit output). The
+ * result is written as a binary PGM/PBM image, which Tesseract's
+ * Leptonica reader takes as-is, so no PNG encode/decode is needed.
+ */
+
+#ifndef IMAGING_OCR_PREP_H
+#define IMAGING_OCR_PREP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "binarize.h"
+#include "imageTypes.h"
+
+namespace Imaging {
+
+struct OcrPrepOptions {
+    bool deskew = true;
+    double maxSkew = 5.0;   // degrees searched either way
+    bool denoise = true;    // 3x3 median
+    double contrast = 1.3;  // gray output only, around mid-gray; 1 = off
+    bool bitonal = false;   // 1-bit PBM instead of 8-bit PGM
+    BinarizeOptions binarize = {ThresholdMethod::Sauvola};
+};
+
+struct OcrPrepResult {
+    int width = 0;
+    int height = 0;
+    double skewAngle = 0.0;  // degrees, positive = lines fall to the right
+};
+
+/**
+ * PNM header for an output image ("P5" gray or "P4" bitonal)
+ */
+std::string OcrImageHeader(int width, int height, bool bitonal);
+
+/**
+ * Total PNM size in bytes. Deskewing keeps the page size, so this is
+ * known before the kernel runs.
+ */
+size_t OcrImageSize(int width, int height, bool bitonal);
+
+/**
+ * 3x3 median filter in place; border pixels are kept
+ */
+void MedianFilter3x3(GrayImage& image);
+
+/**
+ * Skew of the text lines in degrees, within +-maxDegrees (0 when the
+ * page has too little dark content to tell)
+ */
+double EstimateSkew(const GrayImage& gray, double maxDegrees);
+
+/**
+ * Rotate by -degrees about the centre (undoing a skew of `degrees`),
+ * same size, bilinear, white outside the source
+ */
+GrayImage RotateGray(const GrayImage& gray, double degrees);
+
+/**
+ * Full pipeline into `out`, which must hold OcrImageSize() bytes
+ */
+OcrPrepResult PrepareForOcr(const ImageView& src, const OcrPrepOptions& options, uint8_t* out);
+
+} // namespace Imaging
+
+#endif // IMAGING_OCR_PREP_H
@@ -0,0 +1,210 @@
+/**
+ * Perspective Warp Implementation
+ */
+
+#include "perspectiveWarp.h"
+#include "threadPool.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define IMAGING_SSE2 1
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define IMAGING_NEON 1
+#endif
+
+namespace Imaging {
+
+namespace {
+
+// Bilinear weights in 7 bits so vertical blends stay within int16
+constexpr int kWeightBits = 7;
+constexpr int kWeightOne = 1 << kWeightBits;
+constexpr int kRound = 1 << (2 * kWeightBits - 1);
+
+// Output rows per thread pool task
+constexpr int kTileRows = 32;
+
+/**
+ * Scalar bilinear sample; also handles the clamped right/bottom edges
+ */
+inline void SampleScalar(const uint8_t* p0, const uint8_t* p1, int dx, int channels,
+                         int fx, int fy, uint8_t* out) {
+    for (int c = 0; c < channels; c++) {
+        int left = p0[c] * (kWeightOne - fy) + p1[c] * fy;
+        int right = p0[c + dx] * (kWeightOne - fy) + p1[c + dx] * fy;
+        out[c] = static_cast<uint8_t>((left * (kWeightOne - fx) + right * fx + kRound) >> (2 * kWeightBits));
+    }
+}
+
+#if defined(IMAGING_SSE2)
+/**
+ * Blend one pixel with all channels in a single register. Reads 8 bytes
+ * from each row, so the caller guarantees that is in bounds.
+ */
+template <int Channels>
+inline void SampleSimd(const uint8_t* p0, const uint8_t* p1, int fx, int fy, uint8_t* out) {
+    const __m128i zero = _mm_setzero_si128();
+    __m128i top = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p0)), zero);
+    __m128i bottom = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p1)), zero);
+
+    // Vertical: top * (1 - fy) + bottom * fy, <= 255 * 128
+    __m128i v = _mm_add_epi16(_mm_mullo_epi16(top, _mm_set1_epi16(static_cast<int16_t>(kWeightOne - fy))),
+                              _mm_mullo_epi16(bottom, _mm_set1_epi16(static_cast<int16_t>(fy))));
+
+    // Horizontal: pair each channel of p(x0) with p(x1) and madd
+    __m128i pairs = _mm_unpacklo_epi16(v, _mm_srli_si128(v, Channels * 2));
+    __m128i weights = _mm_set1_epi32(static_cast<int>((static_cast<uint32_t>(fx) << 16) | static_cast<uint32_t>(kWeightOne - fx)));
+    __m128i sum = _mm_srli_epi32(_mm_add_epi32(_mm_madd_epi16(pairs, weights), _mm_set1_epi32(kRound)), 2 * kWeightBits);
+
+    __m128i packed = _mm_packus_epi16(_mm_packs_epi32(sum, zero), zero);
+    uint32_t value = static_cast<uint32_t>(_mm_cvtsi128_si32(packed));
+    std::memcpy(out, &value, Channels);
+}
+#elif defined(IMAGING_NEON)
+template <int Channels>
+inline void SampleSimd(const uint8_t* p0, const uint8_t* p1, int fx, int fy, uint8_t* out) {
+    uint16x8_t top = vmovl_u8(vld1_u8(p0));
+    uint16x8_t bottom = vmovl_u8(vld1_u8(p1));
+
+    uint16x8_t v = vmlaq_n_u16(vmulq_n_u16(top, static_cast<uint16_t>(kWeightOne - fy)), bottom, static_cast<uint16_t>(fy));
+    uint16x8_t next = vextq_u16(v, v, Channels);
+
+    uint32x4_t sum = vmlal_n_u16(vmull_n_u16(vget_low_u16(v), static_cast<uint16_t>(kWeightOne - fx)),
+                                 vget_low_u16(next), static_cast<uint16_t>(fx));
+    uint8x8_t packed = vmovn_u16(vcombine_u16(vrshrn_n_u32(sum, 2 * kWeightBits), vdup_n_u16(0)));
+
+    uint32_t value = vget_lane_u32(vreinterpret_u32_u8(packed), 0);
+    std::memcpy(out, &value, Channels);
+}
+#endif
+
+template <int Channels>
+void WarpRows(const ImageView& src, const Homography& m, int outWidth, int rowBegin, int rowEnd, uint8_t* out) {
+    const double maxX = src.width - 1;
+    const double maxY = src.height - 1;
+    // Last byte offset a SIMD sample may still read from
+    const size_t srcSize = static_cast<size_t>(src.stride) * (src.height - 1) +
+                           static_cast<size_t>(src.width) * Channels;
+
+    for (int y = rowBegin; y < rowEnd; y++) {
+        uint8_t* dst = out + static_cast<size_t>(y) * outWidth * Channels;
+
+        // Numerators and denominator are linear in x: step them per pixel
+        double nx = m.b * y + m.c;
+        double ny = m.e * y + m.f;
+        double dn = m.h * y + 1.0;
+
+        for (int x = 0; x < outWidth; x++, nx += m.a, ny += m.d, dn += m.g, dst += Channels) {
+            double inv = 1.0 / dn;
+            double sx = std::min(maxX, std::max(0.0, nx * inv));
+            double sy = std::min(maxY, std::max(0.0, ny * inv));
+
+            int x0 = static_cast<int>(sx);
+            int y0 = static_cast<int>(sy);
+            int fx = static_cast<int>((sx - x0) * kWeightOne + 0.5);
+            int fy = static_cast<int>((sy - y0) * kWeightOne + 0.5);
+            int dx = x0 + 1 < src.width ? Channels : 0;
+            size_t rowStep = y0 + 1 < src.height ? static_cast<size_t>(src.stride) : 0;
+
+            size_t offset = static_cast<size_t>(y0) * src.stride + static_cast<size_t>(x0) * Channels;
+            const uint8_t* p0 = src.data + offset;
+            const uint8_t* p1 = p0 + rowStep;
+
+#if defined(IMAGING_SSE2) || defined(IMAGING_NEON)
+            if (dx != 0 && offset + rowStep + 8 <= srcSize) {
+                SampleSimd<Channels>(p0, p1, fx, fy, dst);
+                continue;
+            }
+#endif
+            SampleScalar(p0, p1, dx, Channels, fx, fy, dst);
+        }
+    }
+}
+
+} // namespace
+
+bool InvertHomography(const Homography& m, Homography& inverse) {
+    const double det = m.a * m.e - m.b * m.d - m.a * m.f * m.h + m.b * m.f * m.g +
+                       m.c * m.d * m.h - m.c * m.e * m.g;
+    if (std::abs(det) < 1e-10) {
+        return false;
+    }
+
+    inverse.a = (m.e - m.f * m.h) / det;
+    inverse.b = (m.c * m.h - m.b) / det;
+    inverse.c = (m.b * m.f - m.c * m.e) / det;
+    inverse.d = (m.f * m.g - m.d) / det;
+    inverse.e = (m.a - m.c * m.g) / det;
+    inverse.f = (m.c * m.d - m.a * m.f) / det;
+    inverse.g = (m.d * m.h - m.e * m.g) / det;
+    inverse.h = (m.b * m.g - m.a * m.h) / det;
+    return true;
+}
+
+Homography RectToQuad(const Point corners[4], int outWidth, int outHeight) {
+    // Unit square to quadrilateral in closed form (Heckbert), then
+    // scaled so output pixel coordinates span the square
+    const Point& p0 = corners[0];
+    const Point& p1 = corners[1];
+    const Point& p2 = corners[2];
+    const Point& p3 = corners[3];
+    const double dx1 = p1.x - p2.x;
+    const double dx2 = p3.x - p2.x;
+    const double dx3 = p0.x - p1.x + p2.x - p3.x;
+    const double dy1 = p1.y - p2.y;
+    const double dy2 = p3.y - p2.y;
+    const double dy3 = p0.y - p1.y + p2.y - p3.y;
+
+    Homography m{};
+    const double det = dx1 * dy2 - dx2 * dy1;
+    if ((dx3 == 0.0 && dy3 == 0.0) || std::abs(det) < 1e-12) {
+        // Parallelogram: affine
+        m.g = 0.0;
+        m.h = 0.0;
+    } else {
+        m.g = (dx3 * dy2 - dx2 * dy3) / det;
+        m.h = (dx1 * dy3 - dx3 * dy1) / det;
+    }
+    m.a = p1.x - p0.x + m.g * p1.x;
+    m.b = p3.x - p0.x + m.h * p3.x;
+    m.c = p0.x;
+    m.d = p1.y - p0.y + m.g * p1.y;
+    m.e = p3.y - p0.y + m.h * p3.y;
+    m.f = p0.y;
+
+    const double sx = 1.0 / std::max(1, outWidth - 1);
+    const double sy = 1.0 / std::max(1, outHeight - 1);
+    m.a *= sx;
+    m.d *= sx;
+    m.g *= sx;
+    m.b *= sy;
+    m.e *= sy;
+    m.h *= sy;
+    return m;
+}
+
+std::vector<uint8_t> WarpPerspective(const ImageView& src,
+                                     const Homography& inverse,
+                                     int outWidth,
+                                     int outHeight) {
+    std::vector<uint8_t> out(static_cast<size_t>(outWidth) * outHeight * src.channels);
+    if (outWidth <= 0 || outHeight <= 0 || src.width <= 0 || src.height <= 0) {
+        return out;
+    }
+
+    ThreadPool::Shared().ParallelFor(outHeight, kTileRows, [&](int begin, int end) {
+        switch (src.channels) {
+            case 1: WarpRows<1>(src, inverse, outWidth, begin, end, out.data()); break;
+            case 3: WarpRows<3>(src, inverse, outWidth, begin, end, out.data()); break;
+            default: WarpRows<4>(src, inverse, outWidth, begin, end, out.data()); break;
+        }
+    });
+
+    return out;
+}
+
+} // namespace Imaging
@@ -0,0 +1,52 @@
+/**
+ * Perspective Warp
+ *
+ * Native counterpart of PerspectiveCorrection.correctPerspective in
+ * src/lib/scanner/perspectiveCorrection.ts. Output rows are split into
+ * tiles across the imaging thread pool; each pixel is sampled with
+ * 7-bit fixed-point bilinear weights (SIMD across channels).
+ */
+
+#ifndef IMAGING_PERSPECTIVE_WARP_H
+#define IMAGING_PERSPECTIVE_WARP_H
+
+#include <cstdint>
+#include <vector>
+#include "imageTypes.h"
+
+namespace Imaging {
+
+/**
+ * Same layout as PerspectiveMatrix in perspectiveCorrection.ts:
+ *   x' = (a x + b y + c) / (g x + h y + 1)
+ *   y' = (d x + e y + f) / (g x + h y + 1)
+ */
+struct Homography {
+    double a, b, c, d, e, f, g, h;
+};
+
+/**
+ * Inverse homography; returns false if the matrix is singular
+ */
+bool InvertHomography(const Homography& m, Homography& inverse);
+
+/**
+ * Homography mapping an outWidth x outHeight rectangle onto the
+ * quadrilateral `corners` (clockwise from top-left, as DetectDocument()
+ * returns them); this is the `inverse` WarpPerspective() takes to
+ * straighten that quadrilateral
+ */
+Homography RectToQuad(const Point corners[4], int outWidth, int outHeight);
+
+/**
+ * Warp `src` into a tightly packed outWidth x outHeight image with the
+ * same channel count. `inverse` maps output to source coordinates.
+ */
+std::vector<uint8_t> WarpPerspective(const ImageView& src,
+                                     const Homography& inverse,
+                                     int outWidth,
+                                     int outHeight);
+
+} // namespace Imaging
+
+#endif // IMAGING_PERSPECTIVE_WARP_H
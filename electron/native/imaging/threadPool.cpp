@@ -0,0 +1,259 @@
+/**
+ * Imaging Thread Pool Implementation
+ */
+
+#include "threadPool.h"
+#include <algorithm>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#elif defined(__APPLE__)
+#include <pthread.h>
+#include <pthread/qos.h>
+#elif defined(__linux__)
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace Imaging {
+
+namespace {
+
+// Worker index of the current thread in `tlsPool`, -1 elsewhere
+thread_local ThreadPool* tlsPool = nullptr;
+thread_local int tlsWorker = -1;
+
+} // namespace
+
+// Post-processing yields to the acquisition and UI threads
+void LowerThreadPriority() {
+#if defined(_WIN32)
+    SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_BELOW_NORMAL);
+#elif defined(__APPLE__)
+    pthread_set_qos_class_self_np(QOS_CLASS_UTILITY, 0);
+#elif defined(__linux__)
+    // Linux nice values are per thread
+    setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), 5);
+#endif
+}
+
+ThreadPool::ThreadPool(unsigned threads) {
+    for (unsigned i = 0; i < threads; i++) {
+        workers_.push_back(std::make_unique<Worker>());
+    }
+    // Deques exist before any thread can steal from them
+    for (unsigned i = 0; i < threads; i++) {
+        workers_[i]->thread = std::thread(&ThreadPool::WorkerLoop, this, static_cast<int>(i));
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (auto& worker : workers_) {
+        worker->thread.join();
+    }
+}
+
+ThreadPool& ThreadPool::Shared() {
+    // The caller participates in ParallelFor, so keep one core for it
+    static ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()) - 1);
+    return pool;
+}
+
+void ThreadPool::Push(std::function<void()> job) {
+    if (tlsPool == this && tlsWorker >= 0) {
+        Worker& own = *workers_[tlsWorker];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        own.tasks.push_back(std::move(job));
+    } else {
+        std::lock_guard<std::mutex> lock(injectMutex_);
+        injected_.push_back(std::move(job));
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        queued_++;
+    }
+    wake_.notify_all();
+}
+
+bool ThreadPool::RunOne(int self) {
+    std::function<void()> job;
+
+    // Own work newest first (still warm in cache), then outside work,
+    // then the oldest work of another worker
+    if (self >= 0) {
+        Worker& own = *workers_[self];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            job = std::move(own.tasks.back());
+            own.tasks.pop_back();
+        }
+    }
+    if (!job) {
+        std::lock_guard<std::mutex> lock(injectMutex_);
+        if (!injected_.empty()) {
+            job = std::move(injected_.front());
+            injected_.pop_front();
+        }
+    }
+    const int count = static_cast<int>(workers_.size());
+    for (int i = 1; !job && i <= count; i++) {
+        int victim = (std::max(self, 0) + i) % count;
+        if (victim == self) {
+            continue;
+        }
+        Worker& other = *workers_[victim];
+        std::lock_guard<std::mutex> lock(other.mutex);
+        if (!other.tasks.empty()) {
+            job = std::move(other.tasks.front());
+            other.tasks.pop_front();
+        }
+    }
+
+    if (!job) {
+        return false;
+    }
+    queued_--;
+    job();
+    return true;
+}
+
+void ThreadPool::WorkerLoop(int index) {
+    tlsPool = this;
+    tlsWorker = index;
+    LowerThreadPriority();
+
+    for (;;) {
+        if (RunOne(index)) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepMutex_);
+        wake_.wait(lock, [this]() { return stopping_ || queued_ > 0; });
+        if (stopping_ && queued_ == 0) {
+            return;
+        }
+    }
+}
+
+void ThreadPool::ParallelFor(int count, int grain, const std::function<void(int begin, int end)>& fn) {
+    if (count <= 0) {
+        return;
+    }
+    grain = std::max(1, grain);
+    const int chunks = (count + grain - 1) / grain;
+    if (chunks == 1 || workers_.empty()) {
+        fn(0, count);
+        return;
+    }
+
+    // Chunks are claimed from a shared counter so fast threads take more,
+    // and the caller never waits on a helper that has not started yet
+    struct Job {
+        std::atomic<int> next{0};
+        std::atomic<int> remaining{0};
+        std::mutex mutex;
+        std::condition_variable done;
+    };
+    auto job = std::make_shared<Job>();
+    job->remaining = chunks;
+
+    auto run = [job, chunks, count, grain, &fn]() {
+        for (int chunk = job->next++; chunk < chunks; chunk = job->next++) {
+            int begin = chunk * grain;
+            fn(begin, std::min(count, begin + grain));
+            if (--job->remaining == 0) {
+                std::lock_guard<std::mutex> lock(job->mutex);
+                job->done.notify_all();
+            }
+        }
+    };
+
+    const unsigned helpers = std::min<unsigned>(ThreadCount(), static_cast<unsigned>(chunks - 1));
+    for (unsigned i = 0; i < helpers; i++) {
+        Push(run);
+    }
+
+    run();
+
+    std::unique_lock<std::mutex> lock(job->mutex);
+    job->done.wait(lock, [&job]() { return job->remaining == 0; });
+}
+
+ThreadPool::TaskHandle ThreadPool::Submit(std::function<void()> fn, const std::vector<TaskHandle>& dependencies) {
+    auto task = std::make_shared<Task>();
+    task->fn_ = std::move(fn);
+
+    for (const TaskHandle& dependency : dependencies) {
+        if (!dependency) {
+            continue;
+        }
+        std::lock_guard<std::mutex> lock(dependency->mutex_);
+        if (!dependency->done_) {
+            task->blockers_++;
+            dependency->successors_.push_back(task);
+        }
+    }
+
+    // Drop the submission guard; schedule now if nothing is outstanding
+    if (--task->blockers_ == 0) {
+        Schedule(task);
+    }
+    return task;
+}
+
+void ThreadPool::Schedule(const TaskHandle& task) {
+    if (workers_.empty()) {
+        task->fn_();
+        Complete(task);
+        return;
+    }
+    Push([this, task]() {
+        task->fn_();
+        Complete(task);
+    });
+}
+
+void ThreadPool::Complete(const TaskHandle& task) {
+    std::vector<TaskHandle> ready;
+    {
+        std::lock_guard<std::mutex> lock(task->mutex_);
+        task->done_ = true;
+        task->fn_ = nullptr;
+        ready.swap(task->successors_);
+    }
+    {
+        // Waiters check Done() under this mutex, so the wake-up is not lost
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+    }
+    wake_.notify_all();
+
+    for (const TaskHandle& successor : ready) {
+        if (--successor->blockers_ == 0) {
+            Schedule(successor);
+        }
+    }
+}
+
+void ThreadPool::Wait(const TaskHandle& task) {
+    if (!task) {
+        return;
+    }
+    const int self = tlsPool == this ? tlsWorker : -1;
+
+    while (!task->Done()) {
+        if (self >= 0 && RunOne(self)) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepMutex_);
+        wake_.wait(lock, [&]() { return task->Done() || (self >= 0 && queued_ > 0); });
+    }
+}
+
+} // namespace Imaging
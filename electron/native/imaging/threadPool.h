@@ -0,0 +1,116 @@
+/**
+ * Imaging Thread Pool
+ *
+ * Work-stealing scheduler shared by every post-processing stage of the
+ * scanner addons (detection, warp, binarization, encoding, PDF output).
+ * Each worker owns a deque: it pushes and pops its own work at the back
+ * and idle workers steal from the front of the others, so a page task
+ * that fans out into row tiles keeps them local while spare cores pick
+ * them up. Tasks may depend on earlier tasks, which lets per-page
+ * stages run in parallel across pages while ordered stages chain.
+ *
+ * Workers run below normal priority and the pool leaves one core free,
+ * so the acquisition thread that feeds the pool keeps the device busy.
+ * The calling thread takes part in ParallelFor, so it can be used from
+ * an AsyncWorker without starving the libuv pool.
+ */
+
+#ifndef IMAGING_THREAD_POOL_H
+#define IMAGING_THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Imaging {
+
+/**
+ * Move the calling thread below normal priority, as the pool's workers
+ * run; for background work that must not compete with the UI
+ */
+void LowerThreadPriority();
+
+class ThreadPool {
+public:
+    class Task;
+    using TaskHandle = std::shared_ptr<Task>;
+
+    explicit ThreadPool(unsigned threads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * Process-wide pool sized to the hardware concurrency
+     */
+    static ThreadPool& Shared();
+
+    unsigned ThreadCount() const { return static_cast<unsigned>(workers_.size()); }
+
+    // Jobs waiting for a worker (a gauge; may be stale by the time it is read)
+    int QueuedTasks() const { return queued_.load(); }
+
+    /**
+     * Run fn(begin, end) over [0, count) in chunks of `grain` items and
+     * wait for all chunks to finish
+     */
+    void ParallelFor(int count, int grain, const std::function<void(int begin, int end)>& fn);
+
+    /**
+     * Schedule fn once every task in `dependencies` has finished. Null
+     * handles are ignored.
+     */
+    TaskHandle Submit(std::function<void()> fn, const std::vector<TaskHandle>& dependencies = {});
+
+    /**
+     * Block until task has finished. Called from a worker, the thread
+     * keeps running other tasks meanwhile.
+     */
+    void Wait(const TaskHandle& task);
+
+    class Task {
+    public:
+        bool Done() const { return done_.load(); }
+
+    private:
+        friend class ThreadPool;
+
+        std::function<void()> fn_;
+        std::atomic<int> blockers_{1};  // unfinished dependencies + 1 until submitted
+        std::mutex mutex_;
+        std::vector<TaskHandle> successors_;
+        std::atomic<bool> done_{false};
+    };
+
+private:
+    struct Worker {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+        std::thread thread;
+    };
+
+    void WorkerLoop(int index);
+    void Push(std::function<void()> job);
+    bool RunOne(int self);
+    void Schedule(const TaskHandle& task);
+    void Complete(const TaskHandle& task);
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::mutex injectMutex_;
+    std::deque<std::function<void()>> injected_;  // work pushed from outside the pool
+
+    std::mutex sleepMutex_;
+    std::condition_variable wake_;
+    std::atomic<int> queued_{0};
+    bool stopping_ = false;
+};
+
+} // namespace Imaging
+
+#endif // IMAGING_THREAD_POOL_H
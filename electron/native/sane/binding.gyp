@@ -5,16 +5,52 @@
       "cflags!": ["-fno-exceptions"],
       "cflags_cc!": ["-fno-exceptions"],
       "sources": [
-        "saneWrapper.cpp"
+        "saneWrapper.cpp",
+        "udevMonitor.cpp",
+        "../core/bandStream.cpp",
+        "../core/batchWorker.cpp",
+        "../core/bitonalSink.cpp",
+        "../core/blankPage.cpp",
+        "../core/bufferPool.cpp",
+        "../core/cancelToken.cpp",
+        "../core/ccittG4Encoder.cpp",
+        "../core/deviceEvents.cpp",
+        "../core/deviceRegistry.cpp",
+        "../core/fileIo.cpp",
+        "../core/imageEncoder.cpp",
+        "../core/initWorker.cpp",
+        "../core/jpegEncoder.cpp",
+        "../core/metricsEvents.cpp",
+        "../core/napiConvert.cpp",
+        "../core/pageQueue.cpp",
+        "../core/pdfWriter.cpp",
+        "../core/pixelKernels.cpp",
+        "../core/previewCache.cpp",
+        "../core/previewWorker.cpp",
+        "../core/scanMetrics.cpp",
+        "../core/scanWorker.cpp",
+        "../core/separatorSheet.cpp",
+        "../core/sessionManager.cpp",
+        "../core/spoolFile.cpp",
+        "../core/spoolWorker.cpp",
+        "../core/streamWorker.cpp",
+        "../core/thumbnailPyramid.cpp",
+        "../imaging/binarize.cpp",
+        "../imaging/documentDetect.cpp",
+        "../imaging/threadPool.cpp"
       ],
       "include_dirs": [
-        "<!@(node -p \"require('node-addon-api').include\")"
+        "<!@(node -p \"require('node-addon-api').include\")",
+        "../core",
+        "../imaging"
       ],
       "defines": ["NAPI_DISABLE_CPP_EXCEPTIONS"],
       "conditions": [
         ["OS=='linux'", {
           "libraries": [
-            "-lsane"
+            "-lsane",
+            "-ludev",
+            "-ljpeg"
           ]
         }]
       ]
@@ -6,83 +6,89 @@
  */
 
 #include "saneWrapper.h"
+#include "scanArea.h"
 
 namespace SaneWrapper {
 
-Napi::Object SaneScanner::Init(Napi::Env env, Napi::Object exports) {
-    Napi::Function func = DefineClass(env, "SaneScanner", {
-        InstanceMethod("initialize", &SaneScanner::Initialize),
-        InstanceMethod("enumerateDevices", &SaneScanner::EnumerateDevices),
-        InstanceMethod("selectDevice", &SaneScanner::SelectDevice),
-        InstanceMethod("getCapabilities", &SaneScanner::GetCapabilities),
-        InstanceMethod("scan", &SaneScanner::Scan),
-        InstanceMethod("cancelScan", &SaneScanner::CancelScan),
-        InstanceMethod("close", &SaneScanner::Close),
-    });
+SaneScanner::SaneScanner(const Napi::CallbackInfo& info) : ScannerObject<SaneScanner>(info) {}
 
-    Napi::FunctionReference* constructor = new Napi::FunctionReference();
-    *constructor = Napi::Persistent(func);
-    env.SetInstanceData(constructor);
-
-    exports.Set("SaneScanner", func);
-    return exports;
-}
-
-SaneScanner::SaneScanner(const Napi::CallbackInfo& info)
-    : Napi::ObjectWrap<SaneScanner>(info), isInitialized_(false) {}
-
-Napi::Value SaneScanner::Initialize(const Napi::CallbackInfo& info) {
-    Napi::Env env = info.Env();
-    // TODO: Call sane_init()
-    isInitialized_ = true;
-    return Napi::Boolean::New(env, true);
-}
-
-Napi::Value SaneScanner::EnumerateDevices(const Napi::CallbackInfo& info) {
-    Napi::Env env = info.Env();
-    // TODO: Call sane_get_devices()
-    return Napi::Array::New(env);
+bool SaneScanner::LoadDriver(std::string& error) {
+    // TODO: Call sane_init(&version, nullptr); it dlopen()s every backend
+    // listed in dll.conf, which is what makes it slow. On failure set
+    // error from sane_strstatus() and return false.
+    (void)error;
+    return true;
 }
 
-Napi::Value SaneScanner::SelectDevice(const Napi::CallbackInfo& info) {
-    Napi::Env env = info.Env();
-    if (info.Length() < 1 || !info[0].IsString()) {
-        Napi::TypeError::New(env, "Device ID expected").ThrowAsJavaScriptException();
-        return env.Null();
+void SaneScanner::OnInitialize() {
+    // USB hot-plug re-probes
+    if (!udevMonitor_) {
+        ScannerCore::DeviceRegistry* registry = registry_.get();
+        udevMonitor_ = std::make_unique<UdevMonitor>([registry]() { registry->Invalidate(); });
+        udevMonitor_->Start();
     }
-    selectedDeviceId_ = info[0].As<Napi::String>().Utf8Value();
-    // TODO: Call sane_open()
-    return Napi::Boolean::New(env, true);
 }
 
-Napi::Value SaneScanner::GetCapabilities(const Napi::CallbackInfo& info) {
-    Napi::Env env = info.Env();
-    // TODO: Query device options via sane_get_option_descriptor()
-    return Napi::Object::New(env);
+void SaneScanner::OnClose() {
+    // TODO: Call sane_exit()
 }
 
-Napi::Value SaneScanner::Scan(const Napi::CallbackInfo& info) {
-    Napi::Env env = info.Env();
-    // TODO: Call sane_start(), sane_read(), sane_cancel()
-    Napi::Object result = Napi::Object::New(env);
-    result.Set("success", false);
-    result.Set("errorMessage", "SANE scanning not implemented");
-    return result;
+std::vector<ScannerDevice> SaneScanner::ProbeDevices() {
+    // TODO: Call sane_get_devices(&list, SANE_FALSE) and map each SANE_Device
+    return {};
 }
 
-Napi::Value SaneScanner::CancelScan(const Napi::CallbackInfo& info) {
-    // TODO: Call sane_cancel()
-    return Napi::Boolean::New(info.Env(), true);
+std::shared_ptr<ScannerCore::ScanSession> SaneScanner::OpenDevice(const std::string& deviceId, std::string& error) {
+    // TODO: sane_open(deviceId) into the session handle; Jpeg in
+    // session->transferEncodings when the backend has a "compression"
+    // string-list option containing "JPEG" (fujitsu, canon_dr), whose
+    // frames then use the non-standard SANE_FRAME_JPEG (11)
+    (void)deviceId;
+    (void)error;
+    return std::make_shared<SaneSession>();
 }
 
-Napi::Value SaneScanner::Close(const Napi::CallbackInfo& info) {
-    // TODO: Call sane_close() and sane_exit()
-    isInitialized_ = false;
-    return Napi::Boolean::New(info.Env(), true);
+bool SaneScanner::AcquirePages(SaneSession& session,
+                               const ScanSettings& settings,
+                               int maxPages,
+                               ScannerCore::BandWriter& writer,
+                               std::string& error) {
+    // TODO: Multi-frame loop on the open handle: sane_start(),
+    // writer.BeginPage() from sane_get_parameters(), writer.Write() for
+    // every sane_read() block, writer.EndPage() on SANE_STATUS_EOF; repeat
+    // sane_start() until SANE_STATUS_NO_DOCS, maxPages, or EndPage()
+    // returns false, then sane_cancel(). Write() and EndPage() block at
+    // settings.highWaterMark; just stop reading meanwhile, the backend
+    // holds the device until the next sane_read()
+    //
+    // settings.preview: set the "preview" option to SANE_TRUE so the
+    // backend picks its fast mode, and "resolution" to settings.resolution
+    //
+    // settings.scanArea (inches, when set): "tl-x", "tl-y", "br-x" and
+    // "br-y" as SANE_FIX(inches * kMillimetersPerInch) for backends in
+    // SANE_UNIT_MM, after ClampScanArea() to the options' range constraint
+    //
+    // TransferEncodingFor(settings, session.transferEncodings) == Jpeg:
+    // set "compression" to "JPEG" (and "compression-arg" to
+    // settings.jpegQuality where offered) before sane_start(); a
+    // SANE_FRAME_JPEG page is BeginPage() with geometry.encoding =
+    // ImageEncoding::Jpeg (lines may be -1), and its sane_read() blocks are
+    // the JFIF stream, written as they come
+    //
+    // Cancellation: CancelHook abort(writer.Token(), [&session]() {
+    // sane_cancel(session.handle); }) for the whole loop; a blocked
+    // sane_read() then returns SANE_STATUS_CANCELLED, and Write() /
+    // EndPage() return false at the next block
+    (void)session;
+    (void)settings;
+    (void)maxPages;
+    (void)writer;
+    error = "SANE scanning not implemented";
+    return false;
 }
 
 Napi::Object Init(Napi::Env env, Napi::Object exports) {
-    return SaneScanner::Init(env, exports);
+    return SaneScanner::Export(env, exports, "SaneScanner");
 }
 
 NODE_API_MODULE(sane_wrapper, Init)
@@ -9,26 +9,55 @@
 #define SANE_WRAPPER_H
 
 #include <napi.h>
+#include <memory>
 #include <string>
+#include <vector>
+#include "scanTypes.h"
+#include "scannerObject.h"
+#include "udevMonitor.h"
 
 namespace SaneWrapper {
 
-class SaneScanner : public Napi::ObjectWrap<SaneScanner> {
+using ScannerCore::ScannerDevice;
+using ScannerCore::ScanSettings;
+using ScannerCore::ScanResult;
+
+/**
+ * Open SANE device held by a scan session
+ */
+struct SaneSession : ScannerCore::ScanSession {
+    // TODO: SANE_Handle from sane_open(); sane_close() it in the destructor
+};
+
+class SaneScanner : public ScannerCore::ScannerObject<SaneScanner> {
 public:
-    static Napi::Object Init(Napi::Env env, Napi::Object exports);
     SaneScanner(const Napi::CallbackInfo& info);
 
 private:
-    Napi::Value Initialize(const Napi::CallbackInfo& info);
-    Napi::Value EnumerateDevices(const Napi::CallbackInfo& info);
-    Napi::Value SelectDevice(const Napi::CallbackInfo& info);
-    Napi::Value GetCapabilities(const Napi::CallbackInfo& info);
-    Napi::Value Scan(const Napi::CallbackInfo& info);
-    Napi::Value CancelScan(const Napi::CallbackInfo& info);
-    Napi::Value Close(const Napi::CallbackInfo& info);
-
-    bool isInitialized_;
-    std::string selectedDeviceId_;
+    friend class ScannerCore::ScannerObject<SaneScanner>;
+    using Session = SaneSession;
+
+    // Driver load, runs once on the registry thread before the first probe
+    static bool LoadDriver(std::string& error);
+
+    // Driver setup on initialize() and teardown on close()
+    void OnInitialize();
+    void OnClose();
+
+    // Driver device probe, runs on the registry thread
+    static std::vector<ScannerDevice> ProbeDevices();
+
+    // Driver session open, runs on the JavaScript thread
+    static std::shared_ptr<ScannerCore::ScanSession> OpenDevice(const std::string& deviceId, std::string& error);
+
+    // Driver acquisition, runs on the session's acquisition thread
+    static bool AcquirePages(SaneSession& session,
+                             const ScanSettings& settings,
+                             int maxPages,
+                             ScannerCore::BandWriter& writer,
+                             std::string& error);
+
+    std::unique_ptr<UdevMonitor> udevMonitor_;
 };
 
 } // namespace SaneWrapper
@@ -0,0 +1,117 @@
+/**
+ * udev Hot-Plug Monitor Implementation
+ */
+
+#include "udevMonitor.h"
+#include <libudev.h>
+#include <poll.h>
+#include <unistd.h>
+#include <cstring>
+
+namespace SaneWrapper {
+
+namespace {
+
+// USB scanners enumerate as several nodes; wait for the burst to settle
+// before asking SANE to re-probe
+constexpr int kSettleMs = 500;
+
+} // namespace
+
+UdevMonitor::UdevMonitor(std::function<void()> onChange)
+    : onChange_(std::move(onChange)), running_(false), wakeFds_{-1, -1} {}
+
+UdevMonitor::~UdevMonitor() {
+    Stop();
+}
+
+bool UdevMonitor::Start() {
+    if (running_) {
+        return true;
+    }
+    if (pipe(wakeFds_) != 0) {
+        return false;
+    }
+
+    running_ = true;
+    thread_ = std::thread(&UdevMonitor::Run, this);
+    return true;
+}
+
+void UdevMonitor::Stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+
+    char byte = 0;
+    ssize_t ignored = write(wakeFds_[1], &byte, 1);
+    (void)ignored;
+
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+
+    close(wakeFds_[0]);
+    close(wakeFds_[1]);
+    wakeFds_[0] = wakeFds_[1] = -1;
+}
+
+void UdevMonitor::Run() {
+    struct udev* udev = udev_new();
+    if (udev == nullptr) {
+        return;
+    }
+
+    struct udev_monitor* monitor = udev_monitor_new_from_netlink(udev, "udev");
+    if (monitor == nullptr) {
+        udev_unref(udev);
+        return;
+    }
+
+    udev_monitor_filter_add_match_subsystem_devtype(monitor, "usb", "usb_device");
+    udev_monitor_enable_receiving(monitor);
+
+    struct pollfd fds[2];
+    fds[0].fd = udev_monitor_get_fd(monitor);
+    fds[0].events = POLLIN;
+    fds[1].fd = wakeFds_[0];
+    fds[1].events = POLLIN;
+
+    bool pending = false;
+
+    while (running_) {
+        int ready = poll(fds, 2, pending ? kSettleMs : -1);
+
+        if (ready < 0) {
+            break;
+        }
+
+        if (ready == 0) {
+            // Burst settled
+            pending = false;
+            onChange_();
+            continue;
+        }
+
+        if (fds[1].revents & POLLIN) {
+            break;
+        }
+
+        if (fds[0].revents & POLLIN) {
+            struct udev_device* device = udev_monitor_receive_device(monitor);
+            if (device != nullptr) {
+                const char* action = udev_device_get_action(device);
+                if (action != nullptr &&
+                    (std::strcmp(action, "add") == 0 || std::strcmp(action, "remove") == 0)) {
+                    pending = true;
+                }
+                udev_device_unref(device);
+            }
+        }
+    }
+
+    udev_monitor_unref(monitor);
+    udev_unref(udev);
+}
+
+} // namespace SaneWrapper
@@ -0,0 +1,41 @@
+/**
+ * udev Hot-Plug Monitor
+ *
+ * Watches USB device add/remove events through libudev so the SANE
+ * device registry can re-probe backends when a scanner is plugged in
+ * or removed.
+ */
+
+#ifndef SANE_UDEV_MONITOR_H
+#define SANE_UDEV_MONITOR_H
+
+#include <atomic>
+#include <functional>
+#include <thread>
+
+namespace SaneWrapper {
+
+class UdevMonitor {
+public:
+    explicit UdevMonitor(std::function<void()> onChange);
+    ~UdevMonitor();
+
+    UdevMonitor(const UdevMonitor&) = delete;
+    UdevMonitor& operator=(const UdevMonitor&) = delete;
+
+    // Returns false if udev is unavailable (e.g. inside a container)
+    bool Start();
+    void Stop();
+
+private:
+    void Run();
+
+    std::function<void()> onChange_;
+    std::thread thread_;
+    std::atomic<bool> running_;
+    int wakeFds_[2];
+};
+
+} // namespace SaneWrapper
+
+#endif // SANE_UDEV_MONITOR_H
@@ -1,14 +1,50 @@
 {
+  "variables": {
+    "libjpeg_turbo_dir%": "C:/libjpeg-turbo64"
+  },
   "targets": [
     {
       "target_name": "twain_wrapper",
       "cflags!": ["-fno-exceptions"],
       "cflags_cc!": ["-fno-exceptions"],
       "sources": [
-        "twainWrapper.cpp"
+        "twainWrapper.cpp",
+        "../core/bandStream.cpp",
+        "../core/batchWorker.cpp",
+        "../core/bitonalSink.cpp",
+        "../core/blankPage.cpp",
+        "../core/bufferPool.cpp",
+        "../core/cancelToken.cpp",
+        "../core/ccittG4Encoder.cpp",
+        "../core/deviceEvents.cpp",
+        "../core/deviceRegistry.cpp",
+        "../core/fileIo.cpp",
+        "../core/imageEncoder.cpp",
+        "../core/initWorker.cpp",
+        "../core/jpegEncoder.cpp",
+        "../core/metricsEvents.cpp",
+        "../core/napiConvert.cpp",
+        "../core/pageQueue.cpp",
+        "../core/pdfWriter.cpp",
+        "../core/pixelKernels.cpp",
+        "../core/previewCache.cpp",
+        "../core/previewWorker.cpp",
+        "../core/scanMetrics.cpp",
+        "../core/scanWorker.cpp",
+        "../core/separatorSheet.cpp",
+        "../core/sessionManager.cpp",
+        "../core/spoolFile.cpp",
+        "../core/spoolWorker.cpp",
+        "../core/streamWorker.cpp",
+        "../core/thumbnailPyramid.cpp",
+        "../imaging/binarize.cpp",
+        "../imaging/documentDetect.cpp",
+        "../imaging/threadPool.cpp"
       ],
       "include_dirs": [
-        "<!@(node -p \"require('node-addon-api').include\")"
+        "<!@(node -p \"require('node-addon-api').include\")",
+        "../core",
+        "../imaging"
       ],
       "defines": ["NAPI_DISABLE_CPP_EXCEPTIONS"],
       "conditions": [
@@ -18,10 +54,14 @@
               "ExceptionHandling": 1
             }
           },
+          "include_dirs": [
+            "<(libjpeg_turbo_dir)/include"
+          ],
           "libraries": [
             "-lkernel32.lib",
             "-luser32.lib",
-            "-lgdi32.lib"
+            "-lgdi32.lib",
+            "<(libjpeg_turbo_dir)/lib/jpeg-static.lib"
           ]
         }]
       ]
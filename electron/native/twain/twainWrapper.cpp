@@ -6,180 +6,126 @@
  */
 
 #include "twainWrapper.h"
+#include "scanArea.h"
 
 namespace TwainWrapper {
 
-Napi::Object TwainScanner::Init(Napi::Env env, Napi::Object exports) {
-    Napi::Function func = DefineClass(env, "TwainScanner", {
-        InstanceMethod("initialize", &TwainScanner::Initialize),
-        InstanceMethod("enumerateDevices", &TwainScanner::EnumerateDevices),
-        InstanceMethod("selectDevice", &TwainScanner::SelectDevice),
-        InstanceMethod("getCapabilities", &TwainScanner::GetCapabilities),
-        InstanceMethod("scan", &TwainScanner::Scan),
-        InstanceMethod("cancelScan", &TwainScanner::CancelScan),
-        InstanceMethod("close", &TwainScanner::Close),
-    });
-
-    Napi::FunctionReference* constructor = new Napi::FunctionReference();
-    *constructor = Napi::Persistent(func);
-    env.SetInstanceData(constructor);
-
-    exports.Set("TwainScanner", func);
-    return exports;
-}
-
-TwainScanner::TwainScanner(const Napi::CallbackInfo& info)
-    : Napi::ObjectWrap<TwainScanner>(info), isInitialized_(false) {
-    // Constructor
-}
-
-Napi::Value TwainScanner::Initialize(const Napi::CallbackInfo& info) {
-    Napi::Env env = info.Env();
+TwainScanner::TwainScanner(const Napi::CallbackInfo& info) : ScannerObject<TwainScanner>(info) {}
 
+bool TwainScanner::LoadDriver(std::string& error) {
     // TODO: Implement actual TWAIN initialization
-    // - Load TWAIN DSM (Data Source Manager)
-    // - Open DSM connection
+    // - Load TWAIN DSM (Data Source Manager): LoadLibrary("TWAINDSM.dll")
+    // - Open DSM connection (MSG_OPENDSM) with a hidden window owned by
+    //   the registry thread, which then pumps its messages
     // - Initialize state machine
-
-    isInitialized_ = true;
-
-    return Napi::Boolean::New(env, true);
+    // On failure set error and return false.
+    (void)error;
+    return true;
 }
 
-Napi::Value TwainScanner::EnumerateDevices(const Napi::CallbackInfo& info) {
-    Napi::Env env = info.Env();
+void TwainScanner::OnInitialize() {
+    // TODO: RegisterDeviceNotification() for WM_DEVICECHANGE and call
+    // registry_->Invalidate() on DBT_DEVICEARRIVAL / DBT_DEVICEREMOVECOMPLETE
+}
 
-    if (!isInitialized_) {
-        Napi::Error::New(env, "TWAIN not initialized").ThrowAsJavaScriptException();
-        return env.Null();
-    }
+void TwainScanner::OnClose() {
+    // TODO: Close DSM (MSG_CLOSEDSM); data sources close with their sessions
+}
 
+std::vector<ScannerDevice> TwainScanner::ProbeDevices() {
     // TODO: Implement actual device enumeration
-    // - Enumerate TWAIN data sources
+    // - Enumerate TWAIN data sources (MSG_GETFIRST / MSG_GETNEXT)
     // - Get device info for each source
 
-    // Placeholder: Return empty array
-    Napi::Array devices = Napi::Array::New(env);
-
     // Mock device for development
-    Napi::Object mockDevice = Napi::Object::New(env);
-    mockDevice.Set("id", "twain-mock-001");
-    mockDevice.Set("name", "TWAIN Mock Scanner");
-    mockDevice.Set("manufacturer", "PaperFlow");
-    mockDevice.Set("model", "Virtual Scanner");
-    mockDevice.Set("available", true);
-    mockDevice.Set("platform", "twain");
-
-    Napi::Object capabilities = Napi::Object::New(env);
-    capabilities.Set("hasFlatbed", true);
-    capabilities.Set("hasADF", true);
-    capabilities.Set("duplex", true);
-
-    Napi::Array resolutions = Napi::Array::New(env, 4);
-    resolutions.Set((uint32_t)0, 75);
-    resolutions.Set((uint32_t)1, 150);
-    resolutions.Set((uint32_t)2, 300);
-    resolutions.Set((uint32_t)3, 600);
-    capabilities.Set("resolutions", resolutions);
-
-    Napi::Array colorModes = Napi::Array::New(env, 3);
-    colorModes.Set((uint32_t)0, "color");
-    colorModes.Set((uint32_t)1, "grayscale");
-    colorModes.Set((uint32_t)2, "blackwhite");
-    capabilities.Set("colorModes", colorModes);
-
-    Napi::Array paperSizes = Napi::Array::New(env, 4);
-    paperSizes.Set((uint32_t)0, "letter");
-    paperSizes.Set((uint32_t)1, "legal");
-    paperSizes.Set((uint32_t)2, "a4");
-    paperSizes.Set((uint32_t)3, "a5");
-    capabilities.Set("paperSizes", paperSizes);
-
-    capabilities.Set("maxWidth", 8.5);
-    capabilities.Set("maxHeight", 14.0);
-
-    mockDevice.Set("capabilities", capabilities);
-    devices.Set((uint32_t)0, mockDevice);
-
-    return devices;
+    ScannerDevice mockDevice;
+    mockDevice.id = "twain-mock-001";
+    mockDevice.name = "TWAIN Mock Scanner";
+    mockDevice.manufacturer = "PaperFlow";
+    mockDevice.model = "Virtual Scanner";
+    mockDevice.platform = "twain";
+    mockDevice.available = true;
+
+    ScannerCapabilities& capabilities = mockDevice.capabilities;
+    capabilities.hasFlatbed = true;
+    capabilities.hasADF = true;
+    capabilities.duplex = true;
+    capabilities.resolutions = {75, 150, 300, 600};
+    capabilities.colorModes = {"color", "grayscale", "blackwhite"};
+    capabilities.paperSizes = {"letter", "legal", "a4", "a5"};
+    capabilities.maxWidth = 8.5;
+    capabilities.maxHeight = 14.0;
+
+    return {mockDevice};
 }
 
-Napi::Value TwainScanner::SelectDevice(const Napi::CallbackInfo& info) {
-    Napi::Env env = info.Env();
-
-    if (info.Length() < 1 || !info[0].IsString()) {
-        Napi::TypeError::New(env, "Device ID expected").ThrowAsJavaScriptException();
-        return env.Null();
-    }
-
-    selectedDeviceId_ = info[0].As<Napi::String>().Utf8Value();
-
+std::shared_ptr<ScannerCore::ScanSession> TwainScanner::OpenDevice(const std::string& deviceId, std::string& error) {
     // TODO: Implement actual device selection
-    // - Open data source
+    // - Open data source (MSG_OPENDS) for this session
     // - Negotiate capabilities
-
-    return Napi::Boolean::New(env, true);
-}
-
-Napi::Value TwainScanner::GetCapabilities(const Napi::CallbackInfo& info) {
-    Napi::Env env = info.Env();
-
-    // TODO: Query actual device capabilities
-
-    Napi::Object capabilities = Napi::Object::New(env);
-    capabilities.Set("hasFlatbed", true);
-    capabilities.Set("hasADF", true);
-    capabilities.Set("duplex", true);
-
-    return capabilities;
+    // - ICAP_COMPRESSION MSG_GET: TWCP_JPEG (with TWSX_MEMFILE or
+    //   TWSX_FILE in ICAP_XFERMECH) and TWCP_GROUP4 (with TWSX_MEMORY) go
+    //   into session->transferEncodings; ProbeDevices() reports the same
+    //   values as capabilities.compression
+    (void)deviceId;
+    (void)error;
+    return std::make_shared<TwainSession>();
 }
 
-Napi::Value TwainScanner::Scan(const Napi::CallbackInfo& info) {
-    Napi::Env env = info.Env();
-
-    if (selectedDeviceId_.empty()) {
-        Napi::Error::New(env, "No device selected").ThrowAsJavaScriptException();
-        return env.Null();
-    }
-
+bool TwainScanner::AcquirePages(TwainSession& session,
+                                const ScanSettings& settings,
+                                int maxPages,
+                                ScannerCore::BandWriter& writer,
+                                std::string& error) {
     // TODO: Implement actual scanning
-    // - Set scan parameters
-    // - Enable data source
-    // - Transfer image data
+    // - Set scan parameters (ICAP_XFERMECH = TWSX_MEMORY, CAP_XFERCOUNT = maxPages or -1)
+    // - Enable data source once for the whole stack
+    // - Per sheet: writer.BeginPage() from DAT_IMAGEINFO, writer.Write() each
+    //   DAT_IMAGEMEMXFER strip, then writer.EndPage() and MSG_ENDXFER;
+    //   continue while TW_PENDINGXFERS.Count != 0 and EndPage() returns true,
+    //   otherwise MSG_RESET the pending transfers. EndPage() blocks while
+    //   the buffered pages are at settings.highWaterMark, so calling it
+    //   before MSG_ENDXFER holds the feeder instead of buffering more
     // - Disable data source
+    //
+    // settings.preview: ICAP_XRESOLUTION / ICAP_YRESOLUTION = lowest
+    // supported value >= settings.resolution, CAP_FEEDERENABLED = FALSE
+    //
+    // settings.scanArea (inches, when set): ICAP_UNITS = TWUN_INCHES, then
+    // DAT_IMAGELAYOUT / MSG_SET with TW_FRAME {left, top, left + width,
+    // top + height} as TW_FIX32; the source may round the frame, so read
+    // it back with MSG_GET before the transfer
+    //
+    // Compressed transfer, when TransferEncodingFor(settings,
+    // session.transferEncodings) is not Raw (the stream then goes into the
+    // result and the PDF without being decoded):
+    // - Jpeg: ICAP_COMPRESSION = TWCP_JPEG, ICAP_XFERMECH = TWSX_MEMFILE
+    //   (each DAT_IMAGEMEMFILEXFER block is part of the JFIF file); sources
+    //   without it use TWSX_FILE with ICAP_IMAGEFILEFORMAT = TWFF_JFIF and
+    //   the file is read back into writer.Write()
+    // - CcittG4: ICAP_COMPRESSION = TWCP_GROUP4, ICAP_PIXELFLAVOR =
+    //   TWPF_CHOCOLATE (0 = black), ICAP_XFERMECH = TWSX_MEMORY; strips are
+    //   raw T.6 data
+    // - BeginPage() with geometry.encoding set; G4 needs ImageLength from
+    //   DAT_IMAGEINFO (JPEG sizes come from the frame header)
+    // - If MSG_SET fails, fall back to the uncompressed memory transfer
+    //
+    // Cancellation: when Write() or EndPage() returns false because
+    // writer.Cancelled(), send DAT_PENDINGXFERS / MSG_RESET (MSG_ENDXFER
+    // first inside a transfer) so the feeder stops, then disable the source
+    (void)session;
+    (void)settings;
+    (void)maxPages;
+    (void)writer;
 
     // Placeholder result
-    Napi::Object result = Napi::Object::New(env);
-    result.Set("success", false);
-    result.Set("errorMessage", "TWAIN scanning not implemented - using mock scanner");
-
-    return result;
-}
-
-Napi::Value TwainScanner::CancelScan(const Napi::CallbackInfo& info) {
-    Napi::Env env = info.Env();
-
-    // TODO: Implement scan cancellation
-
-    return Napi::Boolean::New(env, true);
-}
-
-Napi::Value TwainScanner::Close(const Napi::CallbackInfo& info) {
-    Napi::Env env = info.Env();
-
-    // TODO: Implement cleanup
-    // - Close data source
-    // - Close DSM
-
-    isInitialized_ = false;
-    selectedDeviceId_.clear();
-
-    return Napi::Boolean::New(env, true);
+    error = "TWAIN scanning not implemented - using mock scanner";
+    return false;
 }
 
 // Module initialization
 Napi::Object Init(Napi::Env env, Napi::Object exports) {
-    return TwainScanner::Init(env, exports);
+    return TwainScanner::Export(env, exports, "TwainScanner");
 }
 
 NODE_API_MODULE(twain_wrapper, Init)
@@ -9,83 +9,56 @@
 #define TWAIN_WRAPPER_H
 
 #include <napi.h>
+#include <memory>
 #include <string>
 #include <vector>
+#include "scanTypes.h"
+#include "scannerObject.h"
 
 namespace TwainWrapper {
 
-/**
- * Scanner device information
- */
-struct ScannerDevice {
-    std::string id;
-    std::string name;
-    std::string manufacturer;
-    std::string model;
-    bool available;
-};
-
-/**
- * Scanner capabilities
- */
-struct ScannerCapabilities {
-    bool hasFlatbed;
-    bool hasADF;
-    bool duplex;
-    std::vector<int> resolutions;
-    std::vector<std::string> colorModes;
-    std::vector<std::string> paperSizes;
-    double maxWidth;
-    double maxHeight;
-};
+using ScannerCore::ScannerDevice;
+using ScannerCore::ScannerCapabilities;
+using ScannerCore::ScanSettings;
+using ScannerCore::ScanResult;
 
 /**
- * Scan settings
+ * Open TWAIN data source held by a scan session
  */
-struct ScanSettings {
-    int resolution;
-    std::string colorMode;
-    std::string paperSize;
-    bool useADF;
-    bool duplex;
-    int brightness;
-    int contrast;
-};
-
-/**
- * Scan result
- */
-struct ScanResult {
-    bool success;
-    std::string errorMessage;
-    std::string imageData; // Base64 encoded
-    int width;
-    int height;
-    int resolution;
-    std::string colorMode;
+struct TwainSession : ScannerCore::ScanSession {
+    // TODO: TW_IDENTITY of the opened data source; MSG_CLOSEDS in the destructor
 };
 
 /**
  * TWAIN wrapper class
  */
-class TwainScanner : public Napi::ObjectWrap<TwainScanner> {
+class TwainScanner : public ScannerCore::ScannerObject<TwainScanner> {
 public:
-    static Napi::Object Init(Napi::Env env, Napi::Object exports);
     TwainScanner(const Napi::CallbackInfo& info);
 
 private:
-    // Core methods
-    Napi::Value Initialize(const Napi::CallbackInfo& info);
-    Napi::Value EnumerateDevices(const Napi::CallbackInfo& info);
-    Napi::Value SelectDevice(const Napi::CallbackInfo& info);
-    Napi::Value GetCapabilities(const Napi::CallbackInfo& info);
-    Napi::Value Scan(const Napi::CallbackInfo& info);
-    Napi::Value CancelScan(const Napi::CallbackInfo& info);
-    Napi::Value Close(const Napi::CallbackInfo& info);
+    friend class ScannerCore::ScannerObject<TwainScanner>;
+    using Session = TwainSession;
+
+    // Driver load, runs once on the registry thread before the first probe
+    static bool LoadDriver(std::string& error);
+
+    // Driver setup on initialize() and teardown on close()
+    void OnInitialize();
+    void OnClose();
+
+    // Driver device probe, runs on the registry thread
+    static std::vector<ScannerDevice> ProbeDevices();
+
+    // Driver session open, runs on the JavaScript thread
+    static std::shared_ptr<ScannerCore::ScanSession> OpenDevice(const std::string& deviceId, std::string& error);
 
-    // State
-    bool isInitialized_;
-    std::string selectedDeviceId_;
+    // Driver acquisition, runs on the session's acquisition thread
+    static bool AcquirePages(TwainSession& session,
+                             const ScanSettings& settings,
+                             int maxPages,
+                             ScannerCore::BandWriter& writer,
+                             std::string& error);
 };
 
 } // namespace TwainWrapper
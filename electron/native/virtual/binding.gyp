@@ -0,0 +1,170 @@
+{
+  "variables": {
+    "conditions": [
+      ["OS=='win'", {
+        "libjpeg_turbo_dir%": "C:/libjpeg-turbo64"
+      }, {
+        "libjpeg_turbo_dir%": "/opt/homebrew/opt/jpeg-turbo"
+      }]
+    ]
+  },
+  "target_defaults": {
+    "cflags!": ["-fno-exceptions"],
+    "cflags_cc!": ["-fno-exceptions"],
+    "include_dirs": [
+      "../core",
+      "../imaging"
+    ],
+    "conditions": [
+      ["OS=='linux'", {
+        "libraries": [
+          "-ljpeg"
+        ]
+      }],
+      ["OS=='mac'", {
+        "include_dirs": [
+          "<(libjpeg_turbo_dir)/include"
+        ],
+        "link_settings": {
+          "libraries": [
+            "<(libjpeg_turbo_dir)/lib/libjpeg.a"
+          ]
+        }
+      }],
+      ["OS=='win'", {
+        "include_dirs": [
+          "<(libjpeg_turbo_dir)/include"
+        ],
+        "libraries": [
+          "<(libjpeg_turbo_dir)/lib/jpeg-static.lib"
+        ]
+      }]
+    ]
+  },
+  "targets": [
+    {
+      "target_name": "virtual_wrapper",
+      "sources": [
+        "virtualWrapper.cpp",
+        "pageSynth.cpp",
+        "virtualDevice.cpp",
+        "../core/bandStream.cpp",
+        "../core/batchWorker.cpp",
+        "../core/bitonalSink.cpp",
+        "../core/blankPage.cpp",
+        "../core/bufferPool.cpp",
+        "../core/cancelToken.cpp",
+        "../core/ccittG4Encoder.cpp",
+        "../core/deviceEvents.cpp",
+        "../core/deviceRegistry.cpp",
+        "../core/fileIo.cpp",
+        "../core/imageEncoder.cpp",
+        "../core/initWorker.cpp",
+        "../core/jpegEncoder.cpp",
+        "../core/metricsEvents.cpp",
+        "../core/napiConvert.cpp",
+        "../core/pageQueue.cpp",
+        "../core/pdfWriter.cpp",
+        "../core/pixelKernels.cpp",
+        "../core/previewCache.cpp",
+        "../core/previewWorker.cpp",
+        "../core/scanMetrics.cpp",
+        "../core/scanWorker.cpp",
+        "../core/separatorSheet.cpp",
+        "../core/sessionManager.cpp",
+        "../core/spoolFile.cpp",
+        "../core/spoolWorker.cpp",
+        "../core/streamWorker.cpp",
+        "../core/thumbnailPyramid.cpp",
+        "../imaging/binarize.cpp",
+        "../imaging/documentDetect.cpp",
+        "../imaging/threadPool.cpp"
+      ],
+      "include_dirs": [
+        "<!@(node -p \"require('node-addon-api').include\")"
+      ],
+      "defines": ["NAPI_DISABLE_CPP_EXCEPTIONS"]
+    },
+    {
+      "target_name": "scanner_benchmark",
+      "type": "executable",
+      "cflags_cc": ["-O3"],
+      "sources": [
+        "scanBenchmark.cpp",
+        "pageSynth.cpp",
+        "virtualDevice.cpp",
+        "../core/bandStream.cpp",
+        "../core/bitonalSink.cpp",
+        "../core/blankPage.cpp",
+        "../core/bufferPool.cpp",
+        "../core/cancelToken.cpp",
+        "../core/ccittG4Encoder.cpp",
+        "../core/fileIo.cpp",
+        "../core/imageEncoder.cpp",
+        "../core/jpegEncoder.cpp",
+        "../core/pageQueue.cpp",
+        "../core/pdfWriter.cpp",
+        "../core/pixelKernels.cpp",
+        "../core/scanMetrics.cpp",
+        "../core/thumbnailPyramid.cpp",
+        "../imaging/binarize.cpp",
+        "../imaging/documentDetect.cpp",
+        "../imaging/perspectiveWarp.cpp",
+        "../imaging/threadPool.cpp"
+      ],
+      "conditions": [
+        ["OS=='linux'", {
+          "libraries": [
+            "-lpthread"
+          ]
+        }],
+        ["OS=='mac'", {
+          "xcode_settings": {
+            "GCC_OPTIMIZATION_LEVEL": "3"
+          }
+        }],
+        ["OS=='win'", {
+          "msvs_settings": {
+            "VCCLCompilerTool": {
+              "Optimization": 2
+            }
+          },
+          "libraries": [
+            "psapi.lib"
+          ]
+        }]
+      ]
+    },
+    {
+      "target_name": "scanner_pipeline_tests",
+      "type": "executable",
+      "sources": [
+        "pipelineTests.cpp",
+        "../core/bandStream.cpp",
+        "../core/bitonalSink.cpp",
+        "../core/blankPage.cpp",
+        "../core/bufferPool.cpp",
+        "../core/cancelToken.cpp",
+        "../core/ccittG4Encoder.cpp",
+        "../core/fileIo.cpp",
+        "../core/imageEncoder.cpp",
+        "../core/jpegEncoder.cpp",
+        "../core/pageQueue.cpp",
+        "../core/pdfWriter.cpp",
+        "../core/pixelKernels.cpp",
+        "../core/scanMetrics.cpp",
+        "../core/spoolFile.cpp",
+        "../core/thumbnailPyramid.cpp",
+        "../imaging/binarize.cpp",
+        "../imaging/threadPool.cpp"
+      ],
+      "conditions": [
+        ["OS=='linux'", {
+          "libraries": [
+            "-lpthread"
+          ]
+        }]
+      ]
+    }
+  ]
+}
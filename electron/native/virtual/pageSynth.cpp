@@ -0,0 +1,223 @@
+/**
+ * Synthetic Page Generator Implementation
+ */
+
+#include "pageSynth.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace VirtualWrapper {
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+
+// A skewed sheet covers this share of the frame, so it stays on the bed
+// for skews up to about 6 degrees
+constexpr double kSkewedSheetScale = 0.88;
+
+constexpr int kPaper = 244;
+constexpr int kInk = 30;
+constexpr int kShowThrough = 230;
+constexpr int kBed = 28;
+
+inline uint32_t Hash(uint32_t a, uint32_t b, uint32_t c) {
+    uint32_t h = a * 0x9E3779B1u ^ (b + 0x7F4A7C15u) * 0x85EBCA77u ^ c * 0xC2B2AE3Du;
+    h ^= h >> 16;
+    h *= 0x7FEB352Du;
+    h ^= h >> 15;
+    h *= 0x846CA68Bu;
+    h ^= h >> 16;
+    return h;
+}
+
+inline uint8_t Clamp8(int v) {
+    return static_cast<uint8_t>(std::min(255, std::max(0, v)));
+}
+
+} // namespace
+
+bool ParseSyntheticContent(const std::string& name, SyntheticContent& content) {
+    if (name == "text") {
+        content = SyntheticContent::Text;
+    } else if (name == "photo") {
+        content = SyntheticContent::Photo;
+    } else if (name == "mixed") {
+        content = SyntheticContent::Mixed;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+PageSynthesizer::PageSynthesizer(const SyntheticPage& page)
+    : page_(page),
+      stride_(ScannerCore::MinStride(page.pixelFormat, page.width)),
+      color_(page.pixelFormat == ScannerCore::PixelFormat::Rgb24) {
+    const double radians = page.skewDegrees * kPi / 180.0;
+    cos_ = std::cos(radians);
+    sin_ = std::sin(radians);
+
+    const double scale = page.skewDegrees != 0.0 ? kSkewedSheetScale : 1.0;
+    sheetWidth_ = page.width * scale;
+    sheetHeight_ = page.height * scale;
+
+    const int dpi = std::max(1, page.resolution);
+    margin_ = static_cast<int>(dpi * 0.6);
+    lineHeight_ = std::max(3, dpi / 6);
+    glyphWidth_ = std::max(2, dpi / 15);
+    photoRight_ = margin_ + static_cast<int>(0.55 * (sheetWidth_ - 2 * margin_));
+    photoBottom_ = margin_ + static_cast<int>(0.3 * (sheetHeight_ - 2 * margin_));
+}
+
+uint8_t PageSynthesizer::TextInk(int u, int v) const {
+    const int right = static_cast<int>(sheetWidth_) - margin_;
+    const int bottom = static_cast<int>(sheetHeight_) - margin_;
+    if (u < margin_ || u >= right || v < margin_ || v >= bottom) {
+        return 0;
+    }
+
+    const uint32_t seed = page_.seed;
+    const int lu = u - margin_;
+    const int line = (v - margin_) / lineHeight_;
+    const int r = (v - margin_) % lineHeight_;
+
+    // Paragraph breaks, and a short last line before each
+    if (Hash(line, seed, 7) % 9 == 0) {
+        return 0;
+    }
+    if (Hash(line + 1, seed, 7) % 9 == 0) {
+        const int length = (right - margin_) * (40 + static_cast<int>(Hash(line, seed, 11) % 50)) / 100;
+        if (lu >= length) {
+            return 0;
+        }
+    }
+
+    const int cell = lu / glyphWidth_;
+    const int cu = lu % glyphWidth_;
+    if (Hash(line, cell, seed) % 6 == 0) {
+        return 0;  // word space
+    }
+
+    const uint32_t h = Hash(line, cell, seed ^ 0x5BD1E995u);
+    const int stroke = std::max(1, glyphWidth_ / 6);
+    const int advance = glyphWidth_ - std::max(1, glyphWidth_ / 5);
+    if (cu >= advance) {
+        return 0;
+    }
+
+    const int xTop = lineHeight_ * 35 / 100;
+    const int xBottom = lineHeight_ * 65 / 100;
+    const int top = (h & 1) ? lineHeight_ * 20 / 100 : xTop;
+    const int bottomRow = ((h >> 1) & 3) == 0 ? lineHeight_ * 78 / 100 : xBottom;
+    if (r < top || r >= bottomRow) {
+        return 0;
+    }
+
+    uint32_t strokes = (h >> 3) & 0x1F;
+    if (strokes == 0) {
+        strokes = 1;
+    }
+    const bool left = (strokes & 1) && cu < stroke;
+    const bool rightStem = (strokes & 2) && cu >= advance - stroke;
+    const bool inX = r >= xTop && r < xBottom;
+    const bool topBar = (strokes & 4) && inX && r < xTop + stroke;
+    const bool baseBar = (strokes & 8) && inX && r >= xBottom - stroke;
+    const int mid = (xTop + xBottom) / 2;
+    const bool midBar = (strokes & 16) && r >= mid - stroke / 2 && r < mid - stroke / 2 + stroke;
+    return left || rightStem || topBar || baseBar || midBar ? 1 : 0;
+}
+
+void PageSynthesizer::PhotoColor(int u, int v, uint8_t rgb[3]) const {
+    const double dpi = std::max(1, page_.resolution);
+    const double fx = u / dpi;
+    const double fy = v / dpi;
+    const double phase = (page_.seed % 97) * 0.1;
+    const int noise = static_cast<int>(Hash(u, v, page_.seed ^ 0xA5A5u) % 25) - 12;
+
+    rgb[0] = Clamp8(static_cast<int>(128 + 70 * std::sin(1.3 * fx + 0.7 * fy + phase)) + noise);
+    rgb[1] = Clamp8(static_cast<int>(120 + 60 * std::sin(0.9 * fx - 1.1 * fy + 2.0)) + noise);
+    rgb[2] = Clamp8(static_cast<int>(110 + 80 * std::cos(0.6 * fx + 1.7 * fy - phase)) + noise);
+}
+
+void PageSynthesizer::Sample(double u, double v, int x, int y, uint8_t rgb[3]) const {
+    const int noise = static_cast<int>(Hash(x, y, page_.seed) & 7) - 3;
+
+    if (u < 0.0 || v < 0.0 || u >= sheetWidth_ || v >= sheetHeight_) {
+        rgb[0] = rgb[1] = rgb[2] = Clamp8(kBed + noise);
+        return;
+    }
+
+    const int iu = static_cast<int>(u);
+    const int iv = static_cast<int>(v);
+    int value = kPaper;
+
+    if (page_.backSide) {
+        // Mirrored show-through of the front, and the odd speck of dust
+        if (TextInk(static_cast<int>(sheetWidth_) - 1 - iu, iv)) {
+            value = kShowThrough;
+        }
+        if (Hash(iu, iv, page_.seed ^ 0xD00Du) % 200000 == 0) {
+            value = 80;
+        }
+    } else {
+        const bool inPhoto =
+            iu >= margin_ && iv >= margin_ &&
+            (page_.content == SyntheticContent::Photo
+                 ? iu < static_cast<int>(sheetWidth_) - margin_ && iv < static_cast<int>(sheetHeight_) - margin_
+                 : page_.content == SyntheticContent::Mixed && iu < photoRight_ && iv < photoBottom_);
+        if (inPhoto) {
+            PhotoColor(iu, iv, rgb);
+            if (!color_) {
+                rgb[0] = rgb[1] = rgb[2] =
+                    static_cast<uint8_t>((54 * rgb[0] + 183 * rgb[1] + 19 * rgb[2]) >> 8);
+            }
+            return;
+        }
+        if (page_.content != SyntheticContent::Photo && TextInk(iu, iv)) {
+            value = kInk;
+        }
+    }
+
+    // Slightly warm paper in colour
+    rgb[0] = Clamp8(value + noise + (color_ ? 2 : 0));
+    rgb[1] = Clamp8(value + noise);
+    rgb[2] = Clamp8(value + noise - (color_ ? 5 : 0));
+}
+
+void PageSynthesizer::RenderRow(int y, uint8_t* out) const {
+    const double cx = page_.width / 2.0;
+    const double cy = page_.height / 2.0;
+    const double dy = y - cy;
+    // Sheet coordinates of x = 0; step by (cos, -sin) along the row
+    double u = -cos_ * cx + sin_ * dy + sheetWidth_ / 2.0;
+    double v = sin_ * cx + cos_ * dy + sheetHeight_ / 2.0;
+
+    if (page_.pixelFormat == ScannerCore::PixelFormat::BlackWhite1) {
+        std::memset(out, 0, stride_);
+    }
+
+    uint8_t rgb[3];
+    for (int x = 0; x < page_.width; x++, u += cos_, v -= sin_) {
+        Sample(u, v, x, y, rgb);
+        switch (page_.pixelFormat) {
+            case ScannerCore::PixelFormat::Rgb24:
+                out[3 * x] = rgb[0];
+                out[3 * x + 1] = rgb[1];
+                out[3 * x + 2] = rgb[2];
+                break;
+            case ScannerCore::PixelFormat::BlackWhite1:
+                // MSB first, 1 = white
+                if (rgb[0] >= 128) {
+                    out[x >> 3] |= static_cast<uint8_t>(0x80 >> (x & 7));
+                }
+                break;
+            default:
+                out[x] = rgb[0];
+                break;
+        }
+    }
+}
+
+} // namespace VirtualWrapper
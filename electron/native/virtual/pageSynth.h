@@ -0,0 +1,80 @@
+/**
+ * Synthetic Page Generator
+ *
+ * Renders realistic full-resolution scan pages for the virtual scanner:
+ * printed text (lines of glyph-like strokes in paragraphs), photos
+ * (smooth colour fields with sensor noise), a mix of both, and nearly
+ * blank duplex backs. A page can lie skewed on a dark bed so document
+ * detection and perspective correction have real work to do. Rows are
+ * rendered on demand, so the device streams a page without holding it,
+ * and the same seed always gives the same page.
+ */
+
+#ifndef VIRTUAL_PAGE_SYNTH_H
+#define VIRTUAL_PAGE_SYNTH_H
+
+#include <cstdint>
+#include <string>
+#include "pixelBuffer.h"
+
+namespace VirtualWrapper {
+
+enum class SyntheticContent {
+    Text,
+    Photo,
+    Mixed  // photo block in the top left, text around it
+};
+
+/**
+ * Parse "text", "photo" or "mixed"; false for anything else
+ */
+bool ParseSyntheticContent(const std::string& name, SyntheticContent& content);
+
+struct SyntheticPage {
+    int width = 0;   // pixels
+    int height = 0;
+    int resolution = 300;
+    ScannerCore::PixelFormat pixelFormat = ScannerCore::PixelFormat::Rgb24;  // Rgb24, Gray8 or BlackWhite1
+    SyntheticContent content = SyntheticContent::Mixed;
+    double skewDegrees = 0.0;  // non-zero: a smaller sheet rotated on a dark bed
+    bool backSide = false;     // duplex back: blank paper with faint show-through
+    uint32_t seed = 1;
+};
+
+class PageSynthesizer {
+public:
+    explicit PageSynthesizer(const SyntheticPage& page);
+
+    const SyntheticPage& Page() const { return page_; }
+    int Stride() const { return stride_; }
+
+    // Render scanline y into `out` (Stride() bytes)
+    void RenderRow(int y, uint8_t* out) const;
+
+private:
+    // Page-space sample at sheet coordinates (u, v): RGB, or gray in r
+    void Sample(double u, double v, int x, int y, uint8_t rgb[3]) const;
+    uint8_t TextInk(int u, int v) const;
+    void PhotoColor(int u, int v, uint8_t rgb[3]) const;
+
+    SyntheticPage page_;
+    int stride_;
+    bool color_;
+
+    // Sheet placement: rotation about the frame centre
+    double cos_;
+    double sin_;
+    double sheetWidth_;
+    double sheetHeight_;
+
+    // Layout in sheet pixels
+    int margin_;
+    int lineHeight_;
+    int glyphWidth_;
+    int photoRight_;
+    int photoBottom_;
+};
+
+} // namespace VirtualWrapper
+
+#endif // VIRTUAL_PAGE_SYNTH_H
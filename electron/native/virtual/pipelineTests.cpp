@@ -0,0 +1,281 @@
+/**
+ * Scanner Pipeline Tests
+ *
+ * Standalone test runner (the scanner_pipeline_tests target) for the
+ * parts of the core pipeline that need no driver and no N-API: band
+ * re-chunking and page spools. Exits non-zero and names the failed
+ * checks when any fail.
+ */
+
+#include "bandStream.h"
+#include "spoolFile.h"
+#include <cstdio>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <vector>
+
+using namespace ScannerCore;
+
+namespace {
+
+int failures = 0;
+
+#define CHECK(condition)                                                              \
+    do {                                                                              \
+        if (!(condition)) {                                                           \
+            std::fprintf(stderr, "  %s:%d: CHECK(%s)\n", __FILE__, __LINE__, #condition); \
+            failures++;                                                               \
+        }                                                                             \
+    } while (0)
+
+/**
+ * Records the bands a BandWriter emits
+ */
+class RecordingSink : public BandSink {
+public:
+    struct Band {
+        int firstRow;
+        int rows;
+        bool lastBand;
+    };
+
+    bool OnBand(const ScanBand& band) override {
+        bands.push_back({band.firstRow, band.rows, band.lastBand});
+        return true;
+    }
+
+    int LastBands() const {
+        int count = 0;
+        for (const Band& band : bands) {
+            count += band.lastBand ? 1 : 0;
+        }
+        return count;
+    }
+
+    std::vector<Band> bands;
+};
+
+constexpr int kBandRows = 4;
+constexpr int kWidth = 10;
+
+PageGeometry GrayPage(int height) {
+    return {kWidth, height, kWidth, PixelFormat::Gray8, 100};
+}
+
+// Write `rows` scanlines to one page and close it
+void WritePage(BandWriter& writer, const PageGeometry& geometry, int rows) {
+    std::vector<uint8_t> data(static_cast<size_t>(geometry.stride) * rows, 0x80);
+    CHECK(writer.BeginPage(geometry));
+    CHECK(writer.Write(data.data(), data.size()));
+    CHECK(writer.EndPage());
+}
+
+void TestKnownHeightPage() {
+    RecordingSink sink;
+    BandWriter writer(sink, kBandRows);
+    WritePage(writer, GrayPage(10), 10);
+
+    CHECK(sink.bands.size() == 3);
+    CHECK(sink.LastBands() == 1);
+    CHECK(sink.bands.back().lastBand);
+    CHECK(sink.bands.back().firstRow == 8);
+    CHECK(sink.bands.back().rows == 2);
+}
+
+void TestShortPageEndingOnBandBoundary() {
+    // The device reported 12 rows but ended the page after 8
+    RecordingSink sink;
+    BandWriter writer(sink, kBandRows);
+    WritePage(writer, GrayPage(12), 8);
+
+    CHECK(sink.bands.size() == 2);
+    CHECK(sink.LastBands() == 1);
+    CHECK(sink.bands.back().lastBand);
+    CHECK(sink.bands.back().firstRow == 4);
+    CHECK(sink.bands.back().rows == 4);
+}
+
+void TestUnknownHeightPage() {
+    RecordingSink sink;
+    BandWriter writer(sink, kBandRows);
+    WritePage(writer, GrayPage(0), 8);
+    WritePage(writer, GrayPage(0), 10);
+
+    CHECK(sink.bands.size() == 5);
+    CHECK(sink.LastBands() == 2);
+    CHECK(sink.bands[1].lastBand);
+    CHECK(sink.bands[1].rows == 4);
+    CHECK(sink.bands[4].lastBand);
+    CHECK(sink.bands[4].rows == 2);
+}
+
+void TestRejectsUnusableGeometry() {
+    RecordingSink sink;
+    BandWriter writer(sink, kBandRows);
+    const uint8_t row[kWidth] = {};
+
+    CHECK(!writer.BeginPage({kWidth, 10, 0, PixelFormat::Gray8, 100}));
+    CHECK(!writer.Write(row, sizeof(row)));
+    CHECK(!writer.BeginPage({0, 10, 0, PixelFormat::Gray8, 100}));
+    CHECK(!writer.BeginPage({kWidth, 10, kWidth - 1, PixelFormat::Gray8, 100}));
+    CHECK(sink.bands.empty());
+}
+
+// 10x10 gray page filled with `value`
+ScanResult GraySpoolPage(uint8_t value) {
+    ScanResult page{};
+    page.success = true;
+    page.width = kWidth;
+    page.height = kWidth;
+    page.stride = kWidth;
+    page.pixelFormat = PixelFormat::Gray8;
+    page.resolution = 100;
+    page.colorMode = "grayscale";
+    page.pixels = std::make_shared<PixelBuffer>(std::vector<uint8_t>(kWidth * kWidth, value));
+    return page;
+}
+
+// Spool of `pages` gray pages; page i is filled with byte i
+std::string WriteSpool(const char* name, int pages, std::vector<uint64_t>& offsets) {
+    const std::string path = (std::filesystem::temp_directory_path() / name).string();
+    SpoolWriter writer;
+    std::string error;
+    CHECK(writer.Open(path, false, error));
+    for (int i = 0; i < pages; i++) {
+        CHECK(writer.Append(GraySpoolPage(static_cast<uint8_t>(i)), error));
+    }
+    for (int i = 0; i < writer.PageCount(); i++) {
+        offsets.push_back(writer.PageOffset(i));
+    }
+    CHECK(writer.Close(error));
+    return path;
+}
+
+// Flip one data byte of the page whose record starts at `offset`
+void CorruptPage(const std::string& path, uint64_t offset) {
+    FILE* file = std::fopen(path.c_str(), "r+b");
+    CHECK(file != nullptr);
+    if (file) {
+        std::fseek(file, static_cast<long>(offset + 96 + 5), SEEK_SET);
+        std::fputc(0x55, file);
+        std::fclose(file);
+    }
+}
+
+void TestSpoolReadsOnePage() {
+    std::vector<uint64_t> offsets;
+    const std::string path = WriteSpool("pipeline-tests-one.spool", 3, offsets);
+    CHECK(offsets.size() == 3);
+    if (offsets.size() != 3) {
+        return;
+    }
+
+    // A corrupt neighbour does not keep one page from being read
+    CorruptPage(path, offsets[0]);
+
+    SpoolReader reader;
+    std::string error;
+    CHECK(reader.OpenPage(path, 2, offsets[2], error));
+    CHECK(reader.PageCount() == 1);
+    if (reader.PageCount() == 1) {
+        CHECK(reader.Page(0).index == 2);
+        CHECK(reader.Page(0).size == kWidth * kWidth);
+        CHECK(reader.Page(0).data[0] == 2);
+        CHECK(reader.Verify(0));
+    }
+
+    CHECK(reader.OpenPage(path, 0, offsets[0], error));
+    CHECK(!reader.Verify(0));
+
+    // Handles that do not name a record
+    CHECK(!reader.OpenPage(path, 1, offsets[2], error));
+    CHECK(!reader.OpenPage(path, 3, offsets[2], error));
+    CHECK(!reader.OpenPage(path, 1, offsets[1] + 8, error));
+
+    std::filesystem::remove(path);
+}
+
+void TestSpoolResumeDropsCorruptPages() {
+    std::vector<uint64_t> offsets;
+    const std::string path = WriteSpool("pipeline-tests-resume.spool", 3, offsets);
+    if (offsets.size() != 3) {
+        return;
+    }
+    CorruptPage(path, offsets[1]);
+
+    SpoolWriter writer;
+    std::string error;
+    CHECK(writer.Open(path, true, error));
+    CHECK(writer.PageCount() == 1);
+    CHECK(writer.CorruptPages() == 2);
+
+    // The next page goes where the first dropped one was
+    CHECK(writer.Append(GraySpoolPage(7), error));
+    CHECK(writer.PageOffset(1) == offsets[1]);
+    CHECK(writer.Close(error));
+
+    SpoolReader reader;
+    CHECK(reader.Open(path, error));
+    CHECK(reader.PageCount() == 2);
+    CHECK(reader.VerifyAll(error));
+    if (reader.PageCount() == 2) {
+        CHECK(reader.Page(1).data[0] == 7);
+    }
+
+    std::filesystem::remove(path);
+}
+
+void TestSpoolReplacedUnderLiveReader() {
+    std::vector<uint64_t> offsets;
+    const std::string path = WriteSpool("pipeline-tests-replace.spool", 3, offsets);
+
+    SpoolReader old;
+    std::string error;
+    CHECK(old.Open(path, error));
+    CHECK(old.PageCount() == 3);
+
+    // A new batch at the same path leaves the old mapping intact
+    offsets.clear();
+    WriteSpool("pipeline-tests-replace.spool", 1, offsets);
+    if (old.PageCount() == 3) {
+        CHECK(old.Page(2).data[0] == 2);
+        CHECK(old.Verify(2));
+    }
+
+    SpoolReader fresh;
+    CHECK(fresh.Open(path, error));
+    CHECK(fresh.PageCount() == 1);
+
+    std::filesystem::remove(path);
+}
+
+struct TestCase {
+    const char* name;
+    std::function<void()> run;
+};
+
+} // namespace
+
+int main() {
+    const std::vector<TestCase> tests = {
+        {"band writer: known-height page", TestKnownHeightPage},
+        {"band writer: short page ending on a band boundary", TestShortPageEndingOnBandBoundary},
+        {"band writer: unknown-height pages", TestUnknownHeightPage},
+        {"band writer: unusable geometry", TestRejectsUnusableGeometry},
+        {"spool: read one page by handle", TestSpoolReadsOnePage},
+        {"spool: resume drops corrupt pages", TestSpoolResumeDropsCorruptPages},
+        {"spool: replaced under a live reader", TestSpoolReplacedUnderLiveReader},
+    };
+
+    int failed = 0;
+    for (const TestCase& test : tests) {
+        const int before = failures;
+        test.run();
+        const bool passed = failures == before;
+        std::printf("%s %s\n", passed ? "ok  " : "FAIL", test.name);
+        failed += passed ? 0 : 1;
+    }
+    std::printf("%d of %zu passed\n", static_cast<int>(tests.size()) - failed, tests.size());
+    return failed == 0 ? 0 : 1;
+}
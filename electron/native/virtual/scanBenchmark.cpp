@@ -0,0 +1,505 @@
+/**
+ * Scanner Pipeline Benchmark
+ *
+ * Standalone tool (the scanner_benchmark target) that feeds the virtual
+ * scanner through the full batch pipeline: acquisition, document
+ * detection, perspective correction, compression and PDF output, with
+ * the same band writer, buffer pool, byte budget and work-stealing pool
+ * the addons use. It reports pages per minute, per-page latency
+ * percentiles and peak RSS. Runs are reproducible for a given seed, so
+ * the JSON output of two builds can be compared before an upgrade.
+ */
+
+#include "bandStream.h"
+#include "bitonalSink.h"
+#include "blankPage.h"
+#include "bufferPool.h"
+#include "documentDetect.h"
+#include "imageEncoder.h"
+#include "pageQueue.h"
+#include "pdfWriter.h"
+#include "perspectiveWarp.h"
+#include "pixelKernels.h"
+#include "scanMetrics.h"
+#include "threadPool.h"
+#include "thumbnailPyramid.h"
+#include "virtualDevice.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+using namespace ScannerCore;
+
+namespace {
+
+struct BenchmarkOptions {
+    int pages = 50;
+    int resolution = 300;
+    std::string colorMode = "color";
+    std::string compression = "auto";
+    std::string pdfPath = "scanner-benchmark.pdf";
+    std::string skipBlankPages = "none";
+    double blankThreshold = ScanSettings{}.blankThreshold;
+    int thumbnails = 0;
+    bool duplex = false;
+    bool json = false;
+    size_t highWaterMark = kDefaultHighWaterMark;
+    VirtualWrapper::VirtualDeviceOptions device;
+};
+
+/**
+ * Per-page stage times the scanner metrics do not cover
+ */
+struct StraightenTimes {
+    std::atomic<uint64_t> detectNs{0};
+    std::atomic<uint64_t> warpNs{0};
+    std::atomic<int> detected{0};
+};
+
+void PrintUsage() {
+    std::fprintf(stderr,
+                 "Usage: scanner_benchmark [options]\n"
+                 "  --pages N           pages to scan (default 50)\n"
+                 "  --ppm N             device speed in sheets/min, 0 = unthrottled (default 0)\n"
+                 "  --resolution DPI    default 300\n"
+                 "  --color MODE        color | grayscale | blackwhite (default color)\n"
+                 "  --content KIND      text | photo | mixed (default mixed)\n"
+                 "  --skew DEG          max sheet skew in degrees (default 3)\n"
+                 "  --duplex            scan both sides\n"
+                 "  --compression C     auto | jpeg | ccitt-g4 | none (default auto)\n"
+                 "  --device-compression  let the device compress pages (no detect, warp or encode)\n"
+                 "  --skip-blank MODE   drop blank pages: none | backs | all (default none)\n"
+                 "  --blank-threshold P ink coverage in percent that still counts as blank\n"
+                 "  --thumbnails N      thumbnail levels built per page, 0-3 (default 0)\n"
+                 "  --high-water BYTES  buffered bytes before the feeder pauses\n"
+                 "  --pdf PATH          output PDF (default scanner-benchmark.pdf)\n"
+                 "  --seed N            page generator seed (default 1)\n"
+                 "  --json              print the results as JSON\n");
+}
+
+bool ParseArgs(int argc, char** argv, BenchmarkOptions& options) {
+    options.device.pagesPerMinute = 0.0;
+    options.device.feederPages = 0;
+    options.device.maxSkew = 3.0;
+    options.device.hardwareCompression = false;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--duplex") {
+            options.duplex = true;
+        } else if (arg == "--json") {
+            options.json = true;
+        } else if (arg == "--device-compression") {
+            options.device.hardwareCompression = true;
+        } else if (!hasValue) {
+            return false;
+        } else if (arg == "--pages") {
+            options.pages = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--ppm") {
+            options.device.pagesPerMinute = std::max(0.0, std::atof(argv[++i]));
+        } else if (arg == "--resolution") {
+            options.resolution = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--color") {
+            options.colorMode = argv[++i];
+        } else if (arg == "--content") {
+            if (!VirtualWrapper::ParseSyntheticContent(argv[++i], options.device.content)) {
+                return false;
+            }
+        } else if (arg == "--skew") {
+            options.device.maxSkew = std::fabs(std::atof(argv[++i]));
+        } else if (arg == "--skip-blank") {
+            options.skipBlankPages = argv[++i];
+            BlankPageMode mode;
+            if (!ParseBlankPageMode(options.skipBlankPages, mode)) {
+                return false;
+            }
+        } else if (arg == "--blank-threshold") {
+            options.blankThreshold = std::max(0.0, std::atof(argv[++i]));
+        } else if (arg == "--thumbnails") {
+            options.thumbnails = std::max(0, std::min(std::atoi(argv[++i]), kMaxThumbnailLevels));
+        } else if (arg == "--compression") {
+            options.compression = argv[++i];
+        } else if (arg == "--high-water") {
+            options.highWaterMark = static_cast<size_t>(std::max(0.0, std::atof(argv[++i])));
+        } else if (arg == "--pdf") {
+            options.pdfPath = argv[++i];
+        } else if (arg == "--seed") {
+            options.device.seed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t PeakRssBytes() {
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return counters.PeakWorkingSetSize;
+    }
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#if defined(__APPLE__)
+    return static_cast<size_t>(usage.ru_maxrss);
+#else
+    return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+double Distance(const Imaging::Point& a, const Imaging::Point& b) {
+    return std::hypot(a.x - b.x, a.y - b.y);
+}
+
+/**
+ * Detect the sheet on the bed and warp it upright, as the scan dialog
+ * does after an ADF batch
+ */
+void StraightenPage(ScanResult& page, StraightenTimes& times) {
+    if (!page.success || !page.pixels ||
+        (page.pixelFormat != PixelFormat::Gray8 && page.pixelFormat != PixelFormat::Rgb24)) {
+        return;
+    }
+
+    const int channels = Channels(page.pixelFormat);
+    const Imaging::ImageView view{page.pixels->Data(), page.width, page.height, page.stride, channels};
+
+    uint64_t start = ScanMetrics::Now();
+    const Imaging::DetectionResult detection = Imaging::DetectDocument(view);
+    times.detectNs += ScanMetrics::Now() - start;
+    if (!detection.detected) {
+        return;
+    }
+    times.detected++;
+
+    const Imaging::Point* c = detection.corners;
+    const int width = static_cast<int>(std::lround(std::max(Distance(c[0], c[1]), Distance(c[3], c[2]))));
+    const int height = static_cast<int>(std::lround(std::max(Distance(c[0], c[3]), Distance(c[1], c[2]))));
+    if (width < 2 || height < 2) {
+        return;
+    }
+
+    start = ScanMetrics::Now();
+    std::vector<uint8_t> warped =
+        Imaging::WarpPerspective(view, Imaging::RectToQuad(detection.corners, width, height), width, height);
+    times.warpNs += ScanMetrics::Now() - start;
+
+    page.pixels = std::make_shared<PixelBuffer>(std::move(warped));
+    page.width = width;
+    page.height = height;
+    page.stride = width * channels;
+}
+
+/**
+ * Settings pages are assembled with on the acquisition thread: raw
+ * pixels, as in a batch scan
+ */
+ScanSettings RawPageSettings(const ScanSettings& settings) {
+    ScanSettings raw = settings;
+    raw.compression = "none";
+    raw.binarize = "none";
+    return raw;
+}
+
+/**
+ * Binarize and encode a raw page as the settings ask, replaying it as
+ * one band through the sinks the batch worker uses
+ */
+ScanResult EncodePage(ScanResult raw, int pageIndex, const ScanSettings& settings,
+                      const std::shared_ptr<BufferPool>& pool, ScanMetrics* metrics) {
+    if (!raw.success || raw.encoding != ImageEncoding::Raw ||
+        (!BinarizeEnabled(settings) && EncodingForSettings(settings) == ImageEncoding::Raw)) {
+        return raw;
+    }
+
+    PageGeometry geometry{raw.width, raw.height, raw.stride, raw.pixelFormat, raw.resolution};
+    PageAssembler page(settings, pool);
+    BitonalSink bitonal(page, settings, pool);
+    page.SetMetrics(metrics);
+    bitonal.SetMetrics(metrics);
+    bitonal.BeginPage(pageIndex, geometry);
+    if (bitonal.OnBand(ScanBand{std::move(raw.pixels), pageIndex, 0, raw.height, true, geometry})) {
+        bitonal.EndPage(pageIndex);
+    }
+    return page.TakeResult(settings);
+}
+
+/**
+ * Pipeline state shared by the acquisition thread and the pool tasks
+ */
+struct Pipeline {
+    Pipeline(const ScanSettings& scanSettings, size_t highWaterMark)
+        : settings(scanSettings), finishSettings(scanSettings), budget(highWaterMark) {
+        // Thumbnails come from the acquired bands, not the replayed page
+        finishSettings.thumbnailLevels = 0;
+    }
+
+    ScanSettings settings;
+    ScanSettings finishSettings;
+    ByteBudget budget;
+    std::shared_ptr<BufferPool> buffers = BufferPool::Create();
+    ScanMetrics metrics;
+    StraightenTimes straighten;
+    PdfWriter pdf;
+    int maxPages = 0;
+
+    // Written by the acquisition thread only
+    int acquired = 0;
+    int blankPages = 0;
+    uint64_t thumbnailBytes = 0;
+
+    // Written by the ordered output stage only
+    std::vector<double> latencyMs;
+    std::string error;
+
+    Imaging::ThreadPool::TaskHandle lastOutput;
+    std::atomic<bool> failed{false};
+};
+
+/**
+ * Assembles each page on the acquisition thread and hands it to the
+ * pool: detect and warp, then encode (parallel across pages), then the
+ * PDF append (in page order). Latency runs from the first row leaving
+ * the device to the page landing in the PDF.
+ */
+class BenchmarkSink : public BandSink {
+public:
+    explicit BenchmarkSink(Pipeline& pipeline)
+        : pipeline_(pipeline), raw_(RawPageSettings(pipeline.settings)), page_(raw_, pipeline.buffers) {
+        page_.SetMetrics(&pipeline.metrics);
+    }
+
+    void BeginPage(int pageIndex, const PageGeometry& geometry) override {
+        pageStartNs_ = ScanMetrics::Now();
+        page_.BeginPage(pageIndex, geometry);
+        detectBlank_ = BlankPageEligible(pipeline_.settings, pageIndex);
+        if (detectBlank_) {
+            blank_.BeginPage(geometry);
+        }
+    }
+
+    bool OnBand(const ScanBand& band) override {
+        if (detectBlank_) {
+            blank_.OnBand(band);
+        }
+        return page_.OnBand(band);
+    }
+
+    bool EndPage(int pageIndex) override {
+        if (pipeline_.failed) {
+            return false;
+        }
+
+        auto page = std::make_shared<ScanResult>(page_.TakeResult(raw_));
+        pipeline_.acquired++;
+        if (detectBlank_ && page->success) {
+            const double coverage = blank_.InkCoverage();
+            if (coverage >= 0.0 && coverage <= pipeline_.settings.blankThreshold) {
+                pipeline_.blankPages++;
+                pipeline_.metrics.DiscardPage(pageIndex);
+                return pipeline_.acquired < pipeline_.maxPages;
+            }
+        }
+
+        // What a UI would be sent ahead of the page
+        for (const PageThumbnail& thumbnail : page->thumbnails) {
+            pipeline_.thumbnailBytes += thumbnail.pixels->Size();
+        }
+        page->thumbnails.clear();
+
+        const size_t bytes = PageBytes(*page);
+        {
+            StageTimer timer(&pipeline_.metrics, MetricStage::QueueWait, pageIndex);
+            pipeline_.budget.Acquire(bytes);
+        }
+
+        Imaging::ThreadPool& pool = Imaging::ThreadPool::Shared();
+        Pipeline* pipeline = &pipeline_;
+        const uint64_t startNs = pageStartNs_;
+
+        auto finish = pool.Submit([pipeline, page, pageIndex]() {
+            try {
+                StraightenPage(*page, pipeline->straighten);
+                *page = EncodePage(std::move(*page), pageIndex, pipeline->finishSettings, pipeline->buffers,
+                                   &pipeline->metrics);
+            } catch (const std::exception& e) {
+                *page = ScanResult{};
+                page->success = false;
+                page->errorMessage = e.what();
+            }
+        });
+        pipeline_.lastOutput = pool.Submit([pipeline, page, pageIndex, bytes, startNs]() {
+            if (!pipeline->failed) {
+                if (!page->success) {
+                    pipeline->error = page->errorMessage;
+                    pipeline->failed = true;
+                } else {
+                    StageTimer timer(&pipeline->metrics, MetricStage::PdfWrite, pageIndex);
+                    if (!pipeline->pdf.AddPage(*page, pipeline->error)) {
+                        pipeline->failed = true;
+                    }
+                }
+                pipeline->metrics.FinishPage(pageIndex);
+                pipeline->latencyMs.push_back(static_cast<double>(ScanMetrics::Now() - startNs) / 1e6);
+            }
+            page->pixels.reset();
+            page->encoded.reset();
+            pipeline->budget.Release(bytes);
+        }, {finish, pipeline_.lastOutput});
+
+        return pipeline_.acquired < pipeline_.maxPages;
+    }
+
+private:
+    Pipeline& pipeline_;
+    ScanSettings raw_;
+    PageAssembler page_;
+    BlankPageDetector blank_;
+    bool detectBlank_ = false;
+    uint64_t pageStartNs_ = 0;
+};
+
+double Percentile(std::vector<double> values, double p) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    std::sort(values.begin(), values.end());
+    // Nearest rank
+    const size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * values.size()));
+    return values[std::min(values.size(), std::max<size_t>(rank, 1)) - 1];
+}
+
+double StageMeanMs(const MetricsSnapshot& snapshot, MetricStage stage) {
+    const StageStats& stats = snapshot.stages[static_cast<int>(stage)];
+    return stats.count > 0 ? static_cast<double>(stats.totalNs) / stats.count / 1e6 : 0.0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    BenchmarkOptions options;
+    if (!ParseArgs(argc, argv, options)) {
+        PrintUsage();
+        return 2;
+    }
+
+    ScanSettings settings{options.resolution, options.colorMode, "letter", true, options.duplex, 0, 0};
+    settings.compression = options.compression;
+    settings.highWaterMark = options.highWaterMark;
+    settings.skipBlankPages = options.skipBlankPages;
+    settings.blankThreshold = options.blankThreshold;
+    settings.thumbnailLevels = options.thumbnails;
+
+    Pipeline pipeline(settings, options.highWaterMark);
+    pipeline.maxPages = options.pages;
+    pipeline.latencyMs.reserve(options.pages);
+
+    if (!pipeline.pdf.Open(options.pdfPath, PdfInfo{}, pipeline.error)) {
+        std::fprintf(stderr, "scanner_benchmark: %s\n", pipeline.error.c_str());
+        return 1;
+    }
+
+    pipeline.buffers->ConfigureForScan(RawPageSettings(settings), kDefaultBandRows);
+    pipeline.metrics.BeginScan();
+
+    BenchmarkSink sink(pipeline);
+    BandWriter writer(sink, kDefaultBandRows, pipeline.buffers, &pipeline.metrics);
+
+    const uint64_t startNs = ScanMetrics::Now();
+    std::string acquireError;
+    const ImageEncoding transfer =
+        TransferEncodingFor(settings, VirtualWrapper::VirtualTransferEncodings(options.device));
+    const bool acquired =
+        VirtualWrapper::AcquireVirtualPages(options.device, settings, transfer, options.pages, writer, acquireError);
+    Imaging::ThreadPool::Shared().Wait(pipeline.lastOutput);
+    std::string closeError;
+    const bool closed = pipeline.pdf.Close(closeError);
+    const double wallSeconds = static_cast<double>(ScanMetrics::Now() - startNs) / 1e9;
+
+    if (!acquired || pipeline.failed || !closed) {
+        const std::string& message =
+            !acquireError.empty() ? acquireError : !pipeline.error.empty() ? pipeline.error : closeError;
+        std::fprintf(stderr, "scanner_benchmark: %s\n", message.c_str());
+        return 1;
+    }
+
+    const MetricsSnapshot snapshot = pipeline.metrics.Snapshot();
+    const int pages = static_cast<int>(pipeline.latencyMs.size());
+    const double pagesPerMinute = wallSeconds > 0.0 ? pipeline.acquired * 60.0 / wallSeconds : 0.0;
+    const double p50 = Percentile(pipeline.latencyMs, 50);
+    const double p99 = Percentile(pipeline.latencyMs, 99);
+    const double maxLatency = Percentile(pipeline.latencyMs, 100);
+    const size_t peakRss = PeakRssBytes();
+    const double detectMs = pages > 0 ? pipeline.straighten.detectNs / 1e6 / pages : 0.0;
+    const double warpMs = pipeline.straighten.detected > 0
+                              ? pipeline.straighten.warpNs / 1e6 / pipeline.straighten.detected
+                              : 0.0;
+
+    if (options.json) {
+        std::printf("{\"pages\":%d,\"blankPages\":%d,\"wallSeconds\":%.3f,\"pagesPerMinute\":%.1f,"
+                    "\"latencyMs\":{\"p50\":%.2f,\"p99\":%.2f,\"max\":%.2f},"
+                    "\"peakRssBytes\":%zu,\"pdfBytes\":%llu,\"thumbnailBytes\":%llu,\"simd\":\"%s\",\"stagesMeanMs\":{",
+                    pages, pipeline.blankPages, wallSeconds, pagesPerMinute, p50, p99, maxLatency, peakRss,
+                    static_cast<unsigned long long>(pipeline.pdf.BytesWritten()),
+                    static_cast<unsigned long long>(pipeline.thumbnailBytes), SimdLevelName(ActiveSimdLevel()));
+        for (int i = 0; i < kMetricStageCount; i++) {
+            const MetricStage stage = static_cast<MetricStage>(i);
+            std::printf("\"%s\":%.3f,", MetricStageName(stage), StageMeanMs(snapshot, stage));
+        }
+        std::printf("\"detect\":%.3f,\"warp\":%.3f}}\n", detectMs, warpMs);
+        return 0;
+    }
+
+    std::printf("Scanner benchmark: %d pages, %d dpi %s, %s%s, %s compression%s, %u pool threads, %s\n", pages,
+                options.resolution, options.colorMode.c_str(),
+                options.device.content == VirtualWrapper::SyntheticContent::Text    ? "text"
+                : options.device.content == VirtualWrapper::SyntheticContent::Photo ? "photo"
+                                                                                      : "mixed",
+                options.duplex ? ", duplex" : "", options.compression.c_str(),
+                transfer != ImageEncoding::Raw ? " in the device" : "",
+                Imaging::ThreadPool::Shared().ThreadCount(), SimdLevelName(ActiveSimdLevel()));
+    if (pipeline.blankPages > 0) {
+        std::printf("  blank pages    %10d dropped\n", pipeline.blankPages);
+    }
+    std::printf("  wall time      %10.2f s\n", wallSeconds);
+    std::printf("  throughput     %10.1f pages/min\n", pagesPerMinute);
+    std::printf("  latency p50    %10.1f ms\n", p50);
+    std::printf("  latency p99    %10.1f ms\n", p99);
+    std::printf("  latency max    %10.1f ms\n", maxLatency);
+    std::printf("  peak RSS       %10.1f MB\n", peakRss / (1024.0 * 1024.0));
+    std::printf("  PDF            %10.1f MB  %s\n", pipeline.pdf.BytesWritten() / (1024.0 * 1024.0),
+                options.pdfPath.c_str());
+    if (pipeline.thumbnailBytes > 0) {
+        std::printf("  thumbnails     %10.1f MB\n", pipeline.thumbnailBytes / (1024.0 * 1024.0));
+    }
+    std::printf("  mean per page (ms):\n");
+    for (int i = 0; i < kMetricStageCount; i++) {
+        const MetricStage stage = static_cast<MetricStage>(i);
+        std::printf("    %-12s %8.2f\n", MetricStageName(stage), StageMeanMs(snapshot, stage));
+    }
+    std::printf("    %-12s %8.2f\n", "detect", detectMs);
+    std::printf("    %-12s %8.2f\n", "warp", warpMs);
+    return 0;
+}
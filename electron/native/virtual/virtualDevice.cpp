@@ -0,0 +1,217 @@
+/**
+ * Virtual Scanner Device Implementation
+ */
+
+#include "virtualDevice.h"
+#include "bufferPool.h"
+#include "imageEncoder.h"
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace VirtualWrapper {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Rows rendered per Write(), about one USB bulk transfer at 300 dpi colour
+constexpr int kWriteRows = 32;
+
+ScannerCore::PixelFormat FormatForSettings(const ScannerCore::ScanSettings& settings) {
+    if (settings.colorMode == "blackwhite") {
+        return ScannerCore::PixelFormat::BlackWhite1;
+    }
+    return settings.colorMode == "grayscale" ? ScannerCore::PixelFormat::Gray8 : ScannerCore::PixelFormat::Rgb24;
+}
+
+/**
+ * Skew of one sheet, evenly spread over +-maxSkew
+ */
+double SheetSkew(const VirtualDeviceOptions& options, int sheet) {
+    if (options.maxSkew <= 0.0) {
+        return 0.0;
+    }
+    uint32_t h = options.seed * 0x9E3779B1u ^ static_cast<uint32_t>(sheet) * 0x85EBCA77u;
+    h ^= h >> 15;
+    h *= 0x2C1B3C6Du;
+    h ^= h >> 12;
+    const double unit = (h % 20001) / 10000.0 - 1.0;
+    const double skew = unit * options.maxSkew;
+    // Exactly zero would place the sheet edge to edge with the frame
+    return skew != 0.0 ? skew : options.maxSkew / 2;
+}
+
+/**
+ * Compress one side as the device would, then write its stream in as
+ * many pieces as the raw transfer has row chunks, on the same schedule
+ */
+bool WriteEncodedSide(const PageSynthesizer& synth,
+                      ScannerCore::ImageEncoding transfer,
+                      int jpegQuality,
+                      Clock::time_point start,
+                      Clock::duration duration,
+                      ScannerCore::BandWriter& writer,
+                      std::vector<uint8_t>& rows,
+                      bool& more) {
+    const SyntheticPage& page = synth.Page();
+    ScannerCore::PageGeometry geometry{page.width, page.height, synth.Stride(), page.pixelFormat, page.resolution};
+    std::unique_ptr<ScannerCore::PageEncoder> encoder = ScannerCore::CreatePageEncoder(transfer, jpegQuality);
+    std::string error;
+    if (!encoder || !encoder->Begin(geometry, error)) {
+        return false;
+    }
+
+    const size_t stride = static_cast<size_t>(synth.Stride());
+    rows.resize(stride * kWriteRows);
+    for (int y = 0; y < page.height; y += kWriteRows) {
+        const int count = std::min(kWriteRows, page.height - y);
+        // The device-side encode runs before the first byte is written
+        if (writer.Cancelled()) {
+            return false;
+        }
+        for (int i = 0; i < count; i++) {
+            synth.RenderRow(y + i, rows.data() + stride * i);
+        }
+        if (!encoder->WriteRows(rows.data(), count, error)) {
+            return false;
+        }
+    }
+    if (!encoder->Finish(page.height, error)) {
+        return false;
+    }
+    std::shared_ptr<ScannerCore::PixelBuffer> stream = encoder->TakeOutput();
+
+    geometry.encoding = transfer;
+    if (!writer.BeginPage(geometry)) {
+        return false;
+    }
+
+    const size_t size = stream->Size();
+    const size_t pieces = static_cast<size_t>((page.height + kWriteRows - 1) / kWriteRows);
+    const size_t piece = std::max<size_t>(1, (size + pieces - 1) / pieces);
+    for (size_t offset = 0; offset < size; offset += piece) {
+        const size_t count = std::min(piece, size - offset);
+        if (duration.count() > 0) {
+            std::this_thread::sleep_until(start + duration * static_cast<double>(offset + count) / size);
+        }
+        if (!writer.Write(stream->Data() + offset, count)) {
+            return false;
+        }
+    }
+
+    more = writer.EndPage();
+    return true;
+}
+
+/**
+ * Stream one side, its rows spread evenly over [start, start + duration)
+ */
+bool WriteSide(const PageSynthesizer& synth,
+               const ScannerCore::ScanSettings& settings,
+               ScannerCore::ImageEncoding transfer,
+               Clock::time_point start,
+               Clock::duration duration,
+               ScannerCore::BandWriter& writer,
+               std::vector<uint8_t>& rows,
+               bool& more) {
+    if (transfer != ScannerCore::ImageEncoding::Raw) {
+        return WriteEncodedSide(synth, transfer, settings.jpegQuality, start, duration, writer, rows, more);
+    }
+
+    const SyntheticPage& page = synth.Page();
+    if (!writer.BeginPage({page.width, page.height, synth.Stride(), page.pixelFormat, page.resolution})) {
+        return false;
+    }
+
+    const size_t stride = static_cast<size_t>(synth.Stride());
+    rows.resize(stride * kWriteRows);
+    for (int y = 0; y < page.height; y += kWriteRows) {
+        const int count = std::min(kWriteRows, page.height - y);
+        for (int i = 0; i < count; i++) {
+            synth.RenderRow(y + i, rows.data() + stride * i);
+        }
+        if (duration.count() > 0) {
+            std::this_thread::sleep_until(start + duration * (y + count) / page.height);
+        }
+        if (!writer.Write(rows.data(), stride * count)) {
+            return false;
+        }
+    }
+
+    more = writer.EndPage();
+    return true;
+}
+
+} // namespace
+
+std::vector<ScannerCore::ImageEncoding> VirtualTransferEncodings(const VirtualDeviceOptions& options) {
+    if (!options.hardwareCompression) {
+        return {};
+    }
+    return {ScannerCore::ImageEncoding::Jpeg, ScannerCore::ImageEncoding::CcittG4};
+}
+
+bool AcquireVirtualPages(const VirtualDeviceOptions& options,
+                         const ScannerCore::ScanSettings& settings,
+                         ScannerCore::ImageEncoding transfer,
+                         int maxPages,
+                         ScannerCore::BandWriter& writer,
+                         std::string& error) {
+    SyntheticPage page;
+    ScannerCore::PagePixelSize(settings, page.width, page.height);
+    page.resolution = std::max(1, settings.resolution);
+    page.pixelFormat = FormatForSettings(settings);
+    page.content = options.content;
+    if (page.width <= 0 || page.height <= 0) {
+        error = "Empty scan area";
+        return false;
+    }
+
+    // The flatbed takes one page; previews never use the feeder
+    const bool feeder = settings.useADF && !settings.preview;
+    const bool duplex = feeder && settings.duplex;
+    int sheets = feeder ? options.feederPages : 1;
+    if (maxPages > 0) {
+        sheets = sheets > 0 ? std::min(sheets, maxPages) : maxPages;
+    }
+
+    const Clock::duration sheetTime =
+        options.pagesPerMinute > 0.0
+            ? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(60.0 / options.pagesPerMinute))
+            : Clock::duration::zero();
+    const Clock::duration sideTime = duplex ? sheetTime / 2 : sheetTime;
+
+    std::vector<uint8_t> rows;
+    Clock::time_point next = Clock::now();
+    for (int sheet = 0; sheets <= 0 || sheet < sheets; sheet++) {
+        page.seed = options.seed + static_cast<uint32_t>(sheet) * 2654435761u;
+        page.skewDegrees = feeder ? SheetSkew(options, sheet) : 0.0;
+
+        // Sides follow each other on the clock, so a slow consumer only
+        // delays the feeder rather than making it catch up in a burst
+        const Clock::time_point start = std::max(next, Clock::now());
+        bool more = true;
+
+        page.backSide = false;
+        if (!WriteSide(PageSynthesizer(page), settings, transfer, start, sideTime, writer, rows, more)) {
+            error = writer.Cancelled() ? ScannerCore::kScanCancelledMessage : "Transfer stopped";
+            return false;
+        }
+        if (duplex && more) {
+            page.backSide = true;
+            if (!WriteSide(PageSynthesizer(page), settings, transfer, start + sideTime, sideTime, writer, rows, more)) {
+                error = writer.Cancelled() ? ScannerCore::kScanCancelledMessage : "Transfer stopped";
+                return false;
+            }
+        }
+        if (!more) {
+            break;
+        }
+        next = start + sheetTime;
+    }
+    return true;
+}
+
+} // namespace VirtualWrapper
@@ -0,0 +1,56 @@
+/**
+ * Virtual Scanner Device
+ *
+ * Simulated high-speed ADF/flatbed scanner feeding synthetic pages
+ * through the shared band pipeline, at a configurable speed. A sheet
+ * takes 60 / pagesPerMinute seconds and its rows are written at an even
+ * pace over that time, like a real transfer; duplex sheets yield a
+ * front and a back image in the same time. Used by the virtual_wrapper
+ * addon and by the scanner_benchmark tool.
+ */
+
+#ifndef VIRTUAL_DEVICE_H
+#define VIRTUAL_DEVICE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "bandStream.h"
+#include "pageSynth.h"
+#include "scanTypes.h"
+
+namespace VirtualWrapper {
+
+struct VirtualDeviceOptions {
+    double pagesPerMinute = 60.0;  // sheets per minute; 0 = as fast as the pipeline takes them
+    int feederPages = 50;          // sheets in the ADF; 0 = never runs empty
+    SyntheticContent content = SyntheticContent::Mixed;
+    double maxSkew = 0.0;          // degrees; each sheet gets a random skew within +-maxSkew
+    uint32_t seed = 1;             // same seed, same pages
+    bool hardwareCompression = true;  // offer JPEG and G4 transfers like a production ADF
+};
+
+/**
+ * Compressed transfers the device offers with these options
+ */
+std::vector<ScannerCore::ImageEncoding> VirtualTransferEncodings(const VirtualDeviceOptions& options);
+
+/**
+ * Take up to maxPages sheets (0 = until the feeder is empty, or until
+ * EndPage() returns false when the feeder never runs empty). Settings
+ * pick the page size, resolution and colour mode; useADF and duplex
+ * select the feeder and back sides, otherwise a single flatbed page is
+ * scanned. With a transfer encoding other than Raw each side is
+ * compressed "in the device" and its stream is written instead of rows,
+ * paced the same way.
+ */
+bool AcquireVirtualPages(const VirtualDeviceOptions& options,
+                         const ScannerCore::ScanSettings& settings,
+                         ScannerCore::ImageEncoding transfer,
+                         int maxPages,
+                         ScannerCore::BandWriter& writer,
+                         std::string& error);
+
+} // namespace VirtualWrapper
+
+#endif // VIRTUAL_DEVICE_H
@@ -0,0 +1,145 @@
+/**
+ * Virtual Scanner Wrapper Implementation
+ */
+
+#include "virtualWrapper.h"
+#include "imageEncoder.h"
+#include "napiConvert.h"
+#include <cmath>
+
+namespace VirtualWrapper {
+
+VirtualScanner::VirtualScanner(const Napi::CallbackInfo& info) : ScannerObject<VirtualScanner>(info) {}
+
+std::vector<ScannerDevice> VirtualScanner::ProbeDevices() {
+    ScannerDevice adf;
+    adf.id = "virtual-adf";
+    adf.name = "PaperFlow Virtual ADF Scanner";
+    adf.manufacturer = "PaperFlow";
+    adf.model = "Virtual Duplex ADF";
+    adf.platform = "virtual";
+    adf.available = true;
+
+    ScannerCapabilities& capabilities = adf.capabilities;
+    capabilities.hasFlatbed = true;
+    capabilities.hasADF = true;
+    capabilities.duplex = true;
+    capabilities.resolutions = {75, 150, 200, 300, 600};
+    capabilities.colorModes = {"color", "grayscale", "blackwhite"};
+    capabilities.paperSizes = {"auto", "letter", "legal", "a4", "a5"};
+    capabilities.maxWidth = 8.5;
+    capabilities.maxHeight = 14.0;
+    capabilities.compression = {"jpeg", "ccitt-g4"};
+
+    ScannerDevice flatbed = adf;
+    flatbed.id = "virtual-flatbed";
+    flatbed.name = "PaperFlow Virtual Flatbed";
+    flatbed.model = "Virtual Flatbed";
+    flatbed.capabilities.hasADF = false;
+    flatbed.capabilities.duplex = false;
+    flatbed.capabilities.maxHeight = 11.69;
+
+    return {adf, flatbed};
+}
+
+std::shared_ptr<ScannerCore::ScanSession> VirtualScanner::OpenDevice(const std::string& deviceId, std::string& error) {
+    if (deviceId != "virtual-adf" && deviceId != "virtual-flatbed") {
+        error = "Unknown virtual device " + deviceId;
+        return nullptr;
+    }
+    return std::make_shared<VirtualSession>();
+}
+
+bool VirtualScanner::AcquirePages(VirtualSession& session,
+                                  const ScanSettings& settings,
+                                  int maxPages,
+                                  ScannerCore::BandWriter& writer,
+                                  std::string& error) {
+    VirtualDeviceOptions options;
+    {
+        std::lock_guard<std::mutex> lock(session.mutex);
+        options = session.options;
+    }
+    // The device's offer depends on its options, so it is negotiated
+    // per scan rather than once at open
+    const ScannerCore::ImageEncoding transfer =
+        ScannerCore::TransferEncodingFor(settings, VirtualTransferEncodings(options));
+    return AcquireVirtualPages(options, settings, transfer, maxPages, writer, error);
+}
+
+VirtualDeviceOptions VirtualScanner::ParseOptions(const Napi::Value& value, const VirtualDeviceOptions& base) {
+    VirtualDeviceOptions options = base;
+    if (!value.IsObject()) {
+        return options;
+    }
+    Napi::Object obj = value.As<Napi::Object>();
+
+    if (obj.Has("pagesPerMinute") && obj.Get("pagesPerMinute").IsNumber()) {
+        options.pagesPerMinute = std::max(0.0, obj.Get("pagesPerMinute").As<Napi::Number>().DoubleValue());
+    }
+    if (obj.Has("feederPages") && obj.Get("feederPages").IsNumber()) {
+        options.feederPages = std::max(0, obj.Get("feederPages").As<Napi::Number>().Int32Value());
+    }
+    if (obj.Has("content") && obj.Get("content").IsString()) {
+        SyntheticContent content;
+        if (ParseSyntheticContent(obj.Get("content").As<Napi::String>().Utf8Value(), content)) {
+            options.content = content;
+        }
+    }
+    if (obj.Has("maxSkew") && obj.Get("maxSkew").IsNumber()) {
+        options.maxSkew = std::fabs(obj.Get("maxSkew").As<Napi::Number>().DoubleValue());
+    }
+    if (obj.Has("seed") && obj.Get("seed").IsNumber()) {
+        options.seed = obj.Get("seed").As<Napi::Number>().Uint32Value();
+    }
+    if (obj.Has("hardwareCompression") && obj.Get("hardwareCompression").IsBoolean()) {
+        options.hardwareCompression = obj.Get("hardwareCompression").As<Napi::Boolean>().Value();
+    }
+    return options;
+}
+
+Napi::Value VirtualScanner::ApplyOptions(const Napi::CallbackInfo& info,
+                                         const std::shared_ptr<ScannerCore::ScanSession>& session,
+                                         size_t index) {
+    Napi::Env env = info.Env();
+    if (info.Length() <= index || !info[index].IsObject()) {
+        Napi::TypeError::New(env, "Options object expected").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    VirtualSession& device = static_cast<VirtualSession&>(*session);
+    std::lock_guard<std::mutex> lock(device.mutex);
+    device.options = ParseOptions(info[index], device.options);
+    return Napi::Boolean::New(env, true);
+}
+
+std::vector<VirtualScanner::Descriptor> VirtualScanner::ExtraMethods() {
+    return {
+        InstanceMethod("configure", &VirtualScanner::Configure),
+        InstanceMethod("sessionConfigure", &VirtualScanner::SessionConfigure),
+    };
+}
+
+Napi::Value VirtualScanner::Configure(const Napi::CallbackInfo& info) {
+    std::shared_ptr<ScannerCore::ScanSession> session = Selected(info);
+    if (!session) {
+        return info.Env().Null();
+    }
+    return ApplyOptions(info, session, 0);
+}
+
+Napi::Value VirtualScanner::SessionConfigure(const Napi::CallbackInfo& info) {
+    std::shared_ptr<ScannerCore::ScanSession> session = ScannerCore::SessionFromArgs(info, sessions_);
+    if (!session) {
+        return info.Env().Null();
+    }
+    return ApplyOptions(info, session, 1);
+}
+
+Napi::Object Init(Napi::Env env, Napi::Object exports) {
+    return VirtualScanner::Export(env, exports, "VirtualScanner");
+}
+
+NODE_API_MODULE(virtual_wrapper, Init)
+
+} // namespace VirtualWrapper
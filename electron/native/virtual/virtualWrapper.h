@@ -0,0 +1,71 @@
+/**
+ * Virtual Scanner Wrapper Header
+ *
+ * Native Node.js addon exposing a simulated scanner with the same API
+ * as the platform wrappers, for development and performance testing.
+ * Pages are synthesised at full resolution and fed at a configurable
+ * speed through the shared acquisition pipeline.
+ */
+
+#ifndef VIRTUAL_WRAPPER_H
+#define VIRTUAL_WRAPPER_H
+
+#include <napi.h>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "scanTypes.h"
+#include "scannerObject.h"
+#include "virtualDevice.h"
+
+namespace VirtualWrapper {
+
+using ScannerCore::ScannerDevice;
+using ScannerCore::ScannerCapabilities;
+using ScannerCore::ScanSettings;
+using ScannerCore::ScanResult;
+
+/**
+ * Open virtual device; its options can change between scans
+ */
+struct VirtualSession : ScannerCore::ScanSession {
+    std::mutex mutex;
+    VirtualDeviceOptions options;
+};
+
+class VirtualScanner : public ScannerCore::ScannerObject<VirtualScanner> {
+public:
+    VirtualScanner(const Napi::CallbackInfo& info);
+
+private:
+    friend class ScannerCore::ScannerObject<VirtualScanner>;
+    using Session = VirtualSession;
+
+    static std::vector<Descriptor> ExtraMethods();
+    Napi::Value Configure(const Napi::CallbackInfo& info);
+    Napi::Value SessionConfigure(const Napi::CallbackInfo& info);
+
+    // Device options from a JavaScript object; unset fields keep `base`
+    static VirtualDeviceOptions ParseOptions(const Napi::Value& value, const VirtualDeviceOptions& base);
+    static Napi::Value ApplyOptions(const Napi::CallbackInfo& info,
+                                    const std::shared_ptr<ScannerCore::ScanSession>& session,
+                                    size_t index);
+
+    // Driver device probe, runs on the registry thread
+    static std::vector<ScannerDevice> ProbeDevices();
+
+    // Driver session open, runs on the JavaScript thread
+    static std::shared_ptr<ScannerCore::ScanSession> OpenDevice(const std::string& deviceId, std::string& error);
+
+    // Driver acquisition, runs on the session's acquisition thread
+    static bool AcquirePages(VirtualSession& session,
+                             const ScanSettings& settings,
+                             int maxPages,
+                             ScannerCore::BandWriter& writer,
+                             std::string& error);
+};
+
+} // namespace VirtualWrapper
+
+#endif // VIRTUAL_WRAPPER_H
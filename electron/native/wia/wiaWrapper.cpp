@@ -6,79 +6,75 @@
  */
 
 #include "wiaWrapper.h"
+#include "scanArea.h"
 
 namespace WiaWrapper {
 
-Napi::Object WiaScanner::Init(Napi::Env env, Napi::Object exports) {
-    Napi::Function func = DefineClass(env, "WiaScanner", {
-        InstanceMethod("initialize", &WiaScanner::Initialize),
-        InstanceMethod("enumerateDevices", &WiaScanner::EnumerateDevices),
-        InstanceMethod("selectDevice", &WiaScanner::SelectDevice),
-        InstanceMethod("getCapabilities", &WiaScanner::GetCapabilities),
-        InstanceMethod("scan", &WiaScanner::Scan),
-        InstanceMethod("cancelScan", &WiaScanner::CancelScan),
-        InstanceMethod("close", &WiaScanner::Close),
-    });
-
-    Napi::FunctionReference* constructor = new Napi::FunctionReference();
-    *constructor = Napi::Persistent(func);
-    env.SetInstanceData(constructor);
-
-    exports.Set("WiaScanner", func);
-    return exports;
-}
-
-WiaScanner::WiaScanner(const Napi::CallbackInfo& info)
-    : Napi::ObjectWrap<WiaScanner>(info), isInitialized_(false) {}
-
-Napi::Value WiaScanner::Initialize(const Napi::CallbackInfo& info) {
-    Napi::Env env = info.Env();
-    // TODO: Initialize WIA COM interface
-    isInitialized_ = true;
-    return Napi::Boolean::New(env, true);
-}
-
-Napi::Value WiaScanner::EnumerateDevices(const Napi::CallbackInfo& info) {
-    Napi::Env env = info.Env();
-    // TODO: Use IWiaDevMgr to enumerate WIA devices
-    return Napi::Array::New(env);
-}
-
-Napi::Value WiaScanner::SelectDevice(const Napi::CallbackInfo& info) {
-    Napi::Env env = info.Env();
-    if (info.Length() < 1 || !info[0].IsString()) {
-        Napi::TypeError::New(env, "Device ID expected").ThrowAsJavaScriptException();
-        return env.Null();
-    }
-    selectedDeviceId_ = info[0].As<Napi::String>().Utf8Value();
-    return Napi::Boolean::New(env, true);
-}
-
-Napi::Value WiaScanner::GetCapabilities(const Napi::CallbackInfo& info) {
-    Napi::Env env = info.Env();
-    Napi::Object capabilities = Napi::Object::New(env);
-    return capabilities;
+WiaScanner::WiaScanner(const Napi::CallbackInfo& info) : ScannerObject<WiaScanner>(info) {}
+
+bool WiaScanner::LoadDriver(std::string& error) {
+    // TODO: Initialize WIA COM interface (CoInitializeEx on the registry
+    // thread, CoCreateInstance(CLSID_WiaDevMgr2)); register an
+    // IWiaEventCallback for WIA_EVENT_DEVICE_CONNECTED /
+    // WIA_EVENT_DEVICE_DISCONNECTED via
+    // IWiaDevMgr2::RegisterEventCallbackInterface that calls
+    // registry_->Invalidate(). On failure set error and return false.
+    (void)error;
+    return true;
 }
 
-Napi::Value WiaScanner::Scan(const Napi::CallbackInfo& info) {
-    Napi::Env env = info.Env();
-    Napi::Object result = Napi::Object::New(env);
-    result.Set("success", false);
-    result.Set("errorMessage", "WIA scanning not implemented");
-    return result;
+std::vector<ScannerDevice> WiaScanner::ProbeDevices() {
+    // TODO: Use IWiaDevMgr2::EnumDeviceInfo to enumerate WIA scanners
+    return {};
 }
 
-Napi::Value WiaScanner::CancelScan(const Napi::CallbackInfo& info) {
-    return Napi::Boolean::New(info.Env(), true);
+std::shared_ptr<ScannerCore::ScanSession> WiaScanner::OpenDevice(const std::string& deviceId, std::string& error) {
+    // TODO: IWiaDevMgr2::CreateDevice(deviceId) into the session root item;
+    // Jpeg in session->transferEncodings when the feeder item's
+    // WIA_IPA_FORMAT valid values include WiaImgFmt_JPEG (G4 only comes
+    // wrapped in TIFF, so it stays a software encoding)
+    (void)deviceId;
+    (void)error;
+    return std::make_shared<WiaSession>();
 }
 
-Napi::Value WiaScanner::Close(const Napi::CallbackInfo& info) {
-    isInitialized_ = false;
-    return Napi::Boolean::New(info.Env(), true);
+bool WiaScanner::AcquirePages(WiaSession& session,
+                              const ScanSettings& settings,
+                              int maxPages,
+                              ScannerCore::BandWriter& writer,
+                              std::string& error) {
+    // TODO: IWiaTransfer::Download on the feeder item with
+    // WIA_IPS_PAGES = maxPages; the transfer callback's per-page IStream
+    // forwards Write() calls to writer.Write(), with writer.BeginPage() /
+    // writer.EndPage() on page boundaries. Return S_FALSE from the callback
+    // when EndPage() returns false.
+    //
+    // settings.preview: WIA_DPS_PREVIEW = WIA_PREVIEW_SCAN and
+    // WIA_IPS_XRES / WIA_IPS_YRES = settings.resolution on the flatbed item
+    //
+    // settings.scanArea (inches, when set): WIA_IPS_XPOS / WIA_IPS_YPOS /
+    // WIA_IPS_XEXTENT / WIA_IPS_YEXTENT from ScanAreaToPixels(area, resolution),
+    // clipped with ClampScanArea() to WIA_IPS_MAX_HORIZONTAL_SIZE / _VERTICAL_SIZE
+    //
+    // TransferEncodingFor(settings, session.transferEncodings) == Jpeg:
+    // WIA_IPA_FORMAT = WiaImgFmt_JPEG, WIA_IPA_COMPRESSION =
+    // WIA_COMPRESSION_JPEG and WIA_IPA_TYMED = TYMED_FILE; each page's
+    // stream is then the JFIF file, so BeginPage() with geometry.encoding =
+    // ImageEncoding::Jpeg and Write() it unchanged
+    //
+    // Cancellation: the transfer callback returns S_FALSE as soon as
+    // writer.Cancelled() is set (checked on every WIA_TRANSFER_MSG_STATUS
+    // as well as in Write()), which ends IWiaTransfer::Download
+    (void)session;
+    (void)settings;
+    (void)maxPages;
+    (void)writer;
+    error = "WIA scanning not implemented";
+    return false;
 }
 
 Napi::Object Init(Napi::Env env, Napi::Object exports) {
-    return WiaScanner::Init(env, exports);
+    return WiaScanner::Export(env, exports, "WiaScanner");
 }
 
 NODE_API_MODULE(wia_wrapper, Init)
@@ -9,27 +9,48 @@
 #define WIA_WRAPPER_H
 
 #include <napi.h>
+#include <memory>
 #include <string>
 #include <vector>
+#include "scanTypes.h"
+#include "scannerObject.h"
 
 namespace WiaWrapper {
 
-class WiaScanner : public Napi::ObjectWrap<WiaScanner> {
+using ScannerCore::ScannerDevice;
+using ScannerCore::ScanSettings;
+using ScannerCore::ScanResult;
+
+/**
+ * Open WIA device held by a scan session
+ */
+struct WiaSession : ScannerCore::ScanSession {
+    // TODO: IWiaItem2 from IWiaDevMgr2::CreateDevice(); Release() it in the destructor
+};
+
+class WiaScanner : public ScannerCore::ScannerObject<WiaScanner> {
 public:
-    static Napi::Object Init(Napi::Env env, Napi::Object exports);
     WiaScanner(const Napi::CallbackInfo& info);
 
 private:
-    Napi::Value Initialize(const Napi::CallbackInfo& info);
-    Napi::Value EnumerateDevices(const Napi::CallbackInfo& info);
-    Napi::Value SelectDevice(const Napi::CallbackInfo& info);
-    Napi::Value GetCapabilities(const Napi::CallbackInfo& info);
-    Napi::Value Scan(const Napi::CallbackInfo& info);
-    Napi::Value CancelScan(const Napi::CallbackInfo& info);
-    Napi::Value Close(const Napi::CallbackInfo& info);
-
-    bool isInitialized_;
-    std::string selectedDeviceId_;
+    friend class ScannerCore::ScannerObject<WiaScanner>;
+    using Session = WiaSession;
+
+    // Driver load, runs once on the registry thread before the first probe
+    static bool LoadDriver(std::string& error);
+
+    // Driver device probe, runs on the registry thread
+    static std::vector<ScannerDevice> ProbeDevices();
+
+    // Driver session open, runs on the JavaScript thread
+    static std::shared_ptr<ScannerCore::ScanSession> OpenDevice(const std::string& deviceId, std::string& error);
+
+    // Driver acquisition, runs on the session's acquisition thread
+    static bool AcquirePages(WiaSession& session,
+                             const ScanSettings& settings,
+                             int maxPages,
+                             ScannerCore::BandWriter& writer,
+                             std::string& error);
 };
 
 } // namespace WiaWrapper
@@ -19,10 +19,22 @@ interface TaskMessage {
       inputPath: string;
       outputPath: string;
       options: unknown;
+      pages?: PageImage[];
     };
   };
 }
 
+/**
+ * Encoded page received in memory (moved, not copied, from the pool)
+ */
+interface PageImage {
+  data: Uint8Array;
+  encoding: 'jpeg' | 'png';
+  width: number;
+  height: number;
+  resolution: number;
+}
+
 /**
  * Send progress update
  */
@@ -210,6 +222,47 @@ async function splitPdf(
   return { parts: totalParts, totalPages };
 }
 
+/**
+ * Images to PDF operation, one page per image at its scan resolution
+ */
+async function imagesToPdf(
+  taskId: string,
+  pages: PageImage[],
+  outputPath: string
+): Promise<{ size: number; pageCount: number }> {
+  sendProgress(taskId, 5);
+
+  const pdfDoc = await PDFDocument.create();
+
+  for (let i = 0; i < pages.length; i++) {
+    const page = pages[i]!;
+    const image =
+      page.encoding === 'png'
+        ? await pdfDoc.embedPng(page.data)
+        : await pdfDoc.embedJpg(page.data);
+
+    // Page size in points from the scan resolution; a page without one
+    // is laid out at 72 dpi, one point per pixel
+    const dpi = page.resolution > 0 ? page.resolution : 72;
+    const width = (page.width / dpi) * 72;
+    const height = (page.height / dpi) * 72;
+    pdfDoc.addPage([width, height]).drawImage(image, { x: 0, y: 0, width, height });
+
+    sendProgress(taskId, 5 + Math.round(((i + 1) / pages.length) * 85));
+  }
+
+  pdfDoc.setProducer('PaperFlow');
+  pdfDoc.setCreationDate(new Date());
+
+  // Save
+  const outputBytes = await pdfDoc.save();
+  await writeFile(outputPath, outputBytes);
+
+  sendProgress(taskId, 100);
+
+  return { size: outputBytes.length, pageCount: pages.length };
+}
+
 /**
  * Add watermark operation
  */
@@ -323,6 +376,10 @@ parentPort?.on('message', async (message: TaskMessage) => {
         );
         break;
 
+      case 'imagesToPdf':
+        result = await imagesToPdf(task.id, payload.pages ?? [], payload.outputPath);
+        break;
+
       case 'watermark':
         result = await addWatermark(
           task.id,
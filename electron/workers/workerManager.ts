@@ -4,9 +4,20 @@
  */
 
 import { EventEmitter } from 'events';
-import { WorkerPool, createWorkerPool } from './workerPool';
+import { WorkerPool, createWorkerPool, transferableBuffers } from './workerPool';
 import type { WorkerTask, WorkerPoolConfig } from './workerPool';
 
+/**
+ * Encoded page handed to a worker in memory, e.g. a scan result's `data`
+ */
+export interface PageImageData {
+  data: Uint8Array;
+  encoding: 'jpeg' | 'png';
+  width: number;
+  height: number;
+  resolution: number;
+}
+
 /**
  * Batch processing task
  */
@@ -18,6 +29,11 @@ export interface BatchProcessingTask {
   outputPath: string;
   options: unknown;
   priority: number;
+  /**
+   * In-memory pages for the operation; their buffers move to the worker
+   * without a copy and are detached here once the task starts
+   */
+  pages?: PageImageData[];
 }
 
 /**
@@ -160,8 +176,12 @@ export class WorkerManager extends EventEmitter {
           inputPath: task.inputPath,
           outputPath: task.outputPath,
           options: task.options,
+          pages: task.pages,
         },
         priority: task.priority,
+        transferList: task.pages
+          ? transferableBuffers(task.pages.map((page) => page.data))
+          : undefined,
       };
 
       const result = await this.pool.submitTask(workerTask);
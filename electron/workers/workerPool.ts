@@ -3,7 +3,9 @@
  * Manages Node.js worker threads for parallel PDF processing.
  */
 
+import * as workerThreads from 'worker_threads';
 import { Worker } from 'worker_threads';
+import type { TransferListItem } from 'worker_threads';
 import { cpus } from 'os';
 import path from 'path';
 import { EventEmitter } from 'events';
@@ -17,6 +19,11 @@ export interface WorkerTask {
   payload: unknown;
   priority: number;
   timeout?: number;
+  /**
+   * Buffers referenced by `payload` that move to the worker instead of
+   * being copied; they are detached in this thread once the task starts
+   */
+  transferList?: TransferListItem[];
 }
 
 /**
@@ -30,6 +37,37 @@ export interface WorkerTaskResult {
   processingTime: number;
 }
 
+/**
+ * Node 21 and later can tell which buffers are marked untransferable;
+ * on older runtimes (tests under Node 20) only the pool check applies
+ */
+type MarkCheck = (buffer: object) => boolean;
+const isMarkedAsUntransferable: MarkCheck =
+  (workerThreads as { isMarkedAsUntransferable?: MarkCheck })
+    .isMarkedAsUntransferable ?? (() => false);
+
+/**
+ * Backing stores of `views` that can be moved to a worker. Shared memory
+ * needs no transfer, and buffers Node marks untransferable (pooled
+ * allocations, native external buffers) or shares with other data are
+ * left to be copied as before.
+ */
+export function transferableBuffers(views: ArrayBufferView[]): TransferListItem[] {
+  const buffers = new Set<ArrayBuffer>();
+  for (const view of views) {
+    const buffer = view.buffer;
+    if (
+      buffer instanceof ArrayBuffer &&
+      view.byteOffset === 0 &&
+      view.byteLength === buffer.byteLength &&
+      !isMarkedAsUntransferable(buffer)
+    ) {
+      buffers.add(buffer);
+    }
+  }
+  return Array.from(buffers);
+}
+
 /**
  * Pool configuration
  */
@@ -331,11 +369,15 @@ export class WorkerPool extends EventEmitter {
     availableWorker.currentTask = task;
     availableWorker.taskStartTime = Date.now();
 
-    // Send task to worker
-    availableWorker.worker.postMessage({
-      type: 'task',
-      task,
-    });
+    // Send task to worker, moving its transferable buffers
+    const { transferList, ...message } = task;
+    availableWorker.worker.postMessage(
+      {
+        type: 'task',
+        task: message,
+      },
+      transferList
+    );
 
     this.emit('taskStarted', { taskId: task.id, workerId: availableWorker.id });
   }
@@ -1,4 +1,4 @@
-import { Suspense, lazy } from 'react';
+import { Suspense, lazy, useEffect } from 'react';
 import { Routes, Route } from 'react-router-dom';
 import { LoadingIndicator } from '@components/ui/LoadingIndicator';
 
@@ -11,6 +11,14 @@ const Terms = lazy(() => import('@/pages/Terms'));
 const NotFound = lazy(() => import('@/pages/NotFound'));
 
 function App() {
+  // Load scanner drivers once the first screen is up, so the scanner
+  // dialog does not wait on them
+  useEffect(() => {
+    void import('@lib/scanner/scannerProvider').then(({ scannerProvider }) =>
+      scannerProvider.warmUp()
+    );
+  }, []);
+
   return (
     <Suspense fallback={<PageLoadingFallback />}>
       <Routes>
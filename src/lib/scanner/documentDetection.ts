@@ -5,7 +5,7 @@
  * detect and crop document boundaries.
  */
 
-import type { Point, Rectangle, DocumentDetectionResult } from './types';
+import type { Point, Rectangle, DocumentDetectionResult, ScanArea } from './types';
 
 /**
  * Edge detection options
@@ -501,6 +501,23 @@ export class DocumentDetection {
     return true;
   }
 
+  /**
+   * Turn a crop rectangle detected in an image scanned at `resolution`
+   * into a hardware scan area (inches), padded by `margin` inches, so
+   * the next scan transfers only the document
+   */
+  static cropRectToScanArea(cropRect: Rectangle, resolution: number, margin = 0.125): ScanArea {
+    const left = Math.max(0, cropRect.x / resolution - margin);
+    const top = Math.max(0, cropRect.y / resolution - margin);
+
+    return {
+      left,
+      top,
+      width: (cropRect.x + cropRect.width) / resolution + margin - left,
+      height: (cropRect.y + cropRect.height) / resolution + margin - top,
+    };
+  }
+
   /**
    * Convert quadrilateral to bounding rectangle
    */
@@ -55,6 +55,22 @@ export interface PageOCRResult {
   height: number;
 }
 
+/**
+ * Page pre-processed for OCR by the native imaging addon
+ * (`prepareForOcr()`): grayscale, median-denoised, deskewed and either
+ * contrast-boosted or binarized, as a complete binary PGM/PBM file that
+ * Tesseract reads without a PNG round trip. Word boxes refer to the
+ * deskewed page.
+ */
+export interface PreparedOCRImage {
+  data: ArrayBuffer;
+  format: 'pgm' | 'pbm';
+  width: number;
+  height: number;
+  /** Skew that was corrected, in degrees (positive = lines fell to the right) */
+  skewAngle: number;
+}
+
 /**
  * Scan OCR Service
  */
@@ -94,11 +110,13 @@ export class ScanOCR {
   }
 
   /**
-   * Perform OCR on a scan result
+   * Perform OCR on a scan result. With a natively prepared image the
+   * page goes to the engine as-is and the canvas is skipped entirely.
    */
   async recognize(
     scan: ScanResult,
-    settings: Partial<InternalOCRSettings> = {}
+    settings: Partial<InternalOCRSettings> = {},
+    prepared?: PreparedOCRImage
   ): Promise<PageOCRResult> {
     const opts = { ...DEFAULT_OCR_SETTINGS, ...settings };
 
@@ -108,11 +126,13 @@ export class ScanOCR {
       throw new Error('OCR worker not initialized');
     }
 
-    if (!scan.dataUrl) {
+    if (!prepared && !scan.dataUrl) {
       throw new Error('Scan has no image data');
     }
 
-    const result = await this.worker.recognize(scan.dataUrl);
+    const result = await this.worker.recognize(
+      prepared ? new Blob([prepared.data]) : (scan.dataUrl as string)
+    );
     const data = result.data as Page;
 
     // Extract words with positioning
@@ -148,8 +168,8 @@ export class ScanOCR {
       words: words.filter((w) => w.confidence >= opts.confidence),
       lines: lines.filter((l) => l.confidence >= opts.confidence),
       paragraphs,
-      width: scan.width || 0,
-      height: scan.height || 0,
+      width: prepared?.width ?? scan.width ?? 0,
+      height: prepared?.height ?? scan.height ?? 0,
     };
   }
 
@@ -218,7 +238,9 @@ export class ScanOCR {
   }
 
   /**
-   * Preprocess image for better OCR results
+   * Preprocess image for better OCR results. Canvas fallback for when
+   * the native imaging addon is unavailable; its prepareForOcr() also
+   * deskews and denoises and yields a PreparedOCRImage for recognize().
    */
   static async preprocessForOCR(dataUrl: string): Promise<string> {
     return new Promise((resolve) => {
@@ -22,7 +22,11 @@ import type {
 export interface PlatformScanner {
   /** Platform type */
   platform: ScannerPlatform;
-  /** Initialize the scanner driver */
+  /**
+   * Load the scanner driver. Called on first scanner use or from an
+   * idle warm-up, never at startup, so implementations should defer
+   * requiring their native addon until here.
+   */
   initialize(): Promise<boolean>;
   /** Check if platform is available */
   isAvailable(): Promise<boolean>;
@@ -53,6 +57,12 @@ const DEFAULT_SCAN_SETTINGS: ScanSettings = {
   autoCorrect: true,
 };
 
+/**
+ * How long after the first paint an idle warm-up may wait for the
+ * renderer to go idle before loading the drivers anyway
+ */
+const WARM_UP_TIMEOUT_MS = 5000;
+
 /**
  * Scanner Provider - Unified scanner interface
  */
@@ -63,6 +73,10 @@ export class ScannerProvider {
   private selectedDevice: ScannerDevice | null = null;
   private listeners: Map<ScanEvent, ScanEventCallback[]> = new Map();
   private isInitialized = false;
+  private initializing: Promise<boolean> | null = null;
+  /** Bumped by dispose(), so a driver load still running is not committed */
+  private generation = 0;
+  private warmUpScheduled = false;
   private isScanning = false;
 
   private constructor() {}
@@ -85,34 +99,76 @@ export class ScannerProvider {
   }
 
   /**
-   * Initialize all available platform scanners
+   * Initialize all available platform scanners. Drivers load in
+   * parallel; concurrent callers share one load, and once a driver is
+   * up it stays loaded for every later scanner dialog until dispose().
    */
   async initialize(): Promise<boolean> {
     if (this.isInitialized) {
       return true;
     }
+    if (!this.initializing) {
+      const initializing = this.initializePlatforms(this.generation).finally(() => {
+        if (this.initializing === initializing) {
+          this.initializing = null;
+        }
+      });
+      this.initializing = initializing;
+    }
+    return this.initializing;
+  }
 
-    let anyAvailable = false;
-
-    for (const [platform, scanner] of this.platformScanners) {
-      try {
-        const available = await scanner.isAvailable();
-        if (available) {
-          const initialized = await scanner.initialize();
-          if (initialized) {
-            anyAvailable = true;
-            console.log(`Scanner platform ${platform} initialized`);
+  private async initializePlatforms(generation: number): Promise<boolean> {
+    const results = await Promise.all(
+      Array.from(this.platformScanners, async ([platform, scanner]) => {
+        try {
+          const available = await scanner.isAvailable();
+          if (available) {
+            const initialized = await scanner.initialize();
+            if (initialized) {
+              console.log(`Scanner platform ${platform} initialized`);
+              return true;
+            }
           }
+        } catch (error) {
+          console.error(`Failed to initialize ${platform}:`, error);
         }
-      } catch (error) {
-        console.error(`Failed to initialize ${platform}:`, error);
-      }
+        return false;
+      })
+    );
+
+    // dispose() ran while the drivers loaded
+    if (generation !== this.generation) {
+      return false;
     }
 
+    const anyAvailable = results.some(Boolean);
     this.isInitialized = anyAvailable;
     return anyAvailable;
   }
 
+  /**
+   * Load the drivers in the background once the first window has
+   * painted, so opening the scanner dialog later finds them ready.
+   * Waits for the renderer to go idle where it can tell. App calls
+   * this from its mount effect.
+   */
+  warmUp(): void {
+    if (this.isInitialized || this.warmUpScheduled) {
+      return;
+    }
+    this.warmUpScheduled = true;
+
+    const run = () => {
+      void this.initialize();
+    };
+    if (typeof requestIdleCallback === 'function') {
+      requestIdleCallback(run, { timeout: WARM_UP_TIMEOUT_MS });
+    } else {
+      setTimeout(run, 0);
+    }
+  }
+
   /**
    * Enumerate all available scanner devices
    */
@@ -340,6 +396,7 @@ export class ScannerProvider {
    * Dispose all resources
    */
   async dispose(): Promise<void> {
+    this.generation++;
     for (const scanner of this.platformScanners.values()) {
       try {
         await scanner.dispose();
@@ -352,6 +409,8 @@ export class ScannerProvider {
     this.availableDevices = [];
     this.selectedDevice = null;
     this.isInitialized = false;
+    this.initializing = null;
+    this.warmUpScheduled = false;
   }
 
   /**
@@ -7,7 +7,7 @@
 /**
  * Scanner platform
  */
-export type ScannerPlatform = 'twain' | 'wia' | 'sane' | 'imagecapture';
+export type ScannerPlatform = 'twain' | 'wia' | 'sane' | 'imagecapture' | 'escl' | 'virtual';
 
 /**
  * Scan color mode
@@ -19,6 +19,28 @@ export type ScanColorMode = 'color' | 'grayscale' | 'blackwhite';
  */
 export type ScanResolution = 75 | 100 | 150 | 200 | 300 | 400 | 600 | 1200;
 
+/**
+ * Raw pixel layout delivered by the native scanner addons
+ */
+export type ScanPixelFormat = 'bw1' | 'gray8' | 'gray16' | 'rgb24' | 'rgb48';
+
+/**
+ * In-pipeline compression requested from the native scanner addons
+ * ('auto' = CCITT G4 for black & white, JPEG otherwise)
+ */
+export type ScanCompression = 'none' | 'jpeg' | 'ccitt-g4' | 'auto';
+
+/**
+ * Native thresholding applied right after acquisition. Pages come back
+ * as 1-bit black & white (CCITT G4 when compressed).
+ */
+export type ScanBinarization = 'none' | 'fixed' | 'otsu' | 'sauvola' | 'bradley';
+
+/**
+ * Encoding of the image returned by the native scanner addons
+ */
+export type ScanEncoding = 'raw' | 'jpeg' | 'ccitt-g4';
+
 /**
  * Paper size for scanning
  */
@@ -51,6 +73,8 @@ export interface ScannerCapabilities {
   maxHeight: number;
   /** Supported paper sizes */
   paperSizes: ScanPaperSize[];
+  /** Encodings the device compresses in hardware; matching scans skip software encoding */
+  compression?: Exclude<ScanEncoding, 'raw'>[];
 }
 
 /**
@@ -73,6 +97,16 @@ export interface ScannerDevice {
   available: boolean;
 }
 
+/**
+ * Region of the scan bed in inches from its top-left corner
+ */
+export interface ScanArea {
+  left: number;
+  top: number;
+  width: number;
+  height: number;
+}
+
 /**
  * Scan settings
  */
@@ -99,6 +133,59 @@ export interface ScanSettings {
   autoDetect?: boolean;
   /** Automatically correct perspective */
   autoCorrect?: boolean;
+  /** Compress pages natively while they are acquired */
+  compression?: ScanCompression;
+  /** JPEG quality (1-100) when compressing */
+  jpegQuality?: number;
+  /** Hardware region of the bed to scan; the driver transfers only this area */
+  scanArea?: ScanArea;
+  /** Scan only the document found by the last native preview (flatbed) */
+  usePreviewCrop?: boolean;
+  /** Threshold pages natively instead of using the driver's 1-bit mode */
+  binarize?: ScanBinarization;
+  /** Gray level (0-255) above which pixels are white, for 'fixed' */
+  binarizeThreshold?: number;
+  /**
+   * Bytes of scanned data buffered natively before acquisition pauses
+   * (default 256 MB)
+   */
+  highWaterMark?: number;
+  /**
+   * Drop blank pages during batch scans: 'backs' only checks the back
+   * sides of duplex sheets (default 'none')
+   */
+  skipBlankPages?: 'none' | 'backs' | 'all';
+  /** Ink coverage in percent below which a page counts as blank (default 0.3) */
+  blankThreshold?: number;
+  /**
+   * Split batch scans into documents at separator sheets: patch codes
+   * T, 2 and 3, Code 39 barcodes, or either (default 'none')
+   */
+  separation?: 'none' | 'patch' | 'barcode' | 'any';
+  /** Only Code 39 values starting with this mark a separator */
+  separatorBarcode?: string;
+  /** Deliver separator sheets as the first page of their document instead of dropping them */
+  keepSeparators?: boolean;
+  /**
+   * Thumbnail levels built natively from each page (0-3); every level
+   * is 1/4 the width and height of the one before
+   */
+  thumbnails?: number;
+}
+
+/**
+ * Reduced copy of a scanned page (8-bit gray or RGB)
+ */
+export interface ScanThumbnail {
+  width: number;
+  height: number;
+  /** Row stride of `pixels` in bytes */
+  stride: number;
+  channels: number;
+  pixelFormat: ScanPixelFormat;
+  /** Page size divided by thumbnail size along each side */
+  scale: number;
+  pixels: Uint8Array;
 }
 
 /**
@@ -113,16 +200,40 @@ export interface ScanResult {
   dataUrl?: string;
   /** Image as blob (if successful) */
   blob?: Blob;
+  /** Raw pixels wrapping the native transfer buffer (no Base64 round trip) */
+  pixels?: Uint8Array;
   /** Width in pixels */
   width?: number;
   /** Height in pixels */
   height?: number;
+  /** Row stride of `pixels` in bytes */
+  stride?: number;
+  /** Bits per sample of `pixels` */
+  bitDepth?: number;
+  /** Samples per pixel of `pixels` */
+  channels?: number;
+  /** Layout of `pixels` */
+  pixelFormat?: ScanPixelFormat;
+  /** Encoding of the returned image */
+  encoding?: ScanEncoding;
+  /** Encoded image bytes when `encoding` is not 'raw' */
+  data?: Uint8Array;
   /** Resolution used */
   resolution?: number;
   /** Color mode used */
   colorMode?: ScanColorMode;
+  /** Bed area that was scanned, when not the full paper size */
+  scanArea?: ScanArea;
   /** Timestamp when scan was taken */
   timestamp?: number;
+  /** Acquisition index of the page within the batch, counting dropped blank pages */
+  pageIndex?: number;
+  /** Document of the page within a batch split by separator sheets */
+  documentIndex?: number;
+  /** Thumbnail pyramid, largest first (see ScanSettings.thumbnails) */
+  thumbnails?: ScanThumbnail[];
+  /** Index of the page in the batch spool (BatchScanResult.spoolPath), when the batch was spooled */
+  spoolIndex?: number;
   /** Error message (if failed) */
   error?: string;
 }
@@ -133,12 +244,209 @@ export interface ScanResult {
 export interface BatchScanResult {
   /** Success flag */
   success: boolean;
-  /** Number of pages scanned */
+  /** Number of pages captured; pages counted in failedPages are not included */
   pageCount: number;
+  /**
+   * Pages that were acquired but failed to process. They reach onPage
+   * with success false and an error, but are left out of pageCount, the
+   * PDF, the spool and pageHandles; the batch itself still succeeds.
+   */
+  failedPages?: number;
   /** Individual scan results */
   pages: ScanResult[];
+  /** Pages dropped as blank (see skipBlankPages) */
+  blankPages?: number;
+  /** How many of the dropped pages were duplex back sides */
+  blankBacks?: number;
+  /** Separator sheet sides dropped (see ScanSettings.separation) */
+  separatorPages?: number;
+  /** Documents of a batch split by separator sheets, in feed order */
+  documents?: BatchDocument[];
+  /** Acquisition was stopped by cancelScan(); pages already finished are kept */
+  cancelled?: boolean;
   /** Error message (if failed) */
   error?: string;
+  /** PDF written natively during the batch (see BatchPdfOutput) */
+  pdfPath?: string;
+  /** Size of the written PDF in bytes */
+  pdfBytes?: number;
+  /** Spool the pages were written to (see BatchSpoolOutput) */
+  spoolPath?: string;
+  /** Handles of every committed spool page, instead of `pages` data */
+  pageHandles?: SpoolPageHandle[];
+  /** Pages that were already in the spool when the batch resumed */
+  resumedPages?: number;
+  /** Spooled pages a resumed batch dropped because their data failed its checksum */
+  corruptPages?: number;
+}
+
+/**
+ * Separator sheet code that opened a document
+ */
+export interface ScanSeparator {
+  type: 'patchT' | 'patch2' | 'patch3' | 'code39';
+  /** Barcode text */
+  value?: string;
+}
+
+/**
+ * One document of a batch split by separator sheets
+ */
+export interface BatchDocument {
+  /** pageIndex of its first page */
+  firstPage?: number;
+  pageCount: number;
+  /** PDF the document was written to, when the batch had a PDF output */
+  pdfPath?: string;
+  pdfBytes?: number;
+  /** Absent for the pages before the first separator */
+  separator?: ScanSeparator;
+}
+
+/**
+ * A page in a native batch spool. Page data stays in the spool file
+ * until it is read (readSpoolPage, readSpool) or converted (spoolToPdf).
+ */
+export interface SpoolPageHandle {
+  /** Spool file path */
+  spoolPath: string;
+  /** Page index in the spool */
+  index: number;
+  /** File offset of the page's record, so readSpoolPage reads only that page */
+  offset: number;
+}
+
+/**
+ * Spool output for a native batch scan. Pages are appended to a
+ * crash-safe spool file as they come off the feeder; with `resume`, a
+ * batch that was interrupted continues after its last committed page.
+ */
+export interface BatchSpoolOutput {
+  /** Spool file path */
+  spoolPath: string;
+  /** Keep the committed pages of an existing spool at spoolPath */
+  resume?: boolean;
+}
+
+/**
+ * Early thumbnails for a native batch scan. Each page's thumbnails are
+ * passed here as soon as the sheet is acquired, ahead of the page
+ * itself, and the page result then comes without them.
+ */
+export interface BatchThumbnailOutput {
+  onThumbnails: (pageIndex: number, thumbnails: ScanThumbnail[]) => void;
+}
+
+/**
+ * Direct-to-PDF output for a native batch scan. Pages are appended to
+ * the file as they come off the feeder instead of being collected in JS.
+ */
+export interface BatchPdfOutput {
+  /** Output file path */
+  pdfPath: string;
+  /** PDF title */
+  title?: string;
+  /** PDF author */
+  author?: string;
+  /** PDF subject */
+  subject?: string;
+  /** PDF keywords */
+  keywords?: string[];
+}
+
+/**
+ * An open device in a multi-scanner setup. Each session scans
+ * independently of the others.
+ */
+export interface ScanSessionInfo {
+  /** Session ID passed to the session* scanner calls */
+  sessionId: number;
+  /** Device the session has open */
+  deviceId: string;
+  /** Whether this session is currently acquiring */
+  isScanning: boolean;
+}
+
+/**
+ * Pipeline stage timed by the native scanner metrics
+ */
+export type ScanMetricStage =
+  | 'deviceSetup'
+  | 'transfer'
+  | 'assemble'
+  | 'binarize'
+  | 'encode'
+  | 'pdfWrite'
+  | 'spool'
+  | 'queueWait'
+  | 'ipcHandoff';
+
+/**
+ * Totals for one stage across a scanner's acquisitions
+ */
+export interface ScanStageMetrics {
+  count: number;
+  totalMs: number;
+  maxMs: number;
+  meanMs: number;
+}
+
+/**
+ * Stage timings of one finished page
+ */
+export interface PageScanMetrics {
+  /** Page index within its acquisition */
+  pageIndex: number;
+  /** Raw bytes read from the driver for this page */
+  bytesTransferred: number;
+  /** Milliseconds spent per stage */
+  stages: Record<ScanMetricStage, number>;
+}
+
+/**
+ * Native getMetrics() / sessionGetMetrics() result
+ */
+export interface ScanMetrics {
+  /** Acquisitions started */
+  scans: number;
+  /** Pages handed to JavaScript */
+  pages: number;
+  stages: Record<ScanMetricStage, ScanStageMetrics>;
+  bytes: {
+    transferred: number;
+    encoded: number;
+    delivered: number;
+  };
+  /** Pages and bytes buffered between acquisition and JavaScript */
+  queue: {
+    depth: number;
+    maxDepth: number;
+    bytes: number;
+    maxBytes: number;
+  };
+  /** Page and band buffer recycling */
+  bufferPool: {
+    hits: number;
+    misses: number;
+    pooledBytes: number;
+    pooledBuffers: number;
+  };
+  /** Shared post-processing pool */
+  threadPool: {
+    threads: number;
+    queuedTasks: number;
+  };
+  /** Last finished pages, oldest first */
+  recentPages: PageScanMetrics[];
+}
+
+/**
+ * Native onMetrics() event, sent once per finished page
+ */
+export interface ScanMetricsEvent {
+  sessionId: number;
+  deviceId: string;
+  page: PageScanMetrics;
 }
 
 /**
@@ -184,6 +492,23 @@ export interface DocumentDetectionResult {
   confidence?: number;
 }
 
+/**
+ * Document found in a native preview frame. Pixel coordinates refer to
+ * the preview frame; scanArea is the padded crop on the bed.
+ */
+export interface PreviewDocument extends DocumentDetectionResult {
+  scanArea?: ScanArea;
+}
+
+/**
+ * Native preview() result: a low-resolution frame plus its document.
+ * Like scan(), a failed preview resolves with success false.
+ */
+export interface PreviewScanResult extends ScanResult {
+  /** Absent when the preview failed */
+  document?: PreviewDocument;
+}
+
 /**
  * Point
  */
@@ -0,0 +1,164 @@
+/**
+ * PDF Worker Tests
+ *
+ * Round trip of in-memory scan pages through the worker's imagesToPdf
+ * task, with the page buffers moved the way the pool sends them.
+ *
+ * @vitest-environment node
+ */
+
+import { describe, it, expect, beforeAll, beforeEach, afterAll, vi } from 'vitest';
+import { mkdtemp, readFile, rm } from 'fs/promises';
+import { tmpdir } from 'os';
+import path from 'path';
+import { PDFDocument } from 'pdf-lib';
+
+// The worker script talks to the pool through parentPort
+vi.mock('worker_threads', async (importOriginal) => {
+  const actual = await importOriginal<typeof import('worker_threads')>();
+  const { EventEmitter } = await import('events');
+  const parentPort = Object.assign(new EventEmitter(), { postMessage: vi.fn() });
+  return { ...actual, parentPort, workerData: { workerId: 'test-worker' } };
+});
+
+import * as workerThreads from 'worker_threads';
+import { transferableBuffers } from '../../electron/workers/workerPool';
+
+// 1x1 PNG
+const PNG_BASE64 =
+  'iVBORw0KGgoAAAANSUhEUgAAAAEAAAABCAYAAAAfFcSJAAAADUlEQVR42mNk+M9QDwADhgGAWjR9awAAAABJRU5ErkJggg==';
+
+const parentPort = workerThreads.parentPort as unknown as {
+  emit: (event: string, message: unknown) => void;
+  postMessage: ReturnType<typeof vi.fn>;
+};
+
+/**
+ * Post a task to the worker over a real channel with its transfer list,
+ * as WorkerPool does, and wait for the worker's result
+ */
+async function runTask(task: {
+  id: string;
+  type: string;
+  payload: Record<string, unknown>;
+  pages: Uint8Array[];
+}): Promise<{ result?: { size: number; pageCount: number }; error?: string }> {
+  const { port1, port2 } = new workerThreads.MessageChannel();
+  port1.postMessage(
+    { type: 'task', task: { id: task.id, type: task.type, payload: task.payload } },
+    transferableBuffers(task.pages)
+  );
+  const message = workerThreads.receiveMessageOnPort(port2)?.message;
+  port1.close();
+  port2.close();
+
+  parentPort.emit('message', message);
+  await vi.waitFor(() =>
+    expect(parentPort.postMessage).toHaveBeenCalledWith(
+      expect.objectContaining({ type: 'result', taskId: task.id })
+    )
+  );
+  return parentPort.postMessage.mock.calls
+    .map(([sent]) => sent)
+    .find((sent) => sent.type === 'result' && sent.taskId === task.id);
+}
+
+describe('PDF Worker', () => {
+  let outputDir: string;
+
+  beforeAll(async () => {
+    vi.spyOn(console, 'log').mockImplementation(() => {});
+    await import('../../electron/workers/pdfWorker');
+    outputDir = await mkdtemp(path.join(tmpdir(), 'pdf-worker-'));
+  });
+
+  afterAll(async () => {
+    await rm(outputDir, { recursive: true, force: true });
+    vi.restoreAllMocks();
+  });
+
+  beforeEach(() => {
+    parentPort.postMessage.mockClear();
+  });
+
+  describe('imagesToPdf', () => {
+    it('should write one page per moved image at its scan resolution', async () => {
+      const letter = new Uint8Array(Buffer.from(PNG_BASE64, 'base64'));
+      const a4 = new Uint8Array(Buffer.from(PNG_BASE64, 'base64'));
+      const outputPath = path.join(outputDir, 'pages.pdf');
+      const pages = [
+        { data: letter, encoding: 'png', width: 2550, height: 3300, resolution: 300 },
+        { data: a4, encoding: 'png', width: 1240, height: 1754, resolution: 150 },
+      ];
+
+      const sent = await runTask({
+        id: 'task-1',
+        type: 'imagesToPdf',
+        payload: { inputPath: '', outputPath, options: {}, pages },
+        pages: pages.map((page) => page.data),
+      });
+
+      // The page bytes moved to the worker instead of being copied
+      expect(letter.byteLength).toBe(0);
+      expect(a4.byteLength).toBe(0);
+
+      expect(sent.error).toBeUndefined();
+      expect(sent.result?.pageCount).toBe(2);
+
+      const bytes = await readFile(outputPath);
+      expect(sent.result?.size).toBe(bytes.length);
+
+      const pdf = await PDFDocument.load(bytes);
+      expect(pdf.getPageCount()).toBe(2);
+      const first = pdf.getPage(0).getSize();
+      expect(first.width).toBeCloseTo(612);
+      expect(first.height).toBeCloseTo(792);
+      const second = pdf.getPage(1).getSize();
+      expect(second.width).toBeCloseTo(595.2);
+      expect(second.height).toBeCloseTo(841.92);
+    });
+
+    it('should lay out a page without a resolution at 72 dpi', async () => {
+      const data = new Uint8Array(Buffer.from(PNG_BASE64, 'base64'));
+      const outputPath = path.join(outputDir, 'no-resolution.pdf');
+
+      const sent = await runTask({
+        id: 'task-3',
+        type: 'imagesToPdf',
+        payload: {
+          inputPath: '',
+          outputPath,
+          options: {},
+          pages: [{ data, encoding: 'png', width: 200, height: 100, resolution: 0 }],
+        },
+        pages: [data],
+      });
+
+      expect(sent.error).toBeUndefined();
+      const pdf = await PDFDocument.load(await readFile(outputPath));
+      const size = pdf.getPage(0).getSize();
+      expect(size.width).toBe(200);
+      expect(size.height).toBe(100);
+    });
+
+    it('should report a page that is not a valid image', async () => {
+      const outputPath = path.join(outputDir, 'broken.pdf');
+      const data = new Uint8Array([1, 2, 3, 4]);
+
+      const sent = await runTask({
+        id: 'task-2',
+        type: 'imagesToPdf',
+        payload: {
+          inputPath: '',
+          outputPath,
+          options: {},
+          pages: [{ data, encoding: 'png', width: 100, height: 100, resolution: 100 }],
+        },
+        pages: [data],
+      });
+
+      expect(sent.result).toBeUndefined();
+      expect(sent.error).toBeDefined();
+    });
+  });
+});
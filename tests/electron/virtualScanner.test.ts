@@ -0,0 +1,122 @@
+/**
+ * Virtual Scanner Addon Tests
+ *
+ * Drives the shared ScannerObject API through the virtual backend.
+ * Skipped unless the addon has been built (see
+ * electron/native/virtual/README.md).
+ *
+ * @vitest-environment node
+ */
+
+import { describe, it, expect, afterEach } from 'vitest';
+import { existsSync } from 'fs';
+import { createRequire } from 'module';
+import path from 'path';
+
+const ADDON_PATH = path.resolve(
+  __dirname,
+  '../../electron/native/virtual/build/Release/virtual_wrapper.node'
+);
+
+interface VirtualScanner {
+  initialize(): Promise<boolean>;
+  enumerateDevices(): { id: string }[];
+  selectDevice(deviceId: string): boolean;
+  configure(options: Record<string, unknown>): boolean;
+  scan(settings: Record<string, unknown>): Promise<{ success: boolean }>;
+  cancelScan(): boolean;
+  openSession(deviceId: string): number;
+  getSessions(): { sessionId: number; deviceId: string; isScanning: boolean }[];
+  close(): boolean;
+}
+
+type VirtualScannerClass = new () => VirtualScanner;
+
+function loadScanner(): VirtualScannerClass | null {
+  if (!existsSync(ADDON_PATH)) {
+    return null;
+  }
+  const addon = createRequire(__filename)(ADDON_PATH) as {
+    VirtualScanner: VirtualScannerClass;
+  };
+  return addon.VirtualScanner;
+}
+
+const VirtualScannerAddon = loadScanner();
+
+describe.skipIf(!VirtualScannerAddon)('Virtual Scanner addon', () => {
+  let scanner: VirtualScanner;
+
+  afterEach(() => {
+    scanner?.close();
+  });
+
+  describe('initialization', () => {
+    it('should refuse device calls before initialize()', () => {
+      scanner = new VirtualScannerAddon!();
+
+      expect(() => scanner.enumerateDevices()).toThrow('Scanner not initialized');
+      expect(() => scanner.selectDevice('virtual-adf')).toThrow('Scanner not initialized');
+      expect(() => scanner.scan({})).toThrow('Scanner not initialized');
+    });
+
+    it('should refuse device calls again after close()', async () => {
+      scanner = new VirtualScannerAddon!();
+      await scanner.initialize();
+      scanner.close();
+
+      expect(() => scanner.enumerateDevices()).toThrow('Scanner not initialized');
+    });
+
+    it('should list devices once initialized', async () => {
+      scanner = new VirtualScannerAddon!();
+      await scanner.initialize();
+
+      const ids = scanner.enumerateDevices().map((device) => device.id);
+      expect(ids).toContain('virtual-adf');
+      expect(ids).toContain('virtual-flatbed');
+    });
+  });
+
+  describe('selectDevice', () => {
+    it('should release the previously selected device', async () => {
+      scanner = new VirtualScannerAddon!();
+      await scanner.initialize();
+
+      scanner.selectDevice('virtual-adf');
+      scanner.selectDevice('virtual-flatbed');
+
+      expect(scanner.getSessions().map((session) => session.deviceId)).toEqual([
+        'virtual-flatbed',
+      ]);
+    });
+
+    it('should keep a session the caller opened itself', async () => {
+      scanner = new VirtualScannerAddon!();
+      await scanner.initialize();
+
+      const sessionId = scanner.openSession('virtual-adf');
+      scanner.selectDevice('virtual-adf');
+      scanner.selectDevice('virtual-flatbed');
+
+      const sessions = scanner.getSessions();
+      expect(sessions.map((session) => session.sessionId)).toContain(sessionId);
+      expect(sessions).toHaveLength(2);
+    });
+
+    it('should not switch away from a device that is scanning', async () => {
+      scanner = new VirtualScannerAddon!();
+      await scanner.initialize();
+
+      scanner.selectDevice('virtual-adf');
+      scanner.configure({ pagesPerMinute: 1 });
+      const scan = scanner.scan({ resolution: 75 });
+
+      expect(() => scanner.selectDevice('virtual-flatbed')).toThrow('Scan in progress');
+      expect(scanner.getSessions()).toHaveLength(1);
+
+      scanner.cancelScan();
+      await scan;
+    });
+  });
+});
@@ -0,0 +1,76 @@
+/**
+ * Worker Pool Tests
+ *
+ * Tests for the transfer list built for page buffers sent to workers.
+ *
+ * @vitest-environment node
+ */
+
+import { describe, it, expect } from 'vitest';
+import * as workerThreads from 'worker_threads';
+import { MessageChannel, markAsUntransferable, receiveMessageOnPort } from 'worker_threads';
+import { transferableBuffers } from '../../electron/workers/workerPool';
+
+describe('Worker Pool', () => {
+  describe('transferableBuffers', () => {
+    it('should list each whole ArrayBuffer once', () => {
+      const buffer = new ArrayBuffer(64);
+      const first = new Uint8Array(buffer);
+      const second = new Uint8Array(buffer);
+      const other = new Uint8Array(32);
+
+      const list = transferableBuffers([first, second, other]);
+
+      expect(list).toHaveLength(2);
+      expect(list).toContain(buffer);
+      expect(list).toContain(other.buffer);
+    });
+
+    it('should skip views over part of a buffer', () => {
+      const buffer = new ArrayBuffer(64);
+
+      expect(transferableBuffers([new Uint8Array(buffer, 16, 16)])).toEqual([]);
+      expect(transferableBuffers([new Uint8Array(buffer, 0, 32)])).toEqual([]);
+    });
+
+    it('should skip pooled Node buffers', () => {
+      // Small Buffers are slices of a shared allocation pool
+      const pooled = Buffer.from('page');
+
+      expect(transferableBuffers([pooled])).toEqual([]);
+    });
+
+    // Marks are only visible from Node 21 on
+    it.skipIf(!('isMarkedAsUntransferable' in workerThreads))('should skip buffers marked as untransferable', () => {
+      const data = new Uint8Array(64);
+      markAsUntransferable(data.buffer);
+
+      expect(transferableBuffers([data])).toEqual([]);
+    });
+
+    it('should skip shared memory', () => {
+      const shared = new Uint8Array(new SharedArrayBuffer(64));
+
+      expect(transferableBuffers([shared])).toEqual([]);
+    });
+
+    it('should detach transferred buffers on the sending side', () => {
+      const { port1, port2 } = new MessageChannel();
+      const data = new Uint8Array([1, 2, 3, 4]);
+      const pooled = Buffer.from([5, 6, 7, 8]);
+
+      port1.postMessage({ pages: [data, pooled] }, transferableBuffers([data, pooled]));
+      const received = receiveMessageOnPort(port2)?.message as { pages: Uint8Array[] };
+      port1.close();
+      port2.close();
+
+      // Moved, so the sender's view is empty
+      expect(data.byteLength).toBe(0);
+      expect(Array.from(received.pages[0]!)).toEqual([1, 2, 3, 4]);
+
+      // Copied, so the sender keeps its pooled buffer
+      expect(pooled.byteLength).toBe(4);
+      expect(Array.from(received.pages[1]!)).toEqual([5, 6, 7, 8]);
+    });
+  });
+});
@@ -0,0 +1,31 @@
+import { describe, it, expect, vi } from 'vitest';
+import { render } from '@testing-library/react';
+import { MemoryRouter } from 'react-router-dom';
+import App from '@/App';
+
+const { warmUp } = vi.hoisted(() => ({ warmUp: vi.fn() }));
+
+vi.mock('@lib/scanner/scannerProvider', () => ({
+  scannerProvider: { warmUp },
+}));
+
+vi.mock('@/pages/Home', () => ({
+  default: () => <div>Home</div>,
+}));
+
+describe('App', () => {
+  it('should warm up the scanner drivers once after mounting', async () => {
+    const { rerender } = render(
+      <MemoryRouter>
+        <App />
+      </MemoryRouter>
+    );
+    rerender(
+      <MemoryRouter>
+        <App />
+      </MemoryRouter>
+    );
+
+    await vi.waitFor(() => expect(warmUp).toHaveBeenCalledTimes(1));
+  });
+});
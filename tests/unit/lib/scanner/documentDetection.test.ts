@@ -302,4 +302,53 @@ describe('DocumentDetection', () => {
       expect(largeConfidence).toBeGreaterThan(smallConfidence);
     });
   });
+
+  describe('crop rect to scan area', () => {
+    it('should convert a rect in the middle of the bed to inches with the margin', () => {
+      // 1" x 2" offset, 5" x 7" document at 300 dpi
+      const area = DocumentDetection.cropRectToScanArea({ x: 300, y: 600, width: 1500, height: 2100 }, 300);
+
+      expect(area.left).toBeCloseTo(0.875);
+      expect(area.top).toBeCloseTo(1.875);
+      expect(area.width).toBeCloseTo(5.25);
+      expect(area.height).toBeCloseTo(7.25);
+    });
+
+    it('should use a custom margin', () => {
+      const area = DocumentDetection.cropRectToScanArea({ x: 150, y: 150, width: 300, height: 150 }, 150, 0.5);
+
+      expect(area.left).toBeCloseTo(0.5);
+      expect(area.top).toBeCloseTo(0.5);
+      expect(area.width).toBeCloseTo(3);
+      expect(area.height).toBeCloseTo(2);
+    });
+
+    it('should clamp the margin at the top left edge of the bed', () => {
+      // Letter page touching the bed origin
+      const area = DocumentDetection.cropRectToScanArea({ x: 10, y: 0, width: 2540, height: 3300 }, 300);
+
+      expect(area.left).toBe(0);
+      expect(area.top).toBe(0);
+      // The far edges keep their margin; the driver clips them to the bed
+      expect(area.width).toBeCloseTo(8.625);
+      expect(area.height).toBeCloseTo(11.125);
+    });
+
+    it('should turn a degenerate rect into a margin-sized area around it', () => {
+      const area = DocumentDetection.cropRectToScanArea({ x: 600, y: 300, width: 0, height: 0 }, 300);
+
+      expect(area.left).toBeCloseTo(1.875);
+      expect(area.top).toBeCloseTo(0.875);
+      expect(area.width).toBeCloseTo(0.25);
+      expect(area.height).toBeCloseTo(0.25);
+    });
+
+    it('should give an empty area for a degenerate rect without margin', () => {
+      const area = DocumentDetection.cropRectToScanArea({ x: 600, y: 300, width: 0, height: 0 }, 300, 0);
+
+      // An empty area means the full bed to the native scan path
+      expect(area.width).toBe(0);
+      expect(area.height).toBe(0);
+    });
+  });
 });
@@ -0,0 +1,122 @@
+/**
+ * Scan OCR Tests
+ *
+ * @vitest-environment node
+ */
+
+import { describe, it, expect, vi, beforeEach } from 'vitest';
+import { ScanOCR, type PreparedOCRImage } from '@lib/scanner/scanOcr';
+import type { ScanResult } from '@lib/scanner/types';
+
+const { createWorker, recognize } = vi.hoisted(() => {
+  const recognize = vi.fn(async () => ({
+    data: {
+      text: 'Invoice 42',
+      confidence: 91,
+      words: [
+        {
+          text: 'Invoice',
+          confidence: 93,
+          bbox: { x0: 10, y0: 20, x1: 110, y1: 50 },
+          baseline: { y1: 48 },
+        },
+      ],
+      lines: [],
+      paragraphs: [],
+    },
+  }));
+  const createWorker = vi.fn(async () => ({
+    recognize,
+    setParameters: vi.fn(async () => {}),
+    terminate: vi.fn(async () => {}),
+  }));
+  return { createWorker, recognize };
+});
+
+// Mock tesseract.js
+vi.mock('tesseract.js', () => ({
+  createWorker,
+  OEM: { LSTM_ONLY: 1 },
+  PSM: { AUTO: 3 },
+}));
+
+const scan: ScanResult = {
+  success: true,
+  dataUrl: 'data:image/png;base64,iVBORw0KGgo=',
+  width: 2550,
+  height: 3300,
+  resolution: 300,
+  colorMode: 'grayscale',
+};
+
+const createPrepared = (): PreparedOCRImage => {
+  // Binary PGM header followed by a few pixels
+  const bytes = new TextEncoder().encode('P5\n4 2\n255\n\x00\x10\x20\x30\x40\x50\x60\x70');
+  const data = new ArrayBuffer(bytes.length);
+  new Uint8Array(data).set(bytes);
+  return { data, format: 'pgm', width: 2540, height: 3310, skewAngle: 0.4 };
+};
+
+describe('ScanOCR', () => {
+  let ocr: ScanOCR;
+
+  beforeEach(() => {
+    vi.clearAllMocks();
+    ocr = new ScanOCR();
+  });
+
+  describe('recognize with a prepared image', () => {
+    it('should recognise the prepared buffer instead of the scan', async () => {
+      const prepared = createPrepared();
+      const expected = new Uint8Array(prepared.data.slice(0));
+
+      await ocr.recognize(scan, {}, prepared);
+
+      expect(recognize).toHaveBeenCalledTimes(1);
+      const input = (recognize.mock.calls[0] as unknown[])[0];
+      expect(input).toBeInstanceOf(Blob);
+      const received = new Uint8Array(await (input as Blob).arrayBuffer());
+      expect(received).toEqual(expected);
+    });
+
+    it('should not run the canvas prep step again', async () => {
+      const preprocess = vi.spyOn(ScanOCR, 'preprocessForOCR');
+
+      await ocr.recognize(scan, {}, createPrepared());
+
+      expect(preprocess).not.toHaveBeenCalled();
+      preprocess.mockRestore();
+    });
+
+    it('should size word boxes to the prepared page', async () => {
+      const result = await ocr.recognize(scan, {}, createPrepared());
+
+      // The deskewed page, not the scan
+      expect(result.width).toBe(2540);
+      expect(result.height).toBe(3310);
+      expect(result.words.map((word) => word.text)).toEqual(['Invoice']);
+    });
+
+    it('should accept a scan that only has metadata', async () => {
+      const metadata: ScanResult = { ...scan, dataUrl: undefined };
+
+      await expect(ocr.recognize(metadata, {}, createPrepared())).resolves.toBeDefined();
+      expect(recognize).toHaveBeenCalledTimes(1);
+    });
+  });
+
+  describe('recognize without a prepared image', () => {
+    it('should recognise the scan data URL', async () => {
+      const result = await ocr.recognize(scan);
+
+      expect(recognize).toHaveBeenCalledWith(scan.dataUrl);
+      expect(result.width).toBe(2550);
+      expect(result.height).toBe(3300);
+    });
+
+    it('should reject a scan without image data', async () => {
+      await expect(ocr.recognize({ success: true })).rejects.toThrow('Scan has no image data');
+      expect(recognize).not.toHaveBeenCalled();
+    });
+  });
+});
@@ -3,7 +3,7 @@
  */
 
 /* eslint-disable @typescript-eslint/no-explicit-any */
-import { describe, it, expect, beforeEach } from 'vitest';
+import { describe, it, expect, beforeEach, afterEach, vi } from 'vitest';
 import { ScannerProvider } from '@lib/scanner/scannerProvider';
 import type { PlatformScanner, ScannerDevice, ScanResult } from '@lib/scanner/types';
 
@@ -240,4 +240,100 @@ describe('ScannerProvider', () => {
       expect(selectedDevice!.capabilities.colorModes).toContain('color');
     });
   });
+
+  describe('initialization', () => {
+    afterEach(() => {
+      vi.unstubAllGlobals();
+    });
+
+    it('should share one platform init between concurrent callers', async () => {
+      const initialize = vi.fn(async () => true);
+      const newProvider = new (ScannerProvider as any)();
+      newProvider.registerPlatformScanner({ ...createMockScanner(), initialize });
+
+      const results = await Promise.all([newProvider.initialize(), newProvider.initialize()]);
+
+      expect(results).toEqual([true, true]);
+      expect(initialize).toHaveBeenCalledTimes(1);
+
+      // Later callers find the drivers loaded
+      expect(await newProvider.initialize()).toBe(true);
+      expect(initialize).toHaveBeenCalledTimes(1);
+    });
+
+    it('should retry a failed init on the next call', async () => {
+      const initialize = vi.fn().mockResolvedValueOnce(false).mockResolvedValueOnce(true);
+      const newProvider = new (ScannerProvider as any)();
+      newProvider.registerPlatformScanner({ ...createMockScanner(), initialize });
+
+      expect(await newProvider.initialize()).toBe(false);
+      expect(await newProvider.initialize()).toBe(true);
+      expect(initialize).toHaveBeenCalledTimes(2);
+    });
+
+    it('should retry an init that threw', async () => {
+      const initialize = vi.fn().mockRejectedValueOnce(new Error('driver missing')).mockResolvedValueOnce(true);
+      const newProvider = new (ScannerProvider as any)();
+      newProvider.registerPlatformScanner({ ...createMockScanner(), initialize });
+      vi.spyOn(console, 'error').mockImplementation(() => {});
+
+      expect(await newProvider.initialize()).toBe(false);
+      expect(await newProvider.initialize()).toBe(true);
+      expect(initialize).toHaveBeenCalledTimes(2);
+    });
+
+    it('should not commit an init that finishes after dispose', async () => {
+      let finishInit: (initialized: boolean) => void = () => {};
+      const initialize = vi.fn(
+        () =>
+          new Promise<boolean>((resolve) => {
+            finishInit = resolve;
+          })
+      );
+      const newProvider = new (ScannerProvider as any)();
+      newProvider.registerPlatformScanner({ ...createMockScanner(), initialize });
+
+      const pending = newProvider.initialize();
+      await vi.waitFor(() => expect(initialize).toHaveBeenCalledTimes(1));
+      await newProvider.dispose();
+      finishInit(true);
+
+      expect(await pending).toBe(false);
+      expect(newProvider.isInitialized).toBe(false);
+    });
+
+    it('should schedule warmUp without blocking the caller', async () => {
+      const idleCallbacks: Array<() => void> = [];
+      vi.stubGlobal('requestIdleCallback', (callback: () => void) => {
+        idleCallbacks.push(callback);
+        return idleCallbacks.length;
+      });
+
+      let finishInit: (initialized: boolean) => void = () => {};
+      const initialize = vi.fn(
+        () =>
+          new Promise<boolean>((resolve) => {
+            finishInit = resolve;
+          })
+      );
+      const newProvider = new (ScannerProvider as any)();
+      newProvider.registerPlatformScanner({ ...createMockScanner(), initialize });
+
+      expect(newProvider.warmUp()).toBeUndefined();
+      newProvider.warmUp();
+      expect(idleCallbacks.length).toBe(1);
+      expect(initialize).not.toHaveBeenCalled();
+
+      // The driver load runs once the renderer is idle and returns at once
+      idleCallbacks[0]();
+      await vi.waitFor(() => expect(initialize).toHaveBeenCalledTimes(1));
+      expect(newProvider.isInitialized).toBe(false);
+
+      // A scanner dialog opened meanwhile joins the same load
+      const opened = newProvider.initialize();
+      finishInit(true);
+      expect(await opened).toBe(true);
+      expect(initialize).toHaveBeenCalledTimes(1);
+    });
+  });
 });